@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "common.h"
@@ -32,6 +33,7 @@
 #include "context.h"
 
 THREAD_LOCAL enum int_log_opts log_opt;
+THREAD_LOCAL int log_defer_path;
 THREAD_LOCAL LY_ERR ly_errno_glob;
 
 API LY_ERR *
@@ -49,7 +51,7 @@ ly_vecode(const struct ly_ctx *ctx)
 
     struct ly_err_item *i;
 
-    i = ly_err_first(ctx);
+    i = ly_err_first_int(ctx);
     if (i) {
         return i->prev->vecode;
     }
@@ -64,7 +66,7 @@ ly_errmsg(const struct ly_ctx *ctx)
 
     struct ly_err_item *i;
 
-    i = ly_err_first(ctx);
+    i = ly_err_first_int(ctx);
     if (i) {
         return i->prev->msg;
     }
@@ -79,8 +81,9 @@ ly_errpath(const struct ly_ctx *ctx)
 
     struct ly_err_item *i;
 
-    i = ly_err_first(ctx);
+    i = ly_err_first_int(ctx);
     if (i) {
+        ly_err_build_path(i->prev);
         return i->prev->path;
     }
 
@@ -94,7 +97,7 @@ ly_errapptag(const struct ly_ctx *ctx)
 
     struct ly_err_item *i;
 
-    i = ly_err_first(ctx);
+    i = ly_err_first_int(ctx);
     if (i) {
         return i->prev->apptag;
     }
@@ -102,16 +105,31 @@ ly_errapptag(const struct ly_ctx *ctx)
     return NULL;
 }
 
+struct ly_err_item *
+ly_err_first_int(const struct ly_ctx *ctx)
+{
+    if (!ctx) {
+        return NULL;
+    }
+
+    return pthread_getspecific(ctx->errlist_key);
+}
+
 API struct ly_err_item *
 ly_err_first(const struct ly_ctx *ctx)
 {
     FUN_IN;
 
-    if (!ctx) {
-        return NULL;
+    struct ly_err_item *first, *i;
+
+    first = ly_err_first_int(ctx);
+
+    /* the caller may read any of the errors */
+    for (i = first; i; i = i->next) {
+        ly_err_build_path(i);
     }
 
-    return pthread_getspecific(ctx->errlist_key);
+    return first;
 }
 
 void
@@ -136,7 +154,7 @@ ly_err_clean(struct ly_ctx *ctx, struct ly_err_item *eitem)
 
     struct ly_err_item *i, *first;
 
-    first = ly_err_first(ctx);
+    first = ly_err_first_int(ctx);
     if (first == eitem) {
         eitem = NULL;
     }
@@ -159,6 +177,85 @@ ly_err_clean(struct ly_ctx *ctx, struct ly_err_item *eitem)
     }
 }
 
+volatile int ly_prof_enabled;
+static THREAD_LOCAL struct ly_prof ly_prof_data;
+static void (*ly_prof_clb)(LY_PROF_PHASE phase, uint64_t nsec, void *arg);
+static void *ly_prof_clb_arg;
+
+API int
+ly_prof_enable(int enable)
+{
+    FUN_IN;
+
+    int prev = ly_prof_enabled;
+
+    ly_prof_enabled = enable ? 1 : 0;
+    return prev;
+}
+
+API void
+ly_prof_get(struct ly_prof *prof)
+{
+    FUN_IN;
+
+    if (!prof) {
+        LOGARG;
+        return;
+    }
+
+    memcpy(prof, &ly_prof_data, sizeof *prof);
+}
+
+API void
+ly_prof_reset(void)
+{
+    FUN_IN;
+
+    memset(&ly_prof_data, 0, sizeof ly_prof_data);
+}
+
+API void
+ly_prof_set_clb(void (*clb)(LY_PROF_PHASE phase, uint64_t nsec, void *arg), void *arg)
+{
+    FUN_IN;
+
+    ly_prof_clb = clb;
+    ly_prof_clb_arg = arg;
+}
+
+uint64_t
+ly_prof_now(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts)) {
+        return 0;
+    }
+
+    /* never return 0, it means the phase is not being measured */
+    return ((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec) | 1;
+}
+
+void
+ly_prof_end(LY_PROF_PHASE phase, uint64_t start)
+{
+    uint64_t nsec;
+
+    nsec = ly_prof_now() - start;
+    ly_prof_data.nsec[phase] += nsec;
+    ++ly_prof_data.calls[phase];
+
+    if (ly_prof_clb) {
+        ly_prof_clb(phase, nsec, ly_prof_clb_arg);
+    }
+}
+
+void
+ly_prof_count(LY_PROF_COUNTER counter)
+{
+    ++ly_prof_data.counters[counter];
+}
+
 const char *
 strpbrk_backwards(const char *s, const char *accept, unsigned int s_len)
 {
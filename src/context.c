@@ -23,6 +23,9 @@
 #include <limits.h>
 #include <errno.h>
 #include <fcntl.h>
+#ifdef LY_ENABLED_CACHE
+# include <pcre.h>
+#endif
 
 #include "common.h"
 #include "context.h"
@@ -98,6 +101,12 @@ ly_ctx_new(const char *search_dir, int options)
     /* dictionary */
     lydict_init(&ctx->dict);
 
+    /* compiled patterns */
+    pthread_mutex_init(&ctx->regex.lock, NULL);
+
+    /* identity derivation index */
+    pthread_mutex_init(&ctx->ident_index.lock, NULL);
+
     /* plugins */
     ly_load_plugins();
 
@@ -131,6 +140,7 @@ ly_ctx_new(const char *search_dir, int options)
         }
     }
     ctx->models.module_set_id = 1;
+    ctx->models.module_set_gen = 1;
 
     /* load internal modules */
     if (options & LY_CTX_NOYANGLIBRARY) {
@@ -551,6 +561,17 @@ ly_ctx_destroy(struct ly_ctx *ctx, void (*private_destructor)(const struct lys_n
     ly_err_clean(ctx, 0);
     pthread_key_delete(ctx->errlist_key);
 
+    /* compiled patterns */
+    lyp_regex_cache_clean(ctx);
+    pthread_mutex_destroy(&ctx->regex.lock);
+
+    /* identity derivation index */
+    ly_ctx_ident_index_clean(ctx);
+    pthread_mutex_destroy(&ctx->ident_index.lock);
+
+    /* shared type restrictions, all freed with the modules */
+    lyht_free(ctx->type_shares);
+
     /* dictionary */
     lydict_clean(&ctx->dict);
 
@@ -1315,6 +1336,7 @@ imported:
 
     /* update the module-set-id */
     ctx->models.module_set_id++;
+    ctx->models.module_set_gen++;
 
     return EXIT_SUCCESS;
 }
@@ -1443,6 +1465,7 @@ checkdependency:
 
     /* update the module-set-id */
     ctx->models.module_set_id++;
+    ctx->models.module_set_gen++;
 
     return EXIT_SUCCESS;
 }
@@ -1560,6 +1583,7 @@ imported:
     }
     ctx->models.used = o + 1;
     ctx->models.module_set_id++;
+    ctx->models.module_set_gen++;
 
     /* maintain backlinks (start with internal ietf-yang-library which have leafs as possible targets of leafrefs */
     ctx_modules_undo_backlinks(ctx, mods);
@@ -1595,6 +1619,7 @@ ly_ctx_clean(struct ly_ctx *ctx, void (*private_destructor)(const struct lys_nod
         ctx->models.list[ctx->models.used - 1] = NULL;
     }
     ctx->models.module_set_id++;
+    ctx->models.module_set_gen++;
 
     /* maintain backlinks (actually done only with ietf-yang-library since its leafs can be target of leafref) */
     ctx_modules_undo_backlinks(ctx, NULL);
@@ -1960,6 +1985,250 @@ error:
     return NULL;
 }
 
+/**
+ * @brief Add statistics of the compiled patterns of a type.
+ *
+ * @param[in] type Type to examine.
+ * @param[in,out] mstats Module statistics to add to.
+ */
+static void
+ly_ctx_stats_type(const struct lys_type *type, struct ly_module_stats *mstats)
+{
+    unsigned int i;
+#ifdef LY_ENABLED_CACHE
+    size_t size;
+
+    if ((type->base == LY_TYPE_STRING) && type->info.str.patterns_pcre) {
+        for (i = 0; i < type->info.str.pat_count; ++i) {
+            if (!type->info.str.patterns_pcre[i * 2]) {
+                continue;
+            }
+
+            ++mstats->patterns;
+            if (!pcre_fullinfo(type->info.str.patterns_pcre[i * 2], NULL, PCRE_INFO_SIZE, &size)) {
+                mstats->pattern_bytes += size;
+            }
+            if (type->info.str.patterns_pcre[i * 2 + 1] && !pcre_fullinfo(type->info.str.patterns_pcre[i * 2],
+                    type->info.str.patterns_pcre[i * 2 + 1], PCRE_INFO_STUDYSIZE, &size)) {
+                mstats->pattern_bytes += size;
+            }
+        }
+    }
+#endif
+
+    if (type->base == LY_TYPE_UNION) {
+        for (i = 0; i < type->info.uni.count; ++i) {
+            ly_ctx_stats_type(&type->info.uni.types[i], mstats);
+        }
+    }
+}
+
+/**
+ * @brief Add statistics of typedefs.
+ *
+ * @param[in] tpdf Array of typedefs.
+ * @param[in] tpdf_size Number of typedefs in \p tpdf.
+ * @param[in,out] mstats Module statistics to add to.
+ */
+static void
+ly_ctx_stats_tpdf(const struct lys_tpdf *tpdf, uint16_t tpdf_size, struct ly_module_stats *mstats)
+{
+    uint16_t i;
+
+    for (i = 0; i < tpdf_size; ++i) {
+        ly_ctx_stats_type(&tpdf[i].type, mstats);
+    }
+}
+
+/**
+ * @brief Add statistics of schema nodes with all their descendants.
+ *
+ * @param[in,out] stats Context statistics with the statistics of all the modules.
+ * @param[in,out] mstats Statistics of the module of \p siblings.
+ * @param[in] siblings First schema node to examine, with all its following siblings.
+ */
+static void
+ly_ctx_stats_subtree(struct ly_ctx_stats *stats, struct ly_module_stats *mstats, const struct lys_node *siblings)
+{
+    const struct lys_node *node;
+    const struct lys_module *mod;
+    struct ly_module_stats *nstats;
+    uint32_t i;
+
+    LY_TREE_FOR(siblings, node) {
+        nstats = mstats;
+        mod = lys_node_module(node);
+        if (mod != mstats->module) {
+            /* augment from another module */
+            for (i = 0; i < stats->module_count; ++i) {
+                if (stats->modules[i].module == mod) {
+                    nstats = &stats->modules[i];
+                    break;
+                }
+            }
+        }
+
+        ++nstats->nodes;
+        switch (node->nodetype) {
+        case LYS_CONTAINER:
+            nstats->bytes += sizeof(struct lys_node_container);
+            ly_ctx_stats_tpdf(((struct lys_node_container *)node)->tpdf, ((struct lys_node_container *)node)->tpdf_size,
+                              nstats);
+            break;
+        case LYS_CHOICE:
+            nstats->bytes += sizeof(struct lys_node_choice);
+            break;
+        case LYS_LEAF:
+            nstats->bytes += sizeof(struct lys_node_leaf);
+            ly_ctx_stats_type(&((struct lys_node_leaf *)node)->type, nstats);
+            break;
+        case LYS_LEAFLIST:
+            nstats->bytes += sizeof(struct lys_node_leaflist);
+            ly_ctx_stats_type(&((struct lys_node_leaflist *)node)->type, nstats);
+            break;
+        case LYS_LIST:
+            nstats->bytes += sizeof(struct lys_node_list);
+            ly_ctx_stats_tpdf(((struct lys_node_list *)node)->tpdf, ((struct lys_node_list *)node)->tpdf_size, nstats);
+            break;
+        case LYS_ANYXML:
+        case LYS_ANYDATA:
+            nstats->bytes += sizeof(struct lys_node_anydata);
+            break;
+        case LYS_USES:
+            nstats->bytes += sizeof(struct lys_node_uses);
+            break;
+        case LYS_GROUPING:
+            nstats->bytes += sizeof(struct lys_node_grp);
+            ly_ctx_stats_tpdf(((struct lys_node_grp *)node)->tpdf, ((struct lys_node_grp *)node)->tpdf_size, nstats);
+            break;
+        case LYS_CASE:
+            nstats->bytes += sizeof(struct lys_node_case);
+            break;
+        case LYS_INPUT:
+        case LYS_OUTPUT:
+            nstats->bytes += sizeof(struct lys_node_inout);
+            ly_ctx_stats_tpdf(((struct lys_node_inout *)node)->tpdf, ((struct lys_node_inout *)node)->tpdf_size, nstats);
+            break;
+        case LYS_NOTIF:
+            nstats->bytes += sizeof(struct lys_node_notif);
+            ly_ctx_stats_tpdf(((struct lys_node_notif *)node)->tpdf, ((struct lys_node_notif *)node)->tpdf_size, nstats);
+            break;
+        case LYS_RPC:
+        case LYS_ACTION:
+            nstats->bytes += sizeof(struct lys_node_rpc_action);
+            ly_ctx_stats_tpdf(((struct lys_node_rpc_action *)node)->tpdf,
+                              ((struct lys_node_rpc_action *)node)->tpdf_size, nstats);
+            break;
+        default:
+            nstats->bytes += sizeof *node;
+            break;
+        }
+
+        if (!(node->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA))) {
+            ly_ctx_stats_subtree(stats, nstats, node->child);
+        }
+    }
+}
+
+/**
+ * @brief Add statistics of the augments of a (sub)module.
+ *
+ * @param[in,out] stats Context statistics with the statistics of all the modules.
+ * @param[in,out] mstats Statistics of the module.
+ * @param[in] augment Array of augments.
+ * @param[in] augment_size Number of augments in \p augment.
+ */
+static void
+ly_ctx_stats_augment(struct ly_ctx_stats *stats, struct ly_module_stats *mstats, const struct lys_node_augment *augment,
+                     uint8_t augment_size)
+{
+    uint8_t i;
+
+    for (i = 0; i < augment_size; ++i) {
+        ++mstats->nodes;
+        mstats->bytes += sizeof *augment;
+        if (!augment[i].target) {
+            /* otherwise the nodes are counted as the children of the target */
+            ly_ctx_stats_subtree(stats, mstats, augment[i].child);
+        }
+    }
+}
+
+API struct ly_ctx_stats *
+ly_ctx_stats(struct ly_ctx *ctx)
+{
+    FUN_IN;
+
+    struct ly_ctx_stats *stats;
+    struct ly_module_stats *mstats;
+    struct hash_table *ht;
+    struct dict_rec *rec;
+    const struct lys_module *mod;
+    const struct lys_submodule *submod;
+    uint32_t i, j, r;
+    uint8_t k;
+
+    if (!ctx) {
+        LOGARG;
+        return NULL;
+    }
+
+    /* the module statistics are allocated right after the structure */
+    stats = calloc(1, sizeof *stats + ctx->models.used * sizeof *stats->modules);
+    LY_CHECK_ERR_RETURN(!stats, LOGMEM(ctx), NULL);
+    stats->modules = (struct ly_module_stats *)(stats + 1);
+
+    /* dictionary */
+    pthread_mutex_lock(&ctx->dict.lock);
+    ht = ctx->dict.hash_tab;
+    for (i = 0; i < ht->size; ++i) {
+        if (!LYHT_REC_FILLED(ht, i)) {
+            continue;
+        }
+        rec = (struct dict_rec *)&lyht_get_rec(ht->recs, ht->rec_size, i)->val;
+
+        ++stats->dict_strings;
+        stats->dict_refs += rec->refcount;
+        stats->dict_bytes += strlen(rec->value) + 1;
+
+        /* bucket of refcounts 1, 2, 3-4, 5-8, ... */
+        for (k = 0, r = rec->refcount - 1; r && (k < LY_STATS_REFCOUNT_BUCKETS - 1); r >>= 1, ++k);
+        ++stats->dict_refcounts[k];
+    }
+    lyht_stats(ht, &stats->dict_ht);
+    stats->dict_pinned = ctx->dict.pinned ? ctx->dict.pinned->used : 0;
+    pthread_mutex_unlock(&ctx->dict.lock);
+
+    /* schemas */
+    stats->module_count = ctx->models.used;
+    for (i = 0; i < stats->module_count; ++i) {
+        stats->modules[i].module = ctx->models.list[i];
+    }
+    for (i = 0; i < stats->module_count; ++i) {
+        mod = stats->modules[i].module;
+        mstats = &stats->modules[i];
+
+        ly_ctx_stats_subtree(stats, mstats, mod->data);
+        ly_ctx_stats_augment(stats, mstats, mod->augment, mod->augment_size);
+        ly_ctx_stats_tpdf(mod->tpdf, mod->tpdf_size, mstats);
+        for (j = 0; j < mod->inc_size; ++j) {
+            submod = mod->inc[j].submodule;
+            if (submod) {
+                ly_ctx_stats_augment(stats, mstats, submod->augment, submod->augment_size);
+                ly_ctx_stats_tpdf(submod->tpdf, submod->tpdf_size, mstats);
+            }
+        }
+    }
+    for (i = 0; i < stats->module_count; ++i) {
+        stats->nodes += stats->modules[i].nodes;
+        stats->bytes += stats->modules[i].bytes;
+        stats->patterns += stats->modules[i].patterns;
+        stats->pattern_bytes += stats->modules[i].pattern_bytes;
+    }
+
+    return stats;
+}
+
 API const struct lys_node *
 ly_ctx_get_node(const struct ly_ctx *ctx, const struct lys_node *start, const char *nodeid, int output)
 {
@@ -1998,3 +2267,247 @@ ly_ctx_find_path(struct ly_ctx *ctx, const char *path)
     resolve_schema_nodeid(path, NULL, ctx->models.list[0], &resultset, 1, 1);
     return resultset;
 }
+
+static int
+ly_ctx_ident_rec_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct ly_ident_rec *rec1 = val1_p, *rec2 = val2_p;
+
+    if (rec1->ident) {
+        return rec1->ident == rec2->ident;
+    }
+
+    /* searching by name */
+    return (rec1->module == rec2->module) && (rec1->name_len == rec2->name_len)
+            && !strncmp(rec1->name, rec2->name, rec1->name_len);
+}
+
+static uint32_t
+ly_ctx_ident_rec_hash(const struct lys_module *module, const char *name, uint32_t name_len)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&module, sizeof module);
+    hash = dict_hash_multi(hash, name, name_len);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+static struct ly_ident_rec *
+ly_ctx_ident_rec_get(struct ly_ident_index *index, const struct lys_ident *ident)
+{
+    struct ly_ident_rec rec, *match;
+    const struct lys_module *module;
+
+    module = lys_main_module(ident->module);
+    memset(&rec, 0, sizeof rec);
+    rec.ident = (struct lys_ident *)ident;
+    if (lyht_find(index->ht, &rec, ly_ctx_ident_rec_hash(module, ident->name, strlen(ident->name)), (void **)&match)) {
+        return NULL;
+    }
+    return match;
+}
+
+/**
+ * @brief Fill the row of an identity with all its (transitive) bases.
+ */
+static void
+ly_ctx_ident_index_fill(struct ly_ident_index *index, struct ly_ident_rec *rec, uint8_t *done)
+{
+    struct ly_ident_rec *base;
+    uint32_t *row, *base_row, i, j;
+
+    if (done[rec->idx]) {
+        return;
+    }
+    row = &index->bases[rec->idx * index->row_size];
+
+    for (i = 0; i < rec->ident->base_size; ++i) {
+        base = ly_ctx_ident_rec_get(index, rec->ident->base[i]);
+        if (!base) {
+            /* cannot happen, bases are in the imported modules */
+            continue;
+        }
+        ly_ctx_ident_index_fill(index, base, done);
+
+        row[base->base_idx / 32] |= (uint32_t)1 << (base->base_idx % 32);
+        base_row = &index->bases[base->idx * index->row_size];
+        for (j = 0; j < index->row_size; ++j) {
+            row[j] |= base_row[j];
+        }
+    }
+
+    done[rec->idx] = 1;
+}
+
+static int
+ly_ctx_ident_index_add(struct ly_ident_index *index, struct lys_module *main_module, struct lys_ident *idents,
+                       uint32_t ident_size)
+{
+    struct ly_ident_rec rec;
+    uint32_t i;
+
+    for (i = 0; i < ident_size; ++i) {
+        rec.ident = &idents[i];
+        rec.module = main_module;
+        rec.name = idents[i].name;
+        rec.name_len = strlen(idents[i].name);
+        rec.idx = index->count++;
+        rec.base_idx = UINT32_MAX;
+        if (lyht_insert(index->ht, &rec, ly_ctx_ident_rec_hash(main_module, rec.name, rec.name_len), NULL)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Build the identity index for the current module set. Index must be locked.
+ */
+static int
+ly_ctx_ident_index_build(struct ly_ctx *ctx)
+{
+    struct ly_ident_index *index = &ctx->ident_index;
+    struct lys_module *mod;
+    struct ly_ident_rec *rec, *base;
+    uint8_t *done = NULL;
+    uint32_t i;
+    int j;
+
+    ly_ctx_ident_index_clean(ctx);
+
+    index->ht = lyht_new(256, sizeof(struct ly_ident_rec), ly_ctx_ident_rec_equal, NULL, 1);
+    LY_CHECK_ERR_GOTO(!index->ht, LOGMEM(ctx), error);
+
+    for (j = 0; j < ctx->models.used; ++j) {
+        mod = ctx->models.list[j];
+        if (ly_ctx_ident_index_add(index, mod, mod->ident, mod->ident_size)) {
+            goto error;
+        }
+        for (i = 0; i < mod->inc_size; ++i) {
+            if (ly_ctx_ident_index_add(index, mod, mod->inc[i].submodule->ident, mod->inc[i].submodule->ident_size)) {
+                goto error;
+            }
+        }
+    }
+
+    /* number the identities used as bases */
+    for (i = 0; i < index->ht->size; ++i) {
+        if (LYHT_REC_FILLED(index->ht, i)) {
+            rec = (struct ly_ident_rec *)lyht_get_rec(index->ht->recs, index->ht->rec_size, i)->val;
+            for (j = 0; j < rec->ident->base_size; ++j) {
+                base = ly_ctx_ident_rec_get(index, rec->ident->base[j]);
+                if (base && (base->base_idx == UINT32_MAX)) {
+                    base->base_idx = index->base_count++;
+                }
+            }
+        }
+    }
+
+    index->row_size = (index->base_count + 31) / 32;
+    if (index->count && index->row_size) {
+        index->bases = calloc(index->count * index->row_size, sizeof *index->bases);
+        done = calloc(index->count, sizeof *done);
+        LY_CHECK_ERR_GOTO(!index->bases || !done, LOGMEM(ctx), error);
+
+        for (i = 0; i < index->ht->size; ++i) {
+            if (LYHT_REC_FILLED(index->ht, i)) {
+                rec = (struct ly_ident_rec *)lyht_get_rec(index->ht->recs, index->ht->rec_size, i)->val;
+                ly_ctx_ident_index_fill(index, rec, done);
+            }
+        }
+        free(done);
+    }
+
+    /* publish the index for the readers not holding the lock */
+    __atomic_store_n(&index->module_set_gen, ctx->models.module_set_gen, __ATOMIC_RELEASE);
+    return 0;
+
+error:
+    free(done);
+    ly_ctx_ident_index_clean(ctx);
+    return -1;
+}
+
+/**
+ * @brief Make sure the identity index is built for the current module set.
+ *
+ * The module set cannot change while the context is being used by several threads, so once built,
+ * the index is only read and the lock is taken only by the threads (re)building it.
+ */
+static int
+ly_ctx_ident_index_get(struct ly_ctx *ctx)
+{
+    struct ly_ident_index *index = &ctx->ident_index;
+    int ret = 0;
+
+    if (__atomic_load_n(&index->module_set_gen, __ATOMIC_ACQUIRE) == ctx->models.module_set_gen) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&index->lock);
+    if (index->module_set_gen != ctx->models.module_set_gen) {
+        ret = ly_ctx_ident_index_build(ctx);
+    }
+    pthread_mutex_unlock(&index->lock);
+
+    return ret;
+}
+
+int
+ly_ctx_ident_derived(struct ly_ctx *ctx, const struct lys_ident *der, const struct lys_ident *base)
+{
+    struct ly_ident_index *index = &ctx->ident_index;
+    struct ly_ident_rec *der_rec, *base_rec;
+
+    if (ly_ctx_ident_index_get(ctx)) {
+        return -1;
+    }
+
+    der_rec = ly_ctx_ident_rec_get(index, der);
+    base_rec = ly_ctx_ident_rec_get(index, base);
+    if (!der_rec || !base_rec) {
+        return -1;
+    }
+
+    if (base_rec->base_idx == UINT32_MAX) {
+        /* nothing is derived from base */
+        return 0;
+    }
+    return (index->bases[der_rec->idx * index->row_size + base_rec->base_idx / 32] >> (base_rec->base_idx % 32)) & 1;
+}
+
+struct lys_ident *
+ly_ctx_ident_find(struct ly_ctx *ctx, const struct lys_module *module, const char *name, uint32_t name_len)
+{
+    struct ly_ident_index *index = &ctx->ident_index;
+    struct ly_ident_rec rec, *match;
+
+    if (ly_ctx_ident_index_get(ctx)) {
+        return NULL;
+    }
+
+    memset(&rec, 0, sizeof rec);
+    rec.module = module;
+    rec.name = name;
+    rec.name_len = name_len;
+    if (lyht_find(index->ht, &rec, ly_ctx_ident_rec_hash(module, name, name_len), (void **)&match)) {
+        return NULL;
+    }
+    return match->ident;
+}
+
+void
+ly_ctx_ident_index_clean(struct ly_ctx *ctx)
+{
+    struct ly_ident_index *index = &ctx->ident_index;
+
+    lyht_free(index->ht);
+    index->ht = NULL;
+    free(index->bases);
+    index->bases = NULL;
+    index->count = 0;
+    index->base_count = 0;
+    index->row_size = 0;
+    index->module_set_gen = 0;
+}
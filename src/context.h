@@ -34,9 +34,59 @@ struct ly_modules_list {
     uint8_t parsing_sub_modules_count;
     uint8_t parsed_submodules_count;
     uint16_t module_set_id;
+    uint64_t module_set_gen; /* changed with module_set_id, but never wraps */
     int flags; /* see @ref contextoptions. */
 };
 
+/* maximum number of compiled patterns kept in the context */
+#define LY_REGEX_CACHE_SIZE 64
+
+/* compiled pattern, freed when evicted from the cache and no longer used */
+struct ly_regex {
+    char *pattern;          /* original (XSD) pattern */
+    uint32_t hash;          /* hash of pattern */
+    void *cmp;              /* compiled pattern (pcre *) */
+    void *std;              /* studied pattern (pcre_extra *) */
+    uint32_t refcount;      /* number of current users */
+    uint8_t used;           /* recently used flag for the eviction */
+    uint8_t evicted;        /* removed from the cache, free with the last user */
+};
+
+/* context cache of patterns compiled for XPath re-match() and ad-hoc value checks */
+struct ly_regex_cache {
+    struct ly_regex *items[LY_REGEX_CACHE_SIZE];
+    uint16_t count;         /* number of items */
+    uint16_t hand;          /* next item considered for eviction */
+    pthread_mutex_t lock;
+};
+
+/* transitive closure of the identity derivation, valid for one module set */
+struct ly_ident_index {
+    uint64_t module_set_gen;    /* module set generation the index was built for, 0 if not built */
+    uint32_t count;             /* number of indexed identities */
+    uint32_t base_count;        /* number of indexed identities used as a base */
+    uint32_t row_size;          /* number of words of a row */
+    struct hash_table *ht;      /* (struct ly_ident_rec) records of all the identities */
+    uint32_t *bases;            /* bitset rows, bit of a base identity (base_idx) is set in the row (idx)
+                                 * of all the identities derived from it */
+    pthread_mutex_t lock;
+};
+
+struct ly_ident_rec {
+    struct lys_ident *ident;
+    const struct lys_module *module;    /* main module of the identity */
+    const char *name;                   /* identity name, not necessarily terminated when searching */
+    uint32_t name_len;
+    uint32_t idx;                       /* row in ly_ident_index.bases */
+    uint32_t base_idx;                  /* bit in the rows, UINT32_MAX if not a base of any identity */
+};
+
+/* type restriction array (restrictions, enums or bits) shared by several types, see lys_type_dup() */
+struct ly_type_share {
+    const void *info;           /* shared array */
+    uint32_t refcount;          /* number of types using the array */
+};
+
 struct ly_ctx {
     struct dict_table dict;
     struct ly_modules_list models;
@@ -48,7 +98,41 @@ struct ly_ctx {
     void *(*priv_dup_clb)(const void *priv);
 #endif
     pthread_key_t errlist_key;
+    struct ly_regex_cache regex;
+    struct ly_ident_index ident_index;
+    struct hash_table *type_shares;     /* (struct ly_type_share) records of the shared type restrictions */
     uint8_t internal_module_count;
 };
 
+/**
+ * @brief Check whether an identity is derived from another one using the context identity index.
+ * The index is (re)built if the module set changed.
+ *
+ * @param[in] ctx Context with the index.
+ * @param[in] der Derived identity.
+ * @param[in] base Base identity.
+ * @return 1 if \p der is derived from \p base (not the identity itself), 0 if not,
+ * -1 if any of the identities is not indexed (module still being parsed).
+ */
+int ly_ctx_ident_derived(struct ly_ctx *ctx, const struct lys_ident *der, const struct lys_ident *base);
+
+/**
+ * @brief Find an identity in the context identity index.
+ *
+ * @param[in] ctx Context with the index.
+ * @param[in] module Main module of the identity.
+ * @param[in] name Identity name.
+ * @param[in] name_len Length of \p name.
+ * @return Found identity, NULL if not found or not indexed.
+ */
+struct lys_ident *ly_ctx_ident_find(struct ly_ctx *ctx, const struct lys_module *module, const char *name,
+                                    uint32_t name_len);
+
+/**
+ * @brief Free the context identity index.
+ *
+ * @param[in] ctx Context with the index.
+ */
+void ly_ctx_ident_index_clean(struct ly_ctx *ctx);
+
 #endif /* LY_CONTEXT_H_ */
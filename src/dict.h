@@ -32,6 +32,11 @@ struct ly_ctx;
  *
  * Publicly visible functions and values of the libyang dictionary. They provide
  * access to the strings stored in the libyang context.
+ *
+ * With #LY_CTX_PIN_SCHEMA_STRINGS, the names of the schema nodes and the names, prefixes and namespaces
+ * of the modules are pinned in the dictionary once a module is added into the context. The pinned strings
+ * are kept until the context is destroyed (even if their module is removed) and they are inserted and
+ * removed without locking the dictionary and without maintaining their reference counter.
  */
 
 /**
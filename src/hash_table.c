@@ -17,11 +17,16 @@
 #include <stdlib.h>
 #include <pthread.h>
 #include <assert.h>
+#ifdef __SSE2__
+#   include <emmintrin.h>
+#endif
 
 #include "common.h"
 #include "context.h"
 #include "hash_table.h"
 
+static int lydict_resize_val_eq(void *val1_p, void *val2_p, int mod, void *cb_data);
+
 static int
 lydict_val_eq(void *val1_p, void *val2_p, int UNUSED(mod), void *cb_data)
 {
@@ -62,18 +67,38 @@ void
 lydict_clean(struct dict_table *dict)
 {
     unsigned int i;
-    struct dict_rec *dict_rec  = NULL;
+    size_t len;
+    struct dict_rec *dict_rec  = NULL, rec_p;
     struct ht_rec *rec = NULL;
+    struct dict_pin *pin;
 
     if (!dict) {
         LOGARG;
         return;
     }
 
+    /* pinned strings are not removed by their users, free them here (all are in the current table) */
+    for (i = 0; dict->pinned && (i < dict->pinned->size); ++i) {
+        if (!dict->pinned->recs[i].value) {
+            continue;
+        }
+        rec_p.value = (char *)dict->pinned->recs[i].value;
+        len = strlen(rec_p.value);
+        lyht_set_cb_data(dict->hash_tab, (void *)&len);
+        if (!lyht_remove_with_resize_cb(dict->hash_tab, &rec_p, dict->pinned->recs[i].hash, lydict_resize_val_eq)) {
+            free(rec_p.value);
+        }
+    }
+    while (dict->pinned) {
+        pin = dict->pinned;
+        dict->pinned = pin->prev;
+        free(pin);
+    }
+
     for (i = 0; i < dict->hash_tab->size; i++) {
         /* get ith record */
-        rec = (struct ht_rec *)&dict->hash_tab->recs[i * dict->hash_tab->rec_size];
-        if (rec->hits == 1) {
+        rec = lyht_get_rec(dict->hash_tab->recs, dict->hash_tab->rec_size, i);
+        if (LYHT_REC_FILLED(dict->hash_tab, i)) {
             /*
              * this should not happen, all records inserted into
              * dictionary are supposed to be removed using lydict_remove()
@@ -94,24 +119,53 @@ lydict_clean(struct dict_table *dict)
 }
 
 /*
- * Bob Jenkin's one-at-a-time hash
- * http://www.burtleburtle.net/bob/hash/doobs.html
+ * MurmurHash3 (x86, 32-bit) by Austin Appleby, public domain
+ * https://github.com/aappleby/smhasher
  *
- * Spooky hash is faster, but it works only for little endian architectures.
+ * The dictionary strings (mostly long descriptions when parsing schemas) are hashed 4 bytes at a time.
+ * The blocks are read in the native byte order, which is fine since these hashes are never stored
+ * (unlike the data node hashes, see dict_hash_multi()).
  */
 static uint32_t
 dict_hash(const char *key, size_t len)
 {
-    uint32_t hash, i;
+    const uint32_t c1 = 0xcc9e2d51, c2 = 0x1b873593;
+    uint32_t hash = 0, k;
+    size_t i;
+
+    for (i = 0; i + 4 <= len; i += 4) {
+        memcpy(&k, key + i, 4);
+        k *= c1;
+        k = (k << 15) | (k >> 17);
+        k *= c2;
+
+        hash ^= k;
+        hash = (hash << 13) | (hash >> 19);
+        hash = hash * 5 + 0xe6546b64;
+    }
 
-    for (hash = i = 0; i < len; ++i) {
-        hash += key[i];
-        hash += (hash << 10);
-        hash ^= (hash >> 6);
+    k = 0;
+    switch (len & 3) {
+    case 3:
+        k ^= (uint32_t)(unsigned char)key[i + 2] << 16;
+        /* fallthrough */
+    case 2:
+        k ^= (uint32_t)(unsigned char)key[i + 1] << 8;
+        /* fallthrough */
+    case 1:
+        k ^= (unsigned char)key[i];
+        k *= c1;
+        k = (k << 15) | (k >> 17);
+        k *= c2;
+        hash ^= k;
     }
-    hash += (hash << 3);
-    hash ^= (hash >> 11);
-    hash += (hash << 15);
+
+    hash ^= len;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
     return hash;
 }
 
@@ -170,6 +224,104 @@ lydict_resize_val_eq(void *val1_p, void *val2_p, int mod, void *cb_data)
     return 0;
 }
 
+/**
+ * @brief Find a pinned string, safe to be called without holding the dictionary lock.
+ *
+ * @param[in] dict Dictionary to search.
+ * @param[in] value String to find, does not need to be terminated.
+ * @param[in] len Length of \p value.
+ * @param[in] hash Hash of \p value.
+ * @return Pinned string, NULL if \p value is not pinned.
+ */
+static const char *
+dict_pinned_find(struct dict_table *dict, const char *value, size_t len, uint32_t hash)
+{
+    struct dict_pin *pin;
+    const char *str;
+    uint32_t i;
+
+    pin = __atomic_load_n(&dict->pinned, __ATOMIC_ACQUIRE);
+    if (!pin) {
+        return NULL;
+    }
+
+    for (i = hash & (pin->size - 1); (str = __atomic_load_n(&pin->recs[i].value, __ATOMIC_ACQUIRE));
+            i = (i + 1) & (pin->size - 1)) {
+        if ((pin->recs[i].hash == hash) && !strncmp(str, value, len) && !str[len]) {
+            return str;
+        }
+    }
+
+    return NULL;
+}
+
+/* pin a string into the table, the dictionary lock must be held and the table must have an empty record */
+static void
+dict_pin_add(struct dict_pin *pin, const char *value, uint32_t hash)
+{
+    uint32_t i;
+
+    for (i = hash & (pin->size - 1); pin->recs[i].value; i = (i + 1) & (pin->size - 1));
+
+    pin->recs[i].hash = hash;
+    __atomic_store_n(&pin->recs[i].value, value, __ATOMIC_RELEASE);
+    ++pin->used;
+}
+
+void
+lydict_pin(struct ly_ctx *ctx, const char *value)
+{
+    struct dict_pin *pin, *new_pin;
+    struct dict_rec rec, *match = NULL;
+    size_t len;
+    uint32_t hash, i;
+
+    if (!value) {
+        return;
+    }
+
+    len = strlen(value);
+    hash = dict_hash(value, len);
+    if (dict_pinned_find(&ctx->dict, value, len, hash)) {
+        /* already pinned */
+        return;
+    }
+
+    rec.value = (char *)value;
+    rec.refcount = 0;
+
+    pthread_mutex_lock(&ctx->dict.lock);
+    lyht_set_cb_data(ctx->dict.hash_tab, (void *)&len);
+    if (lyht_find(ctx->dict.hash_tab, &rec, hash, (void **)&match) || (match->value != value)
+            || dict_pinned_find(&ctx->dict, value, len, hash)) {
+        /* not a dictionary string or pinned meanwhile */
+        goto finish;
+    }
+
+    pin = ctx->dict.pinned;
+    if (!pin || ((pin->used + 1) * 2 > pin->size)) {
+        /* keep the table at most half full, the readers may still use the previous one */
+        new_pin = calloc(1, sizeof *new_pin + (pin ? pin->size * 2 : 256) * sizeof *new_pin->recs);
+        LY_CHECK_ERR_GOTO(!new_pin, LOGMEM(ctx), finish);
+        new_pin->size = pin ? pin->size * 2 : 256;
+        new_pin->prev = pin;
+        for (i = 0; pin && (i < pin->size); ++i) {
+            if (pin->recs[i].value) {
+                dict_pin_add(new_pin, pin->recs[i].value, pin->recs[i].hash);
+            }
+        }
+        __atomic_store_n(&ctx->dict.pinned, new_pin, __ATOMIC_RELEASE);
+        pin = new_pin;
+    }
+
+    /* the pin holds its own reference so that no remove racing with the pinning can free the string */
+    ++match->refcount;
+    dict_pin_add(pin, value, hash);
+
+finish:
+    pthread_mutex_unlock(&ctx->dict.lock);
+}
+
 API void
 lydict_remove(struct ly_ctx *ctx, const char *value)
 {
@@ -187,6 +339,10 @@ lydict_remove(struct ly_ctx *ctx, const char *value)
 
     len = strlen(value);
     hash = dict_hash(value, len);
+    if (dict_pinned_find(&ctx->dict, value, len, hash)) {
+        /* pinned strings are not refcounted */
+        return;
+    }
 
     /* create record for lyht_find call */
     rec.value = (char *)value;
@@ -221,13 +377,11 @@ finish:
 }
 
 static char *
-dict_insert(struct ly_ctx *ctx, char *value, size_t len, int zerocopy)
+dict_insert(struct ly_ctx *ctx, char *value, size_t len, uint32_t hash, int zerocopy)
 {
     struct dict_rec *match = NULL, rec;
     int ret = 0;
-    uint32_t hash;
 
-    hash = dict_hash(value, len);
     /* set len as data for compare callback */
     lyht_set_cb_data(ctx->dict.hash_tab, (void *)&len);
     /* create record for lyht_insert */
@@ -237,11 +391,13 @@ dict_insert(struct ly_ctx *ctx, char *value, size_t len, int zerocopy)
     LOGDBG(LY_LDGDICT, "inserting \"%s\"", rec.value);
     ret = lyht_insert_with_resize_cb(ctx->dict.hash_tab, (void *)&rec, hash, lydict_resize_val_eq, (void **)&match);
     if (ret == 1) {
+        LY_PROF_COUNT(LY_PROF_DICT_HIT);
         match->refcount++;
         if (zerocopy) {
             free(value);
         }
     } else if (ret == 0) {
+        LY_PROF_COUNT(LY_PROF_DICT_MISS);
         if (!zerocopy) {
             /*
              * allocate string for new record
@@ -267,6 +423,7 @@ lydict_insert(struct ly_ctx *ctx, const char *value, size_t len)
     FUN_IN;
 
     const char *result;
+    uint32_t hash;
 
     if (!value) {
         return NULL;
@@ -276,8 +433,15 @@ lydict_insert(struct ly_ctx *ctx, const char *value, size_t len)
         len = strlen(value);
     }
 
+    hash = dict_hash(value, len);
+    result = dict_pinned_find(&ctx->dict, value, len, hash);
+    if (result) {
+        LY_PROF_COUNT(LY_PROF_DICT_HIT);
+        return result;
+    }
+
     pthread_mutex_lock(&ctx->dict.lock);
-    result = dict_insert(ctx, (char *)value, len, 0);
+    result = dict_insert(ctx, (char *)value, len, hash, 0);
     pthread_mutex_unlock(&ctx->dict.lock);
 
     return result;
@@ -289,13 +453,24 @@ lydict_insert_zc(struct ly_ctx *ctx, char *value)
     FUN_IN;
 
     const char *result;
+    size_t len;
+    uint32_t hash;
 
     if (!value) {
         return NULL;
     }
 
+    len = strlen(value);
+    hash = dict_hash(value, len);
+    result = dict_pinned_find(&ctx->dict, value, len, hash);
+    if (result) {
+        LY_PROF_COUNT(LY_PROF_DICT_HIT);
+        free(value);
+        return result;
+    }
+
     pthread_mutex_lock(&ctx->dict.lock);
-    result = dict_insert(ctx, value, strlen(value), 1);
+    result = dict_insert(ctx, value, len, hash, 1);
     pthread_mutex_unlock(&ctx->dict.lock);
 
     return result;
@@ -307,6 +482,96 @@ lyht_get_rec(unsigned char *recs, uint16_t rec_size, uint32_t idx)
     return (struct ht_rec *)&recs[idx * rec_size];
 }
 
+/**
+ * @brief Set control byte of a record, including its copy after the end of the control bytes.
+ *
+ * @param[in] ht Hash table.
+ * @param[in] idx Index of the record.
+ * @param[in] ctrl Control byte to set.
+ */
+static void
+lyht_set_ctrl(struct hash_table *ht, uint32_t idx, uint8_t ctrl)
+{
+    uint32_t i;
+
+    ht->ctrl[idx] = ctrl;
+
+    /* the first records have their control bytes copied after the last one so that a group never wraps */
+    for (i = idx + ht->size; i < ht->size + LYHT_GROUP_SIZE; i += ht->size) {
+        ht->ctrl[i] = ctrl;
+    }
+}
+
+/**
+ * @brief Match a group of control bytes.
+ *
+ * @param[in] ctrl First control byte of the group.
+ * @param[in] byte Control byte to look for.
+ * @return Bit mask of the matching control bytes in the group (lowest bit is the first byte).
+ */
+static uint32_t
+lyht_group_match(const uint8_t *ctrl, uint8_t byte)
+{
+#ifdef __SSE2__
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)ctrl), _mm_set1_epi8((char)byte)));
+#else
+    uint32_t i, mask = 0;
+
+    for (i = 0; i < LYHT_GROUP_SIZE; ++i) {
+        if (ctrl[i] == byte) {
+            mask |= 1 << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+/**
+ * @brief Find the next record with a specific hash in its probe sequence.
+ *
+ * @param[in] ht Hash table to search in.
+ * @param[in] hash Hash to look for.
+ * @param[in,out] idx_p Index of the first record to check, index of the found record
+ * or the empty record ending the probe sequence.
+ * @return 0 if a record with \p hash was found, 1 if an empty record was reached.
+ */
+static int
+lyht_probe(struct hash_table *ht, uint32_t hash, uint32_t *idx_p)
+{
+    uint32_t idx, i, match, empty, step, bits;
+    uint8_t tag;
+
+    tag = LYHT_HASH_TAG(hash);
+    step = (ht->size < LYHT_GROUP_SIZE) ? ht->size : LYHT_GROUP_SIZE;
+    bits = (1 << step) - 1;
+
+    /* there is always an empty record so the probing ends */
+    idx = *idx_p;
+    while (1) {
+        match = lyht_group_match(&ht->ctrl[idx], tag) & bits;
+        empty = lyht_group_match(&ht->ctrl[idx], LYHT_CTRL_EMPTY) & bits;
+        if (empty) {
+            /* only records before the first empty one are in the probe sequence */
+            match &= (empty & -empty) - 1;
+        }
+
+        /* compare the full hashes of all the records with matching control bytes */
+        for (; match; match &= match - 1) {
+            i = (idx + __builtin_ctz(match)) & (ht->size - 1);
+            if (lyht_get_rec(ht->recs, ht->rec_size, i)->hash == hash) {
+                *idx_p = i;
+                return 0;
+            }
+        }
+
+        if (empty) {
+            *idx_p = (idx + __builtin_ctz(empty)) & (ht->size - 1);
+            return 1;
+        }
+        idx = (idx + step) & (ht->size - 1);
+    }
+}
+
 struct hash_table *
 lyht_new(uint32_t size, uint16_t val_size, values_equal_cb val_equal, void *cb_data, int resize)
 {
@@ -326,15 +591,17 @@ lyht_new(uint32_t size, uint16_t val_size, values_equal_cb val_equal, void *cb_d
 
     ht->used = 0;
     ht->size = size;
-    ht->invalid = 0;
     ht->val_equal = val_equal;
     ht->cb_data = cb_data;
     ht->resize = (uint16_t)resize;
 
     ht->rec_size = (sizeof(struct ht_rec) - 1) + val_size;
     /* allocate the records correctly */
-    ht->recs = calloc(size, ht->rec_size);
+    ht->recs = malloc(size * ht->rec_size);
     LY_CHECK_ERR_RETURN(!ht->recs, free(ht); LOGMEM(NULL), NULL);
+    ht->ctrl = malloc(size + LYHT_GROUP_SIZE);
+    LY_CHECK_ERR_RETURN(!ht->ctrl, free(ht->recs); free(ht); LOGMEM(NULL), NULL);
+    memset(ht->ctrl, LYHT_CTRL_EMPTY, size + LYHT_GROUP_SIZE);
 
     return ht;
 }
@@ -373,9 +640,10 @@ lyht_dup(const struct hash_table *orig)
         return NULL;
     }
 
-    memcpy(ht->recs, orig->recs, (size_t)orig->used * (size_t)orig->rec_size);
+    memcpy(ht->recs, orig->recs, (size_t)orig->size * (size_t)orig->rec_size);
+    memcpy(ht->ctrl, orig->ctrl, orig->size + LYHT_GROUP_SIZE);
     ht->used = orig->used;
-    ht->invalid = orig->invalid;
+    ht->resize = orig->resize;
     return ht;
 }
 
@@ -384,19 +652,51 @@ lyht_free(struct hash_table *ht)
 {
     if (ht) {
         free(ht->recs);
+        free(ht->ctrl);
         free(ht);
     }
 }
 
+void
+lyht_stats(const struct hash_table *ht, struct ly_ht_stats *stats)
+{
+    uint32_t i, dist;
+
+    if (!ht) {
+        return;
+    }
+
+    ++stats->count;
+    stats->size += ht->size;
+    stats->used += ht->used;
+    stats->bytes += sizeof *ht + ht->size * ht->rec_size + ht->size + LYHT_GROUP_SIZE;
+
+    for (i = 0; i < ht->size; ++i) {
+        if (!LYHT_REC_FILLED(ht, i)) {
+            continue;
+        }
+
+        /* distance from the index given by the hash */
+        dist = (i - lyht_get_rec(ht->recs, ht->rec_size, i)->hash) & (ht->size - 1);
+        stats->probe_total += dist;
+        if (dist > stats->probe_max) {
+            stats->probe_max = dist;
+        }
+    }
+}
+
 static int
 lyht_resize(struct hash_table *ht, int enlarge)
 {
     struct ht_rec *rec;
     unsigned char *old_recs;
-    uint32_t i, old_size;
-    int ret;
+    uint8_t *old_ctrl;
+    uint32_t i, idx, start, old_size;
+
+    LY_PROF_COUNT(LY_PROF_HT_RESIZE);
 
     old_recs = ht->recs;
+    old_ctrl = ht->ctrl;
     old_size = ht->size;
 
     if (enlarge > 0) {
@@ -407,243 +707,129 @@ lyht_resize(struct hash_table *ht, int enlarge)
         ht->size >>= 1;
     }
 
-    ht->recs = calloc(ht->size, ht->rec_size);
+    ht->recs = malloc(ht->size * ht->rec_size);
     LY_CHECK_ERR_RETURN(!ht->recs, LOGMEM(NULL); ht->recs = old_recs; ht->size = old_size, -1);
-
-    /* reset used, it will increase again */
-    ht->used = 0;
-    /* reset invalid, it will increase agein */
-    ht->invalid = 0;
-
-    /* add all the old records into the new records array */
-    for (i = 0; i < old_size; ++i) {
-        rec = lyht_get_rec(old_recs, ht->rec_size, i);
-        if (rec->hits > 0) {
-            ret = lyht_insert(ht, rec->val, rec->hash, NULL);
-            assert(!ret);
-            (void)ret;
+    ht->ctrl = malloc(ht->size + LYHT_GROUP_SIZE);
+    LY_CHECK_ERR_RETURN(!ht->ctrl, LOGMEM(NULL); free(ht->recs); ht->recs = old_recs; ht->ctrl = old_ctrl;
+                        ht->size = old_size, -1);
+    memset(ht->ctrl, LYHT_CTRL_EMPTY, ht->size + LYHT_GROUP_SIZE);
+
+    /* add all the old records into the new records array, start after an empty record
+     * so that the records with equal hashes keep their order */
+    for (start = 0; old_ctrl[start] != LYHT_CTRL_EMPTY; ++start);
+    for (i = 1; i <= old_size; ++i) {
+        idx = (start + i) & (old_size - 1);
+        if (old_ctrl[idx] == LYHT_CTRL_EMPTY) {
+            continue;
         }
+        rec = lyht_get_rec(old_recs, ht->rec_size, idx);
+
+        /* values are unique, just find the first empty record */
+        for (idx = rec->hash & (ht->size - 1); ht->ctrl[idx] != LYHT_CTRL_EMPTY; idx = (idx + 1) & (ht->size - 1));
+        memcpy(lyht_get_rec(ht->recs, ht->rec_size, idx), rec, ht->rec_size);
+        lyht_set_ctrl(ht, idx, old_ctrl[(start + i) & (old_size - 1)]);
     }
 
     /* final touches */
     free(old_recs);
-    return 0;
-}
-
-/* return: 0 - hash found, returned its record,
- *         1 - hash not found, returned the record where it would be inserted */
-static int
-lyht_find_first(struct hash_table *ht, uint32_t hash, struct ht_rec **rec_p)
-{
-    struct ht_rec *rec, *inval_rec = NULL;
-    uint32_t i, idx;
-
-    if (rec_p) {
-        *rec_p = NULL;
-    }
-
-    idx = i = hash & (ht->size - 1);
-    rec = lyht_get_rec(ht->recs, ht->rec_size, idx);
-
-    /* skip through overflow and deleted records */
-    while ((rec->hits != 0) && ((rec->hits == -1) || ((rec->hash & (ht->size - 1)) != idx))) {
-        if ((rec->hits == -1) && !inval_rec) {
-            /* remember the first invalid record we found while searching for this hash */
-            inval_rec = rec;
-        }
-        i = (i + 1) % ht->size;
-        if (i == idx) {
-            /* we went through all the records (very unlikely, but possible when many records are invalid),
-             * just return not found */
-            assert(inval_rec);
-            if (rec_p) {
-                *rec_p = inval_rec;
-            }
-            return 1;
-        }
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-    }
-
-    if (rec->hits == 0) {
-        /* we could not find the value */
-        if (rec_p) {
-            /* return the first empty (or invalid) record found */
-            *rec_p = inval_rec ? inval_rec : rec;
-        }
-        return 1;
-    }
-
-    /* we have found a record with equal (shortened) hash,
-     * move it to the first invalid record so that the next search is faster */
-    if (inval_rec) {
-        memcpy(inval_rec, rec, ht->rec_size);
-        rec->hits = -1;
-        rec = inval_rec;
-    }
-    if (rec_p) {
-        *rec_p = rec;
-    }
+    free(old_ctrl);
     return 0;
 }
 
 /**
- * @brief Search for the next collision.
+ * @brief Find a record with an equal value.
  *
  * @param[in] ht Hash table to search in.
- * @param[in,out] last Last returned collision record.
- * @param[in] first First collision record (hits > 1).
- * @return 0 when hash collision found, \p last points to this next collision,
- *         1 when hash collision not found, \p last points to the record where it would be inserted.
+ * @param[in] val_p Pointer to the value to find.
+ * @param[in] hash Hash of the value.
+ * @param[in] mod Whether the operation modifies the hash table, passed to the callback.
+ * @param[out] idx_p Index of the found record or of the empty record where the value would be inserted.
+ * @return 0 if found, 1 if not found.
  */
 static int
-lyht_find_collision(struct hash_table *ht, struct ht_rec **last, struct ht_rec *first)
+lyht_find_rec(struct hash_table *ht, void *val_p, uint32_t hash, int mod, uint32_t *idx_p)
 {
-    struct ht_rec *inval_rec = NULL;
-    uint32_t i, idx;
-
-    assert(last && *last);
-
-    idx = (*last)->hash & (ht->size - 1);
-    i = (((unsigned char *)*last) - ht->recs) / ht->rec_size;
-
-    do {
-        i = (i + 1) % ht->size;
-        *last = lyht_get_rec(ht->recs, ht->rec_size, i);
-        if (*last == first) {
-            /* we went through all the records (very unlikely, but possible when many records are invalid),
-             * just return an invalid record */
-            assert(inval_rec);
-            *last = inval_rec;
-            return 1;
-        }
+    uint32_t idx;
 
-        if (((*last)->hits == -1) && !inval_rec) {
-            inval_rec = *last;
-        }
-    } while (((*last)->hits != 0) && (((*last)->hits == -1) || (((*last)->hash & (ht->size - 1)) != idx)));
-
-    if ((*last)->hits > 0) {
-        /* we found a collision, so move it to the first invalid record so the next search is faster */
-        assert((*last)->hits == 1);
-        if (inval_rec) {
-            memcpy(inval_rec, *last, ht->rec_size);
-            (*last)->hits = -1;
-            *last = inval_rec;
+    idx = hash & (ht->size - 1);
+    while (!lyht_probe(ht, hash, &idx)) {
+        if (ht->val_equal(val_p, &lyht_get_rec(ht->recs, ht->rec_size, idx)->val, mod, ht->cb_data)) {
+            *idx_p = idx;
+            return 0;
         }
-        return 0;
+        idx = (idx + 1) & (ht->size - 1);
     }
 
-    /* no next collision found, return the record where it would be inserted */
-    if (inval_rec) {
-        *last = inval_rec;
-    } /* else (*last)->hits == 0, it is already correct */
+    *idx_p = idx;
     return 1;
 }
 
 int
 lyht_find(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
 {
-    struct ht_rec *rec, *crec;
-    uint32_t i, c;
-    int r;
+    uint32_t idx;
 
-    if (lyht_find_first(ht, hash, &rec)) {
+    if (lyht_find_rec(ht, val_p, hash, 0, &idx)) {
         /* not found */
         return 1;
     }
-    if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 0, ht->cb_data)) {
-        /* even the value matches */
-        if (match_p) {
-            *match_p = rec->val;
-        }
-        return 0;
+
+    if (match_p) {
+        *match_p = lyht_get_rec(ht->recs, ht->rec_size, idx)->val;
     }
+    return 0;
+}
 
-    /* some collisions, we need to go through them, too */
-    crec = rec;
-    c = rec->hits;
-    for (i = 1; i < c; ++i) {
-        r = lyht_find_collision(ht, &rec, crec);
-        assert(!r);
-        (void)r;
+int
+lyht_find_with_val_cb(struct hash_table *ht, void *val_p, uint32_t hash, values_equal_cb val_equal, void *cb_data,
+                      void **match_p)
+{
+    uint32_t idx;
 
-        /* compare values */
-        if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 0, ht->cb_data)) {
+    idx = hash & (ht->size - 1);
+    while (!lyht_probe(ht, hash, &idx)) {
+        if (val_equal(val_p, &lyht_get_rec(ht->recs, ht->rec_size, idx)->val, 0, cb_data)) {
             if (match_p) {
-                *match_p = rec->val;
+                *match_p = lyht_get_rec(ht->recs, ht->rec_size, idx)->val;
             }
             return 0;
         }
+        idx = (idx + 1) & (ht->size - 1);
     }
 
-    /* not found even in collisions */
     return 1;
 }
 
 int
 lyht_find_next(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
 {
-    struct ht_rec *rec, *crec;
-    uint32_t i, c;
-    int r, found = 0;
+    uint32_t idx;
 
-    if (lyht_find_first(ht, hash, &rec)) {
+    /* find the previously returned value */
+    if (lyht_find_rec(ht, val_p, hash, 1, &idx)) {
         /* not found, cannot happen */
         assert(0);
+        return 1;
     }
 
-    if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
-        /* previously returned value */
-        found = 1;
-    }
-
-    if (rec->hits == 1) {
-        /* there are no more similar values */
-        assert(rec->hash == hash);
-        assert(found);
+    /* values with equal hashes are kept in the order of their insertion, return the following one */
+    idx = (idx + 1) & (ht->size - 1);
+    if (lyht_probe(ht, hash, &idx)) {
+        /* the last equal value was already returned */
         return 1;
     }
 
-    /* go through collisions and find next one after the previous one */
-    crec = rec;
-    c = rec->hits;
-    for (i = 1; i < c; ++i) {
-        r = lyht_find_collision(ht, &rec, crec);
-        assert(!r);
-        (void)r;
-
-        if (rec->hash != hash) {
-            /* a normal collision, we are not interested in those */
-            continue;
-        }
-
-        if (found) {
-            /* next value with equal hash, found our value */
-            if (match_p) {
-                *match_p = rec->val;
-            }
-            return 0;
-        }
-
-        if (!ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
-            /* already returned value, skip */
-            continue;
-        }
-
-        /* this one was returned previously, continue looking */
-        found = 1;
+    if (match_p) {
+        *match_p = lyht_get_rec(ht->recs, ht->rec_size, idx)->val;
     }
-
-    /* the last equal value was already returned */
-    assert(found);
-    return 1;
+    return 0;
 }
 
 #ifndef NDEBUG
 
 /* prints little-endian numbers, will also work on big-endian just the values will look weird */
 static char *
-lyht_dbgprint_val2str(void *val_p, int32_t hits, uint16_t rec_size)
+lyht_dbgprint_val2str(void *val_p, int filled, uint16_t rec_size)
 {
     char *val;
     int32_t i, j, val_size;
@@ -652,7 +838,7 @@ lyht_dbgprint_val2str(void *val_p, int32_t hits, uint16_t rec_size)
 
     val = malloc(val_size * 2 + 1);
     for (i = 0, j = val_size - 1; i < val_size; ++i, --j) {
-        if (hits > 0) {
+        if (filled) {
             sprintf(val + i * 2, "%02x", *(((uint8_t *)val_p) + j));
         } else {
             sprintf(val + i * 2, "  ");
@@ -686,13 +872,13 @@ lyht_dbgprint_ht(struct hash_table *ht, const char *info)
 
     for (i = 0; i < ht->size; ++i) {
         rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        val = lyht_dbgprint_val2str(&rec->val, rec->hits, ht->rec_size);
-        if (rec->hits > 0) {
-            LOGDBG(LY_LDGHASH, "[%*u] val  %s  hash  %10u %% %*u  hits  %2d",
-                   (int)i_len, i, val, rec->hash, (int)i_len, rec->hash & (ht->size - 1), rec->hits);
+        val = lyht_dbgprint_val2str(&rec->val, LYHT_REC_FILLED(ht, i), ht->rec_size);
+        if (LYHT_REC_FILLED(ht, i)) {
+            LOGDBG(LY_LDGHASH, "[%*u] val  %s  hash  %10u %% %*u  ctrl  %02x",
+                   (int)i_len, i, val, rec->hash, (int)i_len, rec->hash & (ht->size - 1), ht->ctrl[i]);
         } else {
-            LOGDBG(LY_LDGHASH, "[%*u] val  %s  hash  %10s %% %*s  hits  %2d",
-                   (int)i_len, i, val, "", (int)i_len, "", rec->hits);
+            LOGDBG(LY_LDGHASH, "[%*u] val  %s  hash  %10s %% %*s  ctrl  %02x",
+                   (int)i_len, i, val, "", (int)i_len, "", ht->ctrl[i]);
         }
         free(val);
     }
@@ -726,64 +912,37 @@ int
 lyht_insert_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash,
                            values_equal_cb resize_val_equal, void **match_p)
 {
-    struct ht_rec *rec, *crec = NULL;
-    int32_t i;
+    struct ht_rec *rec;
+    uint32_t idx;
     int r, ret;
     values_equal_cb old_val_equal;
 
     lyht_dbgprint_ht(ht, "before");
     lyht_dbgprint_value(val_p, hash, ht->rec_size, "inserting");
 
-    if (!lyht_find_first(ht, hash, &rec)) {
-        /* we found matching shortened hash */
-        if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
-            /* even the value matches */
-            if (match_p) {
-                *match_p = (void *)&rec->val;
-            }
-            return 1;
-        }
-
-        /* some collisions, we need to go through them, too */
-        crec = rec;
-        for (i = 1; i < crec->hits; ++i) {
-            r = lyht_find_collision(ht, &rec, crec);
-            assert(!r);
-
-            /* compare values */
-            if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
-                if (match_p) {
-                    *match_p = (void *)&rec->val;
-                }
-                return 1;
-            }
+    if (!lyht_find_rec(ht, val_p, hash, 1, &idx)) {
+        /* the value is already there */
+        if (match_p) {
+            *match_p = (void *)&lyht_get_rec(ht->recs, ht->rec_size, idx)->val;
         }
-
-        /* value not found, get the record where it will be inserted */
-        r = lyht_find_collision(ht, &rec, crec);
-        assert(r);
+        return 1;
     }
 
-    /* insert it into the returned record */
-    assert(rec->hits < 1);
-    if (rec->hits < 0) {
-        --ht->invalid;
+    if (ht->used + 1 == ht->size) {
+        /* there must always be an empty record left */
+        LOGINT(NULL);
+        return -1;
     }
+
+    /* insert it into the returned empty record, after all the values with the same hash */
+    rec = lyht_get_rec(ht->recs, ht->rec_size, idx);
     rec->hash = hash;
-    rec->hits = 1;
     memcpy(&rec->val, val_p, ht->rec_size - (sizeof(struct ht_rec) - 1));
+    lyht_set_ctrl(ht, idx, LYHT_HASH_TAG(hash));
     if (match_p) {
         *match_p = (void *)&rec->val;
     }
 
-    if (crec) {
-        /* there was a collision, increase hits */
-        if (crec->hits == INT32_MAX) {
-            LOGINT(NULL);
-        }
-        ++crec->hits;
-    }
-
     /* check size & enlarge if needed */
     ret = 0;
     ++ht->used;
@@ -824,62 +983,38 @@ lyht_insert(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
 int
 lyht_remove_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash, values_equal_cb resize_val_equal)
 {
-    struct ht_rec *rec, *crec;
-    int32_t i;
-    int first_matched = 0, r, ret;
+    struct ht_rec *rec;
+    uint32_t idx, i, home;
+    int r, ret;
     values_equal_cb old_val_equal;
 
     lyht_dbgprint_ht(ht, "before");
     lyht_dbgprint_value(val_p, hash, ht->rec_size, "removing");
 
-    if (lyht_find_first(ht, hash, &rec)) {
-        /* hash not found */
+    if (lyht_find_rec(ht, val_p, hash, 1, &idx)) {
+        /* value not found */
         LOGDBG(LY_LDGHASH, "remove failed");
         return 1;
     }
-    if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
-        /* even the value matches */
-        first_matched = 1;
-    }
 
-    /* we always need to go through collisions */
-    crec = rec;
-    for (i = 1; i < crec->hits; ++i) {
-        r = lyht_find_collision(ht, &rec, crec);
-        assert(!r);
-
-        /* compare values */
-        if (!first_matched && (rec->hash == hash) && ht->val_equal(val_p, &rec->val, 1, ht->cb_data)) {
-            break;
-        }
-    }
+    /* shift back all the following records that can be moved into the removed one so that
+     * no deleted records need to be kept in the probe sequences */
+    for (i = (idx + 1) & (ht->size - 1); ht->ctrl[i] != LYHT_CTRL_EMPTY; i = (i + 1) & (ht->size - 1)) {
+        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
+        home = rec->hash & (ht->size - 1);
 
-    if (i < crec->hits) {
-        /* one of collisions matched, reduce collision count, remove the record */
-        assert(!first_matched);
-        --crec->hits;
-        rec->hits = -1;
-    } else if (first_matched) {
-        /* the first record matches */
-        if (crec != rec) {
-            /* ... and there are some collisions so put the last collision in its place keeping the correct collision count */
-            rec->hits = crec->hits - 1;
-            memcpy(crec, rec, ht->rec_size);
+        /* the record can be moved only if its home is not (cyclically) in (idx, i] */
+        if ((idx < i) ? ((home <= idx) || (home > i)) : ((home <= idx) && (home > i))) {
+            memcpy(lyht_get_rec(ht->recs, ht->rec_size, idx), rec, ht->rec_size);
+            lyht_set_ctrl(ht, idx, ht->ctrl[i]);
+            idx = i;
         }
-
-        /* this matching record was removed and is not valid anymore */
-        rec->hits = -1;
-    } else {
-        /* value not found even in collisions */
-        assert(!first_matched);
-        LOGDBG(LY_LDGHASH, "remove failed");
-        return 1;
     }
+    lyht_set_ctrl(ht, idx, LYHT_CTRL_EMPTY);
 
     /* check size & shrink if needed */
     ret = 0;
     --ht->used;
-    ++ht->invalid;
     if (ht->resize == 2) {
         r = (ht->used * 100) / ht->size;
         if ((r < LYHT_SHRINK_PERCENTAGE) && (ht->size > LYHT_MIN_SIZE)) {
@@ -896,20 +1031,6 @@ lyht_remove_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash, va
         }
     }
 
-    r = ((ht->size - ht->used - ht->invalid) * 100) / ht->size;
-    if (r < LYHT_REHASH_PERCENTAGE) {
-        if (resize_val_equal) {
-            old_val_equal = lyht_set_cb(ht, resize_val_equal);
-        }
-
-        /* rehash */
-        ret = lyht_resize(ht, 0);
-
-        if (resize_val_equal) {
-            lyht_set_cb(ht, old_val_equal);
-        }
-    }
-
     lyht_dbgprint_ht(ht, "after");
     return ret;
 }
@@ -52,19 +52,26 @@ typedef int (*values_equal_cb)(void *val1_p, void *val2_p, int mod, void *cb_dat
 /** when the table is less than this much percent full, it is shrunk (half the size) */
 #define LYHT_SHRINK_PERCENTAGE 25
 
-/** when the table has less than this much percent empty records, it is rehashed to get rid of all the invalid records */
-#define LYHT_REHASH_PERCENTAGE 2
-
 /** never shrink beyond this size */
 #define LYHT_MIN_SIZE 8
 
+/** number of control bytes compared at once when probing */
+#define LYHT_GROUP_SIZE 16
+
+/** control byte of an empty record */
+#define LYHT_CTRL_EMPTY 0x80
+
+/** control byte of a filled record, the highest 7 bits of its hash */
+#define LYHT_HASH_TAG(hash) ((uint8_t)((hash) >> 25))
+
+/** whether a record with the index is filled */
+#define LYHT_REC_FILLED(ht, idx) ((ht)->ctrl[idx] != LYHT_CTRL_EMPTY)
+
 /**
  * @brief Generic hash table record.
  */
 struct ht_rec {
     uint32_t hash;        /* hash of the value */
-    int32_t hits;         /* (collision/overflow value count - 1) (a filled entry has 1 hit),
-                           * special value (-1) means a deleted record) */
     unsigned char val[1]; /* arbitrary-size value */
 } _PACKED;
 
@@ -73,12 +80,14 @@ struct ht_rec {
  *
  * Hash table with open addressing collision resolution and
  * linear probing of interval 1 (next free record is used).
- * Removal is lazy (removed records are only marked).
+ * Every record has a control byte with a part of its hash so that
+ * whole groups of records are checked at once (using SSE2, if available)
+ * and the full hash and values are compared only for the matching ones.
+ * Removal moves the following records back so there are no deleted records.
  */
 struct hash_table {
     uint32_t used;        /* number of values stored in the hash table (filled records) */
     uint32_t size;        /* always holds 2^x == size (is power of 2), actually number of records allocated */
-    uint32_t invalid;     /* number of invalid records in the hash table (deleted records) */
     values_equal_cb val_equal; /* callback for testing value equivalence */
     void *cb_data;        /* user data callback arbitrary value */
     uint16_t resize;      /* 0 - resizing is disabled, *
@@ -86,6 +95,7 @@ struct hash_table {
                            * 2 - both shrinking and enlarging is enabled */
     uint16_t rec_size;    /* real size (in bytes) of one record for accessing recs array */
     unsigned char *recs;  /* pointer to the hash table itself (array of struct ht_rec) */
+    uint8_t *ctrl;        /* control bytes of the records, the first LYHT_GROUP_SIZE are repeated after the last one */
 };
 
 struct dict_rec {
@@ -93,12 +103,32 @@ struct dict_rec {
     uint32_t refcount;
 } _PACKED;
 
+/**
+ * record of a pinned dictionary string
+ */
+struct dict_pin_rec {
+    uint32_t hash;
+    const char *value;    /* written last (atomically), NULL for an empty record */
+};
+
+/**
+ * Append-only table of the pinned dictionary strings. It is read without the dictionary lock, so records are
+ * never removed or moved, a full table is replaced by a larger copy and kept until the dictionary is cleaned.
+ */
+struct dict_pin {
+    uint32_t size;        /* always a power of 2 */
+    uint32_t used;
+    struct dict_pin *prev; /* previous (replaced) table */
+    struct dict_pin_rec recs[];
+};
+
 /**
  * dictionary to store repeating strings
  */
 struct dict_table {
     struct hash_table *hash_tab;
     pthread_mutex_t lock;
+    struct dict_pin *pinned; /* strings living as long as the dictionary, inserted and removed without refcounting */
 };
 
 /**
@@ -115,6 +145,17 @@ void lydict_init(struct dict_table *dict);
  */
 void lydict_clean(struct dict_table *dict);
 
+/**
+ * @brief Pin a dictionary string so that it lives as long as the dictionary.
+ *
+ * Inserting and removing a pinned string does not lock the dictionary nor change the string's refcount,
+ * so it is meant for the schema strings repeatedly inserted when working with data (node names, namespaces).
+ *
+ * @param[in] ctx libyang context with the dictionary.
+ * @param[in] value String from the dictionary to pin, other strings are ignored.
+ */
+void lydict_pin(struct ly_ctx *ctx, const char *value);
+
 /**
  * @brief Get a specific record from a hash table.
  *
@@ -132,7 +173,8 @@ struct ht_rec *lyht_get_rec(unsigned char *recs, uint16_t rec_size, uint32_t idx
  * @param[in] val_size Size in bytes of value (the stored hashed item).
  * @param[in] val_equal Callback for checking value equivalence.
  * @param[in] cb_data User data always passed to \p val_equal.
- * @param[in] resize Whether to resize the table on too few/too many records taken.
+ * @param[in] resize Whether to resize the table on too few/too many records taken. If not, there must always
+ * be at least one record left empty.
  * @return Empty hash table, NULL on error.
  */
 struct hash_table *lyht_new(uint32_t size, uint16_t val_size, values_equal_cb val_equal, void *cb_data, int resize);
@@ -170,6 +212,14 @@ struct hash_table *lyht_dup(const struct hash_table *orig);
  */
 void lyht_free(struct hash_table *ht);
 
+/**
+ * @brief Add statistics of a hash table.
+ *
+ * @param[in] ht Hash table to examine, NULL is ignored.
+ * @param[in,out] stats Statistics to add to.
+ */
+void lyht_stats(const struct hash_table *ht, struct ly_ht_stats *stats);
+
 /**
  * @brief Find a value in a hash table.
  *
@@ -181,6 +231,21 @@ void lyht_free(struct hash_table *ht);
  */
 int lyht_find(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p);
 
+/**
+ * @brief Find a value in the hash table using a different val equal callback, the table is not modified.
+ * Useful for finding a stored value by something else than another value of the same kind.
+ *
+ * @param[in] ht Hash table to search in.
+ * @param[in] val_p Pointer to the searched value, passed to \p val_equal as the first value.
+ * @param[in] hash Hash of the stored value.
+ * @param[in] val_equal Val equal callback to use.
+ * @param[in] cb_data User data passed to \p val_equal.
+ * @param[out] match_p Pointer to the matching value, optional.
+ * @return 0 on success, 1 on not found.
+ */
+int lyht_find_with_val_cb(struct hash_table *ht, void *val_p, uint32_t hash, values_equal_cb val_equal, void *cb_data,
+                          void **match_p);
+
 /**
  * @brief Find another equal value in the hash table.
  *
@@ -76,7 +76,8 @@ API void
 
 /* !! spends all string parameters !! */
 static int
-log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vecode, char *msg, char *path, char *apptag)
+log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vecode, char *msg, char *path,
+          const void *path_elem, char *apptag)
 {
     struct ly_err_item *eitem, *last;
 
@@ -86,7 +87,7 @@ log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vec
     if (!eitem) {
         /* if we are only to fill in path, there must have been an error stored */
         assert(msg);
-        eitem = malloc(sizeof *eitem);
+        eitem = malloc(sizeof(struct ly_err_item_int));
         if (!eitem) {
             goto mem_fail;
         }
@@ -96,7 +97,7 @@ log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vec
         pthread_setspecific(ctx->errlist_key, eitem);
     } else if (!msg) {
         /* only filling the path */
-        assert(path);
+        assert(path || path_elem);
 
         /* find last error */
         eitem = eitem->prev;
@@ -105,6 +106,7 @@ log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vec
                 /* fill the path */
                 free(eitem->path);
                 eitem->path = path;
+                ((struct ly_err_item_int *)eitem)->path_elem = path_elem;
                 return 0;
             }
             eitem = eitem->prev;
@@ -119,7 +121,7 @@ log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vec
     } else {
         /* store new message */
         last = eitem->prev;
-        eitem->prev = malloc(sizeof *eitem);
+        eitem->prev = malloc(sizeof(struct ly_err_item_int));
         if (!eitem->prev) {
             goto mem_fail;
         }
@@ -135,6 +137,7 @@ log_store(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vec
     eitem->vecode = vecode;
     eitem->msg = msg;
     eitem->path = path;
+    ((struct ly_err_item_int *)eitem)->path_elem = path_elem;
     eitem->apptag = apptag;
     return 0;
 
@@ -149,7 +152,7 @@ mem_fail:
 /* !! spends path !! */
 static void
 log_vprintf(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE vecode, char *path,
-            const char *format, va_list args)
+            const void *path_elem, const char *format, va_list args)
 {
     char *msg = NULL;
     int free_strs;
@@ -178,9 +181,9 @@ log_vprintf(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE v
     /* store the error/warning (if we need to store errors internally, it does not matter what are the user log options) */
     if ((level < LY_LLVRB) && ctx && ((ly_log_opts & LY_LOSTORE) || (log_opt == ILO_STORE))) {
         if (!format) {
-            assert(path);
+            assert(path || path_elem);
             /* postponed print of path related to the previous error, do not rewrite stored original message */
-            if (log_store(ctx, level, no, vecode, NULL, path, NULL)) {
+            if (log_store(ctx, level, no, vecode, NULL, path, path_elem, NULL)) {
                 return;
             }
             msg = "Path is related to the previous error message.";
@@ -190,12 +193,14 @@ log_vprintf(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, LY_VECODE v
                 free(path);
                 return;
             }
-            if (log_store(ctx, level, no, vecode, msg, path, NULL)) {
+            if (log_store(ctx, level, no, vecode, msg, path, path_elem, NULL)) {
                 return;
             }
         }
         free_strs = 0;
     } else {
+        /* the path can be deferred only when storing the errors */
+        assert(!path_elem);
         if (vasprintf(&msg, format, args) == -1) {
             LOGMEM(ctx);
             free(path);
@@ -228,7 +233,7 @@ ly_log(const struct ly_ctx *ctx, LY_LOG_LEVEL level, LY_ERR no, const char *form
     va_list ap;
 
     va_start(ap, format);
-    log_vprintf(ctx, level, no, 0, NULL, format, ap);
+    log_vprintf(ctx, level, no, 0, NULL, NULL, format, ap);
     va_end(ap);
 }
 
@@ -278,7 +283,7 @@ ly_log_dbg(int group, const char *format, ...)
     }
 
     va_start(ap, format);
-    log_vprintf(NULL, LY_LLDBG, 0, 0, NULL, dbg_format, ap);
+    log_vprintf(NULL, LY_LLDBG, 0, 0, NULL, NULL, dbg_format, ap);
     va_end(ap);
     free(dbg_format);
 }
@@ -307,7 +312,7 @@ lyext_log(const struct ly_ctx *ctx, LY_LOG_LEVEL level, const char *plugin, cons
     }
 
     va_start(ap, format);
-    log_vprintf(ctx, level, (level == LY_LLERR ? LY_EPLUGIN : 0), 0, NULL, plugin_msg, ap);
+    log_vprintf(ctx, level, (level == LY_LLERR ? LY_EPLUGIN : 0), 0, NULL, NULL, plugin_msg, ap);
     va_end(ap);
 
     free(plugin_msg);
@@ -331,10 +336,18 @@ lyext_vlog(const struct ly_ctx *ctx, LY_VECODE vecode, const char *plugin, const
     va_list ap;
     int ret;
 
+    if (log_opt == ILO_IGNORE) {
+        /* the error would be thrown away anyway */
+        return;
+    }
+
     if (path_flag && (etype != LY_VLOG_NONE)) {
         if (etype == LY_VLOG_PREV) {
             /* use previous path */
-            const struct ly_err_item *first = ly_err_first(ctx);
+            struct ly_err_item *first = ly_err_first_int(ctx);
+            if (first) {
+                ly_err_build_path(first->prev);
+            }
             if (first && first->prev->path) {
                 path = strdup(first->prev->path);
             }
@@ -362,7 +375,7 @@ lyext_vlog(const struct ly_ctx *ctx, LY_VECODE vecode, const char *plugin, const
 
     va_start(ap, format);
     /* path is spent and should not be freed! */
-    log_vprintf(ctx, LY_LLERR, LY_EVALID, vecode, path, plugin_msg, ap);
+    log_vprintf(ctx, LY_LLERR, LY_EVALID, vecode, path, NULL, plugin_msg, ap);
     va_end(ap);
 
     free(plugin_msg);
@@ -845,30 +858,55 @@ success:
     return 0;
 }
 
+/**
+ * @brief Get the path of the last error for a following #LY_VLOG_PREV message, deferred path is kept deferred.
+ *
+ * @param[in] ctx Context with the errors.
+ * @param[out] path Copy of the path, if built.
+ * @param[out] path_elem Data node of the deferred path.
+ */
+static void
+log_prev_path(const struct ly_ctx *ctx, char **path, const void **path_elem)
+{
+    struct ly_err_item *first;
+
+    first = ly_err_first_int(ctx);
+    if (!first) {
+        return;
+    }
+
+    if (((struct ly_err_item_int *)first->prev)->path_elem) {
+        *path_elem = ((struct ly_err_item_int *)first->prev)->path_elem;
+    } else if (first->prev->path) {
+        *path = strdup(first->prev->path);
+    }
+}
+
 void
 ly_vlog(const struct ly_ctx *ctx, LY_ECODE ecode, enum LY_VLOG_ELEM elem_type, const void *elem, ...)
 {
     va_list ap;
     const char *fmt;
     char* path = NULL;
-    const struct ly_err_item *first;
+    const void *path_elem = NULL;
 
-    if ((ecode == LYE_PATH) && !path_flag) {
+    if (((ecode == LYE_PATH) && !path_flag) || (log_opt == ILO_IGNORE)) {
+        /* nobody is going to read the error, do not spend time building it */
         return;
     }
 
     if (path_flag && (elem_type != LY_VLOG_NONE)) {
         if (elem_type == LY_VLOG_PREV) {
             /* use previous path */
-            first = ly_err_first(ctx);
-            if (first && first->prev->path) {
-                path = strdup(first->prev->path);
-            }
+            log_prev_path(ctx, &path, &path_elem);
         } else {
             /* print path */
             if (!elem) {
                 /* top-level */
                 path = strdup("/");
+            } else if ((elem_type == LY_VLOG_LYD) && (log_opt == ILO_STORE) && log_defer_path) {
+                /* the error is most likely going to be discarded, build the path only if really needed */
+                path_elem = elem;
             } else {
                 ly_vlog_build_path(elem_type, elem, &path, 0, 0);
             }
@@ -880,14 +918,14 @@ ly_vlog(const struct ly_ctx *ctx, LY_ECODE ecode, enum LY_VLOG_ELEM elem_type, c
     switch (ecode) {
     case LYE_SPEC:
         fmt = va_arg(ap, char *);
-        log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, fmt, ap);
+        log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, path_elem, fmt, ap);
         break;
     case LYE_PATH:
-        assert(path);
-        log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, NULL, ap);
+        assert(path || path_elem);
+        log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, path_elem, NULL, ap);
         break;
     default:
-        log_vprintf(ctx, LY_LLERR, LY_EVALID, ecode2vecode[ecode], path, ly_errs[ecode], ap);
+        log_vprintf(ctx, LY_LLERR, LY_EVALID, ecode2vecode[ecode], path, path_elem, ly_errs[ecode], ap);
         break;
     }
     va_end(ap);
@@ -898,16 +936,17 @@ ly_vlog_str(const struct ly_ctx *ctx, enum LY_VLOG_ELEM elem_type, const char *s
 {
     va_list ap;
     char *path = NULL, *fmt, *ptr;
-    const struct ly_err_item *first;
+    const void *path_elem = NULL;
 
     assert((elem_type == LY_VLOG_NONE) || (elem_type == LY_VLOG_PREV));
 
+    if (log_opt == ILO_IGNORE) {
+        return;
+    }
+
     if (elem_type == LY_VLOG_PREV) {
         /* use previous path */
-        first = ly_err_first(ctx);
-        if (first && first->prev->path) {
-            path = strdup(first->prev->path);
-        }
+        log_prev_path(ctx, &path, &path_elem);
     }
 
     if (strchr(str, '%')) {
@@ -924,7 +963,7 @@ ly_vlog_str(const struct ly_ctx *ctx, enum LY_VLOG_ELEM elem_type, const char *s
 
     va_start(ap, str);
     /* path is spent and should not be freed! */
-    log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, fmt, ap);
+    log_vprintf(ctx, LY_LLERR, LY_EVALID, LYVE_SUCCESS, path, path_elem, fmt, ap);
     va_end(ap);
 
     free(fmt);
@@ -933,6 +972,8 @@ ly_vlog_str(const struct ly_ctx *ctx, enum LY_VLOG_ELEM elem_type, const char *s
 API void
 ly_err_print(struct ly_err_item *eitem)
 {
+    ly_err_build_path(eitem);
+
     if (ly_log_opts & LY_LOLOG) {
         if (ly_log_clb) {
             ly_log_clb(eitem->level, eitem->msg, eitem->path);
@@ -945,6 +986,35 @@ ly_err_print(struct ly_err_item *eitem)
     }
 }
 
+void
+ly_err_build_path(struct ly_err_item *eitem)
+{
+    struct ly_err_item_int *eitem_int = (struct ly_err_item_int *)eitem;
+
+    if (eitem_int->path_elem) {
+        assert(!eitem->path);
+        ly_vlog_build_path(LY_VLOG_LYD, eitem_int->path_elem, &eitem->path, 0, 0);
+        eitem_int->path_elem = NULL;
+    }
+}
+
+/**
+ * @brief Build all the deferred paths of the errors following \p last_eitem.
+ */
+static void
+err_build_paths(struct ly_ctx *ctx, struct ly_err_item *last_eitem)
+{
+    if (!last_eitem) {
+        last_eitem = pthread_getspecific(ctx->errlist_key);
+    } else {
+        last_eitem = last_eitem->next;
+    }
+
+    for (; last_eitem; last_eitem = last_eitem->next) {
+        ly_err_build_path(last_eitem);
+    }
+}
+
 static void
 err_print(struct ly_ctx *ctx, struct ly_err_item *last_eitem)
 {
@@ -1030,7 +1100,7 @@ ly_ilo_change(struct ly_ctx *ctx, enum int_log_opts new_ilo, enum int_log_opts *
     if (new_ilo == ILO_STORE) {
         /* only in this case the errors are only temporarily stored */
         assert(ctx && prev_last_eitem);
-        *prev_last_eitem = (struct ly_err_item *)ly_err_first(ctx);
+        *prev_last_eitem = ly_err_first_int(ctx);
         if (*prev_last_eitem) {
             *prev_last_eitem = (*prev_last_eitem)->prev;
         }
@@ -1054,6 +1124,11 @@ ly_ilo_restore(struct ly_ctx *ctx, enum int_log_opts prev_ilo, struct ly_err_ite
 
     assert(ctx);
 
+    if (keep_and_print || (prev_ilo == ILO_STORE)) {
+        /* the errors are kept, but the data nodes they refer to may not exist for long */
+        err_build_paths(ctx, prev_last_eitem);
+    }
+
     log_opt = prev_ilo;
     if (keep_and_print) {
         err_print(ctx, prev_last_eitem);
@@ -1061,13 +1136,79 @@ ly_ilo_restore(struct ly_ctx *ctx, enum int_log_opts prev_ilo, struct ly_err_ite
     err_clean(ctx, prev_last_eitem, keep_and_print);
 }
 
+/**
+ * @brief Take all the errors of this thread, for example before the thread exits.
+ *
+ * @param[in] ctx Context of the errors.
+ * @return First taken error item, NULL if there are none.
+ */
+struct ly_err_item *
+ly_err_detach(struct ly_ctx *ctx)
+{
+    struct ly_err_item *first;
+
+    first = pthread_getspecific(ctx->errlist_key);
+    pthread_setspecific(ctx->errlist_key, NULL);
+    return first;
+}
+
+/**
+ * @brief Append errors taken from another thread by ly_err_detach() to the errors of this thread,
+ * as if they were generated by it.
+ *
+ * @param[in] ctx Context of the errors.
+ * @param[in] eitem First error item to append, it is spent.
+ */
+void
+ly_err_attach(struct ly_ctx *ctx, struct ly_err_item *eitem)
+{
+    struct ly_err_item *first, *last, *i;
+
+    if (!eitem) {
+        return;
+    }
+
+    if ((log_opt == ILO_IGNORE) || !(ly_log_opts & LY_LOSTORE)) {
+        /* the errors would not be stored */
+        ly_err_free(eitem);
+        return;
+    }
+
+    /* update errno */
+    for (i = eitem->prev; i; i = (i == eitem) ? NULL : i->prev) {
+        if (i->level == LY_LLERR) {
+            ly_errno = i->no;
+            break;
+        }
+    }
+
+    first = pthread_getspecific(ctx->errlist_key);
+    last = eitem->prev;
+    if ((log_opt != ILO_STORE) && ((ly_log_opts & LY_LOSTORE_LAST) == LY_LOSTORE_LAST)) {
+        /* keep only the most recent error */
+        if (last != eitem) {
+            last->prev->next = NULL;
+            last->prev = last;
+            ly_err_free(eitem);
+        }
+        ly_err_free(first);
+        pthread_setspecific(ctx->errlist_key, last);
+    } else if (first) {
+        first->prev->next = eitem;
+        eitem->prev = first->prev;
+        first->prev = last;
+    } else {
+        pthread_setspecific(ctx->errlist_key, eitem);
+    }
+}
+
 void
 ly_err_last_set_apptag(const struct ly_ctx *ctx, const char *apptag)
 {
     struct ly_err_item *i;
 
     if (log_opt != ILO_IGNORE) {
-        i = ly_err_first(ctx);
+        i = ly_err_first_int(ctx);
         if (i) {
             i = i->prev;
             i->apptag = strdup(apptag);
@@ -240,6 +240,12 @@ lyp_data_check_options(struct ly_ctx *ctx, int options, const char *func)
         }
     }
 
+    if ((options & LYD_OPT_WD_LAZY) && (options & LYD_OPT_VAL_DIFF)) {
+        LOGERR(ctx, LY_EINVAL, "%s: Invalid options 0x%x (LYD_OPT_WD_LAZY cannot be used with LYD_OPT_VAL_DIFF)",
+               func, options);
+        return 1;
+    }
+
     /* "is power of 2" algorithm, with 0 exception */
     if (x && !(x && !(x & (x - 1)))) {
         LOGERR(ctx, LY_EINVAL, "%s: Invalid options 0x%x (multiple data type flags set).", func, options);
@@ -610,9 +616,6 @@ validate_pattern(struct ly_ctx *ctx, const char *val_str, struct lys_type *type,
 {
     int rc;
     unsigned int i;
-#ifndef LY_ENABLED_CACHE
-    pcre *precomp;
-#endif
 
     assert(ctx && (type->base == LY_TYPE_STRING));
 
@@ -645,11 +648,10 @@ validate_pattern(struct ly_ctx *ctx, const char *val_str, struct lys_type *type,
         rc = pcre_exec((pcre *)type->info.str.patterns_pcre[2 * i], (pcre_extra *)type->info.str.patterns_pcre[2 * i + 1],
                        val_str, strlen(val_str), 0, 0, NULL, 0);
 #else
-        if (lyp_check_pattern(ctx, &type->info.str.patterns[i].expr[1], &precomp)) {
+        rc = lyp_regex_match(ctx, &type->info.str.patterns[i].expr[1], val_str);
+        if (rc == -1) {
             return EXIT_FAILURE;
         }
-        rc = pcre_exec(precomp, NULL, val_str, strlen(val_str), 0, 0, NULL, 0);
-        free(precomp);
 #endif
         if ((rc && type->info.str.patterns[i].expr[0] == 0x06) || (!rc && type->info.str.patterns[i].expr[0] == 0x15)) {
             LOGVAL(ctx, LYE_NOCONSTR, LY_VLOG_LYD, node, val_str, &type->info.str.patterns[i].expr[1]);
@@ -962,7 +964,11 @@ lyp_precompile_pattern(struct ly_ctx *ctx, const char *pattern, pcre** pcre_cmp,
     }
 
     if (pcre_std && pcre_cmp) {
+#ifdef PCRE_STUDY_JIT_COMPILE
+        (*pcre_std) = pcre_study(*pcre_cmp, PCRE_STUDY_JIT_COMPILE, &err_msg);
+#else
         (*pcre_std) = pcre_study(*pcre_cmp, 0, &err_msg);
+#endif
         if (err_msg) {
             LOGWRN(ctx, "Studying pattern \"%s\" failed (%s).", pattern, err_msg);
         }
@@ -971,6 +977,133 @@ lyp_precompile_pattern(struct ly_ctx *ctx, const char *pattern, pcre** pcre_cmp,
     return EXIT_SUCCESS;
 }
 
+static void
+lyp_regex_free(struct ly_regex *re)
+{
+    pcre_free_study(re->std);
+    pcre_free(re->cmp);
+    free(re->pattern);
+    free(re);
+}
+
+/**
+ * @brief Find a compiled pattern in the context cache. Cache must be locked.
+ *
+ * @return Found item with incremented reference count, NULL if not cached.
+ */
+static struct ly_regex *
+lyp_regex_cache_find(struct ly_regex_cache *cache, const char *pattern, uint32_t hash)
+{
+    uint16_t i;
+
+    for (i = 0; i < cache->count; ++i) {
+        if ((cache->items[i]->hash == hash) && !strcmp(cache->items[i]->pattern, pattern)) {
+            cache->items[i]->used = 1;
+            ++cache->items[i]->refcount;
+            return cache->items[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Insert a compiled pattern into the context cache, evict a not recently used one
+ * if the cache is full. Cache must be locked.
+ */
+static void
+lyp_regex_cache_insert(struct ly_regex_cache *cache, struct ly_regex *re)
+{
+    struct ly_regex *victim;
+
+    if (cache->count < LY_REGEX_CACHE_SIZE) {
+        cache->items[cache->count++] = re;
+        return;
+    }
+
+    /* second chance for the recently used items */
+    while (cache->items[cache->hand]->used) {
+        cache->items[cache->hand]->used = 0;
+        cache->hand = (cache->hand + 1) % LY_REGEX_CACHE_SIZE;
+    }
+
+    victim = cache->items[cache->hand];
+    if (victim->refcount) {
+        /* still being matched by someone */
+        victim->evicted = 1;
+    } else {
+        lyp_regex_free(victim);
+    }
+    cache->items[cache->hand] = re;
+    cache->hand = (cache->hand + 1) % LY_REGEX_CACHE_SIZE;
+}
+
+int
+lyp_regex_match(struct ly_ctx *ctx, const char *pattern, const char *str)
+{
+    struct ly_regex_cache *cache = &ctx->regex;
+    struct ly_regex *re, *dup;
+    uint32_t hash;
+    int rc;
+
+    hash = dict_hash_multi(0, pattern, strlen(pattern));
+    hash = dict_hash_multi(hash, NULL, 0);
+
+    pthread_mutex_lock(&cache->lock);
+    re = lyp_regex_cache_find(cache, pattern, hash);
+    pthread_mutex_unlock(&cache->lock);
+
+    if (!re) {
+        /* compile it without holding the lock */
+        re = calloc(1, sizeof *re);
+        LY_CHECK_ERR_RETURN(!re, LOGMEM(ctx), -1);
+        re->pattern = strdup(pattern);
+        LY_CHECK_ERR_RETURN(!re->pattern, LOGMEM(ctx); free(re), -1);
+        if (lyp_precompile_pattern(ctx, pattern, (pcre **)&re->cmp, (pcre_extra **)&re->std)) {
+            free(re->pattern);
+            free(re);
+            return -1;
+        }
+        re->hash = hash;
+        re->refcount = 1;
+        re->used = 1;
+
+        pthread_mutex_lock(&cache->lock);
+        dup = lyp_regex_cache_find(cache, pattern, hash);
+        if (dup) {
+            /* compiled meanwhile by another thread */
+            lyp_regex_free(re);
+            re = dup;
+        } else {
+            lyp_regex_cache_insert(cache, re);
+        }
+        pthread_mutex_unlock(&cache->lock);
+    }
+
+    rc = pcre_exec(re->cmp, re->std, str, strlen(str), 0, 0, NULL, 0) ? 1 : 0;
+
+    pthread_mutex_lock(&cache->lock);
+    if (!--re->refcount && re->evicted) {
+        lyp_regex_free(re);
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    return rc;
+}
+
+void
+lyp_regex_cache_clean(struct ly_ctx *ctx)
+{
+    uint16_t i;
+
+    for (i = 0; i < ctx->regex.count; ++i) {
+        assert(!ctx->regex.items[i]->refcount);
+        lyp_regex_free(ctx->regex.items[i]);
+    }
+    ctx->regex.count = 0;
+    ctx->regex.hand = 0;
+}
+
 /**
  * @brief Change the value into its canonical form. In libyang, additionally to the RFC,
  * all identities have their module as a prefix in their canonical form.
@@ -1213,10 +1346,10 @@ ident_val_add_module_prefix(const char *value, const struct lyxml_elem *xml, str
  * store - flag for union resolution - we do not want to store the result, we are just learning the type
  * dflt - whether the value is a default value from the schema
  */
-struct lys_type *
-lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *xml,
-                struct lyd_node_leaf_list *leaf, struct lyd_attr *attr, struct lys_module *local_mod,
-                int store, int dflt)
+static struct lys_type *
+lyp_parse_value_(struct lys_type *type, const char **value_, struct lyxml_elem *xml,
+                 struct lyd_node_leaf_list *leaf, struct lyd_attr *attr, struct lys_module *local_mod,
+                 int store, int dflt)
 {
     struct lys_type *ret = NULL, *t;
     struct lys_tpdf *tpdf;
@@ -1725,7 +1858,7 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
         /* it is called not only to get the final type, but mainly to update value to canonical or JSON form
          * if needed */
-        t = lyp_parse_value(&type->info.lref.target->type, value_, xml, leaf, attr, NULL, store, dflt);
+        t = lyp_parse_value_(&type->info.lref.target->type, value_, xml, leaf, attr, NULL, store, dflt);
         value = *value_; /* refresh possibly changed value */
         if (!t) {
             /* already logged */
@@ -1957,7 +2090,7 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
         while ((t = lyp_get_next_union_type(type, t, &found))) {
             found = 0;
-            ret = lyp_parse_value(t, value_, xml, leaf, attr, NULL, store, dflt);
+            ret = lyp_parse_value_(t, value_, xml, leaf, attr, NULL, store, dflt);
             if (ret) {
                 /* we have the result */
                 break;
@@ -2025,6 +2158,21 @@ error:
     return NULL;
 }
 
+struct lys_type *
+lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *xml,
+                struct lyd_node_leaf_list *leaf, struct lyd_attr *attr, struct lys_module *local_mod,
+                int store, int dflt)
+{
+    struct lys_type *ret;
+    uint64_t prof;
+
+    LY_PROF_START(prof);
+    ret = lyp_parse_value_(type, value_, xml, leaf, attr, local_mod, store, dflt);
+    LY_PROF_STOP(LY_PROF_VALUE, prof);
+
+    return ret;
+}
+
 /* does not log, cannot fail */
 struct lys_type *
 lyp_get_next_union_type(struct lys_type *type, struct lys_type *prev_type, int *found)
@@ -3681,6 +3829,46 @@ lyp_ctx_check_module(struct lys_module *module)
     return 0;
 }
 
+static void
+lyp_ctx_pin_nodes(struct ly_ctx *ctx, struct lys_node *siblings, struct lys_node *parent)
+{
+    struct lys_node *root, *next, *node;
+
+    LY_TREE_FOR(siblings, root) {
+        if (root->parent != parent) {
+            /* augment nodes are followed by the other children of the target */
+            break;
+        }
+        LY_TREE_DFS_BEGIN(root, next, node) {
+            lydict_pin(ctx, node->name);
+            LY_TREE_DFS_END(root, next, node);
+        }
+    }
+}
+
+/* pin the module strings repeatedly inserted into the dictionary when parsing and printing data */
+static void
+lyp_ctx_pin_module(struct lys_module *module)
+{
+    struct lys_submodule *submodule;
+    int i, j;
+
+    lydict_pin(module->ctx, module->name);
+    lydict_pin(module->ctx, module->prefix);
+    lydict_pin(module->ctx, module->ns);
+
+    lyp_ctx_pin_nodes(module->ctx, module->data, NULL);
+    for (i = 0; i < module->augment_size; ++i) {
+        lyp_ctx_pin_nodes(module->ctx, module->augment[i].child, (struct lys_node *)&module->augment[i]);
+    }
+    for (i = 0; i < module->inc_size; ++i) {
+        submodule = module->inc[i].submodule;
+        for (j = 0; j < submodule->augment_size; ++j) {
+            lyp_ctx_pin_nodes(module->ctx, submodule->augment[j].child, (struct lys_node *)&submodule->augment[j]);
+        }
+    }
+}
+
 int
 lyp_ctx_add_module(struct lys_module *module)
 {
@@ -3714,6 +3902,11 @@ lyp_ctx_add_module(struct lys_module *module)
     }
     module->ctx->models.list[module->ctx->models.used++] = module;
     module->ctx->models.module_set_id++;
+    module->ctx->models.module_set_gen++;
+
+    if (module->ctx->models.flags & LY_CTX_PIN_SCHEMA_STRINGS) {
+        lyp_ctx_pin_module(module);
+    }
 
     return 0;
 }
@@ -4132,3 +4325,148 @@ lyp_reduce_ext_list(struct lys_ext_instance ***ext, uint8_t new_size, uint8_t or
     }
 }
 
+
+int
+lyp_chunk_reader_init(struct lyd_chunk_reader *reader, struct ly_ctx *ctx, LYD_FORMAT format, int options,
+                      lyd_chunk_clb clb, void *arg)
+{
+    memset(reader, 0, sizeof *reader);
+    reader->ctx = ctx;
+    reader->format = format;
+    reader->options = options | LYD_OPT_TRUSTED;
+    reader->clb = clb;
+    reader->arg = arg;
+
+    reader->unres = calloc(1, sizeof *reader->unres);
+    LY_CHECK_ERR_RETURN(!reader->unres, LOGMEM(ctx), EXIT_FAILURE);
+
+    return EXIT_SUCCESS;
+}
+
+int
+lyp_chunk_read(struct lyd_chunk_reader *reader, const char *data, size_t len, int final, size_t *used)
+{
+    switch (reader->format) {
+    case LYD_XML:
+        return xml_read_chunks(reader, data, len, final, used);
+    case LYD_JSON:
+        return json_read_chunks(reader, data, len, final, used);
+    default:
+        LOGINT(reader->ctx);
+        *used = 0;
+        return EXIT_FAILURE;
+    }
+}
+
+/**
+ * @brief Resolve the unresolved items of the read nodes. The data are trusted so only the values are resolved,
+ * and not failing on references into the data that are already passed to the callback.
+ */
+static int
+lyp_chunk_resolve(struct lyd_chunk_reader *reader)
+{
+    struct lyd_node *root = NULL;
+
+    return resolve_unres_data(reader->ctx, reader->unres, &root, LYD_OPT_TRUSTED);
+}
+
+void
+lyp_chunk_add(struct lyd_chunk_reader *reader, struct lyd_node *node, size_t len)
+{
+    if (!reader->chunk) {
+        reader->chunk = node;
+    }
+    reader->chunk_len += len;
+}
+
+int
+lyp_chunk_flush(struct lyd_chunk_reader *reader)
+{
+    struct lyd_node *chunk = reader->chunk;
+
+    if (!chunk) {
+        return EXIT_SUCCESS;
+    }
+    reader->chunk = NULL;
+    reader->chunk_len = 0;
+
+    if (lyp_chunk_resolve(reader)) {
+        if (!chunk->parent) {
+            lyd_free_withsiblings(chunk);
+        }
+        return EXIT_FAILURE;
+    }
+
+    return reader->clb(LYD_CHUNK_NODES, chunk, reader->arg) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int
+lyp_chunk_open(struct lyd_chunk_reader *reader, struct lyd_node *node)
+{
+    assert(!reader->chunk);
+
+    /* default flag is set for the parent only when closing it */
+    node->dflt = 0;
+    if (lyp_chunk_resolve(reader)) {
+        if (!node->parent) {
+            lyd_free(node);
+        }
+        return EXIT_FAILURE;
+    }
+
+    reader->parent = node;
+    return reader->clb(LYD_CHUNK_OPEN, node, reader->arg) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int
+lyp_chunk_close(struct lyd_chunk_reader *reader)
+{
+    struct lyd_node *node = reader->parent;
+
+    assert(node);
+
+    if (lyp_chunk_flush(reader)) {
+        return EXIT_FAILURE;
+    }
+
+#ifdef LY_ENABLED_CACHE
+    /* all the remaining children are read, build the hash table at once */
+    if (lyd_insert_hash_bulk(node)) {
+        return EXIT_FAILURE;
+    }
+#endif
+
+    /* if we have empty non-presence container, mark it as default */
+    if ((node->schema->nodetype == LYS_CONTAINER) && !node->child && !node->attr
+            && !((struct lys_node_container *)node->schema)->presence) {
+        node->dflt = 1;
+    }
+
+    reader->parent = node->parent;
+    return reader->clb(LYD_CHUNK_CLOSE, node, reader->arg) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+void
+lyp_chunk_reader_clean(struct lyd_chunk_reader *reader)
+{
+    struct lyxml_elem *xml;
+
+    if (reader->chunk && !reader->chunk->parent) {
+        lyd_free_withsiblings(reader->chunk);
+    }
+    reader->chunk = NULL;
+
+    if (reader->xml_parent) {
+        for (xml = reader->xml_parent; xml->parent; xml = xml->parent);
+        lyxml_free(reader->ctx, xml);
+        reader->xml_parent = NULL;
+    }
+    json_read_chunks_clean(reader);
+
+    if (reader->unres) {
+        free(reader->unres->node);
+        free(reader->unres->type);
+        free(reader->unres);
+        reader->unres = NULL;
+    }
+}
@@ -43,6 +43,17 @@ struct lys_submodule *yin_read_submodule(struct lys_module *module, const char *
  */
 struct lyd_node *xml_read_data(struct ly_ctx *ctx, const char *data, int options);
 
+/**
+ * @brief Parse data from the XML tree, lyd_parse_xml() with checked variable parameters.
+ */
+struct lyd_node *lyd_parse_xml_(struct ly_ctx *ctx, struct lyxml_elem **root, int options, const struct lyd_node *rpc_act,
+                                const struct lyd_node *data_tree, const char *yang_data_name);
+
+/**
+ * @brief Read XML data by a chunk reader, see lyp_chunk_read().
+ */
+int xml_read_chunks(struct lyd_chunk_reader *reader, const char *data, size_t len, int final, size_t *used);
+
 /**@} xmldata */
 
 /**
@@ -52,6 +63,16 @@ struct lyd_node *xml_read_data(struct ly_ctx *ctx, const char *data, int options
 struct lyd_node *lyd_parse_json(struct ly_ctx *ctx, const char *data, int options, const struct lyd_node *rpc_act,
                                 const struct lyd_node *data_tree, const char *yang_data_name);
 
+/**
+ * @brief Read JSON data by a chunk reader, see lyp_chunk_read().
+ */
+int json_read_chunks(struct lyd_chunk_reader *reader, const char *data, size_t len, int final, size_t *used);
+
+/**
+ * @brief Free the JSON objects and arrays being read by a chunk reader.
+ */
+void json_read_chunks_clean(struct lyd_chunk_reader *reader);
+
 /**@} jsondata */
 
 /**
@@ -110,6 +131,21 @@ int lyp_check_length_range(struct ly_ctx *ctx, const char *expr, struct lys_type
 int lyp_check_pattern(struct ly_ctx *ctx, const char *pattern, pcre **pcre_precomp);
 int lyp_precompile_pattern(struct ly_ctx *ctx, const char *pattern, pcre** pcre_cmp, pcre_extra **pcre_std);
 
+/**
+ * @brief Match a string against a pattern compiled and cached in the context.
+ *
+ * @param[in] ctx Context with the pattern cache.
+ * @param[in] pattern Pattern (XSD regex) to use.
+ * @param[in] str String to match.
+ * @return 0 if matching, 1 if not matching, -1 on error (invalid pattern).
+ */
+int lyp_regex_match(struct ly_ctx *ctx, const char *pattern, const char *str);
+
+/**
+ * @brief Free all the patterns cached in the context.
+ */
+void lyp_regex_cache_clean(struct ly_ctx *ctx);
+
 int fill_yin_type(struct lys_module *module, struct lys_node *parent, struct lyxml_elem *yin, struct lys_type *type,
                   int tpdftype, struct unres_schema *unres);
 
@@ -140,6 +176,76 @@ int lyp_is_rpc_action(struct lys_node *node);
  */
 int lyp_data_check_options(struct ly_ctx *ctx, int options, const char *func);
 
+/**
+ * @brief Initialize a chunk reader of XML or JSON data trees. The data are parsed as trusted, so only the values
+ * are checked, and no default nodes are added.
+ *
+ * @param[in] reader Chunk reader to initialize.
+ * @param[in] ctx libyang context.
+ * @param[in] format Data format, #LYD_XML or #LYD_JSON.
+ * @param[in] options Parser options of a data tree.
+ * @param[in] clb Callback called for the read data.
+ * @param[in] arg Argument for \p clb.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lyp_chunk_reader_init(struct lyd_chunk_reader *reader, struct ly_ctx *ctx, LYD_FORMAT format, int options,
+                          lyd_chunk_clb clb, void *arg);
+
+/**
+ * @brief Read the next data. Sibling subtrees are read together in chunks of about #LYD_CHUNK_SIZE, larger
+ * containers and list instances are opened and their children read in chunks, so only the opened nodes and
+ * the current chunk are held in memory at once.
+ *
+ * @param[in] reader Chunk reader.
+ * @param[in] data Data terminated by a zero byte.
+ * @param[in] len Length of \p data.
+ * @param[in] final Whether \p data are the end of the input, otherwise an incomplete subtree is left unread.
+ * @param[out] used Length of the read \p data, the rest must be passed again with more data.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lyp_chunk_read(struct lyd_chunk_reader *reader, const char *data, size_t len, int final, size_t *used);
+
+/**
+ * @brief Add the next node into the chunk being read, if it is the first one.
+ *
+ * @param[in] reader Chunk reader.
+ * @param[in] node Node linked as the last sibling of the chunk.
+ * @param[in] len Text length of the node.
+ */
+void lyp_chunk_add(struct lyd_chunk_reader *reader, struct lyd_node *node, size_t len);
+
+/**
+ * @brief Pass the chunk being read to the callback.
+ *
+ * @param[in] reader Chunk reader.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lyp_chunk_flush(struct lyd_chunk_reader *reader);
+
+/**
+ * @brief Open a container or a list instance, its children are read next. The chunk being read must be flushed.
+ *
+ * @param[in] reader Chunk reader.
+ * @param[in] node Created node without children, top-level or the last child of the opened node.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lyp_chunk_open(struct lyd_chunk_reader *reader, struct lyd_node *node);
+
+/**
+ * @brief Close the innermost opened node, all its children were read.
+ *
+ * @param[in] reader Chunk reader.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lyp_chunk_close(struct lyd_chunk_reader *reader);
+
+/**
+ * @brief Free all the data held by a chunk reader.
+ *
+ * @param[in] reader Chunk reader.
+ */
+void lyp_chunk_reader_clean(struct lyd_chunk_reader *reader);
+
 int lyp_check_identifier(struct ly_ctx *ctx, const char *id, enum LY_IDENT type, struct lys_module *module, struct lys_node *parent);
 int lyp_check_date(struct ly_ctx *ctx, const char *date);
 int lyp_check_mandatory_augment(struct lys_node_augment *node, const struct lys_node *target);
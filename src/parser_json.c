@@ -551,9 +551,8 @@ inval:
     }
 
 #ifdef LY_ENABLED_CACHE
-    /* calculate the hash and insert it into parent */
+    /* calculate the hash, it is inserted into the parent hash table once all the siblings are parsed */
     lyd_hash((struct lyd_node *)leaf);
-    lyd_insert_hash((struct lyd_node *)leaf);
 #endif
 
     if (leaf->schema->nodetype == LYS_LEAFLIST) {
@@ -886,102 +885,18 @@ json_skip_unknown(struct ly_ctx *ctx, struct lyd_node *parent, const char *data,
     return 0;
 }
 
-static unsigned int
-json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *schema_parent, struct lyd_node **parent,
-                struct lyd_node *first_sibling, struct lyd_node *prev, struct attr_cont **attrs, int options,
-                struct unres_data *unres, struct lyd_node **act_notif, const char *yang_data_name)
+/* does not log */
+static struct lys_node *
+json_get_schema(struct ly_ctx *ctx, const char *prefix, const char *name, const struct lys_node *schema_parent,
+                struct lyd_node *parent, int options, const char *yang_data_name)
 {
-    unsigned int len = 0;
-    unsigned int r;
-    unsigned int flag_leaflist = 0;
-    int i;
-    uint8_t pos;
-    char *name, *prefix = NULL, *str = NULL;
     const struct lys_module *module = NULL;
     struct lys_node *schema = NULL;
     const struct lys_node *sparent = NULL;
-    struct lyd_node *result = NULL, *new, *list, *diter = NULL;
-    struct lyd_attr *attr;
-    struct attr_cont *attrs_aux;
-
-    /* each YANG data node representation starts with string (node identifier) */
-    if (data[len] != '"') {
-        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, (*parent),
-               "JSON data (missing quotation-mark at the beginning of string)");
-        return 0;
-    }
-    len++;
-
-    str = lyjson_parse_text(ctx, &data[len], &r);
-    if (!str) {
-        goto error;
-    }
-
-    if (!r) {
-        goto error;
-    } else if (data[len + r] != '"') {
-        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, (*parent),
-               "JSON data (missing quotation-mark at the end of string)");
-        goto error;
-    }
-    if ((name = strchr(str, ':'))) {
-        *name = '\0';
-        name++;
-        prefix = str;
-        if (prefix[0] == '@') {
-            prefix++;
-        }
-    } else {
-        name = str;
-        if (name[0] == '@') {
-            name++;
-        }
-    }
-
-    /* prepare data for parsing node content */
-    len += r + 1;
-    len += skip_ws(&data[len]);
-    if (data[len] != ':') {
-        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, (*parent), "JSON data (missing name-separator)");
-        goto error;
-    }
-    len++;
-    len += skip_ws(&data[len]);
-
-    if (str[0] == '@' && !str[1]) {
-        /* process attribute of the parent object (container or list) */
-        if (!(*parent)) {
-            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_NONE, NULL, "attribute with no corresponding element to belongs to");
-            goto error;
-        }
-
-        r = json_parse_attr((*parent)->schema->module, &attr, &data[len], options);
-        if (!r) {
-            LOGPATH(ctx, LY_VLOG_LYD, *parent);
-            goto error;
-        }
-        len += r;
+    uint64_t prof;
 
-        if ((*parent)->attr) {
-            lyd_free_attr(ctx, NULL, attr, 1);
-        } else {
-            (*parent)->attr = attr;
-            for (; attr; attr = attr->next) {
-                attr->parent = *parent;
-            }
-        }
-
-        /* check edit-config attribute correctness */
-        if ((options & LYD_OPT_EDIT) && lyp_check_edit_attr(ctx, (*parent)->attr, *parent, NULL)) {
-            goto error;
-        }
-
-        free(str);
-        return len;
-    }
-
-    /* find schema node */
-    if (!(*parent)) {
+    LY_PROF_START(prof);
+    if (!parent) {
         /* starting in root */
         /* get the proper schema */
         module = ly_ctx_get_module(ctx, prefix, NULL, 0);
@@ -1027,8 +942,8 @@ json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *sch
         }
 
         /* go through RPC's input/output following the options' data type */
-        if ((*parent)->schema->nodetype == LYS_RPC || (*parent)->schema->nodetype == LYS_ACTION) {
-            while ((schema = (struct lys_node *)lys_getnext(schema, (*parent)->schema, NULL, LYS_GETNEXT_WITHINOUT))) {
+        if (parent->schema->nodetype == LYS_RPC || parent->schema->nodetype == LYS_ACTION) {
+            while ((schema = (struct lys_node *)lys_getnext(schema, parent->schema, NULL, LYS_GETNEXT_WITHINOUT))) {
                 if ((options & LYD_OPT_RPC) && (schema->nodetype == LYS_INPUT)) {
                     break;
                 } else if ((options & LYD_OPT_RPCREPLY) && (schema->nodetype == LYS_OUTPUT)) {
@@ -1048,15 +963,215 @@ json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *sch
                 }
             }
         } else {
-            while ((schema = (struct lys_node *)lys_getnext(schema, (*parent)->schema, NULL, 0))) {
+            while ((schema = (struct lys_node *)lys_getnext(schema, parent->schema, NULL, 0))) {
                 if (!strcmp(schema->name, name)
                         && ((prefix && !strcmp(lys_node_module(schema)->name, prefix))
-                        || (!prefix && (lys_node_module(schema) == lyd_node_module(*parent))))) {
+                        || (!prefix && (lys_node_module(schema) == lyd_node_module(parent))))) {
                     break;
                 }
             }
         }
     }
+    LY_PROF_STOP(LY_PROF_SCHEMA_LOOKUP, prof);
+
+    return schema;
+}
+
+/**
+ * @brief Parse the name of a JSON object member.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] data Member start.
+ * @param[in] parent Parent node for logging.
+ * @param[out] str Allocated member name, to be freed.
+ * @param[out] prefix Module name in \p str without a leading '@', NULL if none.
+ * @param[out] name Node name in \p str without a leading '@'.
+ * @return Length of the name with the name-separator and whitespaces, 0 on error.
+ */
+static unsigned int
+json_parse_name(struct ly_ctx *ctx, const char *data, struct lyd_node *parent, char **str, char **prefix, char **name)
+{
+    unsigned int len = 0;
+    unsigned int r;
+
+    *str = NULL;
+
+    /* each YANG data node representation starts with string (node identifier) */
+    if (data[len] != '"') {
+        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, parent,
+               "JSON data (missing quotation-mark at the beginning of string)");
+        return 0;
+    }
+    len++;
+
+    *str = lyjson_parse_text(ctx, &data[len], &r);
+    if (!*str) {
+        return 0;
+    }
+
+    if (!r) {
+        goto error;
+    } else if (data[len + r] != '"') {
+        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, parent,
+               "JSON data (missing quotation-mark at the end of string)");
+        goto error;
+    }
+    *prefix = NULL;
+    if ((*name = strchr(*str, ':'))) {
+        **name = '\0';
+        ++(*name);
+        *prefix = *str;
+        if ((*prefix)[0] == '@') {
+            ++(*prefix);
+        }
+    } else {
+        *name = *str;
+        if ((*name)[0] == '@') {
+            ++(*name);
+        }
+    }
+
+    /* prepare data for parsing node content */
+    len += r + 1;
+    len += skip_ws(&data[len]);
+    if (data[len] != ':') {
+        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, parent, "JSON data (missing name-separator)");
+        goto error;
+    }
+    len++;
+    len += skip_ws(&data[len]);
+
+    return len;
+
+error:
+    free(*str);
+    *str = NULL;
+    return 0;
+}
+
+static unsigned int json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *schema_parent,
+                                    struct lyd_node **parent, struct lyd_node *first_sibling, struct lyd_node *prev,
+                                    struct attr_cont **attrs, int options, struct unres_data *unres,
+                                    struct lyd_node **act_notif, const char *yang_data_name, struct lyd_node **opened);
+
+/**
+ * @brief Parse a JSON list instance object.
+ *
+ * @param[in] list List instance without children.
+ * @return Length of the object with the trailing whitespaces, 0 on error.
+ */
+static unsigned int
+json_parse_list_entry(struct ly_ctx *ctx, const char *data, struct lyd_node *list, int options, struct unres_data *unres,
+                      struct lyd_node **act_notif, const char *yang_data_name)
+{
+    unsigned int len = 0, r;
+    struct lyd_node *diter = NULL;
+    struct attr_cont *attrs_aux = NULL;
+
+    if (data[len] != '{') {
+        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, list, "JSON data (missing list instance's begin-object)");
+        return 0;
+    }
+    do {
+        len++;
+        len += skip_ws(&data[len]);
+
+        r = json_parse_data(ctx, &data[len], NULL, &list, list->child, diter, &attrs_aux, options, unres, act_notif,
+                            yang_data_name, NULL);
+        if (!r) {
+            return 0;
+        }
+        len += r;
+
+        if (list->child) {
+            diter = list->child->prev;
+        }
+    } while (data[len] == ',');
+
+#ifdef LY_ENABLED_CACHE
+    /* all the children are parsed, calculate the hash and build the hash table at once */
+    if (lyd_insert_hash_bulk(list)) {
+        return 0;
+    }
+#endif
+
+    /* store attributes */
+    if (store_attrs(ctx, attrs_aux, list->child, options)) {
+        return 0;
+    }
+
+    if (data[len] != '}') {
+        /* expecting end-object */
+        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, list, "JSON data (missing list instance's end-object)");
+        return 0;
+    }
+    len++;
+    len += skip_ws(&data[len]);
+
+    return len;
+}
+
+/*
+ * opened - if set, a container or a list is created without any children and its begin-object or begin-array
+ * with whitespaces is parsed, the container or the list instance (to be parsed) is returned in it
+ */
+static unsigned int
+json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *schema_parent, struct lyd_node **parent,
+                struct lyd_node *first_sibling, struct lyd_node *prev, struct attr_cont **attrs, int options,
+                struct unres_data *unres, struct lyd_node **act_notif, const char *yang_data_name,
+                struct lyd_node **opened)
+{
+    unsigned int len = 0;
+    unsigned int r;
+    unsigned int flag_leaflist = 0;
+    int i;
+    uint8_t pos;
+    char *name, *prefix, *str = NULL;
+    const struct lys_module *module = NULL;
+    struct lys_node *schema = NULL;
+    struct lyd_node *result = NULL, *new, *list, *diter = NULL;
+    struct lyd_attr *attr;
+    struct attr_cont *attrs_aux;
+
+    len = json_parse_name(ctx, data, *parent, &str, &prefix, &name);
+    if (!len) {
+        goto error;
+    }
+
+    if (str[0] == '@' && !str[1]) {
+        /* process attribute of the parent object (container or list) */
+        if (!(*parent)) {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_NONE, NULL, "attribute with no corresponding element to belongs to");
+            goto error;
+        }
+
+        r = json_parse_attr((*parent)->schema->module, &attr, &data[len], options);
+        if (!r) {
+            LOGPATH(ctx, LY_VLOG_LYD, *parent);
+            goto error;
+        }
+        len += r;
+
+        if ((*parent)->attr) {
+            lyd_free_attr(ctx, NULL, attr, 1);
+        } else {
+            (*parent)->attr = attr;
+            for (; attr; attr = attr->next) {
+                attr->parent = *parent;
+            }
+        }
+
+        /* check edit-config attribute correctness */
+        if ((options & LYD_OPT_EDIT) && lyp_check_edit_attr(ctx, (*parent)->attr, *parent, NULL)) {
+            goto error;
+        }
+
+        free(str);
+        return len;
+    }
+
+    /* find schema node */
+    schema = json_get_schema(ctx, prefix, name, schema_parent, *parent, options, yang_data_name);
 
     module = lys_node_module(schema);
     if (!module || !module->implemented || module->disabled) {
@@ -1209,9 +1324,8 @@ attr_repeat:
         }
 
 #ifdef LY_ENABLED_CACHE
-        /* calculate the hash and insert it into parent */
+        /* calculate the hash, it is inserted into the parent hash table once all the siblings are parsed */
         lyd_hash(result);
-        lyd_insert_hash(result);
 #endif
 
         len += r;
@@ -1239,9 +1353,8 @@ attr_repeat:
         }
 
 #ifdef LY_ENABLED_CACHE
-        /* calculate the hash and insert it into parent */
+        /* calculate the hash, it is inserted into the parent hash table once all the siblings are parsed */
         lyd_hash(result);
-        lyd_insert_hash(result);
 #endif
 
         if (data[len] != '{') {
@@ -1251,6 +1364,19 @@ attr_repeat:
         len++;
         len += skip_ws(&data[len]);
 
+        if (opened && (schema->nodetype == LYS_CONTAINER)) {
+            /* only create the container */
+            if (lyv_data_context(result, options | LYD_OPT_TRUSTED, unres)) {
+                goto error;
+            }
+            *opened = result;
+            if (!(*parent)) {
+                *parent = result;
+            }
+            free(str);
+            return len;
+        }
+
         if (data[len] != '}') {
             /* non-empty container */
             len--;
@@ -1260,7 +1386,8 @@ attr_repeat:
                 len++;
                 len += skip_ws(&data[len]);
 
-                r = json_parse_data(ctx, &data[len], NULL, &result, result->child, diter, &attrs_aux, options, unres, act_notif, yang_data_name);
+                r = json_parse_data(ctx, &data[len], NULL, &result, result->child, diter, &attrs_aux, options, unres,
+                                    act_notif, yang_data_name, NULL);
                 if (!r) {
                     goto error;
                 }
@@ -1277,6 +1404,13 @@ attr_repeat:
             }
         }
 
+#ifdef LY_ENABLED_CACHE
+        /* all the children are parsed, build the hash table at once */
+        if (lyd_insert_hash_bulk(result)) {
+            goto error;
+        }
+#endif
+
         if (data[len] != '}') {
             LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, result, "JSON data (missing end-object)");
             goto error;
@@ -1301,49 +1435,21 @@ attr_repeat:
             len++;
             len += skip_ws(&data[len]);
 
-            if (data[len] != '{') {
-                LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, result,
-                       "JSON data (missing list instance's begin-object)");
-                goto error;
-            }
-            diter = NULL;
-            attrs_aux = NULL;
-            do {
-                len++;
-                len += skip_ws(&data[len]);
-
-                r = json_parse_data(ctx, &data[len], NULL, &list, list->child, diter, &attrs_aux, options, unres, act_notif, yang_data_name);
-                if (!r) {
-                    goto error;
-                }
-                len += r;
-
-                if (list->child) {
-                    diter = list->child->prev;
+            if (opened) {
+                /* only create the first instance */
+                *opened = result;
+                if (!(*parent)) {
+                    *parent = result;
                 }
-            } while (data[len] == ',');
-
-#ifdef LY_ENABLED_CACHE
-            /* calculate the hash and insert it into parent */
-            if (!((struct lys_node_list *)list->schema)->keys_size) {
-                lyd_hash(list);
-                lyd_insert_hash(list);
+                free(str);
+                return len;
             }
-#endif
 
-            /* store attributes */
-            if (store_attrs(ctx, attrs_aux, list->child, options)) {
+            r = json_parse_list_entry(ctx, &data[len], list, options, unres, act_notif, yang_data_name);
+            if (!r) {
                 goto error;
             }
-
-            if (data[len] != '}') {
-                /* expecting end-object */
-                LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, result,
-                       "JSON data (missing list instance's end-object)");
-                goto error;
-            }
-            len++;
-            len += skip_ws(&data[len]);
+            len += r;
 
             if (data[len] == ',') {
                 /* various validation checks */
@@ -1517,7 +1623,8 @@ lyd_parse_json(struct ly_ctx *ctx, const char *data, int options, const struct l
             }
         }
 
-        r = json_parse_data(ctx, &data[len], NULL, &next, result, iter, &attrs, options, unres, &act_notif, yang_data_name);
+        r = json_parse_data(ctx, &data[len], NULL, &next, result, iter, &attrs, options, unres, &act_notif,
+                            yang_data_name, NULL);
         if (!r) {
             goto error;
         }
@@ -1566,6 +1673,15 @@ lyd_parse_json(struct ly_ctx *ctx, const char *data, int options, const struct l
         goto error;
     }
 
+#ifdef LY_ENABLED_CACHE
+    if (reply_parent) {
+        /* the reply nodes are all parsed, build the hash table at once */
+        if (lyd_insert_hash_bulk(reply_parent)) {
+            goto error;
+        }
+    }
+#endif
+
     if (reply_top) {
         result = reply_top;
     }
@@ -1643,3 +1759,511 @@ error:
 
     return NULL;
 }
+
+/* states of a JSON object or array being read by a chunk reader */
+#define JSON_FRAME_FIRST 0      /**< after the begin-object or begin-array */
+#define JSON_FRAME_NEXT  1      /**< after a value-separator */
+#define JSON_FRAME_SEP   2      /**< after a member or an array value */
+
+/**
+ * @brief JSON object or array being read by a chunk reader.
+ */
+struct lyd_chunk_json_frame {
+    struct lyd_node *node;      /**< object - its node (NULL for the top-level object), array - the next list
+                                     instance if already created */
+    const struct lys_node *list; /**< array - list schema node, NULL for an object */
+    struct attr_cont *attrs;    /**< metadata of the object members */
+    uint8_t state;              /**< JSON_FRAME_* */
+    uint8_t opened;             /**< object node was opened, it is postponed until its metadata are read */
+};
+
+/**
+ * @brief Scan a JSON object member or an array value for its end. Unless scanned whole, scanning stops
+ * once \p limit bytes are scanned.
+ *
+ * @param[in] scan Scanner state, positions are relative to the member start.
+ * @param[in] buf Member start.
+ * @param[in] len Available length of \p buf.
+ * @param[in] limit Length to stop scanning at.
+ * @return Length of the member, 0 if it is not complete yet.
+ */
+static size_t
+json_chunk_scan(struct lyd_chunk_scan *scan, const char *buf, size_t len, size_t limit)
+{
+    size_t i;
+
+    for (i = scan->scanned; i < len; ++i) {
+        if (!scan->whole && (i >= limit)) {
+            break;
+        }
+
+        if (scan->state == 2) {
+            /* escaped character */
+            scan->state = 1;
+        } else if (scan->state) {
+            if (buf[i] == '\\') {
+                scan->state = 2;
+            } else if (buf[i] == '"') {
+                scan->state = 0;
+            }
+        } else if (buf[i] == '"') {
+            scan->state = 1;
+        } else if ((buf[i] == '{') || (buf[i] == '[')) {
+            ++scan->depth;
+        } else if ((buf[i] == '}') || (buf[i] == ']')) {
+            if (!scan->depth) {
+                /* end of the parent object or array */
+                scan->scanned = i;
+                return i;
+            }
+            --scan->depth;
+        } else if ((buf[i] == ',') && !scan->depth) {
+            scan->scanned = i;
+            return i;
+        }
+    }
+
+    scan->scanned = i;
+    return 0;
+}
+
+/**
+ * @brief Add a JSON frame to a chunk reader.
+ *
+ * @return Added frame, NULL on error.
+ */
+static struct lyd_chunk_json_frame *
+json_chunk_push(struct lyd_chunk_reader *reader, struct lyd_node *node, const struct lys_node *list)
+{
+    struct lyd_chunk_json_frame *frames, *frame;
+    uint32_t size;
+
+    if (reader->frame_count == reader->frame_size) {
+        size = reader->frame_size ? reader->frame_size * 2 : 8;
+        frames = realloc(reader->frames, size * sizeof *frames);
+        LY_CHECK_ERR_RETURN(!frames, LOGMEM(reader->ctx), NULL);
+        reader->frames = frames;
+        reader->frame_size = size;
+    }
+
+    frame = &reader->frames[reader->frame_count++];
+    memset(frame, 0, sizeof *frame);
+    frame->node = node;
+    frame->list = list;
+    frame->state = JSON_FRAME_FIRST;
+    frame->opened = node ? 0 : 1;
+    return frame;
+}
+
+/**
+ * @brief Store the metadata of the chunk being read and pass it to the callback.
+ */
+static int
+json_chunk_flush(struct lyd_chunk_reader *reader, struct lyd_chunk_json_frame *frame)
+{
+    struct attr_cont *attrs = frame->attrs;
+
+    frame->attrs = NULL;
+    if (attrs && store_attrs(reader->ctx, attrs, reader->chunk, reader->options)) {
+        return EXIT_FAILURE;
+    }
+
+    return lyp_chunk_flush(reader);
+}
+
+/**
+ * @brief Create the next list instance of a JSON array read by a chunk reader, as the last sibling.
+ */
+static struct lyd_node *
+json_chunk_new_entry(struct lyd_chunk_reader *reader, const struct lys_node *schema)
+{
+    struct lyd_node *node, *first;
+
+    node = calloc(1, sizeof *node);
+    LY_CHECK_ERR_RETURN(!node, LOGMEM(reader->ctx), NULL);
+
+    node->schema = (struct lys_node *)schema;
+    node->validity = ly_new_node_validity(schema);
+    if (resolve_applies_when(schema, 0, NULL)) {
+        node->when_status = LYD_WHEN;
+    }
+
+    node->parent = reader->parent;
+    first = reader->parent ? reader->parent->child : reader->chunk;
+    if (first) {
+        node->prev = first->prev;
+        first->prev->next = node;
+        first->prev = node;
+    } else {
+        node->prev = node;
+        if (reader->parent) {
+            reader->parent->child = node;
+        }
+    }
+
+    return node;
+}
+
+/**
+ * @brief Read a complete member of a JSON object by a chunk reader.
+ *
+ * @return Length of the member with the trailing whitespaces, 0 on error.
+ */
+static unsigned int
+json_chunk_member(struct lyd_chunk_reader *reader, struct lyd_chunk_json_frame *frame, const char *data, size_t len)
+{
+    struct lyd_node *parent = frame->node, *first, *prev, *node, *act_notif = NULL;
+    unsigned int r;
+
+    if ((reader->chunk_len >= LYD_CHUNK_SIZE) && !frame->attrs && (data[1] != '@')
+            && json_chunk_flush(reader, frame)) {
+        /* metadata are kept in one chunk with their nodes */
+        return 0;
+    }
+
+    first = parent ? parent->child : reader->chunk;
+    prev = first ? first->prev : NULL;
+    r = json_parse_data(reader->ctx, data, NULL, &parent, first, prev, &frame->attrs, reader->options, reader->unres,
+                        &act_notif, NULL, NULL);
+    if (!r) {
+        return 0;
+    }
+
+    /* learn the first new node */
+    if (prev) {
+        node = prev->next;
+    } else if (frame->node) {
+        node = frame->node->child;
+    } else {
+        for (node = parent; node && node->prev->next; node = node->prev);
+    }
+    if (node) {
+        lyp_chunk_add(reader, node, len);
+    }
+
+    return r;
+}
+
+/**
+ * @brief Read a complete list instance of a JSON array by a chunk reader.
+ *
+ * @return Length of the instance with the trailing whitespaces, 0 on error.
+ */
+static unsigned int
+json_chunk_entry(struct lyd_chunk_reader *reader, struct lyd_chunk_json_frame *frame, const char *data, size_t len)
+{
+    struct lyd_node *node, *act_notif = NULL;
+    unsigned int r;
+
+    if ((reader->chunk_len >= LYD_CHUNK_SIZE) && lyp_chunk_flush(reader)) {
+        return 0;
+    }
+
+    if (frame->node) {
+        node = frame->node;
+        frame->node = NULL;
+    } else {
+        node = json_chunk_new_entry(reader, frame->list);
+        if (!node) {
+            return 0;
+        }
+    }
+    lyp_chunk_add(reader, node, len);
+
+    r = json_parse_list_entry(reader->ctx, data, node, reader->options, reader->unres, &act_notif, NULL);
+    if (!r) {
+        return 0;
+    }
+
+    if (lyv_data_context(node, reader->options | LYD_OPT_TRUSTED, reader->unres)
+            || lyv_data_content(node, reader->options, reader->unres)) {
+        return 0;
+    }
+    node->validity |= LYD_VAL_DUP;
+
+    return r;
+}
+
+/**
+ * @brief Open a large member of a JSON object of a chunk reader, if it is a container or a list.
+ *
+ * @param[out] len Length of the member name and the begin-object or begin-array with whitespaces.
+ * @return 0 if opened, 1 if the member must be read whole, -1 on error.
+ */
+static int
+json_chunk_open_member(struct lyd_chunk_reader *reader, const char *data, unsigned int *len)
+{
+    struct lyd_chunk_json_frame *frame = &reader->frames[reader->frame_count - 1];
+    struct lyd_node *parent = frame->node, *first, *node = NULL, *act_notif = NULL;
+    const struct lys_module *mod;
+    struct lys_node *schema;
+    char *str, *prefix, *name;
+    unsigned int r;
+
+    if (frame->attrs) {
+        /* the metadata may belong to this member */
+        return 1;
+    }
+
+    r = json_parse_name(reader->ctx, data, parent, &str, &prefix, &name);
+    if (!r) {
+        return -1;
+    }
+    if (str[0] == '@') {
+        free(str);
+        return 1;
+    }
+    schema = json_get_schema(reader->ctx, prefix, name, NULL, parent, reader->options, NULL);
+    free(str);
+
+    mod = lys_node_module(schema);
+    if (!mod || !mod->implemented || mod->disabled || !(schema->nodetype & (LYS_CONTAINER | LYS_LIST))
+            || (data[r] != (schema->nodetype == LYS_LIST ? '[' : '{'))) {
+        return 1;
+    }
+
+    if (json_chunk_flush(reader, frame)) {
+        return -1;
+    }
+
+    first = parent ? parent->child : NULL;
+    r = json_parse_data(reader->ctx, data, NULL, &parent, first, first ? first->prev : NULL, &frame->attrs,
+                        reader->options, reader->unres, &act_notif, NULL, &node);
+    if (!r) {
+        return -1;
+    }
+    frame->state = JSON_FRAME_SEP;
+
+    if (!json_chunk_push(reader, node, schema->nodetype == LYS_LIST ? schema : NULL)) {
+        if (!node->parent) {
+            lyd_free(node);
+        }
+        return -1;
+    }
+
+    *len = r;
+    return 0;
+}
+
+/**
+ * @brief Open a large list instance of a JSON array of a chunk reader.
+ *
+ * @param[out] len Length of the begin-object with whitespaces.
+ * @return 0 if opened, 1 if the instance must be read whole, -1 on error.
+ */
+static int
+json_chunk_open_entry(struct lyd_chunk_reader *reader, const char *data, unsigned int *len)
+{
+    struct lyd_chunk_json_frame *frame = &reader->frames[reader->frame_count - 1];
+    struct lyd_node *node;
+
+    if (data[0] != '{') {
+        return 1;
+    }
+
+    if (lyp_chunk_flush(reader)) {
+        return -1;
+    }
+
+    if (frame->node) {
+        node = frame->node;
+        frame->node = NULL;
+    } else {
+        node = json_chunk_new_entry(reader, frame->list);
+        if (!node) {
+            return -1;
+        }
+    }
+    frame->state = JSON_FRAME_SEP;
+
+    if (!json_chunk_push(reader, node, NULL)) {
+        if (!node->parent) {
+            lyd_free(node);
+        }
+        return -1;
+    }
+    if (lyv_data_context(node, reader->options | LYD_OPT_TRUSTED, reader->unres)) {
+        return -1;
+    }
+
+    *len = 1 + skip_ws(&data[1]);
+    return 0;
+}
+
+/**
+ * @brief Finish the innermost JSON object or array of a chunk reader.
+ */
+static int
+json_chunk_end(struct lyd_chunk_reader *reader)
+{
+    struct lyd_chunk_json_frame *frame = &reader->frames[reader->frame_count - 1];
+
+    if (frame->list) {
+        /* large list */
+        if (frame->node) {
+            LOGVAL(reader->ctx, LYE_XML_INVAL, LY_VLOG_LYD, frame->node, "JSON data (missing list instance's begin-object)");
+            return EXIT_FAILURE;
+        }
+        --reader->frame_count;
+        return EXIT_SUCCESS;
+    }
+
+    if (reader->frame_count == 1) {
+        /* top-level object */
+        if (json_chunk_flush(reader, frame)) {
+            return EXIT_FAILURE;
+        }
+        --reader->frame_count;
+        reader->done = 1;
+        return EXIT_SUCCESS;
+    }
+
+    if (!frame->opened) {
+        frame->opened = 1;
+        if (lyp_chunk_open(reader, frame->node)) {
+            return EXIT_FAILURE;
+        }
+    }
+    if (json_chunk_flush(reader, frame) || lyp_chunk_close(reader)) {
+        return EXIT_FAILURE;
+    }
+    --reader->frame_count;
+    return EXIT_SUCCESS;
+}
+
+int
+json_read_chunks(struct lyd_chunk_reader *reader, const char *data, size_t len, int final, size_t *used)
+{
+    struct ly_ctx *ctx = reader->ctx;
+    struct lyd_chunk_scan *scan = &reader->scan;
+    struct lyd_chunk_json_frame *frame;
+    const char *c;
+    size_t i = 0, end;
+    unsigned int r;
+    int ret;
+
+    while (1) {
+        i += skip_ws(&data[i]);
+        if (i == len) {
+            break;
+        }
+        c = &data[i];
+
+        if (reader->done) {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (unexpected data after the top-level end-object)");
+            goto error;
+        } else if (!reader->frame_count) {
+            if (*c != '{') {
+                LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (missing top level begin-object)");
+                goto error;
+            }
+            if (!json_chunk_push(reader, NULL, NULL)) {
+                goto error;
+            }
+            ++i;
+            continue;
+        }
+        frame = &reader->frames[reader->frame_count - 1];
+
+        if ((frame->state != JSON_FRAME_NEXT) && (*c == (frame->list ? ']' : '}'))) {
+            if (json_chunk_end(reader)) {
+                goto error;
+            }
+            ++i;
+            continue;
+        } else if (frame->state == JSON_FRAME_SEP) {
+            if (*c != ',') {
+                LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, frame->node, frame->list ? "JSON data (missing end-array)"
+                       : (reader->frame_count == 1 ? "JSON data (missing top-level end-object)" : "JSON data (missing end-object)"));
+                goto error;
+            }
+            frame->state = JSON_FRAME_NEXT;
+            ++i;
+            continue;
+        } else if (*c != (frame->list ? '{' : '"')) {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_LYD, frame->node, frame->list
+                   ? "JSON data (missing list instance's begin-object)" : "JSON data (missing quotation-mark at the beginning of string)");
+            goto error;
+        }
+
+        if (!frame->list && !frame->opened && !final && (len - i < 3)) {
+            /* not known yet whether metadata follow */
+            break;
+        } else if (!frame->list && !frame->opened && strncmp(c, "\"@\"", 3)) {
+            /* all the metadata of the object node were read */
+            frame->opened = 1;
+            if (lyp_chunk_open(reader, frame->node)) {
+                goto error;
+            }
+        }
+
+        end = json_chunk_scan(scan, c, len - i, LYD_CHUNK_SIZE);
+        if (!end && !scan->whole && (scan->scanned >= LYD_CHUNK_SIZE)) {
+            /* large member or instance */
+            ret = frame->list ? json_chunk_open_entry(reader, c, &r) : json_chunk_open_member(reader, c, &r);
+            if (ret == -1) {
+                goto error;
+            } else if (!ret) {
+                i += r;
+                memset(scan, 0, sizeof *scan);
+                continue;
+            }
+
+            scan->whole = 1;
+            end = json_chunk_scan(scan, c, len - i, LYD_CHUNK_SIZE);
+        }
+        if (!end) {
+            if (!final) {
+                break;
+            }
+            /* incomplete, let the parser report the error */
+            end = len - i;
+        }
+
+        r = frame->list ? json_chunk_entry(reader, frame, c, end) : json_chunk_member(reader, frame, c, end);
+        if (!r) {
+            goto error;
+        }
+        frame->state = JSON_FRAME_SEP;
+        i += r;
+        memset(scan, 0, sizeof *scan);
+    }
+
+    if (final && !reader->done) {
+        LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_NONE, NULL, reader->frame_count
+               ? "JSON data (missing top-level end-object)" : "JSON data (missing top level begin-object)");
+        goto error;
+    }
+
+    *used = i;
+    return EXIT_SUCCESS;
+
+error:
+    *used = i;
+    return EXIT_FAILURE;
+}
+
+void
+json_read_chunks_clean(struct lyd_chunk_reader *reader)
+{
+    struct lyd_chunk_json_frame *frame;
+    struct attr_cont *attrs;
+    uint32_t i;
+
+    for (i = 0; i < reader->frame_count; ++i) {
+        frame = &reader->frames[i];
+        while (frame->attrs) {
+            attrs = frame->attrs;
+            frame->attrs = attrs->next;
+            lyd_free_attr(reader->ctx, NULL, attrs->attr, 1);
+            free(attrs);
+        }
+        if (frame->node && !frame->node->parent && (frame->list || !frame->opened)) {
+            /* top-level node not passed to the callback */
+            lyd_free(frame->node);
+        }
+    }
+    free(reader->frames);
+    reader->frames = NULL;
+    reader->frame_count = reader->frame_size = 0;
+}
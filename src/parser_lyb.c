@@ -893,8 +893,8 @@ lyb_is_schema_hash_match(struct lys_node *sibling, LYB_HASH *hash, uint8_t hash_
 }
 
 static int
-lyb_parse_schema_hash(const struct lys_node *sparent, const struct lys_module *mod, const char *data, const char *yang_data_name,
-                      int options, struct lys_node **snode, struct lyb_state *lybs)
+lyb_parse_schema_hash_(const struct lys_node *sparent, const struct lys_module *mod, const char *data, const char *yang_data_name,
+                       int options, struct lys_node **snode, struct lyb_state *lybs)
 {
     int r, ret = 0;
     uint8_t i, j;
@@ -983,6 +983,20 @@ finish:
     return ret;
 }
 
+static int
+lyb_parse_schema_hash(const struct lys_node *sparent, const struct lys_module *mod, const char *data, const char *yang_data_name,
+                      int options, struct lys_node **snode, struct lyb_state *lybs)
+{
+    int ret;
+    uint64_t prof;
+
+    LY_PROF_START(prof);
+    ret = lyb_parse_schema_hash_(sparent, mod, data, yang_data_name, options, snode, lybs);
+    LY_PROF_STOP(LY_PROF_SCHEMA_LOOKUP, prof);
+
+    return ret;
+}
+
 static int
 lyb_skip_subtree(const char *data, struct lyb_state *lybs)
 {
@@ -1119,10 +1133,13 @@ lyb_parse_subtree(const char *data, struct lyd_node *parent, struct lyd_node **f
     }
 
 #ifdef LY_ENABLED_CACHE
-    /* calculate the hash and insert it into parent (list with keys is handled when its keys are inserted) */
-    if ((node->schema->nodetype != LYS_LIST) || !((struct lys_node_list *)node->schema)->keys_size) {
+    /* calculate the hash and build the hash table of all the children at once, the node itself is inserted
+     * into the parent hash table once all its siblings are parsed */
+    if (node->schema->nodetype != LYS_LIST) {
         lyd_hash(node);
-        lyd_insert_hash(node);
+    }
+    if (lyd_insert_hash_bulk(node)) {
+        goto error;
     }
 #endif
 
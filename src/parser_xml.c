@@ -99,49 +99,19 @@ xml_get_value(struct lyd_node *node, struct lyxml_elem *xml, int editbits)
     return EXIT_SUCCESS;
 }
 
-/* logs directly */
-static int
-xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *parent, struct lyd_node *first_sibling,
-               struct lyd_node *prev, int options, struct unres_data *unres, struct lyd_node **result,
-               struct lyd_node **act_notif, const char *yang_data_name)
+/* does not log */
+static struct lys_node *
+xml_data_find_schema(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *parent, int options,
+                     const char *yang_data_name)
 {
     const struct lys_module *mod = NULL;
-    struct lyd_node *diter, *dlast;
     struct lys_node *schema = NULL, *target;
     const struct lys_node *ext_node;
     struct lys_node_augment *aug;
-    struct lyd_attr *dattr, *dattr_iter;
-    struct lyxml_attr *attr;
-    struct lyxml_elem *child, *next;
-    int i, j, havechildren, r, editbits = 0, filterflag = 0, found;
-    uint8_t pos;
-    int ret = 0;
-    const char *str = NULL;
-    char *msg;
-
-    assert(xml);
-    assert(result);
-    *result = NULL;
-
-    if (xml->flags & LYXML_ELEM_MIXED) {
-        if (options & LYD_OPT_STRICT) {
-            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_XML, xml, "XML element with mixed content");
-            return -1;
-        } else {
-            return 0;
-        }
-    }
+    int j;
+    uint64_t prof;
 
-    if (!xml->ns || !xml->ns->value) {
-        if (options & LYD_OPT_STRICT) {
-            LOGVAL(ctx, LYE_XML_MISS, LY_VLOG_XML, xml, "element's", "namespace");
-            return -1;
-        } else {
-            return 0;
-        }
-    }
-
-    /* find schema node */
+    LY_PROF_START(prof);
     if (!parent) {
         mod = ly_ctx_get_module_by_ns(ctx, xml->ns->value, NULL, 0);
         if (ctx->data_clb) {
@@ -209,6 +179,53 @@ xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *pare
             }
         }
     }
+    LY_PROF_STOP(LY_PROF_SCHEMA_LOOKUP, prof);
+
+    return schema;
+}
+
+/* logs directly */
+static int
+xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *parent, struct lyd_node *first_sibling,
+               struct lyd_node *prev, int options, struct unres_data *unres, struct lyd_node **result,
+               struct lyd_node **act_notif, const char *yang_data_name)
+{
+    const struct lys_module *mod = NULL;
+    struct lyd_node *diter, *dlast;
+    struct lys_node *schema = NULL;
+    struct lyd_attr *dattr, *dattr_iter;
+    struct lyxml_attr *attr;
+    struct lyxml_elem *child, *next;
+    int i, havechildren, r, editbits = 0, filterflag = 0, found;
+    uint8_t pos;
+    int ret = 0;
+    const char *str = NULL;
+    char *msg;
+
+    assert(xml);
+    assert(result);
+    *result = NULL;
+
+    if (xml->flags & LYXML_ELEM_MIXED) {
+        if (options & LYD_OPT_STRICT) {
+            LOGVAL(ctx, LYE_XML_INVAL, LY_VLOG_XML, xml, "XML element with mixed content");
+            return -1;
+        } else {
+            return 0;
+        }
+    }
+
+    if (!xml->ns || !xml->ns->value) {
+        if (options & LYD_OPT_STRICT) {
+            LOGVAL(ctx, LYE_XML_MISS, LY_VLOG_XML, xml, "element's", "namespace");
+            return -1;
+        } else {
+            return 0;
+        }
+    }
+
+    /* find schema node */
+    schema = xml_data_find_schema(ctx, xml, parent, options, yang_data_name);
 
     mod = lys_node_module(schema);
     if (!mod || !mod->implemented || mod->disabled) {
@@ -497,10 +514,10 @@ attr_error:
     }
 
 #ifdef LY_ENABLED_CACHE
-    /* calculate the hash and insert it into parent (list with keys is handled when its keys are inserted) */
-    if (((*result)->schema->nodetype != LYS_LIST) || !((struct lys_node_list *)(*result)->schema)->keys_size) {
+    /* calculate the hash, it is inserted into the parent hash table once all the siblings are parsed
+     * (lists are hashed only when all their children are parsed) */
+    if ((*result)->schema->nodetype != LYS_LIST) {
         lyd_hash(*result);
-        lyd_insert_hash(*result);
     }
 #endif
 
@@ -527,6 +544,13 @@ attr_error:
         }
     }
 
+#ifdef LY_ENABLED_CACHE
+    /* all the children are parsed, build the hash table at once */
+    if (lyd_insert_hash_bulk(*result)) {
+        goto error;
+    }
+#endif
+
     /* if we have empty non-presence container, we keep it, but mark it as default */
     if (schema->nodetype == LYS_CONTAINER && !(*result)->child &&
             !(*result)->attr && !((struct lys_node_container *)schema)->presence) {
@@ -562,52 +586,32 @@ error:
     return -1;
 }
 
-API struct lyd_node *
-lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
+struct lyd_node *
+lyd_parse_xml_(struct ly_ctx *ctx, struct lyxml_elem **root, int options, const struct lyd_node *rpc_act,
+               const struct lyd_node *data_tree, const char *yang_data_name)
 {
-    FUN_IN;
-
-    va_list ap;
     int r;
     struct unres_data *unres = NULL;
-    const struct lyd_node *rpc_act = NULL, *data_tree = NULL;
     struct lyd_node *result = NULL, *iter, *last, *reply_parent = NULL, *reply_top = NULL, *act_notif = NULL;
     struct lyxml_elem *xmlstart, *xmlelem, *xmlaux, *xmlfree = NULL;
-    const char *yang_data_name = NULL;
-
-    if (!ctx || !root) {
-        LOGARG;
-        return NULL;
-    }
-
-    if (lyp_data_check_options(ctx, options, __func__)) {
-        return NULL;
-    }
 
     if (!(*root) && !(options & LYD_OPT_RPCREPLY)) {
         /* empty tree */
         if (options & (LYD_OPT_RPC | LYD_OPT_NOTIF)) {
             /* error, top level node identify RPC and Notification */
-            LOGERR(ctx, LY_EINVAL, "%s: *root identifies RPC/Notification so it cannot be NULL.", __func__);
+            LOGERR(ctx, LY_EINVAL, "lyd_parse_xml: *root identifies RPC/Notification so it cannot be NULL.");
             return NULL;
-        } else if (!(options & LYD_OPT_RPCREPLY)) {
-            /* others - no work is needed, just check for missing mandatory nodes */
-            lyd_validate(&result, options, ctx);
-            return result;
         }
-        /* continue with empty RPC reply, for which we need RPC */
+
+        /* others - no work is needed, just check for missing mandatory nodes */
+        lyd_validate(&result, options, ctx);
+        return result;
     }
 
     unres = calloc(1, sizeof *unres);
     LY_CHECK_ERR_RETURN(!unres, LOGMEM(ctx), NULL);
 
-    va_start(ap, options);
     if (options & LYD_OPT_RPCREPLY) {
-        rpc_act = va_arg(ap, const struct lyd_node *);
-        if (!rpc_act || rpc_act->parent || !(rpc_act->schema->nodetype & (LYS_RPC | LYS_LIST | LYS_CONTAINER))) {
-            LOGERR(ctx, LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *rpc_act).", __func__);
-            goto error;
-        }
         if (rpc_act->schema->nodetype == LYS_RPC) {
             /* RPC request */
             reply_top = reply_parent = _lyd_new(NULL, rpc_act->schema, 0);
@@ -621,43 +625,13 @@ lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
                 LY_TREE_DFS_END(reply_top, iter, reply_parent);
             }
             if (!reply_parent) {
-                LOGERR(ctx, LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *rpc_act).", __func__);
+                LOGERR(ctx, LY_EINVAL, "lyd_parse_xml: invalid variable parameter (const struct lyd_node *rpc_act).");
                 lyd_free_withsiblings(reply_top);
                 goto error;
             }
             lyd_free_withsiblings(reply_parent->child);
         }
     }
-    if (options & (LYD_OPT_RPC | LYD_OPT_NOTIF | LYD_OPT_RPCREPLY)) {
-        data_tree = va_arg(ap, const struct lyd_node *);
-        if (data_tree) {
-            if (options & LYD_OPT_NOEXTDEPS) {
-                LOGERR(ctx, LY_EINVAL, "%s: invalid parameter (variable arg const struct lyd_node *data_tree and LYD_OPT_NOEXTDEPS set).",
-                       __func__);
-                goto error;
-            }
-
-            LY_TREE_FOR((struct lyd_node *)data_tree, iter) {
-                if (iter->parent) {
-                    /* a sibling is not top-level */
-                    LOGERR(ctx, LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *data_tree).", __func__);
-                    goto error;
-                }
-            }
-
-            /* move it to the beginning */
-            for (; data_tree->prev->next; data_tree = data_tree->prev);
-
-            /* LYD_OPT_NOSIBLINGS cannot be set in this case */
-            if (options & LYD_OPT_NOSIBLINGS) {
-                LOGERR(ctx, LY_EINVAL, "%s: invalid parameter (variable arg const struct lyd_node *data_tree with LYD_OPT_NOSIBLINGS).", __func__);
-                goto error;
-            }
-        }
-    }
-    if (options & LYD_OPT_DATA_TEMPLATE) {
-        yang_data_name = va_arg(ap, const char *);
-    }
 
     if ((*root) && !(options & LYD_OPT_NOSIBLINGS)) {
         /* locate the first root to process */
@@ -717,6 +691,15 @@ lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
         result = reply_top;
     }
 
+#ifdef LY_ENABLED_CACHE
+    if (reply_parent) {
+        /* the reply nodes are all parsed, build the hash table at once */
+        if (lyd_insert_hash_bulk(reply_parent)) {
+            goto error;
+        }
+    }
+#endif
+
     if ((options & LYD_OPT_RPCREPLY) && (rpc_act->schema->nodetype != LYS_RPC)) {
         /* action reply */
         act_notif = reply_parent;
@@ -762,7 +745,6 @@ lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
     free(unres->node);
     free(unres->type);
     free(unres);
-    va_end(ap);
     return result;
 
 error:
@@ -773,6 +755,414 @@ error:
     free(unres->node);
     free(unres->type);
     free(unres);
-    va_end(ap);
     return NULL;
 }
+
+API struct lyd_node *
+lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
+{
+    FUN_IN;
+
+    va_list ap;
+    const struct lyd_node *rpc_act = NULL, *data_tree = NULL, *iter;
+    const char *yang_data_name = NULL;
+    struct lyd_node *result = NULL;
+    uint64_t prof;
+
+    if (!ctx || !root) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (lyp_data_check_options(ctx, options, __func__)) {
+        return NULL;
+    }
+
+    va_start(ap, options);
+    if (options & LYD_OPT_RPCREPLY) {
+        rpc_act = va_arg(ap, const struct lyd_node *);
+        if (!rpc_act || rpc_act->parent || !(rpc_act->schema->nodetype & (LYS_RPC | LYS_LIST | LYS_CONTAINER))) {
+            LOGERR(ctx, LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *rpc_act).", __func__);
+            goto cleanup;
+        }
+    }
+    if (options & (LYD_OPT_RPC | LYD_OPT_NOTIF | LYD_OPT_RPCREPLY)) {
+        data_tree = va_arg(ap, const struct lyd_node *);
+        if (data_tree) {
+            if (options & LYD_OPT_NOEXTDEPS) {
+                LOGERR(ctx, LY_EINVAL, "%s: invalid parameter (variable arg const struct lyd_node *data_tree and LYD_OPT_NOEXTDEPS set).",
+                       __func__);
+                goto cleanup;
+            }
+
+            LY_TREE_FOR(data_tree, iter) {
+                if (iter->parent) {
+                    /* a sibling is not top-level */
+                    LOGERR(ctx, LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *data_tree).", __func__);
+                    goto cleanup;
+                }
+            }
+
+            /* move it to the beginning */
+            for (; data_tree->prev->next; data_tree = data_tree->prev);
+
+            /* LYD_OPT_NOSIBLINGS cannot be set in this case */
+            if (options & LYD_OPT_NOSIBLINGS) {
+                LOGERR(ctx, LY_EINVAL, "%s: invalid parameter (variable arg const struct lyd_node *data_tree with LYD_OPT_NOSIBLINGS).", __func__);
+                goto cleanup;
+            }
+        }
+    }
+    if (options & LYD_OPT_DATA_TEMPLATE) {
+        yang_data_name = va_arg(ap, const char *);
+    }
+
+    LY_PROF_START(prof);
+    result = lyd_parse_xml_(ctx, root, options, rpc_act, data_tree, yang_data_name);
+    LY_PROF_STOP(LY_PROF_PARSE, prof);
+
+cleanup:
+    va_end(ap);
+    return result;
+}
+
+/* states of the XML element scanner of a chunk reader */
+#define XML_SCAN_TEXT      0    /**< character data between tags */
+#define XML_SCAN_MARKUP    1    /**< after '<' */
+#define XML_SCAN_STAG      2    /**< start tag */
+#define XML_SCAN_STAG_QUOT 3    /**< quoted attribute value in a start tag */
+#define XML_SCAN_ETAG      4    /**< end tag */
+#define XML_SCAN_PI        5    /**< processing instruction */
+#define XML_SCAN_COMMENT   6    /**< comment */
+#define XML_SCAN_CDATA     7    /**< CDATA section */
+#define XML_SCAN_DECL      8    /**< other markup declaration */
+
+/**
+ * @brief Scan an XML element for its end. Unless the element is scanned whole, scanning stops once its start
+ * tag and at least \p limit bytes are scanned.
+ *
+ * @param[in] scan Scanner state, positions are relative to the element start.
+ * @param[in] buf Element start.
+ * @param[in] len Available length of \p buf.
+ * @param[in] limit Length to stop scanning at.
+ * @return Length of the element, 0 if it is not complete yet.
+ */
+static size_t
+xml_chunk_scan(struct lyd_chunk_scan *scan, const char *buf, size_t len, size_t limit)
+{
+    size_t i, avail;
+
+    for (i = scan->scanned; i < len; ++i) {
+        if (!scan->whole && scan->stag_len && (i >= limit)) {
+            break;
+        }
+
+        switch (scan->state) {
+        case XML_SCAN_TEXT:
+            if (buf[i] == '<') {
+                scan->state = XML_SCAN_MARKUP;
+            }
+            break;
+        case XML_SCAN_MARKUP:
+            if (buf[i] == '/') {
+                scan->state = XML_SCAN_ETAG;
+            } else if (buf[i] == '?') {
+                scan->state = XML_SCAN_PI;
+            } else if (buf[i] == '!') {
+                avail = len - i;
+                if ((avail >= 3) && !strncmp(&buf[i], "!--", 3)) {
+                    scan->state = XML_SCAN_COMMENT;
+                    i += 2;
+                } else if ((avail >= 8) && !strncmp(&buf[i], "![CDATA[", 8)) {
+                    scan->state = XML_SCAN_CDATA;
+                    i += 7;
+                } else if (!strncmp(&buf[i], "!--", avail < 3 ? avail : 3) || ((avail < 8) && !strncmp(&buf[i], "![CDATA[", avail))) {
+                    /* cannot decide yet, scan this '!' again with more data */
+                    scan->scanned = i;
+                    return 0;
+                } else {
+                    scan->state = XML_SCAN_DECL;
+                }
+            } else {
+                scan->state = XML_SCAN_STAG;
+            }
+            break;
+        case XML_SCAN_STAG:
+            if ((buf[i] == '"') || (buf[i] == '\'')) {
+                scan->quote = buf[i];
+                scan->state = XML_SCAN_STAG_QUOT;
+            } else if (buf[i] == '>') {
+                scan->state = XML_SCAN_TEXT;
+                if (!scan->stag_len) {
+                    scan->stag_len = i + 1;
+                }
+                if (buf[i - 1] != '/') {
+                    ++scan->depth;
+                } else if (!scan->depth) {
+                    /* empty element */
+                    scan->scanned = i + 1;
+                    return i + 1;
+                }
+            }
+            break;
+        case XML_SCAN_STAG_QUOT:
+            if (buf[i] == scan->quote) {
+                scan->state = XML_SCAN_STAG;
+            }
+            break;
+        case XML_SCAN_ETAG:
+            if (buf[i] == '>') {
+                scan->state = XML_SCAN_TEXT;
+                if (scan->depth) {
+                    --scan->depth;
+                }
+                if (!scan->depth) {
+                    scan->scanned = i + 1;
+                    return i + 1;
+                }
+            }
+            break;
+        case XML_SCAN_PI:
+            if ((buf[i] == '>') && (buf[i - 1] == '?')) {
+                scan->state = XML_SCAN_TEXT;
+            }
+            break;
+        case XML_SCAN_COMMENT:
+            if ((buf[i] == '>') && (buf[i - 1] == '-') && (buf[i - 2] == '-')) {
+                scan->state = XML_SCAN_TEXT;
+            }
+            break;
+        case XML_SCAN_CDATA:
+            if ((buf[i] == '>') && (buf[i - 1] == ']') && (buf[i - 2] == ']')) {
+                scan->state = XML_SCAN_TEXT;
+            }
+            break;
+        case XML_SCAN_DECL:
+            if (buf[i] == '>') {
+                scan->state = XML_SCAN_TEXT;
+            }
+            break;
+        }
+    }
+
+    scan->scanned = i;
+    return 0;
+}
+
+/**
+ * @brief Open a large XML element of a chunk reader, if it is a container or a list instance.
+ *
+ * @param[in] reader Chunk reader.
+ * @param[in] data Element start.
+ * @return 0 if opened, 1 if the element must be read whole, -1 on error.
+ */
+static int
+xml_chunk_open(struct lyd_chunk_reader *reader, const char *data)
+{
+    struct ly_ctx *ctx = reader->ctx;
+    struct lyxml_elem *xml;
+    struct lys_node *schema;
+    const struct lys_module *mod;
+    struct lyd_node *first, *node, *act_notif = NULL;
+    unsigned int len;
+
+    xml = lyxml_parse_elem(ctx, data, &len, reader->xml_parent, LYXML_PARSE_STAG);
+    if (!xml) {
+        return -1;
+    }
+
+    schema = NULL;
+    if (xml->ns && xml->ns->value) {
+        schema = xml_data_find_schema(ctx, xml, reader->parent, reader->options, NULL);
+    }
+    mod = lys_node_module(schema);
+    if (!mod || !mod->implemented || mod->disabled || !(schema->nodetype & (LYS_CONTAINER | LYS_LIST))) {
+        lyxml_free(ctx, xml);
+        return 1;
+    }
+
+    if (lyp_chunk_flush(reader)) {
+        lyxml_free(ctx, xml);
+        return -1;
+    }
+
+    first = reader->parent ? reader->parent->child : NULL;
+    if (xml_parse_data(ctx, xml, reader->parent, first, first ? first->prev : NULL, reader->options, reader->unres,
+                       &node, &act_notif, NULL)) {
+        lyxml_free(ctx, xml);
+        return -1;
+    } else if (!node) {
+        /* ignored element */
+        lyxml_free(ctx, xml);
+        return 1;
+    }
+
+    /* the start tag is kept for the namespaces of the children */
+    reader->xml_parent = xml;
+    if (lyp_chunk_open(reader, node)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Close the opened XML element of a chunk reader.
+ *
+ * @param[in] reader Chunk reader.
+ * @param[in] data End tag start.
+ * @param[in] end End tag '>'.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+static int
+xml_chunk_close(struct lyd_chunk_reader *reader, const char *data, const char *end)
+{
+    struct lyxml_elem *xml = reader->xml_parent;
+    const char *name, *e;
+
+    if (!xml) {
+        LOGVAL(reader->ctx, LYE_XML_INCHAR, LY_VLOG_NONE, NULL, data);
+        return EXIT_FAILURE;
+    }
+
+    /* compare the local names */
+    for (name = e = data + 2; (e < end) && !is_xmlws(*e); ++e) {
+        if (*e == ':') {
+            name = e + 1;
+        }
+    }
+    if (strncmp(name, xml->name, e - name) || xml->name[e - name]) {
+        LOGVAL(reader->ctx, LYE_SPEC, LY_VLOG_XML, xml, "Invalid (mixed names) opening (%s) and closing (%.*s) element tags.",
+               xml->name, (int)(e - name), name);
+        return EXIT_FAILURE;
+    }
+
+    if (lyp_chunk_close(reader)) {
+        return EXIT_FAILURE;
+    }
+
+    reader->xml_parent = xml->parent;
+    lyxml_free(reader->ctx, xml);
+    return EXIT_SUCCESS;
+}
+
+int
+xml_read_chunks(struct lyd_chunk_reader *reader, const char *data, size_t len, int final, size_t *used)
+{
+    struct ly_ctx *ctx = reader->ctx;
+    struct lyd_chunk_scan *scan = &reader->scan;
+    struct lyd_node *first, *node, *act_notif = NULL;
+    struct lyxml_elem *xml;
+    const char *c, *e;
+    size_t i = 0, end;
+    unsigned int size;
+    int r;
+
+    while (1) {
+        /* skip whitespaces, comments, and processing instructions between the elements */
+        for (c = &data[i]; is_xmlws(*c); ++c);
+        i = c - data;
+        if ((i == len) || (!final && (len - i < 4))) {
+            break;
+        }
+        if (!strncmp(c, "<?", 2) || !strncmp(c, "<!--", 4)) {
+            e = strstr(c + 2, c[1] == '?' ? "?>" : "-->");
+            if (!e) {
+                if (final) {
+                    LOGVAL(ctx, LYE_EOF, LY_VLOG_NONE, NULL);
+                    goto error;
+                }
+                break;
+            }
+            i = (e - data) + (c[1] == '?' ? 2 : 3);
+            continue;
+        } else if (!strncmp(c, "<!", 2)) {
+            LOGERR(ctx, LY_EINVAL, "DOCTYPE not supported in XML documents.");
+            goto error;
+        } else if (*c != '<') {
+            LOGVAL(ctx, LYE_XML_INCHAR, LY_VLOG_NONE, NULL, c);
+            goto error;
+        }
+
+        if (c[1] == '/') {
+            /* end tag of the opened element */
+            e = strchr(c, '>');
+            if (!e) {
+                if (final) {
+                    LOGVAL(ctx, LYE_EOF, LY_VLOG_NONE, NULL);
+                    goto error;
+                }
+                break;
+            }
+            if (xml_chunk_close(reader, c, e)) {
+                goto error;
+            }
+            i = (e - data) + 1;
+            continue;
+        }
+
+        end = xml_chunk_scan(scan, c, len - i, LYD_CHUNK_SIZE);
+        if (!end && !scan->whole && scan->stag_len && (scan->scanned >= LYD_CHUNK_SIZE)) {
+            /* large element */
+            r = xml_chunk_open(reader, c);
+            if (r == -1) {
+                goto error;
+            } else if (!r) {
+                i += scan->stag_len;
+                memset(scan, 0, sizeof *scan);
+                continue;
+            }
+
+            scan->whole = 1;
+            end = xml_chunk_scan(scan, c, len - i, LYD_CHUNK_SIZE);
+        }
+        if (!end) {
+            if (final) {
+                /* incomplete element, let the XML parser report the error */
+                xml = lyxml_parse_elem(ctx, c, &size, reader->xml_parent, 0);
+                LY_CHECK_ERR_GOTO(xml, lyxml_free(ctx, xml); LOGINT(ctx), error);
+                goto error;
+            }
+            break;
+        }
+
+        /* complete element, add it to the chunk */
+        xml = lyxml_parse_elem(ctx, c, &size, reader->xml_parent, 0);
+        if (!xml) {
+            goto error;
+        }
+        first = reader->parent ? reader->parent->child : reader->chunk;
+        r = xml_parse_data(ctx, xml, reader->parent, first, first ? first->prev : NULL, reader->options, reader->unres,
+                           &node, &act_notif, NULL);
+        lyxml_free(ctx, xml);
+        if (r) {
+            goto error;
+        }
+        if (node) {
+            lyp_chunk_add(reader, node, end);
+        }
+        i += end;
+        memset(scan, 0, sizeof *scan);
+
+        if ((reader->chunk_len >= LYD_CHUNK_SIZE) && lyp_chunk_flush(reader)) {
+            goto error;
+        }
+    }
+
+    if (final) {
+        if (reader->xml_parent) {
+            LOGVAL(ctx, LYE_XML_MISS, LY_VLOG_XML, reader->xml_parent, "closing element tag", reader->xml_parent->name);
+            goto error;
+        }
+        if (lyp_chunk_flush(reader)) {
+            goto error;
+        }
+    }
+
+    *used = i;
+    return EXIT_SUCCESS;
+
+error:
+    *used = i;
+    return EXIT_FAILURE;
+}
@@ -1753,6 +1753,26 @@ static const flex_int16_t yy_chk[4864] =
 #define YY_USER_ACTION yylloc->first_column = yylloc->last_column +1;\
                        yylloc->last_column = yylloc->first_column + yyleng - 1;
 
+/* characters of quoted strings and comments without any special meaning */
+#define YANG_LEX_DQUOTE_CHAR(c) (((c) == 0x0D) || (((c) >= 0x20) && ((c) <= 0x7f) && ((c) != '"') && ((c) != '\\')))
+#define YANG_LEX_SQUOTE_CHAR(c) (((c) == 0x09) || ((c) == 0x0D) || (((c) >= 0x20) && ((c) <= 0x7f) && ((c) != '\'')))
+#define YANG_LEX_COMMENT1_CHAR(c) (((c) >= 0x01) && ((c) <= 0x7f) && ((c) != '\n') && ((c) != '*'))
+#define YANG_LEX_COMMENT2_CHAR(c) (((c) >= 0x01) && ((c) <= 0x7f) && ((c) != '\n'))
+
+/* the rules match strings and comments one character at a time, extend the current match
+ * over all the following characters accepted by CHAR_OK so that the action runs once for them */
+#define YANG_LEX_RUN(CHAR_OK) { \
+    int run_len = yyleng; \
+    unsigned char run_c = yyg->yy_hold_char; \
+    while (CHAR_OK(run_c)) { \
+        run_c = yytext[++run_len]; \
+    } \
+    if (run_len > yyleng) { \
+        yylloc->last_column += run_len - yyleng; \
+        yyless(run_len); \
+    } \
+}
+
 #define INITIAL 0
 #define COMMENT1 1
 #define COMMENT2 2
@@ -2108,7 +2128,13 @@ YY_RULE_SETUP
 	YY_BREAK
 case 2:
 YY_RULE_SETUP
-
+{
+    if (YY_START == COMMENT1) {
+        YANG_LEX_RUN(YANG_LEX_COMMENT1_CHAR);
+    } else {
+        YANG_LEX_RUN(YANG_LEX_COMMENT2_CHAR);
+    }
+}
 	YY_BREAK
 case 3:
 /* rule 3 can match eol */
@@ -2469,7 +2495,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 94:
 YY_RULE_SETUP
-{ size_str += yyleng; }
+{ YANG_LEX_RUN(YANG_LEX_DQUOTE_CHAR); size_str += yyleng; }
 	YY_BREAK
 case 95:
 /* rule 95 can match eol */
@@ -2539,7 +2565,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 101:
 YY_RULE_SETUP
-{ size_str += yyleng; }
+{ YANG_LEX_RUN(YANG_LEX_SQUOTE_CHAR); size_str += yyleng; }
 	YY_BREAK
 case 102:
 YY_RULE_SETUP
@@ -16,17 +16,20 @@
 #define _POSIX_C_SOURCE 200809L
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <pthread.h>
 
 #include "common.h"
 #include "tree_schema.h"
 #include "tree_data.h"
 #include "printer.h"
+#include "parser.h"
 
 struct ext_substmt_info_s ext_substmt_info[] = {
   {NULL, NULL, 0},                              /**< LYEXT_SUBSTMT_SELF */
@@ -77,37 +80,136 @@ nscmp(const struct lyd_node *node1, const struct lyd_node *node2)
     }
 }
 
+/* size of the buffer gathering small writes into a file descriptor */
+#define LY_OUT_FD_BUFSIZE 16384
+
+/* write the gathered data followed by buf (written in place) into the file descriptor */
+static int
+ly_write_fd(struct lyout *out, const char *buf, size_t count)
+{
+    struct iovec iov[2];
+    int iovcnt = 0;
+    ssize_t r;
+
+    if (out->fd_buf_len) {
+        iov[iovcnt].iov_base = out->fd_buf;
+        iov[iovcnt].iov_len = out->fd_buf_len;
+        ++iovcnt;
+    }
+    if (count) {
+        iov[iovcnt].iov_base = (void *)buf;
+        iov[iovcnt].iov_len = count;
+        ++iovcnt;
+    }
+    out->fd_buf_len = 0;
+
+    while (iovcnt) {
+        r = writev(out->method.fd, iov, iovcnt);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+
+        /* partial write */
+        if ((size_t)r >= iov[0].iov_len) {
+            r -= iov[0].iov_len;
+            iov[0] = iov[1];
+            --iovcnt;
+        }
+        if (iovcnt) {
+            iov[0].iov_base = (char *)iov[0].iov_base + r;
+            iov[0].iov_len -= r;
+            if (!iov[0].iov_len) {
+                --iovcnt;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Make room for more data in a memory output, the buffer grows geometrically
+ * so that printing large data is not quadratic.
+ *
+ * @param[in] out Memory output.
+ * @param[in] count Length of the data to be written, the terminating zero is added.
+ * @return 0 on success, -1 on error.
+ */
+static int
+ly_print_mem_reserve(struct lyout *out, size_t count)
+{
+    char *aux;
+    size_t size;
+
+    if (out->method.mem.len + count + 1 <= out->method.mem.size) {
+        return 0;
+    }
+
+    size = out->method.mem.size * 2;
+    if (size < out->method.mem.len + count + 1) {
+        size = out->method.mem.len + count + 1;
+    }
+    aux = ly_realloc(out->method.mem.buf, size);
+    if (!aux) {
+        out->method.mem.buf = NULL;
+        out->method.mem.len = 0;
+        out->method.mem.size = 0;
+        LOGMEM(NULL);
+        return -1;
+    }
+    out->method.mem.buf = aux;
+    out->method.mem.size = size;
+
+    return 0;
+}
+
 int
 ly_print(struct lyout *out, const char *format, ...)
 {
     int count = 0;
-    char *msg = NULL, *aux;
-    va_list ap;
+    char *msg = NULL;
+    va_list ap, ap2;
 
     va_start(ap, format);
 
     switch (out->type) {
     case LYOUT_FD:
-        count = vdprintf(out->method.fd, format, ap);
+        if (!out->fd_buf) {
+            out->fd_buf = malloc(LY_OUT_FD_BUFSIZE);
+            if (!out->fd_buf) {
+                LOGMEM(NULL);
+                va_end(ap);
+                return -1;
+            }
+        }
+
+        /* print directly into the buffer */
+        va_copy(ap2, ap);
+        count = vsnprintf(out->fd_buf + out->fd_buf_len, LY_OUT_FD_BUFSIZE - out->fd_buf_len, format, ap);
+        if ((count > -1) && (out->fd_buf_len + count < LY_OUT_FD_BUFSIZE)) {
+            out->fd_buf_len += count;
+        } else if (count > -1) {
+            /* does not fit, write it together with the buffered data */
+            count = vasprintf(&msg, format, ap2);
+            if ((count > -1) && (ly_write_fd(out, msg, count) < 0)) {
+                count = -1;
+            }
+            free(msg);
+        }
+        va_end(ap2);
         break;
     case LYOUT_STREAM:
         count = vfprintf(out->method.f, format, ap);
         break;
     case LYOUT_MEMORY:
         count = vasprintf(&msg, format, ap);
-        if (out->method.mem.len + count + 1 > out->method.mem.size) {
-            aux = ly_realloc(out->method.mem.buf, out->method.mem.len + count + 1);
-            if (!aux) {
-                out->method.mem.buf = NULL;
-                out->method.mem.len = 0;
-                out->method.mem.size = 0;
-                LOGMEM(NULL);
-                free(msg);
-                va_end(ap);
-                return -1;
-            }
-            out->method.mem.buf = aux;
-            out->method.mem.size = out->method.mem.len + count + 1;
+        if (ly_print_mem_reserve(out, count)) {
+            free(msg);
+            va_end(ap);
+            return -1;
         }
         memcpy(&out->method.mem.buf[out->method.mem.len], msg, count);
         out->method.mem.len += count;
@@ -134,19 +236,24 @@ ly_print(struct lyout *out, const char *format, ...)
     return count;
 }
 
-void
+int
 ly_print_flush(struct lyout *out)
 {
     switch (out->type) {
     case LYOUT_STREAM:
-        fflush(out->method.f);
-        break;
+        return fflush(out->method.f) ? EXIT_FAILURE : EXIT_SUCCESS;
     case LYOUT_FD:
+        if (out->fd_buf_len && (ly_write_fd(out, NULL, 0) < 0)) {
+            return EXIT_FAILURE;
+        }
+        break;
     case LYOUT_MEMORY:
     case LYOUT_CALLBACK:
         /* nothing to do */
         break;
     }
+
+    return EXIT_SUCCESS;
 }
 
 int
@@ -172,22 +279,25 @@ ly_write(struct lyout *out, const char *buf, size_t count)
 
     switch (out->type) {
     case LYOUT_MEMORY:
-        if (out->method.mem.len + count + 1 > out->method.mem.size) {
-            out->method.mem.buf = ly_realloc(out->method.mem.buf, out->method.mem.len + count + 1);
-            if (!out->method.mem.buf) {
-                out->method.mem.len = 0;
-                out->method.mem.size = 0;
-                LOGMEM(NULL);
-                return -1;
-            }
-            out->method.mem.size = out->method.mem.len + count + 1;
+        if (ly_print_mem_reserve(out, count)) {
+            return -1;
         }
         memcpy(&out->method.mem.buf[out->method.mem.len], buf, count);
         out->method.mem.len += count;
         out->method.mem.buf[out->method.mem.len] = '\0';
         return count;
     case LYOUT_FD:
-        return write(out->method.fd, buf, count);
+        if (out->fd_buf_len + count >= LY_OUT_FD_BUFSIZE) {
+            /* the buffer is full, write everything including buf */
+            return ly_write_fd(out, buf, count);
+        }
+        if (!out->fd_buf) {
+            out->fd_buf = malloc(LY_OUT_FD_BUFSIZE);
+            LY_CHECK_ERR_RETURN(!out->fd_buf, LOGMEM(NULL), -1);
+        }
+        memcpy(&out->fd_buf[out->fd_buf_len], buf, count);
+        out->fd_buf_len += count;
+        return count;
     case LYOUT_STREAM:
         return fwrite(buf, sizeof *buf, count, out->method.f);
     case LYOUT_CALLBACK:
@@ -280,6 +390,111 @@ ly_write_skipped(struct lyout *out, size_t position, const char *buf, size_t cou
     return count;
 }
 
+/* nodes whose subtrees are printed concurrently */
+#define LYP_PAR_NODETYPE (LYS_CONTAINER | LYS_LIST | LYS_NOTIF | LYS_RPC | LYS_ACTION)
+
+/* a level of the tree is split only if there are at least this many subtrees for every thread */
+#define LYP_PAR_TASKS_PER_THREAD 8
+
+/* deepest level of the tree that is split */
+#define LYP_PAR_MAX_DEPTH 8
+
+#define LYP_PAR_MAX_THREADS 64
+#define LYP_PAR_TASK_STEP 64
+#define LYP_PAR_STAGE_SIZE 65536
+
+/**
+ * @brief Deferred subtree.
+ */
+struct lyp_par_task {
+    lyp_subtree_clb clb;
+    const struct lyd_node *node;
+    int level;
+    int toplevel;
+    int options;
+    size_t offset;      /**< length of the main output when the subtree was deferred */
+    size_t len;         /**< length of the printed subtree in the output of its batch */
+};
+
+/**
+ * @brief Consecutive deferred subtrees printed by a single thread.
+ */
+struct lyp_par_batch {
+    struct lyout out;
+    int ret;
+};
+
+/**
+ * @brief Parallel printing state.
+ */
+struct lyp_par {
+    struct ly_ctx *ctx;
+    const struct lyd_node *top_parent;  /**< parent of the printed nodes */
+    int depth;                          /**< depth of the deferred subtrees */
+
+    struct lyp_par_task *tasks;
+    uint32_t task_count;
+    uint32_t task_size;
+
+    struct lyp_par_batch *batches;
+    uint32_t batch_count;
+    uint32_t batch_tasks;               /**< number of tasks in a batch */
+    uint32_t next_batch;                /**< first batch not taken by any thread, protected by lock */
+    pthread_mutex_t lock;
+};
+
+/**
+ * @brief Additional printing thread.
+ */
+struct lyp_par_thread {
+    pthread_t thread;
+    struct lyp_par *par;
+    struct ly_err_item *err;            /**< errors generated by the thread */
+};
+
+int
+ly_print_subtree(struct lyout *out, lyp_subtree_clb clb, int level, const struct lyd_node *node, int toplevel,
+                 int options)
+{
+    struct lyp_par *par = out->par;
+    struct lyp_par_task *task;
+    const struct lyd_node *iter;
+    int depth;
+    void *mem;
+
+    if (!par || !(node->schema->nodetype & LYP_PAR_NODETYPE)) {
+        return clb(out, level, node, toplevel, options);
+    }
+
+    /* only the subtrees on the chosen level are deferred (nodes from anydata trees never) */
+    for (depth = 0, iter = node->parent; iter != par->top_parent; iter = iter->parent) {
+        if (!iter || (++depth > par->depth)) {
+            return clb(out, level, node, toplevel, options);
+        }
+    }
+    if (depth < par->depth) {
+        return clb(out, level, node, toplevel, options);
+    }
+
+    if (par->task_count == par->task_size) {
+        mem = realloc(par->tasks, (par->task_size + LYP_PAR_TASK_STEP) * sizeof *par->tasks);
+        LY_CHECK_ERR_RETURN(!mem, LOGMEM(node->schema->module->ctx), EXIT_FAILURE);
+        par->tasks = mem;
+        par->task_size += LYP_PAR_TASK_STEP;
+    }
+
+    task = &par->tasks[par->task_count++];
+    task->clb = clb;
+    task->node = node;
+    task->level = level;
+    task->toplevel = toplevel;
+    task->options = options;
+    task->offset = out->method.mem.len;
+    task->len = 0;
+
+    return EXIT_SUCCESS;
+}
+
 static int
 write_iff(struct lyout *out, const struct lys_module *module, struct lys_iffeature *expr, int prefix_kind,
           int *index_e, int *index_f)
@@ -430,6 +645,7 @@ lys_print_fd(int fd, const struct lys_module *module, LYS_OUTFORMAT format, cons
              int line_length, int options)
 {
     struct lyout out;
+    int r;
 
     if (fd < 0 || !module) {
         LOGARG;
@@ -441,7 +657,14 @@ lys_print_fd(int fd, const struct lys_module *module, LYS_OUTFORMAT format, cons
     out.type = LYOUT_FD;
     out.method.fd = fd;
 
-    return lys_print_(&out, module, format, target_node, line_length, options);
+    r = lys_print_(&out, module, format, target_node, line_length, options);
+
+    if (ly_print_flush(&out) && !r) {
+        LOGERR(module->ctx, LY_ESYS, "Print error (%s).", strerror(errno));
+        r = EXIT_FAILURE;
+    }
+    free(out.fd_buf);
+    return r;
 }
 
 API int
@@ -703,7 +926,7 @@ lys_print_target(struct lyout *out, const struct lys_module *module, const char
 }
 
 static int
-lyd_print_(struct lyout *out, const struct lyd_node *root, LYD_FORMAT format, int options)
+lyd_print_format(struct lyout *out, const struct lyd_node *root, LYD_FORMAT format, int options)
 {
     switch (format) {
     case LYD_XML:
@@ -713,9 +936,286 @@ lyd_print_(struct lyout *out, const struct lyd_node *root, LYD_FORMAT format, in
     case LYD_LYB:
         return lyb_print_data(out, root, options);
     default:
-        LOGERR(root->schema->module->ctx, LY_EINVAL, "Unknown output format.");
-        return EXIT_FAILURE;
+        break;
+    }
+
+    LOGERR(root->schema->module->ctx, LY_EINVAL, "Unknown output format.");
+    return EXIT_FAILURE;
+}
+
+/* number of subtrees that would be deferred on the level depth */
+static uint32_t
+lyp_par_width(const struct lyd_node *node, int depth, int withsiblings)
+{
+    uint32_t width = 0;
+
+    for (; node; node = node->next) {
+        if (node->schema->nodetype & LYP_PAR_NODETYPE) {
+            width += (depth ? lyp_par_width(node->child, depth - 1, 1) : 1);
+        }
+        if (!withsiblings) {
+            break;
+        }
+    }
+
+    return width;
+}
+
+/* the shallowest level with enough subtrees for all the threads, -1 if not worth it */
+static int
+lyp_par_split_depth(const struct lyd_node *root, LYD_FORMAT format, int options, uint32_t threads)
+{
+    int depth, max_depth, best = -1;
+    uint32_t width, best_width = 1;
+
+    /* LYB subtrees include the sizes of all their descendants, only top-level ones are independent */
+    max_depth = (format == LYD_LYB ? 0 : LYP_PAR_MAX_DEPTH);
+
+    for (depth = 0; depth <= max_depth; ++depth) {
+        width = lyp_par_width(root, depth, options & LYP_WITHSIBLINGS);
+        if (width > best_width) {
+            best = depth;
+            best_width = width;
+        }
+        if (!width || (width >= threads * LYP_PAR_TASKS_PER_THREAD)) {
+            break;
+        }
+    }
+
+    return best;
+}
+
+static void *
+lyp_par_worker(void *arg)
+{
+    struct lyp_par *par = arg;
+    struct lyp_par_batch *batch;
+    struct lyp_par_task *task;
+    uint32_t b, i, last;
+    size_t len;
+
+    while (1) {
+        pthread_mutex_lock(&par->lock);
+        b = par->next_batch;
+        if (b < par->batch_count) {
+            ++par->next_batch;
+        }
+        pthread_mutex_unlock(&par->lock);
+        if (b == par->batch_count) {
+            break;
+        }
+
+        batch = &par->batches[b];
+        batch->out.type = LYOUT_MEMORY;
+        last = (b + 1) * par->batch_tasks;
+        if (last > par->task_count) {
+            last = par->task_count;
+        }
+        for (i = b * par->batch_tasks; i < last; ++i) {
+            task = &par->tasks[i];
+            len = batch->out.method.mem.len;
+            if (task->clb(&batch->out, task->level, task->node, task->toplevel, task->options)) {
+                batch->ret = EXIT_FAILURE;
+                break;
+            }
+            task->len = batch->out.method.mem.len - len;
+        }
+    }
+
+    return NULL;
+}
+
+static void *
+lyp_par_thread(void *arg)
+{
+    struct lyp_par_thread *thread = arg;
+
+    lyp_par_worker(thread->par);
+
+    /* the errors are stored per thread, pass them to the caller */
+    thread->err = ly_err_detach(thread->par->ctx);
+    return NULL;
+}
+
+/* write through a staging buffer so that the small pieces between the subtrees are not written one by one */
+static int
+lyp_par_write(struct lyout *out, char *stage, size_t *stage_len, const char *buf, size_t count)
+{
+    if (stage && (*stage_len + count > LYP_PAR_STAGE_SIZE)) {
+        if (*stage_len && ((size_t)ly_write(out, stage, *stage_len) < *stage_len)) {
+            return EXIT_FAILURE;
+        }
+        *stage_len = 0;
+    }
+
+    if (!count) {
+        return EXIT_SUCCESS;
+    } else if (!stage || (count > LYP_PAR_STAGE_SIZE)) {
+        return ((size_t)ly_write(out, buf, count) < count) ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    memcpy(stage + *stage_len, buf, count);
+    *stage_len += count;
+    return EXIT_SUCCESS;
+}
+
+/* write the main output with all the subtrees printed into the batches inserted in place */
+static int
+lyp_par_merge(struct lyout *out, struct lyp_par *par, struct lyout *main_out)
+{
+    struct lyp_par_task *task;
+    char *stage = NULL;
+    const char *subtree = NULL;
+    size_t stage_len = 0, pos = 0, total;
+    uint32_t i;
+    int ret = EXIT_FAILURE;
+
+    if (out->type == LYOUT_MEMORY) {
+        /* allocate the whole result at once */
+        total = out->method.mem.len + main_out->method.mem.len;
+        for (i = 0; i < par->batch_count; ++i) {
+            total += par->batches[i].out.method.mem.len;
+        }
+        if (total + 1 > out->method.mem.size) {
+            out->method.mem.buf = ly_realloc(out->method.mem.buf, total + 1);
+            if (!out->method.mem.buf) {
+                out->method.mem.len = 0;
+                out->method.mem.size = 0;
+                LOGMEM(NULL);
+                goto cleanup;
+            }
+            out->method.mem.size = total + 1;
+        }
+    } else {
+        stage = malloc(LYP_PAR_STAGE_SIZE);
+        LY_CHECK_ERR_GOTO(!stage, LOGMEM(NULL), cleanup);
+    }
+
+    for (i = 0; i < par->task_count; ++i) {
+        task = &par->tasks[i];
+        if (!(i % par->batch_tasks)) {
+            subtree = par->batches[i / par->batch_tasks].out.method.mem.buf;
+        }
+
+        if (lyp_par_write(out, stage, &stage_len, main_out->method.mem.buf + pos, task->offset - pos)
+                || lyp_par_write(out, stage, &stage_len, subtree, task->len)) {
+            goto cleanup;
+        }
+        pos = task->offset;
+        subtree += task->len;
+    }
+    if (lyp_par_write(out, stage, &stage_len, main_out->method.mem.buf + pos, main_out->method.mem.len - pos)) {
+        goto cleanup;
+    }
+    if (stage_len && ((size_t)ly_write(out, stage, stage_len) < stage_len)) {
+        goto cleanup;
+    }
+    ly_print_flush(out);
+    ret = EXIT_SUCCESS;
+
+cleanup:
+    free(stage);
+    return ret;
+}
+
+static int
+lyd_print_parallel(struct lyout *out, const struct lyd_node *root, LYD_FORMAT format, int options)
+{
+    struct lyp_par par;
+    struct lyout main_out;
+    struct ly_ctx *ctx = root->schema->module->ctx;
+    struct lyp_par_thread threads[LYP_PAR_MAX_THREADS - 1];
+    long cpus;
+    uint32_t i, thread_count, started = 0;
+    int ret = EXIT_FAILURE;
+
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    thread_count = (cpus < 1 ? 1 : (cpus > LYP_PAR_MAX_THREADS ? LYP_PAR_MAX_THREADS : cpus));
+
+    memset(&par, 0, sizeof par);
+    par.ctx = ctx;
+    par.top_parent = root->parent;
+    par.depth = lyp_par_split_depth(root, format, options, thread_count);
+    if (par.depth == -1) {
+        /* not enough independent subtrees */
+        return lyd_print_format(out, root, format, options);
+    }
+
+    /* print everything except the deferred subtrees */
+    memset(&main_out, 0, sizeof main_out);
+    main_out.type = LYOUT_MEMORY;
+    main_out.par = &par;
+    if (lyd_print_format(&main_out, root, format, options)) {
+        goto cleanup;
+    }
+
+    /* print the deferred subtrees */
+    if (par.task_count) {
+        par.batch_tasks = par.task_count / (thread_count * LYP_PAR_TASKS_PER_THREAD);
+        if (!par.batch_tasks) {
+            par.batch_tasks = 1;
+        }
+        par.batch_count = (par.task_count + par.batch_tasks - 1) / par.batch_tasks;
+        par.batches = calloc(par.batch_count, sizeof *par.batches);
+        LY_CHECK_ERR_GOTO(!par.batches, LOGMEM(ctx), cleanup);
+        pthread_mutex_init(&par.lock, NULL);
+
+        for (i = 0; (i < thread_count - 1) && (i + 1 < par.batch_count); ++i) {
+            threads[i].par = &par;
+            threads[i].err = NULL;
+            if (pthread_create(&threads[i].thread, NULL, lyp_par_thread, &threads[i])) {
+                /* the remaining batches are printed by the threads already running */
+                break;
+            }
+            ++started;
+        }
+        lyp_par_worker(&par);
+        for (i = 0; i < started; ++i) {
+            pthread_join(threads[i].thread, NULL);
+            ly_err_attach(ctx, threads[i].err);
+        }
+        pthread_mutex_destroy(&par.lock);
+
+        for (i = 0; i < par.batch_count; ++i) {
+            if (par.batches[i].ret) {
+                /* error already logged */
+                goto cleanup;
+            }
+        }
+    }
+
+    ret = lyp_par_merge(out, &par, &main_out);
+
+cleanup:
+    for (i = 0; i < par.batch_count; ++i) {
+        free(par.batches[i].out.method.mem.buf);
+        free(par.batches[i].out.buffered);
+        if (par.batches[i].out.par_data) {
+            par.batches[i].out.par_data_free(par.batches[i].out.par_data);
+        }
+    }
+    free(par.batches);
+    free(par.tasks);
+    free(main_out.method.mem.buf);
+    free(main_out.buffered);
+    return ret;
+}
+
+static int
+lyd_print_(struct lyout *out, const struct lyd_node *root, LYD_FORMAT format, int options)
+{
+    int ret;
+    uint64_t prof;
+
+    LY_PROF_START(prof);
+    if ((options & LYP_PARALLEL) && root) {
+        ret = lyd_print_parallel(out, root, format, options);
+    } else {
+        ret = lyd_print_format(out, root, format, options);
     }
+    LY_PROF_STOP(LY_PROF_PRINT, prof);
+
+    return ret;
 }
 
 API int
@@ -781,6 +1281,11 @@ lyd_print_fd(int fd, const struct lyd_node *root, LYD_FORMAT format, int options
 
     r = lyd_print_(&out, root, format, options);
 
+    if (ly_print_flush(&out) && !r) {
+        LOGERR(root ? lyd_node_module(root)->ctx : NULL, LY_ESYS, "Print error (%s).", strerror(errno));
+        r = EXIT_FAILURE;
+    }
+    free(out.fd_buf);
     free(out.buffered);
     return r;
 }
@@ -831,6 +1336,371 @@ lyd_print_clb(ssize_t (*writeclb)(void *arg, const void *buf, size_t count), voi
     return r;
 }
 
+/**
+ * @brief Transcoding state.
+ */
+struct lyd_transcode_state {
+    struct lyout *out;
+    LYD_FORMAT format;
+    int options;
+    int level;                      /**< XML level of the next nodes */
+    int nonempty;                   /**< some data were printed (XML) */
+    struct json_chunk_printer *jp;  /**< JSON printer */
+    struct lyd_node *top;           /**< opened top-level node */
+};
+
+static int
+lyd_transcode_chunk(int event, struct lyd_node *node, void *arg)
+{
+    struct lyd_transcode_state *st = (struct lyd_transcode_state *)arg;
+    struct lyd_node *next, *iter;
+    int ret = EXIT_SUCCESS;
+
+    if ((event == LYD_CHUNK_OPEN) && !node->parent) {
+        st->top = node;
+    }
+
+    if (st->format == LYD_JSON) {
+        ret = json_print_chunk(st->jp, event, node);
+    } else {
+        st->nonempty = 1;
+        switch (event) {
+        case LYD_CHUNK_OPEN:
+            ret = xml_print_open(st->out, st->level, node, node->parent ? 2 : 1, st->options);
+            if (st->level) {
+                ++st->level;
+            }
+            break;
+        case LYD_CHUNK_NODES:
+            LY_TREE_FOR(node, iter) {
+                ret = xml_print_node(st->out, st->level, iter, iter->parent ? 2 : 1, st->options);
+                if (ret) {
+                    break;
+                }
+            }
+            break;
+        case LYD_CHUNK_CLOSE:
+            if (st->level) {
+                --st->level;
+            }
+            ret = xml_print_close(st->out, st->level, node);
+            break;
+        }
+    }
+
+    /* the printed nodes are not needed anymore */
+    if (event == LYD_CHUNK_NODES) {
+        LY_TREE_FOR_SAFE(node, next, iter) {
+            lyd_free(iter);
+        }
+    } else if (event == LYD_CHUNK_CLOSE) {
+        if (node == st->top) {
+            st->top = NULL;
+        }
+        lyd_free(node);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Transcoder, also used internally for transcoding the whole data at once.
+ */
+struct lyd_transcoder {
+    struct ly_ctx *ctx;
+    struct lyout out;                 /**< output of the transcoders created by lyd_transcoder_new() */
+    struct lyd_transcode_state st;    /**< printer state */
+    struct lyd_chunk_reader reader;   /**< chunk reader of the input data */
+    int error;                        /**< transcoding failed */
+    char *buf;                        /**< fed data not read yet */
+    size_t len;                       /**< length of the data in buf */
+    size_t size;                      /**< allocated size of buf */
+};
+
+static int
+lyd_transcoder_init(struct lyd_transcoder *tc, struct ly_ctx *ctx, LYD_FORMAT in_format, int parse_options,
+                    struct lyout *out, LYD_FORMAT out_format, int print_options, const char *func)
+{
+    memset(&tc->st, 0, sizeof tc->st);
+    memset(&tc->reader, 0, sizeof tc->reader);
+    tc->ctx = ctx;
+
+    if (lyp_data_check_options(ctx, parse_options, func)) {
+        return EXIT_FAILURE;
+    }
+    if (parse_options & LYD_OPT_TYPEMASK & ~(LYD_OPT_CONFIG | LYD_OPT_GET | LYD_OPT_GETCONFIG | LYD_OPT_EDIT)) {
+        LOGERR(ctx, LY_EINVAL, "%s: only data trees can be transcoded.", func);
+        return EXIT_FAILURE;
+    }
+    if (parse_options & (LYD_OPT_NOSIBLINGS | LYD_OPT_DATA_ADD_YANGLIB)) {
+        LOGERR(ctx, LY_EINVAL, "%s: invalid options (LYD_OPT_NOSIBLINGS and LYD_OPT_DATA_ADD_YANGLIB are not supported).",
+               func);
+        return EXIT_FAILURE;
+    }
+    if ((in_format == LYD_LYB) || (out_format == LYD_LYB)) {
+        LOGERR(ctx, LY_EINVAL, "%s: LYB data cannot be transcoded, parse and print them instead.", func);
+        return EXIT_FAILURE;
+    }
+    if (((in_format != LYD_XML) && (in_format != LYD_JSON)) || ((out_format != LYD_XML) && (out_format != LYD_JSON))) {
+        LOGERR(ctx, LY_EINVAL, "%s: unknown data format.", func);
+        return EXIT_FAILURE;
+    }
+
+    print_options |= LYP_WITHSIBLINGS;
+
+    tc->st.out = out;
+    tc->st.format = out_format;
+    tc->st.options = print_options;
+    tc->st.level = (print_options & LYP_FORMAT ? 1 : 0);
+    if (out_format == LYD_JSON) {
+        tc->st.jp = json_print_chunks_begin(out, print_options);
+        if (!tc->st.jp) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* only the opened nodes and the current chunk are kept, so it is not possible to check anything but the values */
+    if (lyp_chunk_reader_init(&tc->reader, ctx, in_format, parse_options, lyd_transcode_chunk, &tc->st)) {
+        json_print_chunks_free(tc->st.jp);
+        tc->st.jp = NULL;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* read the last data and finish printing */
+static int
+lyd_transcoder_end(struct lyd_transcoder *tc, const char *data, size_t len)
+{
+    size_t used;
+
+    if (lyp_chunk_read(&tc->reader, data, len, 1, &used)) {
+        return EXIT_FAILURE;
+    }
+
+    if (tc->st.format == LYD_JSON) {
+        return json_print_chunks_end(tc->st.jp);
+    } else if (!tc->st.nonempty) {
+        return xml_print_data(tc->st.out, NULL, tc->st.options);
+    }
+    return EXIT_SUCCESS;
+}
+
+static void
+lyd_transcoder_clean(struct lyd_transcoder *tc)
+{
+    lyp_chunk_reader_clean(&tc->reader);
+    lyd_free(tc->st.top);
+    json_print_chunks_free(tc->st.jp);
+    free(tc->buf);
+}
+
+static int
+lyd_transcode_(struct ly_ctx *ctx, const char *data, LYD_FORMAT in_format, int parse_options, struct lyout *out,
+               LYD_FORMAT out_format, int print_options)
+{
+    struct lyd_transcoder tc;
+    int ret;
+
+    if (!ctx || !data) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    memset(&tc, 0, sizeof tc);
+    ret = lyd_transcoder_init(&tc, ctx, in_format, parse_options, out, out_format, print_options, __func__);
+    if (!ret) {
+        ret = lyd_transcoder_end(&tc, data, strlen(data));
+    }
+    lyd_transcoder_clean(&tc);
+
+    return ret;
+}
+
+API struct lyd_transcoder *
+lyd_transcoder_new(struct ly_ctx *ctx, LYD_FORMAT in_format, int parse_options,
+                   ssize_t (*writeclb)(void *arg, const void *buf, size_t count), void *arg,
+                   LYD_FORMAT out_format, int print_options)
+{
+    struct lyd_transcoder *tc;
+
+    if (!ctx || !writeclb) {
+        LOGARG;
+        return NULL;
+    }
+
+    tc = calloc(1, sizeof *tc);
+    LY_CHECK_ERR_RETURN(!tc, LOGMEM(ctx), NULL);
+
+    tc->out.type = LYOUT_CALLBACK;
+    tc->out.method.clb.f = writeclb;
+    tc->out.method.clb.arg = arg;
+
+    if (lyd_transcoder_init(tc, ctx, in_format, parse_options, &tc->out, out_format, print_options, __func__)) {
+        lyd_transcoder_free(tc);
+        return NULL;
+    }
+
+    return tc;
+}
+
+API int
+lyd_transcoder_feed(struct lyd_transcoder *tc, const char *data, size_t len)
+{
+    char *buf;
+    size_t size, used;
+    int ret;
+
+    if (!tc || (!data && len)) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    if (tc->error) {
+        LOGERR(tc->ctx, LY_EINVAL, "%s: transcoding already failed.", __func__);
+        return EXIT_FAILURE;
+    }
+
+    if (tc->len + len + 1 > tc->size) {
+        for (size = tc->size ? tc->size : 1024; size < tc->len + len + 1; size *= 2);
+        buf = realloc(tc->buf, size);
+        LY_CHECK_ERR_RETURN(!buf, LOGMEM(tc->ctx); tc->error = 1, EXIT_FAILURE);
+        tc->buf = buf;
+        tc->size = size;
+    }
+    memcpy(&tc->buf[tc->len], data, len);
+    tc->len += len;
+    tc->buf[tc->len] = '\0';
+
+    ret = lyp_chunk_read(&tc->reader, tc->buf, tc->len, 0, &used);
+
+    /* keep only the data not read yet */
+    memmove(tc->buf, &tc->buf[used], tc->len - used + 1);
+    tc->len -= used;
+
+    if (ret) {
+        tc->error = 1;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+API int
+lyd_transcoder_finish(struct lyd_transcoder *tc)
+{
+    int ret;
+
+    if (!tc) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    if (tc->error) {
+        LOGERR(tc->ctx, LY_EINVAL, "%s: transcoding already failed.", __func__);
+        ret = EXIT_FAILURE;
+    } else {
+        ret = lyd_transcoder_end(tc, tc->buf ? tc->buf : "", tc->len);
+    }
+
+    lyd_transcoder_free(tc);
+    return ret;
+}
+
+API void
+lyd_transcoder_free(struct lyd_transcoder *tc)
+{
+    if (!tc) {
+        return;
+    }
+
+    lyd_transcoder_clean(tc);
+    free(tc->out.buffered);
+    free(tc);
+}
+
+API int
+lyd_transcode_mem(struct ly_ctx *ctx, const char *data, LYD_FORMAT in_format, int parse_options, char **strp,
+                  LYD_FORMAT out_format, int print_options)
+{
+    struct lyout out;
+    int r;
+
+    if (!strp) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    memset(&out, 0, sizeof out);
+
+    out.type = LYOUT_MEMORY;
+
+    r = lyd_transcode_(ctx, data, in_format, parse_options, &out, out_format, print_options);
+
+    if (r) {
+        free(out.method.mem.buf);
+        *strp = NULL;
+    } else {
+        *strp = out.method.mem.buf;
+    }
+    free(out.buffered);
+    return r;
+}
+
+API int
+lyd_transcode_fd(struct ly_ctx *ctx, const char *data, LYD_FORMAT in_format, int parse_options, int fd,
+                 LYD_FORMAT out_format, int print_options)
+{
+    int r;
+    struct lyout out;
+
+    if (fd < 0) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    memset(&out, 0, sizeof out);
+
+    out.type = LYOUT_FD;
+    out.method.fd = fd;
+
+    r = lyd_transcode_(ctx, data, in_format, parse_options, &out, out_format, print_options);
+
+    if (ly_print_flush(&out) && !r) {
+        LOGERR(ctx, LY_ESYS, "Print error (%s).", strerror(errno));
+        r = EXIT_FAILURE;
+    }
+    free(out.fd_buf);
+    free(out.buffered);
+    return r;
+}
+
+API int
+lyd_transcode_clb(struct ly_ctx *ctx, const char *data, LYD_FORMAT in_format, int parse_options,
+                  ssize_t (*writeclb)(void *arg, const void *buf, size_t count), void *arg,
+                  LYD_FORMAT out_format, int print_options)
+{
+    int r;
+    struct lyout out;
+
+    if (!writeclb) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    memset(&out, 0, sizeof out);
+
+    out.type = LYOUT_CALLBACK;
+    out.method.clb.f = writeclb;
+    out.method.clb.arg = arg;
+
+    r = lyd_transcode_(ctx, data, in_format, parse_options, &out, out_format, print_options);
+
+    free(out.buffered);
+    return r;
+}
+
 static int
 lyd_wd_toprint(const struct lyd_node *node, int options)
 {
@@ -49,8 +49,22 @@ struct lyout {
 
     /* hole counter */
     size_t hole_count;
+
+    /* small writes into a file descriptor gathered for a single writev() */
+    char *fd_buf;
+    size_t fd_buf_len;
+
+    /* parallel printing, see ly_print_subtree() */
+    struct lyp_par *par;              /**< deferred subtrees are collected instead of printed (main output only) */
+    void *par_data;                   /**< printer-specific data kept between the subtrees printed into this output */
+    void (*par_data_free)(void *data);
 };
 
+/**
+ * @brief Callback printing a single data subtree.
+ */
+typedef int (*lyp_subtree_clb)(struct lyout *out, int level, const struct lyd_node *node, int toplevel, int options);
+
 struct ext_substmt_info_s {
     const char *name;
     const char *arg;
@@ -71,11 +85,21 @@ extern struct ext_substmt_info_s ext_substmt_info[];
  * @brief Generic printer, replacement for printf() / write() / etc
  */
 int ly_print(struct lyout *out, const char *format, ...);
-void ly_print_flush(struct lyout *out);
+int ly_print_flush(struct lyout *out);
 int ly_write(struct lyout *out, const char *buf, size_t count);
 int ly_write_skip(struct lyout *out, size_t count, size_t *position);
 int ly_write_skipped(struct lyout *out, size_t position, const char *buf, size_t count);
 
+/**
+ * @brief Print a data subtree, it may be deferred and printed by another thread in case of #LYP_PARALLEL.
+ *
+ * The subtree must not depend on anything printed before or after it into the output.
+ *
+ * @return EXIT_SUCCESS or EXIT_FAILURE of \p clb, deferred printing always succeeds here.
+ */
+int ly_print_subtree(struct lyout *out, lyp_subtree_clb clb, int level, const struct lyd_node *node, int toplevel,
+                     int options);
+
 /* prefix_kind: 0 - print import prefixes for foreign features, 1 - print module names, 2 - print prefixes (tree printer), 3 - print module names including revisions (JSONS printer) */
 int ly_print_iffeature(struct lyout *out, const struct lys_module *module, struct lys_iffeature *expr, int prefix_kind);
 
@@ -86,8 +110,52 @@ int info_print_model(struct lyout *out, const struct lys_module *module, const c
 int jsons_print_model(struct lyout *out, const struct lys_module *module, const char *target_schema_path);
 
 int json_print_data(struct lyout *out, const struct lyd_node *root, int options);
+
+/**
+ * @brief JSON printer of the data read by a chunk reader, see lyp_chunk_reader_init().
+ */
+struct json_chunk_printer;
+
+/**
+ * @brief Create a JSON chunk printer and print the top-level begin-object.
+ *
+ * @return Printer to free with json_print_chunks_free(), NULL on error.
+ */
+struct json_chunk_printer *json_print_chunks_begin(struct lyout *out, int options);
+
+/**
+ * @brief Print the data of a chunk reader event, instances of a list or a leaf-list split into several chunks
+ * are printed in a single array.
+ */
+int json_print_chunk(struct json_chunk_printer *jp, int event, const struct lyd_node *node);
+
+/**
+ * @brief Print the top-level end-object, all the opened nodes must be closed.
+ */
+int json_print_chunks_end(struct json_chunk_printer *jp);
+void json_print_chunks_free(struct json_chunk_printer *jp);
+
 int xml_print_data(struct lyout *out, const struct lyd_node *root, int options);
+
+/**
+ * @brief Print a data node into XML.
+ *
+ * @param[in] toplevel 1 for a top-level node, 2 for a node whose parent was already printed separately (its namespaces
+ * are not known), 0 otherwise.
+ */
 int xml_print_node(struct lyout *out, int level, const struct lyd_node *node, int toplevel, int options);
+
+/**
+ * @brief Print the start tag of a container or a list instance whose children are printed separately.
+ *
+ * @param[in] toplevel See xml_print_node().
+ */
+int xml_print_open(struct lyout *out, int level, const struct lyd_node *node, int toplevel, int options);
+
+/**
+ * @brief Print the end tag of a node opened by xml_print_open().
+ */
+int xml_print_close(struct lyout *out, int level, const struct lyd_node *node);
 int lyb_print_data(struct lyout *out, const struct lyd_node *root, int options);
 
 int lys_print_target(struct lyout *out, const struct lys_module *module, const char *target_schema_path,
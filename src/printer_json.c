@@ -33,7 +33,7 @@ static int json_print_nodes(struct lyout *out, int level, const struct lyd_node
 int
 json_print_string(struct lyout *out, const char *text)
 {
-    unsigned int i, n;
+    unsigned int i, n, run;
 
     if (!text) {
         return 0;
@@ -54,8 +54,12 @@ json_print_string(struct lyout *out, const char *text)
                 n += ly_print(out, "\\\\");
                 break;
             default:
-                ly_write(out, &text[i], 1);
-                n++;
+                /* write all the following characters that need no escaping at once */
+                for (run = 1; ((unsigned char)text[i + run] >= 0x20) && (text[i + run] != '"') && (text[i + run] != '\\');
+                     ++run);
+                ly_write(out, &text[i], run);
+                n += run;
+                i += run - 1;
             }
         }
     }
@@ -296,6 +300,37 @@ json_print_container(struct lyout *out, int level, const struct lyd_node *node,
     LY_PRINT_RET(node->schema->module->ctx);
 }
 
+static int
+json_print_list_entry(struct lyout *out, int level, const struct lyd_node *list, int UNUSED(toplevel), int options)
+{
+    LY_PRINT_SET;
+
+    ly_print(out, "%*s{%s", LEVEL, INDENT, (level ? "\n" : ""));
+    if (level) {
+        ++level;
+    }
+    if (list->attr) {
+        ly_print(out, "%*s\"@\":%s{%s", LEVEL, INDENT, (level ? " " : ""), (level ? "\n" : ""));
+        if (json_print_attrs(out, (level ? level + 1 : level), list, NULL)) {
+            return EXIT_FAILURE;
+        }
+        if (list->child) {
+            ly_print(out, "%*s},%s", LEVEL, INDENT, (level ? "\n" : ""));
+        } else {
+            ly_print(out, "%*s}", LEVEL, INDENT);
+        }
+    }
+    if (json_print_nodes(out, level, list->child, 1, 0, options)) {
+        return EXIT_FAILURE;
+    }
+    if (level) {
+        --level;
+    }
+    ly_print(out, "%*s}", LEVEL, INDENT);
+
+    LY_PRINT_RET(list->schema->module->ctx);
+}
+
 static int
 json_print_leaf_list(struct lyout *out, int level, const struct lyd_node *node, int is_list, int toplevel, int options)
 {
@@ -331,34 +366,9 @@ json_print_leaf_list(struct lyout *out, int level, const struct lyd_node *node,
     while (list) {
         if (is_list) {
             /* list print */
-            if (level) {
-                ++level;
-            }
-            ly_print(out, "%*s{%s", LEVEL, INDENT, (level ? "\n" : ""));
-            if (level) {
-                ++level;
-            }
-            if (list->attr) {
-                ly_print(out, "%*s\"@\":%s{%s", LEVEL, INDENT, (level ? " " : ""), (level ? "\n" : ""));
-                if (json_print_attrs(out, (level ? level + 1 : level), list, NULL)) {
-                    return EXIT_FAILURE;
-                }
-                if (list->child) {
-                    ly_print(out, "%*s},%s", LEVEL, INDENT, (level ? "\n" : ""));
-                } else {
-                    ly_print(out, "%*s}", LEVEL, INDENT);
-                }
-            }
-            if (json_print_nodes(out, level, list->child, 1, 0, options)) {
+            if (ly_print_subtree(out, json_print_list_entry, (level ? level + 1 : 0), list, toplevel, options)) {
                 return EXIT_FAILURE;
             }
-            if (level) {
-                --level;
-            }
-            ly_print(out, "%*s}", LEVEL, INDENT);
-            if (level) {
-                --level;
-            }
         } else {
             /* leaf-list print */
             ly_print(out, "%*s", LEVEL, INDENT);
@@ -542,10 +552,15 @@ json_print_anydataxml(struct lyout *out, int level, const struct lyd_node *node,
     LY_PRINT_RET(node->schema->module->ctx);
 }
 
+/**
+ * @brief Print data nodes as JSON object members, without the final newline.
+ *
+ * @param[in] comma_flag Whether a member was already printed and the next one must be preceded by a comma, is updated.
+ */
 static int
-json_print_nodes(struct lyout *out, int level, const struct lyd_node *root, int withsiblings, int toplevel, int options)
+json_print_siblings(struct lyout *out, int level, const struct lyd_node *root, int withsiblings, int toplevel,
+                    int options, int *comma_flag)
 {
-    int comma_flag = 0;
     const struct lyd_node *node, *iter;
 
     LY_PRINT_SET;
@@ -558,16 +573,16 @@ json_print_nodes(struct lyout *out, int level, const struct lyd_node *root, int
             case LYS_ACTION:
             case LYS_NOTIF:
             case LYS_CONTAINER:
-                if (comma_flag) {
+                if (*comma_flag) {
                     /* print the previous comma */
                     ly_print(out, ",%s", (level ? "\n" : ""));
                 }
-                if (json_print_container(out, level, node, toplevel, options)) {
+                if (ly_print_subtree(out, json_print_container, level, node, toplevel, options)) {
                     return EXIT_FAILURE;
                 }
                 break;
             case LYS_LEAF:
-                if (comma_flag) {
+                if (*comma_flag) {
                     /* print the previous comma */
                     ly_print(out, ",%s", (level ? "\n" : ""));
                 }
@@ -588,7 +603,7 @@ json_print_nodes(struct lyout *out, int level, const struct lyd_node *root, int
                     }
                 }
                 if (!iter->next || node == root) {
-                    if (comma_flag) {
+                    if (*comma_flag) {
                         /* print the previous comma */
                         ly_print(out, ",%s", (level ? "\n" : ""));
                     }
@@ -601,7 +616,7 @@ json_print_nodes(struct lyout *out, int level, const struct lyd_node *root, int
                 break;
             case LYS_ANYXML:
             case LYS_ANYDATA:
-                if (comma_flag) {
+                if (*comma_flag) {
                     /* print the previous comma */
                     ly_print(out, ",%s", (level ? "\n" : ""));
                 }
@@ -614,13 +629,25 @@ json_print_nodes(struct lyout *out, int level, const struct lyd_node *root, int
                 return EXIT_FAILURE;
             }
 
-            comma_flag = 1;
+            *comma_flag = 1;
         }
 
         if (!withsiblings) {
             break;
         }
     }
+
+    LY_PRINT_RET(root ? root->schema->module->ctx : NULL);
+}
+
+static int
+json_print_nodes(struct lyout *out, int level, const struct lyd_node *root, int withsiblings, int toplevel, int options)
+{
+    int comma_flag = 0;
+
+    if (json_print_siblings(out, level, root, withsiblings, toplevel, options, &comma_flag)) {
+        return EXIT_FAILURE;
+    }
     if (root && level) {
         ly_print(out, "\n");
     }
@@ -691,3 +718,426 @@ json_print_data(struct lyout *out, const struct lyd_node *root, int options)
     ly_print_flush(out);
     LY_PRINT_RET(NULL);
 }
+
+/**
+ * @brief Object printed by a chunk printer.
+ */
+struct json_chunk_frame {
+    int level;                          /**< level of the members */
+    int close_level;                    /**< level of the end-object */
+    int comma_flag;                     /**< member was printed */
+    int skip;                           /**< instance of a list printed as empty, nothing is printed */
+
+    const struct lys_node *arr;         /**< list or leaf-list whose array is being printed */
+    const char *arr_mod;                /**< module name printed with the array name, if any */
+    uint32_t arr_count;                 /**< printed instances of the array */
+    int arr_empty;                      /**< array printed empty, other instances are skipped */
+    uint32_t arr_nulls;                 /**< leaf-list instances without metadata not printed into arr_attrs yet */
+    struct lyout arr_attrs;             /**< leaf-list metadata array members, once some instance has any */
+
+    struct ly_set *closed;              /**< lists and leaf-lists whose arrays were already printed */
+};
+
+struct json_chunk_printer {
+    struct lyout *out;
+    int options;
+    struct json_chunk_frame *frames;
+    uint32_t count;
+    uint32_t size;
+};
+
+static struct json_chunk_frame *
+json_chunk_push(struct json_chunk_printer *jp, int level, int close_level, int skip)
+{
+    struct json_chunk_frame *frame;
+    void *mem;
+
+    if (jp->count == jp->size) {
+        mem = realloc(jp->frames, (jp->size ? jp->size * 2 : 8) * sizeof *jp->frames);
+        LY_CHECK_ERR_RETURN(!mem, LOGMEM(NULL), NULL);
+        jp->frames = mem;
+        jp->size = jp->size ? jp->size * 2 : 8;
+    }
+
+    frame = &jp->frames[jp->count];
+    memset(frame, 0, sizeof *frame);
+    frame->level = level;
+    frame->close_level = close_level;
+    frame->skip = skip;
+    frame->arr_attrs.type = LYOUT_MEMORY;
+    if (!skip) {
+        frame->closed = ly_set_new();
+        LY_CHECK_ERR_RETURN(!frame->closed, LOGMEM(NULL), NULL);
+    }
+
+    ++jp->count;
+    return frame;
+}
+
+static void
+json_chunk_pop(struct json_chunk_printer *jp)
+{
+    struct json_chunk_frame *frame = &jp->frames[--jp->count];
+
+    free(frame->arr_attrs.method.mem.buf);
+    free(frame->arr_attrs.buffered);
+    ly_set_free(frame->closed);
+}
+
+static int
+json_chunk_arr_close(struct json_chunk_printer *jp, struct json_chunk_frame *frame)
+{
+    struct lyout *out = jp->out;
+    int level = frame->level;
+
+    LY_PRINT_SET;
+
+    if (!frame->arr) {
+        return EXIT_SUCCESS;
+    }
+
+    if (!frame->arr_empty) {
+        ly_print(out, "%s%*s]", (level ? "\n" : ""), LEVEL, INDENT);
+    }
+
+    /* leaf-list attributes */
+    if (frame->arr_attrs.method.mem.len) {
+        if (frame->arr_mod) {
+            ly_print(out, ",%s%*s\"@%s:%s\":%s[%s", (level ? "\n" : ""), LEVEL, INDENT, frame->arr_mod,
+                     frame->arr->name, (level ? " " : ""), (level ? "\n" : ""));
+        } else {
+            ly_print(out, ",%s%*s\"@%s\":%s[%s", (level ? "\n" : ""), LEVEL, INDENT, frame->arr->name,
+                     (level ? " " : ""), (level ? "\n" : ""));
+        }
+        ly_write(out, frame->arr_attrs.method.mem.buf, frame->arr_attrs.method.mem.len);
+        ly_print(out, "%s%*s]", (level ? "\n" : ""), LEVEL, INDENT);
+        frame->arr_attrs.method.mem.len = 0;
+    }
+
+    ly_set_add(frame->closed, (void *)frame->arr, 0);
+    frame->arr = NULL;
+    frame->arr_mod = NULL;
+    frame->arr_count = 0;
+    frame->arr_empty = 0;
+    frame->arr_nulls = 0;
+
+    LY_PRINT_RET(NULL);
+}
+
+/**
+ * @brief Start printing the next instance of a list or a leaf-list, in its array.
+ *
+ * @return 0 if the instance is to be printed, 1 if it is skipped, -1 on error.
+ */
+static int
+json_chunk_arr_next(struct json_chunk_printer *jp, struct json_chunk_frame *frame, const struct lyd_node *node)
+{
+    struct lyout *out = jp->out;
+    int level = frame->level, toplevel = (frame == jp->frames);
+
+    if (frame->arr == node->schema) {
+        if (frame->arr_empty) {
+            return 1;
+        }
+        ly_print(out, ",%s", (level ? "\n" : ""));
+        return 0;
+    }
+
+    if (ly_set_contains(frame->closed, node->schema) > -1) {
+        LOGERR(node->schema->module->ctx, LY_EINVAL, "Instances of the %s \"%s\" are not adjacent, "
+               "they cannot be transcoded into JSON.", strnodetype(node->schema->nodetype), node->schema->name);
+        return -1;
+    }
+    if (json_chunk_arr_close(jp, frame)) {
+        return -1;
+    }
+
+    if (frame->comma_flag) {
+        ly_print(out, ",%s", (level ? "\n" : ""));
+    }
+    frame->comma_flag = 1;
+    frame->arr = node->schema;
+    if (toplevel || !node->parent || nscmp(node, node->parent)) {
+        /* print "namespace" */
+        frame->arr_mod = lys_node_module(node->schema)->name;
+        ly_print(out, "%*s\"%s:%s\":", LEVEL, INDENT, frame->arr_mod, node->schema->name);
+    } else {
+        ly_print(out, "%*s\"%s\":", LEVEL, INDENT, node->schema->name);
+    }
+
+    if ((node->schema->nodetype == LYS_LIST) && !node->child) {
+        /* empty, e.g. in case of filter */
+        ly_print(out, "%s[]", (level ? " " : ""));
+        frame->arr_empty = 1;
+        return 1;
+    }
+    ly_print(out, "%s[%s", (level ? " " : ""), (level ? "\n" : ""));
+    return 0;
+}
+
+static int
+json_chunk_leaf_list_item(struct json_chunk_printer *jp, struct json_chunk_frame *frame, const struct lyd_node *node)
+{
+    struct lyout *out = &frame->arr_attrs;
+    int level = (frame->level ? frame->level + 1 : 0);
+
+    ly_print(jp->out, "%*s", LEVEL, INDENT);
+    if (json_print_leaf(jp->out, level, node, 1, (frame == jp->frames), jp->options)) {
+        return EXIT_FAILURE;
+    }
+
+    /* attributes are printed after the array */
+    if (!node->attr && !out->method.mem.len) {
+        ++frame->arr_nulls;
+        return EXIT_SUCCESS;
+    }
+    for (; frame->arr_nulls; --frame->arr_nulls) {
+        if (out->method.mem.len) {
+            ly_print(out, ",%s", (level ? "\n" : ""));
+        }
+        ly_print(out, "%*snull", LEVEL, INDENT);
+    }
+    if (out->method.mem.len) {
+        ly_print(out, ",%s", (level ? "\n" : ""));
+    }
+    if (node->attr) {
+        ly_print(out, "%*s{%s", LEVEL, INDENT, (level ? " " : ""));
+        if (json_print_attrs(out, 0, node, NULL)) {
+            return EXIT_FAILURE;
+        }
+        ly_print(out, "%*s}", LEVEL, INDENT);
+    } else {
+        ly_print(out, "%*snull", LEVEL, INDENT);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int
+json_chunk_nodes(struct json_chunk_printer *jp, const struct lyd_node *root)
+{
+    struct json_chunk_frame *frame = &jp->frames[jp->count - 1];
+    struct lyout *out = jp->out;
+    const struct lyd_node *node;
+    int level = frame->level, toplevel = (frame == jp->frames), r;
+
+    LY_PRINT_SET;
+
+    if (frame->skip) {
+        return EXIT_SUCCESS;
+    }
+
+    LY_TREE_FOR(root, node) {
+        if (!lyd_node_should_print(node, jp->options)) {
+            continue;
+        }
+
+        if (node->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) {
+            r = json_chunk_arr_next(jp, frame, node);
+            if (r == -1) {
+                return EXIT_FAILURE;
+            } else if (r) {
+                continue;
+            }
+
+            if (node->schema->nodetype == LYS_LIST) {
+                r = ly_print_subtree(out, json_print_list_entry, (level ? level + 1 : 0), node, toplevel, jp->options);
+            } else {
+                r = json_chunk_leaf_list_item(jp, frame, node);
+            }
+            if (r) {
+                return EXIT_FAILURE;
+            }
+            continue;
+        }
+
+        if (json_chunk_arr_close(jp, frame)) {
+            return EXIT_FAILURE;
+        }
+        if (frame->comma_flag) {
+            /* print the previous comma */
+            ly_print(out, ",%s", (level ? "\n" : ""));
+        }
+        switch (node->schema->nodetype) {
+        case LYS_CONTAINER:
+            r = ly_print_subtree(out, json_print_container, level, node, toplevel, jp->options);
+            break;
+        case LYS_LEAF:
+            r = json_print_leaf(out, level, node, 0, toplevel, jp->options);
+            break;
+        case LYS_ANYXML:
+        case LYS_ANYDATA:
+            r = json_print_anydataxml(out, level, node, toplevel, jp->options);
+            break;
+        default:
+            LOGINT(node->schema->module->ctx);
+            r = EXIT_FAILURE;
+            break;
+        }
+        if (r) {
+            return EXIT_FAILURE;
+        }
+        frame->comma_flag = 1;
+    }
+
+    LY_PRINT_RET(root->schema->module->ctx);
+}
+
+static int
+json_chunk_open(struct json_chunk_printer *jp, const struct lyd_node *node)
+{
+    struct json_chunk_frame *frame = &jp->frames[jp->count - 1];
+    struct lyout *out = jp->out;
+    int level = frame->level, close_level, r;
+
+    LY_PRINT_SET;
+
+    if (frame->skip || !lyd_node_should_print(node, jp->options)) {
+        return json_chunk_push(jp, 0, 0, 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (node->schema->nodetype == LYS_LIST) {
+        /* the node children are not known yet, so it is never printed as an empty list */
+        r = json_chunk_arr_next(jp, frame, node);
+        if (r == -1) {
+            return EXIT_FAILURE;
+        } else if (r) {
+            return json_chunk_push(jp, 0, 0, 1) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        if (level) {
+            ++level;
+        }
+        ly_print(out, "%*s{%s", LEVEL, INDENT, (level ? "\n" : ""));
+    } else {
+        if (json_chunk_arr_close(jp, frame)) {
+            return EXIT_FAILURE;
+        }
+        if (frame->comma_flag) {
+            ly_print(out, ",%s", (level ? "\n" : ""));
+        }
+        frame->comma_flag = 1;
+
+        if ((frame == jp->frames) || !node->parent || nscmp(node, node->parent)) {
+            /* print "namespace" */
+            ly_print(out, "%*s\"%s:%s\":%s{%s", LEVEL, INDENT, lys_node_module(node->schema)->name, node->schema->name,
+                     (level ? " " : ""), (level ? "\n" : ""));
+        } else {
+            ly_print(out, "%*s\"%s\":%s{%s", LEVEL, INDENT, node->schema->name, (level ? " " : ""), (level ? "\n" : ""));
+        }
+    }
+
+    close_level = level;
+    if (level) {
+        ++level;
+    }
+    frame = json_chunk_push(jp, level, close_level, 0);
+    if (!frame) {
+        return EXIT_FAILURE;
+    }
+
+    if (node->attr) {
+        ly_print(out, "%*s\"@\":%s{%s", LEVEL, INDENT, (level ? " " : ""), (level ? "\n" : ""));
+        if (json_print_attrs(out, (level ? level + 1 : level), node, NULL)) {
+            return EXIT_FAILURE;
+        }
+        ly_print(out, "%*s}", LEVEL, INDENT);
+        frame->comma_flag = 1;
+    }
+
+    LY_PRINT_RET(node->schema->module->ctx);
+}
+
+static int
+json_chunk_close(struct json_chunk_printer *jp)
+{
+    struct json_chunk_frame *frame = &jp->frames[jp->count - 1];
+    struct lyout *out = jp->out;
+    int level;
+
+    LY_PRINT_SET;
+
+    if (!frame->skip) {
+        if (json_chunk_arr_close(jp, frame)) {
+            return EXIT_FAILURE;
+        }
+        if (frame->comma_flag && frame->level) {
+            ly_print(out, "\n");
+        }
+        level = frame->close_level;
+        ly_print(out, "%*s}", LEVEL, INDENT);
+    }
+    json_chunk_pop(jp);
+
+    LY_PRINT_RET(NULL);
+}
+
+struct json_chunk_printer *
+json_print_chunks_begin(struct lyout *out, int options)
+{
+    struct json_chunk_printer *jp;
+
+    jp = calloc(1, sizeof *jp);
+    LY_CHECK_ERR_RETURN(!jp, LOGMEM(NULL), NULL);
+    jp->out = out;
+    jp->options = options;
+
+    if (!json_chunk_push(jp, (options & LYP_FORMAT ? 1 : 0), 0, 0)) {
+        json_print_chunks_free(jp);
+        return NULL;
+    }
+
+    ly_print(out, "{%s", (options & LYP_FORMAT ? "\n" : ""));
+    return jp;
+}
+
+int
+json_print_chunk(struct json_chunk_printer *jp, int event, const struct lyd_node *node)
+{
+    switch (event) {
+    case LYD_CHUNK_OPEN:
+        return json_chunk_open(jp, node);
+    case LYD_CHUNK_NODES:
+        return json_chunk_nodes(jp, node);
+    case LYD_CHUNK_CLOSE:
+        return json_chunk_close(jp);
+    default:
+        LOGINT(NULL);
+        return EXIT_FAILURE;
+    }
+}
+
+int
+json_print_chunks_end(struct json_chunk_printer *jp)
+{
+    struct json_chunk_frame *frame = jp->frames;
+
+    LY_PRINT_SET;
+
+    assert(jp->count == 1);
+
+    if (json_chunk_arr_close(jp, frame)) {
+        return EXIT_FAILURE;
+    }
+    if (frame->comma_flag && frame->level) {
+        ly_print(jp->out, "\n");
+    }
+    ly_print(jp->out, "}%s", (jp->options & LYP_FORMAT ? "\n" : ""));
+
+    ly_print_flush(jp->out);
+    LY_PRINT_RET(NULL);
+}
+
+void
+json_print_chunks_free(struct json_chunk_printer *jp)
+{
+    if (!jp) {
+        return;
+    }
+
+    while (jp->count) {
+        json_chunk_pop(jp);
+    }
+    free(jp->frames);
+    free(jp);
+}
@@ -1056,6 +1056,46 @@ lyb_print_subtree(struct lyout *out, const struct lyd_node *node, struct hash_ta
     return ret;
 }
 
+static void
+lyb_print_state_clean(struct lyb_state *lybs)
+{
+    int i;
+
+    free(lybs->written);
+    free(lybs->position);
+    free(lybs->inner_chunks);
+    for (i = 0; i < lybs->sib_ht_count; ++i) {
+        lyht_free(lybs->sib_ht[i].ht);
+    }
+    free(lybs->sib_ht);
+}
+
+static void
+lyb_print_state_free(void *lybs)
+{
+    lyb_print_state_clean(lybs);
+    free(lybs);
+}
+
+/* top-level subtree printed on its own, the state with the sibling hash tables is kept in the output */
+static int
+lyb_print_top_subtree(struct lyout *out, int UNUSED(level), const struct lyd_node *node, int UNUSED(toplevel),
+                      int UNUSED(options))
+{
+    struct lyb_state *lybs = out->par_data;
+    struct hash_table *top_sibling_ht = NULL;
+
+    if (!lybs) {
+        lybs = calloc(1, sizeof *lybs);
+        LY_CHECK_ERR_RETURN(!lybs, LOGMEM(lyd_node_module(node)->ctx), EXIT_FAILURE);
+        lybs->ctx = lyd_node_module(node)->ctx;
+        out->par_data = lybs;
+        out->par_data_free = lyb_print_state_free;
+    }
+
+    return (lyb_print_subtree(out, node, &top_sibling_ht, lybs, 1) < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
 int
 lyb_print_data(struct lyout *out, const struct lyd_node *root, int options)
 {
@@ -1106,10 +1146,18 @@ lyb_print_data(struct lyout *out, const struct lyd_node *root, int options)
             prev_mod = lyd_node_module(root);
         }
 
-        ret += (r = lyb_print_subtree(out, root, &top_sibling_ht, &lybs, 1));
-        if (r < 0) {
-            rc = EXIT_FAILURE;
-            goto finish;
+        if (out->par) {
+            /* the subtree may be printed concurrently */
+            if (ly_print_subtree(out, lyb_print_top_subtree, 0, root, 1, options)) {
+                rc = EXIT_FAILURE;
+                goto finish;
+            }
+        } else {
+            ret += (r = lyb_print_subtree(out, root, &top_sibling_ht, &lybs, 1));
+            if (r < 0) {
+                rc = EXIT_FAILURE;
+                goto finish;
+            }
         }
 
         if (!(options & LYP_WITHSIBLINGS)) {
@@ -1124,13 +1172,7 @@ lyb_print_data(struct lyout *out, const struct lyd_node *root, int options)
     }
 
 finish:
-    free(lybs.written);
-    free(lybs.position);
-    free(lybs.inner_chunks);
-    for (r = 0; r < lybs.sib_ht_count; ++r) {
-        lyht_free(lybs.sib_ht[r].ht);
-    }
-    free(lybs.sib_ht);
+    lyb_print_state_clean(&lybs);
 
     return rc;
 }
@@ -325,7 +325,7 @@ xml_print_leaf(struct lyout *out, int level, const struct lyd_node *node, int to
 
     LY_PRINT_SET;
 
-    if (toplevel || !node->parent || nscmp(node, node->parent)) {
+    if ((toplevel == 1) || !node->parent || nscmp(node, node->parent)) {
         /* print "namespace" */
         ns = lyd_node_module(node)->ns;
         ly_print(out, "%*s<%s xmlns=\"%s\"", LEVEL, INDENT, node->schema->name, ns);
@@ -473,7 +473,7 @@ xml_print_container(struct lyout *out, int level, const struct lyd_node *node, i
 
     LY_PRINT_SET;
 
-    if (toplevel || !node->parent || nscmp(node, node->parent)) {
+    if ((toplevel == 1) || !node->parent || nscmp(node, node->parent)) {
         /* print "namespace" */
         ns = lyd_node_module(node)->ns;
         ly_print(out, "%*s<%s xmlns=\"%s\"", LEVEL, INDENT, node->schema->name, ns);
@@ -497,7 +497,7 @@ xml_print_container(struct lyout *out, int level, const struct lyd_node *node, i
     ly_print(out, ">%s", level ? "\n" : "");
 
     LY_TREE_FOR(node->child, child) {
-        if (xml_print_node(out, level ? level + 1 : 0, child, 0, options)) {
+        if (ly_print_subtree(out, xml_print_node, level ? level + 1 : 0, child, 0, options)) {
             return EXIT_FAILURE;
         }
     }
@@ -519,7 +519,7 @@ xml_print_list(struct lyout *out, int level, const struct lyd_node *node, int is
 
     if (is_list) {
         /* list print */
-        if (toplevel || !node->parent || nscmp(node, node->parent)) {
+        if ((toplevel == 1) || !node->parent || nscmp(node, node->parent)) {
             /* print "namespace" */
             ns = lyd_node_module(node)->ns;
             ly_print(out, "%*s<%s xmlns=\"%s\"", LEVEL, INDENT, node->schema->name, ns);
@@ -542,7 +542,7 @@ xml_print_list(struct lyout *out, int level, const struct lyd_node *node, int is
         ly_print(out, ">%s", level ? "\n" : "");
 
         LY_TREE_FOR(node->child, child) {
-            if (xml_print_node(out, level ? level + 1 : 0, child, 0, options)) {
+            if (ly_print_subtree(out, xml_print_node, level ? level + 1 : 0, child, 0, options)) {
                 return EXIT_FAILURE;
             }
         }
@@ -568,7 +568,7 @@ xml_print_anydata(struct lyout *out, int level, const struct lyd_node *node, int
 
     LY_PRINT_SET;
 
-    if (toplevel || !node->parent || nscmp(node, node->parent)) {
+    if ((toplevel == 1) || !node->parent || nscmp(node, node->parent)) {
         /* print "namespace" */
         ns = lyd_node_module(node)->ns;
         ly_print(out, "%*s<%s xmlns=\"%s\"", LEVEL, INDENT, node->schema->name, ns);
@@ -694,6 +694,46 @@ xml_print_node(struct lyout *out, int level, const struct lyd_node *node, int to
     return ret;
 }
 
+int
+xml_print_open(struct lyout *out, int level, const struct lyd_node *node, int toplevel, int options)
+{
+    const char *ns;
+    struct mlist *mlist = NULL;
+
+    LY_PRINT_SET;
+
+    if ((toplevel == 1) || !node->parent || nscmp(node, node->parent)) {
+        /* print "namespace" */
+        ns = lyd_node_module(node)->ns;
+        ly_print(out, "%*s<%s xmlns=\"%s\"", LEVEL, INDENT, node->schema->name, ns);
+    } else {
+        ly_print(out, "%*s<%s", LEVEL, INDENT, node->schema->name);
+    }
+
+    if (toplevel) {
+        /* only the namespaces of the node itself, its children print their own */
+        xml_print_ns(out, node, &mlist, options);
+        free_mlist(&mlist);
+    }
+
+    if (xml_print_attrs(out, node, options)) {
+        return EXIT_FAILURE;
+    }
+    ly_print(out, ">%s", level ? "\n" : "");
+
+    LY_PRINT_RET(node->schema->module->ctx);
+}
+
+int
+xml_print_close(struct lyout *out, int level, const struct lyd_node *node)
+{
+    LY_PRINT_SET;
+
+    ly_print(out, "%*s</%s>%s", LEVEL, INDENT, node->schema->name, level ? "\n" : "");
+
+    LY_PRINT_RET(node->schema->module->ctx);
+}
+
 int
 xml_print_data(struct lyout *out, const struct lyd_node *root, int options)
 {
@@ -748,7 +788,7 @@ xml_print_data(struct lyout *out, const struct lyd_node *root, int options)
 
     /* content */
     LY_TREE_FOR(root, node) {
-        if (xml_print_node(out, level, node, 1, options)) {
+        if (ly_print_subtree(out, xml_print_node, level, node, 1, options)) {
             return EXIT_FAILURE;
         }
         if (!(options & LYP_WITHSIBLINGS)) {
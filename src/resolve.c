@@ -5866,7 +5866,13 @@ search_base_identity(struct lys_ident *der, struct lys_ident *base)
 
     if (der == base) {
         return 1;
+    }
+
+    i = ly_ctx_ident_derived(der->module->ctx, der, base);
+    if (i > -1) {
+        return i;
     } else {
+        /* not indexed yet, walk the bases */
         for(i = 0; i < der->base_size; i++) {
             if (search_base_identity(der->base[i], base) == 1) {
                 return 1;
@@ -5895,7 +5901,7 @@ resolve_identref(struct lys_type *type, const char *ident_name, struct lyd_node
     int mod_name_len, nam_len, rc;
     int need_implemented = 0;
     unsigned int i, j, found;
-    struct lys_ident *der = NULL, *cur;
+    struct lys_ident *der = NULL, *cur, *ident;
     struct lys_module *imod = NULL, *m, *tmod;
     struct ly_ctx *ctx;
 
@@ -6041,9 +6047,20 @@ resolve_identref(struct lys_type *type, const char *ident_name, struct lyd_node
 
     /* go through all the derived types of all the bases */
     found = 0;
+    ident = ly_ctx_ident_find(ctx, imod, name, nam_len);
     for (i = 0; i < type->info.ident.count; ++i) {
         cur = type->info.ident.ref[i];
-        if (cur->der) {
+        rc = ident ? ly_ctx_ident_derived(ctx, ident, cur) : -1;
+        if (rc > -1) {
+            /* indexed identity */
+            if (rc) {
+                der = ident;
+                ++found;
+            } else if (!cur->der) {
+                LOGWRN(ctx, "Identity \"%s\" has no derived identities, identityref with this base can never be instatiated.",
+                       cur->name);
+            }
+        } else if (cur->der) {
             /* there are some derived identities */
             for (j = 0; j < cur->der->number; j++) {
                 der = (struct lys_ident *)cur->der->set.g[j]; /* shortcut */
@@ -6751,11 +6768,9 @@ resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_wh
     memset(&set, 0, sizeof set);
 
     if (!(node->schema->nodetype & (LYS_NOTIF | LYS_RPC | LYS_ACTION)) && snode_get_when(node->schema)) {
-        /* make the node dummy for the evaluation */
-        node->validity |= LYD_VAL_INUSE;
+        /* the node is dummy for the evaluation */
         rc = lyxp_eval(snode_get_when(node->schema)->cond, node, LYXP_NODE_ELEM, lyd_node_module(node),
-                       &set, LYXP_WHEN);
-        node->validity &= ~LYD_VAL_INUSE;
+                       &set, LYXP_WHEN | LYXP_DUMMY_CTX);
         if (rc) {
             if (rc == 1) {
                 LOGVAL(ctx, LYE_INWHEN, LY_VLOG_LYD, node, snode_get_when(node->schema)->cond);
@@ -7471,12 +7486,158 @@ compact_ext_list(struct ly_ctx *ctx, void *elem, LYEXT_PAR elem_type)
     return 0;
 }
 
+/* record of the unres schema index */
+struct unres_schema_rec {
+    void *item;
+    enum UNRES_ITEM type;
+    uint32_t idx;
+};
+
+static int
+unres_schema_rec_equal(void *val1_p, void *val2_p, int mod, void *UNUSED(cb_data))
+{
+    struct unres_schema_rec *rec1 = val1_p, *rec2 = val2_p;
+
+    if (mod) {
+        return rec1->idx == rec2->idx;
+    }
+    return (rec1->item == rec2->item) && (rec1->type == rec2->type);
+}
+
+static uint32_t
+unres_schema_rec_hash(void *item, enum UNRES_ITEM type)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&item, sizeof item);
+    hash = dict_hash_multi(hash, (const char *)&type, sizeof type);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Find the last unres item with the pointer and type using the index.
+ *
+ * @param[in] unres Unres schema structure to use.
+ * @param[in] max_idx Maximal index to consider.
+ * @param[in] item Item pointer.
+ * @param[in] type Item type.
+ * @param[in] match_arg Whether also the item argument and module must match.
+ * @param[in] snode Item argument.
+ * @param[in] mod Item module.
+ * @return Index of the found item, -1 if not found.
+ */
+static int
+unres_schema_find_idx(struct unres_schema *unres, uint32_t max_idx, void *item, enum UNRES_ITEM type, int match_arg,
+                      void *snode, struct lys_module *mod)
+{
+    struct unres_schema_rec rec, *match;
+    uint32_t hash;
+    int ret = -1;
+
+    if (!unres->ht) {
+        return -1;
+    }
+
+    rec.item = item;
+    rec.type = type;
+    hash = unres_schema_rec_hash(item, type);
+    if (lyht_find(unres->ht, &rec, hash, (void **)&match)) {
+        return -1;
+    }
+    do {
+        /* resolved items are not removed from the index */
+        if ((match->idx <= max_idx) && ((signed)match->idx > ret) && (unres->type[match->idx] == type)
+                && (!match_arg || ((unres->str_snode[match->idx] == snode) && (unres->module[match->idx] == mod)))) {
+            ret = match->idx;
+        }
+    } while (!lyht_find_next(unres->ht, match, hash, (void **)&match));
+
+    return ret;
+}
+
+/**
+ * @brief Reset the unres schema index, all the items were resolved.
+ *
+ * @param[in] unres Unres schema structure to use.
+ */
+static void
+unres_schema_index_clear(struct unres_schema *unres)
+{
+    lyht_free(unres->ht);
+    unres->ht = NULL;
+}
+
+/**
+ * @brief Get the unres item types whose resolution can make a forward reference of an item resolvable.
+ *
+ * @param[in] type Type of the unresolved item.
+ * @return Bitmask of the item types.
+ */
+static uint32_t
+unres_schema_deps(enum UNRES_ITEM type)
+{
+    switch (type) {
+    case UNRES_IDENT:
+    case UNRES_TYPE_IDENTREF:
+        /* base identities */
+        return UNRES_IDENT;
+    case UNRES_TYPE_DER:
+    case UNRES_TYPE_DER_TPDF:
+    case UNRES_TYPE_DER_EXT:
+        /* typedefs with their own types */
+        return UNRES_TYPE_DER | UNRES_TYPE_DER_TPDF | UNRES_TYPE_DER_EXT | UNRES_USES;
+    case UNRES_USES:
+        /* groupings are not usable until all their uses and types are resolved */
+        return UNRES_USES | UNRES_TYPE_DER | UNRES_TYPE_DER_TPDF | UNRES_TYPE_DER_EXT | UNRES_EXT;
+    case UNRES_AUGMENT:
+    case UNRES_CHOICE_DFLT:
+    case UNRES_LIST_KEYS:
+    case UNRES_LIST_UNIQ:
+        /* nodes (targets, cases, leaves) added by uses and augments */
+        return UNRES_USES | UNRES_AUGMENT;
+    case UNRES_TYPE_LEAFREF:
+        /* targets and their leafrefs */
+        return UNRES_USES | UNRES_AUGMENT | UNRES_TYPE_LEAFREF;
+    case UNRES_FEATURE:
+        return UNRES_IFFEAT;
+    case UNRES_EXT:
+        return UNRES_EXT | UNRES_USES | UNRES_AUGMENT;
+    default:
+        /* anything */
+        return UINT32_MAX;
+    }
+}
+
+/**
+ * @brief Get the stamp of the resolved items an unres item depends on.
+ *
+ * @param[in] res_kinds Counters of resolved items of every type (bit).
+ * @param[in] type Type of the unresolved item.
+ * @return Sum of the counters of all the types \p type depends on.
+ */
+static uint32_t
+unres_schema_stamp(const uint32_t *res_kinds, enum UNRES_ITEM type)
+{
+    uint32_t deps, stamp = 0;
+    int bit;
+
+    deps = unres_schema_deps(type);
+    for (bit = 0; bit < 32; ++bit) {
+        if (deps & ((uint32_t)1 << bit)) {
+            stamp += res_kinds[bit];
+        }
+    }
+
+    return stamp;
+}
+
 static int
 resolve_unres_schema_types(struct unres_schema *unres, enum UNRES_ITEM types, struct ly_ctx *ctx, int forward_ref,
                            int print_all_errors, uint32_t *resolved)
 {
-    uint32_t i, unres_count, res_count;
-    int ret = 0, rc;
+    uint32_t i, unres_count, res_count, stamp_size = 0, *stamps = NULL, *new_stamps, res_kinds[32];
+    int ret = 0, rc, bit, retry_all = 0;
+    enum UNRES_ITEM type;
     struct ly_err_item *prev_eitem;
     enum int_log_opts prev_ilo;
     LY_ERR prev_ly_errno = LY_SUCCESS;
@@ -7494,16 +7655,40 @@ resolve_unres_schema_types(struct unres_schema *unres, enum UNRES_ITEM types, st
         LY_CHECK_ERR_GOTO(!ext_parents || !ext_par_types, ret = -1, finish);
     }
 
-    do {
+    /*
+     * Every item that failed because of a forward reference remembers the stamp of the resolved items
+     * of the types it depends on and is retried only once the stamp changes. Only if nothing more
+     * can be resolved this way, all the remaining items are retried once more.
+     */
+    memset(res_kinds, 0, sizeof res_kinds);
+    while (1) {
         unres_count = 0;
         res_count = 0;
 
+        if (stamp_size < unres->count) {
+            /* new items were added (or the first round) */
+            new_stamps = realloc(stamps, unres->count * sizeof *stamps);
+            LY_CHECK_ERR_GOTO(!new_stamps, LOGMEM(ctx); ret = -1, finish);
+            stamps = new_stamps;
+            for (i = stamp_size; i < unres->count; ++i) {
+                stamps[i] = UINT32_MAX;
+            }
+            stamp_size = unres->count;
+        }
+
         for (i = 0; i < unres->count; ++i) {
             /* UNRES_TYPE_LEAFREF must be resolved (for storing leafref target pointers);
              * if-features are resolved here to make sure that we will have all if-features for
              * later check of feature circular dependency */
             if (unres->type[i] & types) {
                 ++unres_count;
+                type = unres->type[i];
+                if ((i < stamp_size) && !retry_all && (stamps[i] != UINT32_MAX)
+                        && (stamps[i] == unres_schema_stamp(res_kinds, type))) {
+                    /* nothing it depends on was resolved since the last try */
+                    continue;
+                }
+
                 rc = resolve_unres_schema_item(unres->module[i], unres->item[i], unres->type[i], unres->str_snode[i], unres);
                 if (unres->type[i] == UNRES_EXT_FINALIZE) {
                     /* to avoid double free */
@@ -7533,9 +7718,16 @@ resolve_unres_schema_types(struct unres_schema *unres, enum UNRES_ITEM types, st
 
                     ++(*resolved);
                     ++res_count;
+                    for (bit = 0; (bit < 32) && !(type & ((uint32_t)1 << bit)); ++bit);
+                    if (bit < 32) {
+                        ++res_kinds[bit];
+                    }
                 } else if ((rc == EXIT_FAILURE) && forward_ref) {
                     /* forward reference, erase errors */
                     ly_err_free_next(ctx, prev_eitem);
+                    if (i < stamp_size) {
+                        stamps[i] = unres_schema_stamp(res_kinds, type);
+                    }
                 } else if (print_all_errors) {
                     /* just so that we quit the loop */
                     ++res_count;
@@ -7549,7 +7741,21 @@ resolve_unres_schema_types(struct unres_schema *unres, enum UNRES_ITEM types, st
                 }
             }
         }
-    } while (res_count && (res_count < unres_count));
+
+        if (res_count == unres_count) {
+            /* all resolved */
+            break;
+        } else if (res_count) {
+            /* some progress, retry only the items that can be affected */
+            retry_all = 0;
+        } else if (!retry_all) {
+            /* no progress, the dependencies may be incomplete so try everything once more */
+            retry_all = 1;
+        } else {
+            /* nothing can be resolved */
+            break;
+        }
+    }
 
     if (res_count < unres_count) {
         assert(forward_ref);
@@ -7580,6 +7786,7 @@ resolve_unres_schema_types(struct unres_schema *unres, enum UNRES_ITEM types, st
     }
 
 finish:
+    free(stamps);
     ly_set_free(ext_parents);
     ly_set_free(ext_par_types);
     return ret;
@@ -7629,6 +7836,7 @@ resolve_unres_schema(struct lys_module *mod, struct unres_schema *unres)
 
     LOGVRB("All \"%s\" schema nodes and constraints resolved.", mod->name);
     unres->count = 0;
+    unres_schema_index_clear(unres);
     return EXIT_SUCCESS;
 }
 
@@ -7675,26 +7883,23 @@ unres_schema_add_node(struct lys_module *mod, struct unres_schema *unres, void *
                       struct lys_node *snode)
 {
     int rc;
-    uint32_t u;
     enum int_log_opts prev_ilo;
     struct ly_err_item *prev_eitem;
     LY_ERR prev_ly_errno;
     struct lyxml_elem *yin;
     struct lys_type *stype;
+    struct unres_schema_rec rec;
     struct ly_ctx *ctx = mod->ctx;
 
     assert(unres && (item || (type == UNRES_MOD_IMPLEMENT)) && ((type != UNRES_LEAFREF) && (type != UNRES_INSTID)
            && (type != UNRES_WHEN) && (type != UNRES_MUST)));
 
     /* check for duplicities in unres */
-    for (u = 0; u < unres->count; u++) {
-        if (unres->type[u] == type && unres->item[u] == item &&
-                unres->str_snode[u] == snode && unres->module[u] == mod) {
-            /* duplication can happen when the node contains multiple statements of the same type to check,
-             * this can happen for example when refinement is being applied, so we just postpone the processing
-             * and do not duplicate the information */
-            return EXIT_FAILURE;
-        }
+    if (unres->count && (unres_schema_find_idx(unres, unres->count - 1, item, type, 1, snode, mod) > -1)) {
+        /* duplication can happen when the node contains multiple statements of the same type to check,
+         * this can happen for example when refinement is being applied, so we just postpone the processing
+         * and do not duplicate the information */
+        return EXIT_FAILURE;
     }
 
     if ((type == UNRES_EXT_FINALIZE) || (type == UNRES_XPATH) || (type == UNRES_MOD_IMPLEMENT)) {
@@ -7774,6 +7979,18 @@ unres_schema_add_node(struct lys_module *mod, struct unres_schema *unres, void *
     LY_CHECK_ERR_RETURN(!unres->module, LOGMEM(ctx), -1);
     unres->module[unres->count-1] = mod;
 
+    /* index it */
+    if (!unres->ht) {
+        unres->ht = lyht_new(8, sizeof rec, unres_schema_rec_equal, NULL, 1);
+        LY_CHECK_ERR_RETURN(!unres->ht, LOGMEM(ctx), -1);
+    }
+    rec.item = item;
+    rec.type = type;
+    rec.idx = unres->count - 1;
+    if (lyht_insert(unres->ht, &rec, unres_schema_rec_hash(item, type), NULL) == -1) {
+        return -1;
+    }
+
     return rc;
 }
 
@@ -7855,20 +8072,19 @@ unres_schema_find(struct unres_schema *unres, int start_on_backwards, void *item
     } else {
         i = unres->count - 1;
     }
+    if (type != UNRES_LIST_UNIQ) {
+        return unres_schema_find_idx(unres, i, item, type, 0, NULL, NULL);
+    }
+
+    /* items are compared by their content */
     for (; i > -1; i--) {
         if (unres->type[i] != type) {
             continue;
         }
-        if (type != UNRES_LIST_UNIQ) {
-            if (unres->item[i] == item) {
-                break;
-            }
-        } else {
-            aux_uniq1 = (struct unres_list_uniq *)unres->item[i];
-            aux_uniq2 = (struct unres_list_uniq *)item;
-            if ((aux_uniq1->list == aux_uniq2->list) && ly_strequal(aux_uniq1->expr, aux_uniq2->expr, 0)) {
-                break;
-            }
+        aux_uniq1 = (struct unres_list_uniq *)unres->item[i];
+        aux_uniq2 = (struct unres_list_uniq *)item;
+        if ((aux_uniq1->list == aux_uniq2->list) && ly_strequal(aux_uniq1->expr, aux_uniq2->expr, 0)) {
+            break;
         }
     }
 
@@ -7953,6 +8169,7 @@ unres_schema_free(struct lys_module *module, struct unres_schema **unres, int al
         free((*unres)->type);
         free((*unres)->str_snode);
         free((*unres)->module);
+        unres_schema_index_clear(*unres);
         free((*unres));
         (*unres) = NULL;
     }
@@ -8342,8 +8559,8 @@ resolve_union(struct lyd_node_leaf_list *leaf, struct lys_type *type, int store,
  *
  * @return EXIT_SUCCESS on success, EXIT_FAILURE on forward reference, -1 on error.
  */
-int
-resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_fail, int multi_error,
+static int
+resolve_unres_data_item_(struct lyd_node *node, enum UNRES_ITEM type, int ignore_fail, int multi_error,
         struct lys_when **failed_when)
 {
     int rc, req_inst, ext_dep;
@@ -8463,6 +8680,39 @@ resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_
     return EXIT_SUCCESS;
 }
 
+int
+resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_fail, int multi_error,
+        struct lys_when **failed_when)
+{
+    int rc;
+    uint64_t prof;
+    LY_PROF_PHASE phase;
+
+    LY_PROF_START(prof);
+    rc = resolve_unres_data_item_(node, type, ignore_fail, multi_error, failed_when);
+    if (prof) {
+        switch (type) {
+        case UNRES_WHEN:
+            phase = LY_PROF_WHEN;
+            break;
+        case UNRES_MUST:
+        case UNRES_MUST_INOUT:
+            phase = LY_PROF_MUST;
+            break;
+        case UNRES_UNIQ_LEAVES:
+            phase = LY_PROF_UNIQUE;
+            break;
+        default:
+            /* UNRES_LEAFREF, UNRES_INSTID, UNRES_UNION */
+            phase = LY_PROF_LEAFREF;
+            break;
+        }
+        ly_prof_end(phase, prof);
+    }
+
+    return rc;
+}
+
 /**
  * @brief add data unres item
  *
@@ -8569,6 +8819,7 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
     enum int_log_opts prev_ilo;
     struct ly_err_item *prev_eitem;
     LY_ERR prev_ly_errno = ly_errno;
+    int prev_defer_path = log_defer_path;
     struct lyd_node *parent;
     struct lys_when *when;
 
@@ -8593,6 +8844,8 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
     if (!ignore_fail) {
         /* remember logging state only if errors are generated and valid */
         ly_ilo_change(ctx, ILO_STORE, &prev_ilo, &prev_eitem);
+        /* most of the errors are discarded (forward references), do not waste time on their paths */
+        log_defer_path = 1;
     }
 
     /*
@@ -8711,6 +8964,10 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
         goto error;
     }
 
+    if (del_items && !ignore_fail) {
+        /* all the when-stmt were resolved so there are no relevant errors, but their nodes may be freed now */
+        ly_err_free_next(ctx, prev_eitem);
+    }
     for (i = 0; del_items && i < unres->count; i++) {
         /* we had some when-stmt resulted to false, so now we have to sanitize the unres list */
         if (unres->type[i] != UNRES_DELETE) {
@@ -8740,6 +8997,7 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
         assert(!ignore_fail);
         ignore_fail = 1;
 
+        log_defer_path = prev_defer_path;
         ly_ilo_restore(ctx, prev_ilo, prev_eitem, 0);
         ly_errno = prev_ly_errno;
     }
@@ -8779,6 +9037,7 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
 
     if (!ignore_fail) {
         /* log normally now, throw away irrelevant errors */
+        log_defer_path = prev_defer_path;
         ly_ilo_restore(ctx, prev_ilo, prev_eitem, 0);
         ly_errno = prev_ly_errno;
     }
@@ -8813,6 +9072,7 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
 error:
     if (!ignore_fail) {
         /* print all the new errors */
+        log_defer_path = prev_defer_path;
         ly_ilo_restore(ctx, prev_ilo, prev_eitem, 1);
         /* do not restore ly_errno, it was udpated properly */
     }
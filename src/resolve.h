@@ -109,6 +109,7 @@ struct unres_schema {
     void **str_snode;       /* array of pointers, each is determined by the type (a string, a lys_node *, or NULL) */
     struct lys_module **module; /* array of pointers to the item's module */
     uint32_t count;         /* count of unres items */
+    struct hash_table *ht;  /* (struct unres_schema_rec) index of the items by their pointer and type */
 };
 
 struct len_ran_intv {
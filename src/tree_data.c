@@ -45,6 +45,8 @@ static struct lyd_node *lyd_dup_withsiblings_to_ctx(const struct lyd_node *node,
 static struct lyd_node *lyd_new_dummy(struct lyd_node *root, struct lyd_node *parent, const struct lys_node *schema,
                                       const char *value, int dflt);
 
+static void lyd_wd_free_dflt(struct lyd_node **first);
+
 static int
 lyd_anydata_equal(struct lyd_node *first, struct lyd_node *second)
 {
@@ -467,6 +469,52 @@ lyd_insert_hash(struct lyd_node *node)
     _lyd_insert_hash(node, 1);
 }
 
+/* parser finished the node with all its (already hashed) children linked but not inserted into the hash table */
+int
+lyd_insert_hash_bulk(struct lyd_node *node)
+{
+    struct lyd_node *iter;
+    uint32_t count, size;
+
+    if (!(node->schema->nodetype & (LYS_CONTAINER | LYS_LIST | LYS_RPC | LYS_ACTION | LYS_NOTIF))) {
+        return EXIT_SUCCESS;
+    }
+
+    if (node->schema->nodetype == LYS_LIST) {
+        /* all the keys (or descendants of a key-less list) are present now */
+        lyd_hash(node);
+    }
+
+    count = 0;
+    LY_TREE_FOR(node->child, iter) {
+        if ((iter->schema->nodetype != LYS_LIST) || lyd_list_has_keys(iter)) {
+            ++count;
+        }
+    }
+    if (count < LY_CACHE_HT_MIN_CHILDREN) {
+        return EXIT_SUCCESS;
+    }
+
+    /* create the hash table big enough so that it is never resized while filling it */
+    assert(!node->ht);
+    for (size = LYHT_MIN_SIZE; (count * 100) / size >= LYHT_ENLARGE_PERCENTAGE; size <<= 1);
+    node->ht = lyht_new(size, sizeof(struct lyd_node *), lyd_hash_table_val_equal, NULL, 1);
+    LY_CHECK_ERR_RETURN(!node->ht, LOGMEM(node->schema->module->ctx), EXIT_FAILURE);
+
+    LY_TREE_FOR(node->child, iter) {
+        if ((iter->schema->nodetype == LYS_LIST) && !lyd_list_has_keys(iter)) {
+            /* skip lists without keys */
+            continue;
+        }
+
+        if (lyht_insert(node->ht, &iter, iter->hash, NULL)) {
+            assert(0);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
 static void
 _lyd_unlink_hash(struct lyd_node *node, struct lyd_node *orig_parent, int keyless_list_check)
 {
@@ -594,8 +642,105 @@ lyd_is_when_false(struct lyd_node *root, struct lyd_node *last_parent, struct ly
     return 0;
 }
 
+/**
+ * @brief Instances of a single schema node among data siblings.
+ */
+struct lyd_mand_inst {
+    const struct lys_node *schema; /**< schema node of the instances */
+    struct lyd_node *first;        /**< first instance */
+    uint32_t count;                /**< number of instances */
+};
+
+/**
+ * @brief Instances of data siblings grouped by their schema nodes, collected in a single pass over the siblings
+ * so that the mandatory checks do not need to search the siblings for every schema node.
+ */
+struct lyd_mand_children {
+    struct lyd_mand_inst *inst;    /**< array of the instance groups in the order of the first instances */
+    uint32_t count;                /**< number of used items in #inst */
+    uint32_t size;                 /**< allocated size of #inst */
+    uint32_t last;                 /**< index of the last found item, the next search starts after it */
+};
+
+/**
+ * @brief Group the data siblings by their schema nodes.
+ *
+ * @param[in] first First sibling to process (all the following siblings are processed).
+ * @param[out] children Structure to fill, must be zeroed.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+static int
+lyd_mand_children_fill(struct lyd_node *first, struct lyd_mand_children *children)
+{
+    struct lyd_node *iter;
+    struct lyd_mand_inst *inst = NULL;
+    uint32_t u;
+
+    LY_TREE_FOR(first, iter) {
+        /* instances of a list or leaf-list are mostly adjacent */
+        if (!inst || (inst->schema != iter->schema)) {
+            for (u = 0; (u < children->count) && (children->inst[u].schema != iter->schema); ++u);
+            if (u == children->count) {
+                if (children->count == children->size) {
+                    children->size = children->size ? children->size * 2 : 8;
+                    children->inst = ly_realloc(children->inst, children->size * sizeof *children->inst);
+                    LY_CHECK_ERR_RETURN(!children->inst, LOGMEM(iter->schema->module->ctx), EXIT_FAILURE);
+                }
+                children->inst[u].schema = iter->schema;
+                children->inst[u].first = iter;
+                children->inst[u].count = 0;
+                ++children->count;
+            }
+            inst = &children->inst[u];
+        }
+        ++inst->count;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Find the instances of a schema node among the grouped siblings. The data siblings usually follow the order
+ * of the schema nodes, so the search continues from the previous match.
+ *
+ * @return Found instances, NULL if there are none.
+ */
+static struct lyd_mand_inst *
+lyd_mand_children_find(struct lyd_mand_children *children, const struct lys_node *schema)
+{
+    uint32_t u, i;
+
+    for (u = 0; u < children->count; ++u) {
+        i = (children->last + u) % children->count;
+        if (children->inst[i].schema == schema) {
+            children->last = i + 1;
+            return &children->inst[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Get the instance of \p inst with the index \p idx.
+ */
+static struct lyd_node *
+lyd_mand_inst_get(struct lyd_mand_inst *inst, uint32_t idx)
+{
+    struct lyd_node *iter;
+
+    for (iter = inst->first; iter; iter = iter->next) {
+        if ((iter->schema == inst->schema) && !(idx--)) {
+            break;
+        }
+    }
+
+    return iter;
+}
+
 /**
  * @param[in] root Root node to be able search the data tree in case of no instance
+ * @param[in] inst Instances of \p schema, NULL if there are none.
  * @return
  *  0 - all restrictions met
  *  1 - restrictions not met
@@ -603,13 +748,13 @@ lyd_is_when_false(struct lyd_node *root, struct lyd_node *last_parent, struct ly
  */
 static int
 lyd_check_mandatory_data(struct lyd_node *root, struct lyd_node *last_parent,
-                         struct ly_set *instances, struct lys_node *schema, int options)
+                         struct lyd_mand_inst *inst, struct lys_node *schema, int options)
 {
     struct ly_ctx *ctx = schema->module->ctx;
-    uint32_t limit;
+    uint32_t limit, count = inst ? inst->count : 0;
     uint16_t status;
 
-    if (!instances->number) {
+    if (!count) {
         /* no instance in the data tree - check if the instantiating is enabled
          * (check: if-feature, when, status data in non-status data tree)
          */
@@ -632,7 +777,7 @@ lyd_check_mandatory_data(struct lyd_node *root, struct lyd_node *last_parent,
     case LYS_ANYXML:
     case LYS_ANYDATA:
         /* mandatory */
-        if ((schema->flags & LYS_MAND_TRUE) && !instances->number) {
+        if ((schema->flags & LYS_MAND_TRUE) && !count) {
             LOGVAL(ctx, LYE_MISSELEM, LY_VLOG_LYD, last_parent, schema->name,
                    last_parent ? last_parent->schema->name : lys_node_module(schema)->name);
             return EXIT_FAILURE;
@@ -641,14 +786,14 @@ lyd_check_mandatory_data(struct lyd_node *root, struct lyd_node *last_parent,
     case LYS_LIST:
         /* min-elements */
         limit = ((struct lys_node_list *)schema)->min;
-        if (limit && limit > instances->number) {
+        if (limit && limit > count) {
             LOGVAL(ctx, LYE_NOMIN, LY_VLOG_LYD, last_parent, schema->name);
             return EXIT_FAILURE;
         }
         /* max elements */
         limit = ((struct lys_node_list *)schema)->max;
-        if (limit && limit < instances->number) {
-            LOGVAL(ctx, LYE_NOMAX, LY_VLOG_LYD, instances->set.d[limit], schema->name);
+        if (limit && limit < count) {
+            LOGVAL(ctx, LYE_NOMAX, LY_VLOG_LYD, lyd_mand_inst_get(inst, limit), schema->name);
             return EXIT_FAILURE;
         }
 
@@ -657,14 +802,14 @@ lyd_check_mandatory_data(struct lyd_node *root, struct lyd_node *last_parent,
     case LYS_LEAFLIST:
         /* min-elements */
         limit = ((struct lys_node_leaflist *)schema)->min;
-        if (limit && limit > instances->number) {
+        if (limit && limit > count) {
             LOGVAL(ctx, LYE_NOMIN, LY_VLOG_LYD, last_parent, schema->name);
             return EXIT_FAILURE;
         }
         /* max elements */
         limit = ((struct lys_node_leaflist *)schema)->max;
-        if (limit && limit < instances->number) {
-            LOGVAL(ctx, LYE_NOMAX, LY_VLOG_LYD, instances->set.d[limit], schema->name);
+        if (limit && limit < count) {
+            LOGVAL(ctx, LYE_NOMAX, LY_VLOG_LYD, lyd_mand_inst_get(inst, limit), schema->name);
             return EXIT_FAILURE;
         }
         break;
@@ -677,6 +822,45 @@ lyd_check_mandatory_data(struct lyd_node *root, struct lyd_node *last_parent,
     return EXIT_SUCCESS;
 }
 
+static int lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *last_parent, struct lys_node *schema,
+                                       struct lyd_mand_children *children, int options);
+
+/**
+ * @brief Check the schema children of a data node instance for presence of mandatory nodes.
+ *
+ * @param[in] tree Data tree, needed for case that \p subtree is NULL.
+ * @param[in] subtree Data node instance, NULL if there is none.
+ * @param[in] last_parent The last present parent data node.
+ * @param[in] schema Schema node of \p subtree.
+ * @param[in] options @ref parseroptions to specify the type of the data tree.
+ * @return EXIT_SUCCESS or EXIT_FAILURE if there are missing mandatory nodes
+ */
+static int
+lyd_check_mandatory_children(struct lyd_node *tree, struct lyd_node *subtree, struct lyd_node *last_parent,
+                             struct lys_node *schema, int options)
+{
+    struct lys_node *siter;
+    struct lyd_mand_children children;
+    int ret = EXIT_FAILURE;
+
+    memset(&children, 0, sizeof children);
+    if (subtree && lyd_mand_children_fill(subtree->child, &children)) {
+        goto cleanup;
+    }
+
+    LY_TREE_FOR(schema->child, siter) {
+        if (lyd_check_mandatory_subtree(tree, last_parent, siter, &children, options)) {
+            goto cleanup;
+        }
+    }
+
+    ret = EXIT_SUCCESS;
+
+cleanup:
+    free(children.inst);
+    return ret;
+}
+
 /**
  * @brief Check the specific subtree, specified by \p schema node, for presence of mandatory nodes. Function goes
  * recursively into the subtree.
@@ -685,26 +869,22 @@ lyd_check_mandatory_data(struct lyd_node *root, struct lyd_node *last_parent,
  * - mandatory statement in leaf, choice, anyxml and anydata
  * - min-elements and max-elements in list and leaf-list
  *
- * @param[in] tree Data tree, needed for case that subtree is NULL (in case of not existing data nodes to explore)
- * @param[in] subtree Depend ons \p toplevel flag:
- *                 toplevel = 1, then subtree is ignored, instead the tree is taken to search in top level data elements (if any)
- *                 toplevel = 0, subtree is the parent data node of the possible instances of the schema node being checked
+ * @param[in] tree Data tree, needed for case that there are no data nodes to explore
  * @param[in] last_parent The last present parent data node (so it does not need to be a direct parent) of the possible
  *                 instances of the schema node being checked
  * @param[in] schema The schema node being checked for mandatory nodes
- * @param[in] toplevel, see the \p root parameter description
+ * @param[in] children Data siblings, which can include instances of \p schema, grouped by their schema nodes
  * @param[in] options @ref parseroptions to specify the type of the data tree.
  * @return EXIT_SUCCESS or EXIT_FAILURE if there are missing mandatory nodes
  */
 static int
-lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, struct lyd_node *last_parent,
-                            struct lys_node *schema, int toplevel, int options)
+lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *last_parent, struct lys_node *schema,
+                            struct lyd_mand_children *children, int options)
 {
     struct lys_node *siter, *siter_prev;
     struct lyd_node *iter;
-    struct ly_set *present = NULL;
-    unsigned int u;
-    int ret = EXIT_FAILURE;
+    struct lyd_mand_inst *inst = NULL;
+    uint32_t u;
 
     assert(schema);
 
@@ -714,17 +894,7 @@ lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, str
 
     if (schema->nodetype & (LYS_LEAF | LYS_LIST | LYS_LEAFLIST | LYS_ANYDATA | LYS_CONTAINER)) {
         /* data node */
-        present = ly_set_new();
-        if (!present) {
-            goto error;
-        }
-        if ((toplevel && tree) || (!toplevel && subtree)) {
-            if (toplevel) {
-                lyd_get_node_siblings(tree, schema, present);
-            } else {
-                lyd_get_node_siblings(subtree->child, schema, present);
-            }
-        }
+        inst = lyd_mand_children_find(children, schema);
     }
 
     switch (schema->nodetype) {
@@ -733,83 +903,80 @@ lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, str
     case LYS_ANYXML:
     case LYS_ANYDATA:
         /* check the schema item */
-        if (lyd_check_mandatory_data(tree, last_parent, present, schema, options)) {
-            goto error;
+        if (lyd_check_mandatory_data(tree, last_parent, inst, schema, options)) {
+            return EXIT_FAILURE;
         }
         break;
     case LYS_LIST:
         /* check the schema item */
-        if (lyd_check_mandatory_data(tree, last_parent, present, schema, options)) {
-            goto error;
+        if (lyd_check_mandatory_data(tree, last_parent, inst, schema, options)) {
+            return EXIT_FAILURE;
         }
 
         /* go recursively */
-        for (u = 0; u < present->number; u++) {
-            LY_TREE_FOR(schema->child, siter) {
-                if (lyd_check_mandatory_subtree(tree, present->set.d[u], present->set.d[u], siter, 0, options)) {
-                    goto error;
-                }
+        for (iter = inst ? inst->first : NULL, u = 0; inst && (u < inst->count); iter = iter->next) {
+            if (iter->schema != schema) {
+                continue;
+            }
+            if (lyd_check_mandatory_children(tree, iter, iter, schema, options)) {
+                return EXIT_FAILURE;
             }
+            ++u;
         }
         break;
 
     case LYS_CONTAINER:
-        if (present->number || !((struct lys_node_container *)schema)->presence) {
+        if (inst || !((struct lys_node_container *)schema)->presence) {
             /* if we have existing or non-presence container, go recursively */
-            LY_TREE_FOR(schema->child, siter) {
-                if (lyd_check_mandatory_subtree(tree, present->number ? present->set.d[0] : NULL,
-                                                present->number ? present->set.d[0] : last_parent,
-                                                siter, 0, options)) {
-                    goto error;
-                }
+            if (lyd_check_mandatory_children(tree, inst ? inst->first : NULL, inst ? inst->first : last_parent,
+                                             schema, options)) {
+                return EXIT_FAILURE;
             }
         }
         break;
     case LYS_CHOICE:
         /* get existing node in the data tree from the choice */
-        iter = NULL;
-        if ((toplevel && tree) || (!toplevel && subtree)) {
-            LY_TREE_FOR(toplevel ? tree : subtree->child, iter) {
-                for (siter = lys_parent(iter->schema), siter_prev = iter->schema;
-                        siter && (siter->nodetype & (LYS_CASE | LYS_USES | LYS_CHOICE));
-                        siter_prev = siter, siter = lys_parent(siter)) {
-                    if (siter == schema) {
-                        /* we have the choice instance */
-                        break;
-                    }
-                }
+        siter = siter_prev = NULL;
+        for (u = 0; u < children->count; ++u) {
+            for (siter = lys_parent(children->inst[u].schema), siter_prev = (struct lys_node *)children->inst[u].schema;
+                    siter && (siter->nodetype & (LYS_CASE | LYS_USES | LYS_CHOICE));
+                    siter_prev = siter, siter = lys_parent(siter)) {
                 if (siter == schema) {
-                    /* we have the choice instance;
-                     * the condition must be the same as in the loop because of
-                     * choice's sibling nodes that break the loop, so siter is not NULL,
-                     * but it is not the same as schema */
+                    /* we have the choice instance */
                     break;
                 }
             }
+            if (siter == schema) {
+                /* we have the choice instance;
+                 * the condition must be the same as in the loop because of
+                 * choice's sibling nodes that break the loop, so siter is not NULL,
+                 * but it is not the same as schema */
+                break;
+            }
         }
-        if (!iter) {
+        if (u == children->count) {
             if (lyd_is_when_false(tree, last_parent, schema, options)) {
                 /* nothing to check */
                 break;
             }
             if (((struct lys_node_choice *)schema)->dflt) {
                 /* there is a default case */
-                if (lyd_check_mandatory_subtree(tree, subtree, last_parent, ((struct lys_node_choice *)schema)->dflt,
-                                                toplevel, options)) {
-                    goto error;
+                if (lyd_check_mandatory_subtree(tree, last_parent, ((struct lys_node_choice *)schema)->dflt,
+                                                children, options)) {
+                    return EXIT_FAILURE;
                 }
             } else if (schema->flags & LYS_MAND_TRUE) {
                 /* choice requires some data to be instantiated */
                 LOGVAL(schema->module->ctx, LYE_NOMANDCHOICE, LY_VLOG_LYD, last_parent, schema->name);
-                goto error;
+                return EXIT_FAILURE;
             }
         } else {
             /* one of the choice's cases is instantiated, continue into this case */
-            /* since iter != NULL, siter must be also != NULL and we also know siter_prev
+            /* since the instance was found, siter must be also != NULL and we also know siter_prev
              * which points to the child of schema leading towards the instantiated data */
             assert(siter && siter_prev);
-            if (lyd_check_mandatory_subtree(tree, subtree, last_parent, siter_prev, toplevel, options)) {
-                goto error;
+            if (lyd_check_mandatory_subtree(tree, last_parent, siter_prev, children, options)) {
+                return EXIT_FAILURE;
             }
         }
         break;
@@ -825,8 +992,8 @@ lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, str
     case LYS_OUTPUT:
         /* go recursively */
         LY_TREE_FOR(schema->child, siter) {
-            if (lyd_check_mandatory_subtree(tree, subtree, last_parent, siter, toplevel, options)) {
-                goto error;
+            if (lyd_check_mandatory_subtree(tree, last_parent, siter, children, options)) {
+                return EXIT_FAILURE;
             }
         }
         break;
@@ -835,19 +1002,16 @@ lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, str
         break;
     }
 
-    ret = EXIT_SUCCESS;
-
-error:
-    ly_set_free(present);
-    return ret;
+    return EXIT_SUCCESS;
 }
 
-int
-lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, const struct lys_module **modules, int mod_count,
-                         int options)
+static int
+lyd_check_mandatory_tree_(struct lyd_node *root, struct ly_ctx *ctx, const struct lys_module **modules, int mod_count,
+                          int options)
 {
     struct lys_node *siter;
-    int i;
+    struct lyd_mand_children children;
+    int i, ret = EXIT_FAILURE;
 
     assert(root || ctx);
     assert(!(options & LYD_OPT_ACT_NOTIF));
@@ -862,17 +1026,24 @@ lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, const struct
         ctx = root->schema->module->ctx;
     }
 
+    memset(&children, 0, sizeof children);
+
     if (!(options & LYD_OPT_TYPEMASK) || (options & LYD_OPT_CONFIG)) {
+        /* top-level data nodes */
+        if (lyd_mand_children_fill(root, &children)) {
+            goto cleanup;
+        }
+
         if (options & LYD_OPT_NOSIBLINGS) {
-            if (root && lyd_check_mandatory_subtree(root, NULL, NULL, root->schema, 1, options)) {
-                return EXIT_FAILURE;
+            if (root && lyd_check_mandatory_subtree(root, NULL, root->schema, &children, options)) {
+                goto cleanup;
             }
         } else if (modules && mod_count) {
             for (i = 0; i < mod_count; ++i) {
                 LY_TREE_FOR(modules[i]->data, siter) {
                     if (!(siter->nodetype & (LYS_RPC | LYS_NOTIF)) &&
-                            lyd_check_mandatory_subtree(root, NULL, NULL, siter, 1, options)) {
-                        return EXIT_FAILURE;
+                            lyd_check_mandatory_subtree(root, NULL, siter, &children, options)) {
+                        goto cleanup;
                     }
                 }
             }
@@ -888,8 +1059,8 @@ lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, const struct
                 }
                 LY_TREE_FOR(ctx->models.list[i]->data, siter) {
                     if (!(siter->nodetype & (LYS_RPC | LYS_NOTIF)) &&
-                            lyd_check_mandatory_subtree(root, NULL, NULL, siter, 1, options)) {
-                        return EXIT_FAILURE;
+                            lyd_check_mandatory_subtree(root, NULL, siter, &children, options)) {
+                        goto cleanup;
                     }
                 }
             }
@@ -897,34 +1068,56 @@ lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, const struct
     } else if (options & LYD_OPT_NOTIF) {
         if (!root || (root->schema->nodetype != LYS_NOTIF)) {
             LOGERR(ctx, LY_EINVAL, "Subtree is not a single notification.");
-            return EXIT_FAILURE;
+            goto cleanup;
         }
-        if (root->schema->child && lyd_check_mandatory_subtree(root, root, root, root->schema, 0, options)) {
-            return EXIT_FAILURE;
+        if (root->schema->child && lyd_check_mandatory_children(root, root, root, root->schema, options)) {
+            goto cleanup;
         }
     } else if (options & (LYD_OPT_RPC | LYD_OPT_RPCREPLY)) {
         if (!root || !(root->schema->nodetype & (LYS_RPC | LYS_ACTION))) {
             LOGERR(ctx, LY_EINVAL, "Subtree is not a single RPC/action/reply.");
-            return EXIT_FAILURE;
+            goto cleanup;
         }
         if (options & LYD_OPT_RPC) {
             for (siter = root->schema->child; siter && siter->nodetype != LYS_INPUT; siter = siter->next);
         } else { /* LYD_OPT_RPCREPLY */
             for (siter = root->schema->child; siter && siter->nodetype != LYS_OUTPUT; siter = siter->next);
         }
-        if (siter && lyd_check_mandatory_subtree(root, root, root, siter, 0, options)) {
-            return EXIT_FAILURE;
+        if (siter) {
+            if (lyd_mand_children_fill(root->child, &children)
+                    || lyd_check_mandatory_subtree(root, root, siter, &children, options)) {
+                goto cleanup;
+            }
         }
     } else if (options & LYD_OPT_DATA_TEMPLATE) {
-        if (root && lyd_check_mandatory_subtree(root, NULL, NULL, root->schema, 1, options)) {
-            return EXIT_FAILURE;
+        if (lyd_mand_children_fill(root, &children)
+                || (root && lyd_check_mandatory_subtree(root, NULL, root->schema, &children, options))) {
+            goto cleanup;
         }
     } else {
         LOGINT(ctx);
-        return EXIT_FAILURE;
+        goto cleanup;
     }
 
-    return EXIT_SUCCESS;
+    ret = EXIT_SUCCESS;
+
+cleanup:
+    free(children.inst);
+    return ret;
+}
+
+int
+lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, const struct lys_module **modules, int mod_count,
+                         int options)
+{
+    int ret;
+    uint64_t prof;
+
+    LY_PROF_START(prof);
+    ret = lyd_check_mandatory_tree_(root, ctx, modules, mod_count, options);
+    LY_PROF_STOP(LY_PROF_MANDATORY, prof);
+
+    return ret;
 }
 
 static struct lyd_node *
@@ -934,6 +1127,7 @@ lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data,
     struct lyxml_elem *xml;
     struct lyd_node *result = NULL;
     int xmlopt = LYXML_PARSE_MULTIROOT;
+    uint64_t prof_tok;
 
     if (!ctx) {
         LOGARG;
@@ -948,19 +1142,13 @@ lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data,
     ly_errno = LY_SUCCESS;
     switch (format) {
     case LYD_XML:
+        LY_PROF_START(prof_tok);
         xml = lyxml_parse_mem(ctx, data, xmlopt);
+        LY_PROF_STOP(LY_PROF_TOKENIZE, prof_tok);
         if (ly_errno) {
             break;
         }
-        if (options & LYD_OPT_RPCREPLY) {
-            result = lyd_parse_xml(ctx, &xml, options, rpc_act, data_tree);
-        } else if (options & (LYD_OPT_RPC | LYD_OPT_NOTIF)) {
-            result = lyd_parse_xml(ctx, &xml, options, data_tree);
-        } else if (options & LYD_OPT_DATA_TEMPLATE) {
-            result = lyd_parse_xml(ctx, &xml, options, yang_data_name);
-        } else {
-            result = lyd_parse_xml(ctx, &xml, options);
-        }
+        result = lyd_parse_xml_(ctx, &xml, options, rpc_act, data_tree, yang_data_name);
         lyxml_free_withsiblings(ctx, xml);
         break;
     case LYD_JSON:
@@ -976,13 +1164,16 @@ lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data,
 
     if (ly_errno) {
         lyd_free_withsiblings(result);
-        return NULL;
-    }
-
-    if ((options & (LYD_OPT_RPC | LYD_OPT_RPCREPLY)) && lyd_schema_sort(result, 1)) {
+        result = NULL;
+    } else if ((options & (LYD_OPT_RPC | LYD_OPT_RPCREPLY)) && lyd_schema_sort(result, 1)) {
         /* rpc and rpc-reply must be sorted */
         lyd_free_withsiblings(result);
-        return NULL;
+        result = NULL;
+    }
+
+    if (result && (options & LYD_OPT_WD_LAZY)) {
+        /* the default nodes were needed only for the validation */
+        lyd_wd_free_dflt(&result);
     }
 
     return result;
@@ -1046,11 +1237,15 @@ lyd_parse_mem(struct ly_ctx *ctx, const char *data, LYD_FORMAT format, int optio
 
     va_list ap;
     struct lyd_node *result;
+    uint64_t prof;
+
+    LY_PROF_START(prof);
 
     va_start(ap, options);
     result = lyd_parse_data_(ctx, data, format, options, ap);
     va_end(ap);
 
+    LY_PROF_STOP(LY_PROF_PARSE, prof);
     return result;
 }
 
@@ -1060,21 +1255,28 @@ lyd_parse_fd_(struct ly_ctx *ctx, int fd, LYD_FORMAT format, int options, va_lis
     struct lyd_node *ret;
     size_t length;
     char *data;
+    uint64_t prof;
 
     if (!ctx || (fd == -1)) {
         LOGARG;
         return NULL;
     }
 
+    /* mapping the file is part of the parsing */
+    LY_PROF_START(prof);
+
     if (lyp_mmap(ctx, fd, 0, &length, (void **)&data)) {
         LOGERR(ctx, LY_ESYS, "Mapping file descriptor into memory failed (%s()).", __func__);
-        return NULL;
+        ret = NULL;
+        goto cleanup;
     }
 
     ret = lyd_parse_data_(ctx, data, format, options, ap);
 
     lyp_munmap(data, length);
 
+cleanup:
+    LY_PROF_STOP(LY_PROF_PARSE, prof);
     return ret;
 }
 
@@ -1122,58 +1324,251 @@ lyd_parse_path(struct ly_ctx *ctx, const char *path, LYD_FORMAT format, int opti
     return ret;
 }
 
-static struct lys_node *
-lyd_new_find_schema(struct lyd_node *parent, const struct lys_module *module, int rpc_output)
+/**
+ * @brief Chunk reader callback of an incremental parser, append the read top-level nodes to the parsed data tree.
+ */
+static int
+lyd_parser_chunk_clb(int event, struct lyd_node *node, void *arg)
 {
-    struct lys_node *siblings;
+    struct lyd_parser *parser = arg;
+    struct lyd_node *last;
 
-    if (!parent) {
-        siblings = module->data;
+    if ((event == LYD_CHUNK_CLOSE) || node->parent) {
+        /* the node is already linked in its parent */
+        return 0;
+    }
+
+    if (!parser->tree) {
+        parser->tree = node;
     } else {
-        if (!parent->schema) {
-            return NULL;
-        }
-        siblings = parent->schema->child;
-        if (siblings && (siblings->nodetype == (rpc_output ? LYS_INPUT : LYS_OUTPUT))) {
-            siblings = siblings->next;
-        }
-        if (siblings && (siblings->nodetype == (rpc_output ? LYS_OUTPUT : LYS_INPUT))) {
-            siblings = siblings->child;
-        }
+        last = node->prev;
+        parser->tree->prev->next = node;
+        node->prev = parser->tree->prev;
+        parser->tree->prev = last;
     }
 
-    return siblings;
+    return 0;
 }
 
-struct lyd_node *
-_lyd_new(struct lyd_node *parent, const struct lys_node *schema, int dflt)
+API struct lyd_parser *
+lyd_parser_new(struct ly_ctx *ctx, LYD_FORMAT format, int options)
 {
-    struct lyd_node *ret;
+    FUN_IN;
 
-    ret = calloc(1, sizeof *ret);
-    LY_CHECK_ERR_RETURN(!ret, LOGMEM(schema->module->ctx), NULL);
+    struct lyd_parser *parser;
 
-    ret->schema = (struct lys_node *)schema;
-    ret->validity = ly_new_node_validity(schema);
-    if (resolve_applies_when(schema, 0, NULL)) {
-        ret->when_status = LYD_WHEN;
+    if (!ctx) {
+        LOGARG;
+        return NULL;
     }
-    ret->prev = ret;
-    ret->dflt = dflt;
-
-#ifdef LY_ENABLED_CACHE
-    lyd_hash(ret);
-#endif
 
-    if (parent) {
-        if (lyd_insert(parent, ret)) {
-            lyd_free(ret);
-            return NULL;
-        }
+    if (lyp_data_check_options(ctx, options, __func__)) {
+        return NULL;
     }
-    return ret;
-}
-
+    if (options & LYD_OPT_TYPEMASK & ~(LYD_OPT_CONFIG | LYD_OPT_GET | LYD_OPT_GETCONFIG | LYD_OPT_EDIT)) {
+        LOGERR(ctx, LY_EINVAL, "%s: only data trees can be parsed incrementally.", __func__);
+        return NULL;
+    }
+    if (options & (LYD_OPT_NOSIBLINGS | LYD_OPT_VAL_DIFF)) {
+        LOGERR(ctx, LY_EINVAL, "%s: invalid options (LYD_OPT_NOSIBLINGS and LYD_OPT_VAL_DIFF are not supported).", __func__);
+        return NULL;
+    }
+    if ((format != LYD_XML) && (format != LYD_JSON) && (format != LYD_LYB)) {
+        LOGERR(ctx, LY_EINVAL, "%s: unknown data format.", __func__);
+        return NULL;
+    }
+
+    parser = calloc(1, sizeof *parser);
+    LY_CHECK_ERR_RETURN(!parser, LOGMEM(ctx), NULL);
+
+    parser->ctx = ctx;
+    parser->format = format;
+    parser->options = options;
+
+    /* the read data are validated all at once when finishing */
+    if ((format != LYD_LYB) && lyp_chunk_reader_init(&parser->reader, ctx, format,
+            options & ~LYD_OPT_DATA_ADD_YANGLIB, lyd_parser_chunk_clb, parser)) {
+        free(parser);
+        return NULL;
+    }
+
+    return parser;
+}
+
+API int
+lyd_parser_feed(struct lyd_parser *parser, const char *data, size_t len)
+{
+    FUN_IN;
+
+    char *buf;
+    size_t size, used;
+    int ret;
+
+    if (!parser || (!data && len)) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    if (parser->error) {
+        LOGERR(parser->ctx, LY_EINVAL, "%s: parsing already failed.", __func__);
+        return EXIT_FAILURE;
+    }
+
+    if (parser->len + len + 1 > parser->size) {
+        for (size = parser->size ? parser->size : 1024; size < parser->len + len + 1; size *= 2);
+        buf = realloc(parser->buf, size);
+        LY_CHECK_ERR_RETURN(!buf, LOGMEM(parser->ctx); parser->error = 1, EXIT_FAILURE);
+        parser->buf = buf;
+        parser->size = size;
+    }
+    memcpy(&parser->buf[parser->len], data, len);
+    parser->len += len;
+    parser->buf[parser->len] = '\0';
+
+    if (parser->format == LYD_LYB) {
+        /* LYB data are parsed all at once */
+        return EXIT_SUCCESS;
+    }
+
+    ret = lyp_chunk_read(&parser->reader, parser->buf, parser->len, 0, &used);
+
+    /* keep only the data not read yet */
+    memmove(parser->buf, &parser->buf[used], parser->len - used + 1);
+    parser->len -= used;
+
+    if (ret) {
+        parser->error = 1;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+API struct lyd_node *
+lyd_parser_finish(struct lyd_parser *parser)
+{
+    FUN_IN;
+
+    struct lyd_node *tree = NULL, *root, *next, *iter;
+    struct ly_ctx *ctx;
+    size_t used;
+    uint64_t prof;
+
+    if (!parser) {
+        LOGARG;
+        return NULL;
+    }
+    ctx = parser->ctx;
+
+    if (parser->error) {
+        LOGERR(ctx, LY_EINVAL, "%s: parsing already failed.", __func__);
+        goto cleanup;
+    }
+
+    if (parser->format == LYD_LYB) {
+        LY_PROF_START(prof);
+        tree = lyd_parse_(ctx, NULL, parser->buf ? parser->buf : "", LYD_LYB, parser->options, NULL, NULL);
+        LY_PROF_STOP(LY_PROF_PARSE, prof);
+        goto cleanup;
+    }
+
+    if (lyp_chunk_read(&parser->reader, parser->buf ? parser->buf : "", parser->len, 1, &used)) {
+        goto cleanup;
+    }
+
+    tree = parser->tree;
+    parser->tree = NULL;
+
+    if (!(parser->options & LYD_OPT_TRUSTED)) {
+        /* the data were read as trusted, validate everything again */
+        LY_TREE_FOR(tree, root) {
+            LY_TREE_DFS_BEGIN(root, next, iter) {
+                iter->validity = ly_new_node_validity(iter->schema);
+                if (iter->when_status & LYD_WHEN) {
+                    iter->when_status = LYD_WHEN;
+                }
+                LY_TREE_DFS_END(root, next, iter);
+            }
+        }
+    }
+    if (lyd_validate(&tree, parser->options, ctx)) {
+        lyd_free_withsiblings(tree);
+        tree = NULL;
+    }
+
+cleanup:
+    lyd_parser_free(parser);
+    return tree;
+}
+
+API void
+lyd_parser_free(struct lyd_parser *parser)
+{
+    FUN_IN;
+
+    if (!parser) {
+        return;
+    }
+
+    /* nodes not passed to the callback yet, the rest is in the tree */
+    lyp_chunk_reader_clean(&parser->reader);
+    lyd_free_withsiblings(parser->tree);
+    free(parser->buf);
+    free(parser);
+}
+
+static struct lys_node *
+lyd_new_find_schema(struct lyd_node *parent, const struct lys_module *module, int rpc_output)
+{
+    struct lys_node *siblings;
+
+    if (!parent) {
+        siblings = module->data;
+    } else {
+        if (!parent->schema) {
+            return NULL;
+        }
+        siblings = parent->schema->child;
+        if (siblings && (siblings->nodetype == (rpc_output ? LYS_INPUT : LYS_OUTPUT))) {
+            siblings = siblings->next;
+        }
+        if (siblings && (siblings->nodetype == (rpc_output ? LYS_OUTPUT : LYS_INPUT))) {
+            siblings = siblings->child;
+        }
+    }
+
+    return siblings;
+}
+
+struct lyd_node *
+_lyd_new(struct lyd_node *parent, const struct lys_node *schema, int dflt)
+{
+    struct lyd_node *ret;
+
+    ret = calloc(1, sizeof *ret);
+    LY_CHECK_ERR_RETURN(!ret, LOGMEM(schema->module->ctx), NULL);
+
+    ret->schema = (struct lys_node *)schema;
+    ret->validity = ly_new_node_validity(schema);
+    if (resolve_applies_when(schema, 0, NULL)) {
+        ret->when_status = LYD_WHEN;
+    }
+    ret->prev = ret;
+    ret->dflt = dflt;
+
+#ifdef LY_ENABLED_CACHE
+    lyd_hash(ret);
+#endif
+
+    if (parent) {
+        if (lyd_insert(parent, ret)) {
+            lyd_free(ret);
+            return NULL;
+        }
+    }
+    return ret;
+}
+
 API struct lyd_node *
 lyd_new(struct lyd_node *parent, const struct lys_module *module, const char *name)
 {
@@ -1349,25 +1744,35 @@ lyd_change_leaf(struct lyd_node_leaf_list *leaf, const char *val_str)
         return -1;
     }
 
-    backup = leaf->value_str;
-    new_val = lydict_insert(leaf->schema->module->ctx, val_str ? val_str : "", 0);
-
-    /* parse the type correctly, makes the value canonical if needed */
-    if (!lyp_parse_value(&((struct lys_node_leaf *)leaf->schema)->type, &new_val, NULL, leaf, NULL, NULL, 1, 0)) {
-        lydict_remove(leaf->schema->module->ctx, new_val);
-        return -1;
+    if (!val_str) {
+        val_str = "";
     }
 
-    if (!strcmp(backup, new_val)) {
-        /* the value remains the same */
+    if (!strcmp(leaf->value_str, val_str)) {
+        /* the stored value is canonical and valid, so the same string means the same value - there is
+         * no need to parse it again and to touch the dictionary (frequently refreshed counters) */
         val_change = 0;
     } else {
-        val_change = 1;
-    }
+        backup = leaf->value_str;
+        new_val = lydict_insert(leaf->schema->module->ctx, val_str, 0);
+
+        /* parse the type correctly, makes the value canonical if needed */
+        if (!lyp_parse_value(&((struct lys_node_leaf *)leaf->schema)->type, &new_val, NULL, leaf, NULL, NULL, 1, 0)) {
+            lydict_remove(leaf->schema->module->ctx, new_val);
+            return -1;
+        }
+
+        if (!strcmp(backup, new_val)) {
+            /* the value remains the same */
+            val_change = 0;
+        } else {
+            val_change = 1;
+        }
 
-    /* value is correct, replace it */
-    lydict_remove(leaf->schema->module->ctx, leaf->value_str);
-    leaf->value_str = new_val;
+        /* value is correct, replace it */
+        lydict_remove(leaf->schema->module->ctx, leaf->value_str);
+        leaf->value_str = new_val;
+    }
 
     /* clear the default flag, the value is different */
     if (leaf->dflt) {
@@ -2226,8 +2631,724 @@ lyd_new_path(struct lyd_node *data_tree, const struct ly_ctx *ctx, const char *p
         }
     }
 
-    LOGINT(ctx);
-    return NULL;
+    LOGINT(ctx);
+    return NULL;
+}
+
+API struct ly_path *
+ly_path_compile(const struct ly_ctx *ctx, const char *path, int options)
+{
+    FUN_IN;
+
+    const struct lys_node *snode, *siter;
+    struct ly_path *cpath;
+    uint16_t i;
+
+    if (!ctx || !path || (path[0] != '/') || (options & ~LYD_PATH_OPT_OUTPUT)) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (strchr(path, '[')) {
+        LOGVAL(ctx, LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, '[', strchr(path, '['));
+        return NULL;
+    }
+
+    /* resolve the target schema node, sets the error */
+    snode = resolve_json_nodeid(path, ctx, NULL, (options & LYD_PATH_OPT_OUTPUT) ? 1 : 0);
+    if (!snode) {
+        return NULL;
+    }
+
+    cpath = calloc(1, sizeof *cpath);
+    LY_CHECK_ERR_RETURN(!cpath, LOGMEM(ctx), NULL);
+    cpath->ctx = (struct ly_ctx *)ctx;
+
+    /* count the data nodes on the path */
+    for (siter = snode; siter; siter = lys_parent(siter)) {
+        if (siter->nodetype & (LYS_CONTAINER | LYS_LEAF | LYS_LEAFLIST | LYS_LIST | LYS_ANYDATA | LYS_NOTIF | LYS_RPC
+                               | LYS_ACTION)) {
+            ++cpath->count;
+        }
+    }
+    cpath->steps = calloc(cpath->count, sizeof *cpath->steps);
+    LY_CHECK_ERR_GOTO(!cpath->steps, LOGMEM(ctx), error);
+
+    /* fill the steps from the target up */
+    i = cpath->count;
+    for (siter = snode; siter; siter = lys_parent(siter)) {
+        if (siter->nodetype & (LYS_CONTAINER | LYS_LEAF | LYS_LEAFLIST | LYS_LIST | LYS_ANYDATA | LYS_NOTIF | LYS_RPC
+                               | LYS_ACTION)) {
+            cpath->steps[--i].schema = siter;
+        }
+    }
+
+    /* assign slots and hashes */
+    for (i = 0; i < cpath->count; ++i) {
+        siter = cpath->steps[i].schema;
+        switch (siter->nodetype) {
+        case LYS_LIST:
+            if (!((struct lys_node_list *)siter)->keys_size) {
+                LOGVAL(ctx, LYE_SPEC, LY_VLOG_LYS, siter, "Key-less list \"%s\" cannot be a part of a compiled path.",
+                       siter->name);
+                goto error;
+            }
+            cpath->steps[i].slot = cpath->slot_count;
+            cpath->slot_count += ((struct lys_node_list *)siter)->keys_size;
+            break;
+        case LYS_LEAFLIST:
+            if (siter->flags & LYS_CONFIG_R) {
+                LOGVAL(ctx, LYE_SPEC, LY_VLOG_LYS, siter, "State leaf-list \"%s\" cannot be a part of a compiled path.",
+                       siter->name);
+                goto error;
+            }
+            cpath->steps[i].slot = cpath->slot_count;
+            ++cpath->slot_count;
+            break;
+        default:
+            /* same hash as lyd_hash() would compute for an instance */
+            cpath->steps[i].hash = dict_hash_multi(0, lys_node_module(siter)->name, strlen(lys_node_module(siter)->name));
+            cpath->steps[i].hash = dict_hash_multi(cpath->steps[i].hash, siter->name, strlen(siter->name));
+            cpath->steps[i].hash = dict_hash_multi(cpath->steps[i].hash, NULL, 0);
+            break;
+        }
+    }
+
+    return cpath;
+
+error:
+    ly_path_free(cpath);
+    return NULL;
+}
+
+API unsigned int
+ly_path_slot_count(const struct ly_path *cpath)
+{
+    FUN_IN;
+
+    if (!cpath) {
+        LOGARG;
+        return 0;
+    }
+
+    return cpath->slot_count;
+}
+
+API void
+ly_path_free(struct ly_path *cpath)
+{
+    FUN_IN;
+
+    if (!cpath) {
+        return;
+    }
+
+    free(cpath->steps);
+    free(cpath);
+}
+
+/**
+ * @brief Check whether a data node is a list or leaf-list instance with the given key or leaf-list values.
+ *
+ * @param[in] node Data node to check.
+ * @param[in] schema Schema node of the instance.
+ * @param[in] vals Key values of a list or the value of a leaf-list.
+ * @return 1 if equal, 0 otherwise.
+ */
+static int
+ly_path_inst_equal(const struct lyd_node *node, const struct lys_node *schema, const char **vals)
+{
+    const struct lys_node_list *slist;
+    const struct lyd_node *key;
+    uint8_t i;
+
+    if (node->schema != schema) {
+        return 0;
+    }
+
+    if (schema->nodetype == LYS_LEAFLIST) {
+        return !strcmp(((struct lyd_node_leaf_list *)node)->value_str, vals[0]);
+    }
+
+    slist = (const struct lys_node_list *)schema;
+    for (i = 0, key = node->child; i < slist->keys_size; ++i, key = key->next) {
+        if (!key || (key->schema != (struct lys_node *)slist->keys[i])
+                || strcmp(((struct lyd_node_leaf_list *)key)->value_str, vals[i])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+#ifdef LY_ENABLED_CACHE
+
+struct ly_path_inst {
+    const struct lys_node *schema;
+    const char **vals;
+};
+
+static int
+ly_path_inst_val_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct ly_path_inst *inst = val1_p;
+
+    return ly_path_inst_equal(*(struct lyd_node **)val2_p, inst->schema, inst->vals);
+}
+
+#endif
+
+/**
+ * @brief Find a list or leaf-list instance among siblings comparing the stored canonical values.
+ *
+ * @param[in] siblings First sibling to search.
+ * @param[in] schema Schema node of the instance.
+ * @param[in] vals Key values of a list or the value of a leaf-list.
+ * @param[in] count Number of \p vals.
+ * @return Found instance, NULL if there is none.
+ */
+static struct lyd_node *
+ly_path_inst_find(const struct lyd_node *siblings, const struct lys_node *schema, const char **vals, uint8_t count)
+{
+#ifdef LY_ENABLED_CACHE
+    if (siblings->parent && siblings->parent->ht) {
+        const struct lys_module *mod = lys_node_module(schema);
+        struct ly_path_inst inst = {schema, vals};
+        struct lyd_node **match_p;
+        uint32_t hash;
+        uint8_t i;
+
+        /* the same hash as lyd_hash() of the instance */
+        hash = dict_hash_multi(0, mod->name, strlen(mod->name));
+        hash = dict_hash_multi(hash, schema->name, strlen(schema->name));
+        for (i = 0; i < count; ++i) {
+            hash = dict_hash_multi(hash, vals[i], strlen(vals[i]));
+        }
+        hash = dict_hash_multi(hash, NULL, 0);
+
+        if (lyht_find_with_val_cb(siblings->parent->ht, &inst, hash, ly_path_inst_val_equal, NULL, (void **)&match_p)) {
+            return NULL;
+        }
+        return *match_p;
+    }
+#else
+    (void)count;
+#endif
+
+    for (; siblings; siblings = siblings->next) {
+        if (ly_path_inst_equal(siblings, schema, vals)) {
+            return (struct lyd_node *)siblings;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Find an instance of a compiled path step among siblings.
+ *
+ * @param[in] siblings First sibling to search.
+ * @param[in] step Compiled path step.
+ * @param[in] values Bound slot values.
+ * @param[in] value Leaf-list value used if not bound in \p values.
+ * @param[out] match Found instance, NULL if there is none.
+ * @return 0 on success, -1 on error.
+ */
+static int
+ly_path_step_find(const struct lyd_node *siblings, const struct ly_path_step *step, const char **values,
+                  const char *value, struct lyd_node **match)
+{
+    const char **vals, *leaflist_val;
+    char **canon;
+    uint8_t i, count;
+    int changed = 0, ret = 0;
+
+    *match = NULL;
+    if (!siblings) {
+        return 0;
+    }
+
+    switch (step->schema->nodetype) {
+    case LYS_LIST:
+        vals = &values[step->slot];
+        count = ((struct lys_node_list *)step->schema)->keys_size;
+        break;
+    case LYS_LEAFLIST:
+        leaflist_val = (values && values[step->slot]) ? values[step->slot] : value;
+        if (!leaflist_val) {
+            LOGERR(step->schema->module->ctx, LY_EINVAL, "Invalid arguments - no value for a leaf-list (%s()).",
+                   __func__);
+            return -1;
+        }
+        vals = &leaflist_val;
+        count = 1;
+        break;
+    default:
+#ifdef LY_ENABLED_CACHE
+        if (siblings->parent && siblings->parent->ht) {
+            struct lyd_node dummy, *dummy_p = &dummy, **match_p;
+
+            /* only schema and hash are used for these node types, no need to create a real node */
+            memset(&dummy, 0, sizeof dummy);
+            dummy.schema = (struct lys_node *)step->schema;
+            dummy.hash = step->hash;
+            if (!lyht_find(siblings->parent->ht, &dummy_p, step->hash, (void **)&match_p)) {
+                *match = *match_p;
+            }
+            return 0;
+        }
+#endif
+        for (; siblings; siblings = siblings->next) {
+            if (siblings->schema == step->schema) {
+                *match = (struct lyd_node *)siblings;
+                break;
+            }
+        }
+        return 0;
+    }
+
+    /* the values are usually canonical, so they can be compared with the stored ones directly */
+    *match = ly_path_inst_find(siblings, step->schema, vals, count);
+    if (*match) {
+        return 0;
+    }
+
+    /* not found, try again only if some value is not canonical */
+    canon = calloc(count, sizeof *canon);
+    LY_CHECK_ERR_RETURN(!canon, LOGMEM(step->schema->module->ctx), -1);
+    for (i = 0; i < count; ++i) {
+        canon[i] = lyd_make_canonical((step->schema->nodetype == LYS_LIST) ?
+                                      (struct lys_node *)((struct lys_node_list *)step->schema)->keys[i] : step->schema,
+                                      vals[i], 0);
+        if (!canon[i]) {
+            ret = -1;
+            goto cleanup;
+        }
+        if (strcmp(canon[i], vals[i])) {
+            changed = 1;
+        }
+    }
+    if (changed) {
+        *match = ly_path_inst_find(siblings, step->schema, (const char **)canon, count);
+    }
+
+cleanup:
+    for (i = 0; i < count; ++i) {
+        free(canon[i]);
+    }
+    free(canon);
+    return ret;
+}
+
+/**
+ * @brief Check that all the required slot values of a compiled path are bound.
+ *
+ * @param[in] cpath Compiled path.
+ * @param[in] values Bound slot values.
+ * @param[in] value Leaf-list value used if not bound in \p values.
+ * @return 0 on success, -1 on error.
+ */
+static int
+ly_path_check_values(const struct ly_path *cpath, const char **values, const char *value)
+{
+    uint16_t i, j;
+
+    for (i = 0; i < cpath->count; ++i) {
+        if (cpath->steps[i].schema->nodetype == LYS_LIST) {
+            for (j = 0; j < ((struct lys_node_list *)cpath->steps[i].schema)->keys_size; ++j) {
+                if (!values || !values[cpath->steps[i].slot + j]) {
+                    LOGVAL(cpath->ctx, LYE_PATH_MISSKEY, LY_VLOG_LYS, cpath->steps[i].schema,
+                           cpath->steps[i].schema->name);
+                    return -1;
+                }
+            }
+        } else if ((cpath->steps[i].schema->nodetype == LYS_LEAFLIST) && !value
+                && (!values || !values[cpath->steps[i].slot])) {
+            LOGERR(cpath->ctx, LY_EINVAL, "Invalid arguments - no value for a leaf-list (%s()).", __func__);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+API struct lyd_node *
+lyd_find_path_compiled(const struct lyd_node *data_tree, const struct ly_path *cpath, const char **values)
+{
+    FUN_IN;
+
+    struct lyd_node *node = NULL;
+    uint16_t i;
+
+    if (!cpath) {
+        LOGARG;
+        return NULL;
+    }
+    if (data_tree && (lyd_node_module(data_tree)->ctx != cpath->ctx)) {
+        LOGERR(cpath->ctx, LY_EINVAL, "Compiled path and data tree are from different contexts (%s()).", __func__);
+        return NULL;
+    }
+    if (ly_path_check_values(cpath, values, NULL)) {
+        return NULL;
+    }
+
+    /* find the first top-level sibling */
+    for (; data_tree && data_tree->prev->next; data_tree = data_tree->prev);
+
+    for (i = 0; i < cpath->count; ++i) {
+        if (ly_path_step_find(data_tree, &cpath->steps[i], values, NULL, &node) || !node) {
+            return NULL;
+        }
+        data_tree = node->child;
+    }
+
+    return node;
+}
+
+API struct lyd_node *
+lyd_new_path_compiled(struct lyd_node *data_tree, const struct ly_ctx *ctx, const struct ly_path *cpath,
+                      const char **values, void *value, LYD_ANYDATA_VALUETYPE value_type, int options)
+{
+    FUN_IN;
+
+    struct lyd_node *ret = NULL, *node, *parent = NULL, *last;
+    const struct ly_path_step *step;
+    const struct lys_node *sparent;
+    const struct lys_node_list *slist;
+    const char *val_str;
+    uint16_t i;
+    uint8_t k;
+    int dflt = (options & LYD_PATH_OPT_DFLT) ? 1 : 0;
+
+    if (!cpath || (!data_tree && !ctx)) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (!ctx) {
+        ctx = data_tree->schema->module->ctx;
+    }
+    if (ctx != cpath->ctx) {
+        LOGERR(ctx, LY_EINVAL, "Compiled path and data tree are from different contexts (%s()).", __func__);
+        return NULL;
+    }
+    if (ly_path_check_values(cpath, values, value)) {
+        return NULL;
+    }
+
+    /* find the existing part of the path */
+    if (data_tree) {
+        for (node = data_tree; node->prev->next; node = node->prev);
+    } else {
+        node = NULL;
+    }
+    for (i = 0; i < cpath->count; ++i) {
+        if (ly_path_step_find(node, &cpath->steps[i], values, value, &node)) {
+            return NULL;
+        }
+        if (!node) {
+            break;
+        }
+        parent = node;
+        node = node->child;
+    }
+
+    if (i == cpath->count) {
+        /* the node exists, are we supposed to update it or is it default? */
+        if (!(options & LYD_PATH_OPT_UPDATE) && (!parent->dflt || dflt)) {
+            LOGVAL(ctx, LYE_PATH_EXISTS, LY_VLOG_LYD, parent);
+            return NULL;
+        }
+
+        /* no change, the default node already exists */
+        if (parent->dflt && dflt) {
+            return NULL;
+        }
+
+        return lyd_new_path_update(parent, value, value_type, dflt);
+    }
+
+    /* create the rest of the path */
+    for (; i < cpath->count; ++i) {
+        step = &cpath->steps[i];
+        switch (step->schema->nodetype) {
+        case LYS_CONTAINER:
+        case LYS_LIST:
+        case LYS_NOTIF:
+        case LYS_RPC:
+        case LYS_ACTION:
+            if (options & LYD_PATH_OPT_NOPARENT) {
+                /* these were supposed to exist */
+                LOGVAL(ctx, LYE_PATH_MISSPAR, LY_VLOG_LYS, step->schema);
+                goto error;
+            }
+            node = _lyd_new(parent, step->schema, dflt);
+            break;
+        case LYS_LEAF:
+        case LYS_LEAFLIST:
+            val_str = value;
+            if ((step->schema->nodetype == LYS_LEAFLIST) && values && values[step->slot]) {
+                val_str = values[step->slot];
+            }
+            node = _lyd_new_leaf(parent, step->schema, val_str, dflt, options & LYD_PATH_OPT_EDIT);
+            break;
+        case LYS_ANYXML:
+        case LYS_ANYDATA:
+            if ((value_type <= LYD_ANYDATA_STRING) && !value) {
+                value_type = LYD_ANYDATA_CONSTSTRING;
+                value = "";
+            }
+            node = lyd_create_anydata(parent, step->schema, value, value_type);
+            break;
+        default:
+            LOGINT(ctx);
+            node = NULL;
+            break;
+        }
+
+        if (!node) {
+            if (parent) {
+                LOGVAL(ctx, LYE_SPEC, LY_VLOG_LYS, step->schema, "Failed to create node \"%s\" as a child of \"%s\".",
+                       step->schema->name, parent->schema->name);
+            } else {
+                LOGVAL(ctx, LYE_SPEC, LY_VLOG_LYS, step->schema, "Failed to create node \"%s\".", step->schema->name);
+            }
+            goto error;
+        }
+
+        /* special case when we are creating a sibling of a top-level data node */
+        if (!parent && data_tree) {
+            for (last = data_tree; last->next; last = last->next);
+            if (lyd_insert_after(last, node)) {
+                lyd_free(node);
+                goto error;
+            }
+        }
+
+        if (!ret) {
+            /* sort if needed, but only when inserted somewhere */
+            sparent = node->schema;
+            do {
+                sparent = lys_parent(sparent);
+            } while (sparent && !(sparent->nodetype & (LYS_INPUT | LYS_OUTPUT)));
+            if (sparent && lyd_schema_sort(node, 0)) {
+                lyd_free(node);
+                goto error;
+            }
+
+            /* set first created node */
+            ret = node;
+        }
+
+        if (step->schema->nodetype == LYS_LIST) {
+            /* create all the keys */
+            slist = (const struct lys_node_list *)step->schema;
+            for (k = 0; k < slist->keys_size; ++k) {
+                if (!_lyd_new_leaf(node, (struct lys_node *)slist->keys[k], values[step->slot + k], 0, 0)) {
+                    goto error;
+                }
+            }
+
+            /* if a key of the list was supposed to be created, it is created as a part of the list instance creation */
+            if ((i + 2 == cpath->count) && (cpath->steps[i + 1].schema->nodetype == LYS_LEAF)
+                    && (lys_is_key((struct lys_node_leaf *)cpath->steps[i + 1].schema, NULL) == slist)) {
+                return ret;
+            }
+        }
+
+        parent = node;
+    }
+
+    if (options & LYD_PATH_OPT_NOPARENTRET) {
+        /* last created node */
+        return node;
+    }
+    return ret;
+
+error:
+    lyd_free(ret);
+    return NULL;
+}
+
+API struct lyd_batch *
+lyd_batch_new(struct lyd_node *data_tree, const struct ly_ctx *ctx, int options)
+{
+    FUN_IN;
+
+    struct lyd_batch *batch;
+
+    if (!data_tree && !ctx) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (!ctx) {
+        ctx = data_tree->schema->module->ctx;
+    }
+
+    batch = calloc(1, sizeof *batch);
+    LY_CHECK_ERR_RETURN(!batch, LOGMEM(ctx), NULL);
+
+    batch->ctx = (struct ly_ctx *)ctx;
+    batch->tree = data_tree;
+    batch->options = options & ~LYD_PATH_OPT_NOPARENTRET;
+
+    return batch;
+}
+
+/**
+ * @brief Get the end of a data path segment (node identifier with its predicates).
+ *
+ * @param[in] path Data path.
+ * @param[in] start Offset of the '/' starting the segment.
+ * @return Offset of the next segment '/' or the path length.
+ */
+static size_t
+lyd_batch_segment_end(const char *path, size_t start)
+{
+    char quot = 0;
+    int pred = 0;
+
+    for (++start; path[start]; ++start) {
+        if (quot) {
+            if (path[start] == quot) {
+                quot = 0;
+            }
+        } else if (pred && ((path[start] == '\'') || (path[start] == '\"'))) {
+            quot = path[start];
+        } else if (path[start] == '[') {
+            pred = 1;
+        } else if (path[start] == ']') {
+            pred = 0;
+        } else if (!pred && (path[start] == '/')) {
+            break;
+        }
+    }
+
+    return start;
+}
+
+API int
+lyd_batch_add(struct lyd_batch *batch, const char *path, const char *value)
+{
+    FUN_IN;
+
+    struct lyd_node *cursor, *node, *iter;
+    struct lyd_batch_level *levels;
+    size_t len, common, start, end;
+    uint16_t depth, count, i;
+    LY_ERR prev_ly_errno;
+    char *str;
+
+    if (!batch || !path || (path[0] != '/')) {
+        LOGARG;
+        return -1;
+    }
+
+    len = strlen(path);
+
+    /* learn the deepest node of the previous path whose whole segment is shared with this path and that is
+     * a proper ancestor of the new node, it will be used as the cursor */
+    common = 0;
+    if (batch->path) {
+        for (; (common < len) && (path[common] == batch->path[common]); ++common);
+    }
+    for (depth = 0; (depth < batch->depth) && (batch->levels[depth].end <= common)
+            && (path[batch->levels[depth].end] == '/'); ++depth);
+    cursor = depth ? batch->levels[depth - 1].node : NULL;
+    start = depth ? batch->levels[depth - 1].end : 0;
+
+    prev_ly_errno = ly_errno;
+    ly_errno = LY_SUCCESS;
+    if (cursor) {
+        /* relative path from the cursor */
+        node = lyd_new_path(cursor, NULL, path + start + 1, (void *)value, LYD_ANYDATA_CONSTSTRING,
+                            batch->options | LYD_PATH_OPT_NOPARENTRET);
+    } else {
+        node = lyd_new_path(batch->tree, batch->ctx, path, (void *)value, LYD_ANYDATA_CONSTSTRING,
+                            batch->options | LYD_PATH_OPT_NOPARENTRET);
+    }
+    if (!node) {
+        if (ly_errno) {
+            return -1;
+        }
+
+        /* nothing changed, only the shared part of the cursor is valid */
+        ly_errno = prev_ly_errno;
+        count = 0;
+        goto store_path;
+    }
+    ly_errno = prev_ly_errno;
+
+    if (!batch->tree) {
+        for (batch->tree = node; batch->tree->parent; batch->tree = batch->tree->parent);
+    }
+
+    /* count the segments of the new part of the path */
+    count = 0;
+    for (end = start; end < len; end = lyd_batch_segment_end(path, end)) {
+        ++count;
+    }
+
+    /* count the nodes between the cursor and the new node, it may differ (yang-data, list keys) */
+    for (i = 0, iter = node; iter && (iter != cursor); iter = iter->parent) {
+        ++i;
+    }
+    if ((iter != cursor) || (i != count)) {
+        /* do not use the new nodes as cursor */
+        count = 0;
+        goto store_path;
+    }
+
+    /* remember the new nodes as the cursor */
+    if (depth + count > batch->size) {
+        levels = realloc(batch->levels, (depth + count) * sizeof *batch->levels);
+        LY_CHECK_ERR_RETURN(!levels, LOGMEM(batch->ctx), -1);
+        batch->levels = levels;
+        batch->size = depth + count;
+    }
+    for (i = depth + count, iter = node; i > depth; iter = iter->parent) {
+        batch->levels[--i].node = iter;
+    }
+    for (end = start, i = depth; end < len; ++i) {
+        end = lyd_batch_segment_end(path, end);
+        batch->levels[i].end = end;
+    }
+
+store_path:
+    batch->depth = depth + count;
+    if (len + 1 > batch->path_size) {
+        str = realloc(batch->path, len + 1);
+        if (!str) {
+            LOGMEM(batch->ctx);
+            batch->depth = 0;
+            return -1;
+        }
+        batch->path = str;
+        batch->path_size = len + 1;
+    }
+    memcpy(batch->path, path, len + 1);
+
+    return 0;
+}
+
+API struct lyd_node *
+lyd_batch_finish(struct lyd_batch *batch)
+{
+    FUN_IN;
+
+    struct lyd_node *tree;
+
+    if (!batch) {
+        return NULL;
+    }
+
+    for (tree = batch->tree; tree && tree->prev->next; tree = tree->prev);
+
+    free(batch->path);
+    free(batch->levels);
+    free(batch);
+
+    return tree;
 }
 
 API unsigned int
@@ -4957,10 +6078,13 @@ _lyd_validate(struct lyd_node **node, struct lyd_node *data_tree, struct ly_ctx
     unsigned int i;
     struct unres_data *unres = NULL;
     const struct lys_module *yanglib_mod;
+    uint64_t prof;
 
     unres = calloc(1, sizeof *unres);
     LY_CHECK_ERR_RETURN(!unres, LOGMEM(NULL), EXIT_FAILURE);
 
+    LY_PROF_START(prof);
+
     if (diff) {
         unres->store_diff = 1;
         unres->diff = lyd_diff_init_difflist(ctx, &unres->diff_size);
@@ -5097,6 +6221,17 @@ _lyd_validate(struct lyd_node **node, struct lyd_node *data_tree, struct ly_ctx
         unres->diff_idx = 0;
     }
 
+    if (*node && (options & LYD_OPT_WD_LAZY)) {
+        /* the default nodes were needed only for the validation */
+        if ((*node)->parent) {
+            if (!((*node)->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA))) {
+                lyd_wd_free_dflt(&(*node)->child);
+            }
+        } else {
+            lyd_wd_free_dflt(node);
+        }
+    }
+
     ret = EXIT_SUCCESS;
 
 cleanup:
@@ -5113,6 +6248,7 @@ cleanup:
         free(unres);
     }
 
+    LY_PROF_STOP(LY_PROF_VALIDATE, prof);
     return ret;
 }
 
@@ -5964,6 +7100,248 @@ lyd_dup_withsiblings(const struct lyd_node *node, int options)
     return lyd_dup_withsiblings_to_ctx(node, options, lyd_node_module(node)->ctx);
 }
 
+static int
+lyd_compact_count(const struct lyd_node *node, int options, uint32_t *count)
+{
+    const struct lyd_node *iter;
+
+    if (node->schema->nodetype & LYS_ANYDATA) {
+        LOGERR(node->schema->module->ctx, LY_EINVAL, "Compact data trees do not support anydata (\"%s\").",
+               node->schema->name);
+        return EXIT_FAILURE;
+    }
+    if (node->attr && !(options & LYD_DUP_OPT_NO_ATTR)) {
+        LOGERR(node->schema->module->ctx, LY_EINVAL, "Compact data trees do not support attributes (\"%s\").",
+               node->schema->name);
+        return EXIT_FAILURE;
+    }
+    if (*count == UINT32_MAX) {
+        LOGERR(node->schema->module->ctx, LY_EINVAL, "Too many data nodes for a compact data tree.");
+        return EXIT_FAILURE;
+    }
+    ++(*count);
+
+    if (!(node->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST))) {
+        LY_TREE_FOR(node->child, iter) {
+            if (lyd_compact_count(iter, options, count)) {
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static uint32_t
+lyd_compact_fill(struct lyd_compact *tree, const struct lyd_node *node, uint32_t parent)
+{
+    struct lyd_compact_node *cnode;
+    const struct lyd_node *iter;
+    const char *value;
+    uint32_t idx, child, prev = 0;
+
+    idx = tree->count++;
+    cnode = &tree->nodes[idx];
+    cnode->schema = node->schema;
+    cnode->parent = parent;
+    if (node->dflt) {
+        cnode->flags |= LYD_COMPACT_DFLT;
+    }
+
+    if (node->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST)) {
+        value = ((struct lyd_node_leaf_list *)node)->value_str;
+        if (strlen(value) < sizeof cnode->value.inl) {
+            strcpy(cnode->value.inl, value);
+            cnode->flags |= LYD_COMPACT_INLINE;
+        } else {
+            cnode->value.str = lydict_insert(tree->ctx, value, 0);
+        }
+        return idx;
+    }
+
+    LY_TREE_FOR(node->child, iter) {
+        child = lyd_compact_fill(tree, iter, idx);
+        if (prev) {
+            tree->nodes[prev].next = child;
+        } else {
+            cnode = &tree->nodes[idx];
+            cnode->child = child;
+        }
+        prev = child;
+    }
+
+    return idx;
+}
+
+static struct lyd_compact *
+lyd_dup_compact_(const struct lyd_node *node, int options, int withsiblings)
+{
+    struct ly_ctx *ctx;
+    struct lyd_compact *tree;
+    const struct lyd_node *first, *iter;
+    uint32_t count = 1, idx, prev = 0;
+
+    if (!node) {
+        LOGARG;
+        return NULL;
+    }
+    ctx = node->schema->module->ctx;
+
+    if (options & ~LYD_DUP_OPT_NO_ATTR) {
+        LOGERR(ctx, LY_EINVAL, "lyd_dup_compact: invalid options 0x%x.", options);
+        return NULL;
+    }
+
+    first = node;
+    if (withsiblings) {
+        while (first->prev->next) {
+            first = first->prev;
+        }
+    }
+
+    /* count the nodes first so that the array is allocated only once */
+    for (iter = first; iter; iter = withsiblings ? iter->next : NULL) {
+        if (lyd_compact_count(iter, options, &count)) {
+            return NULL;
+        }
+    }
+
+    tree = calloc(1, sizeof *tree);
+    LY_CHECK_ERR_RETURN(!tree, LOGMEM(ctx), NULL);
+    tree->ctx = ctx;
+    tree->nodes = calloc(count, sizeof *tree->nodes);
+    LY_CHECK_ERR_RETURN(!tree->nodes, LOGMEM(ctx); free(tree), NULL);
+    tree->count = 1;
+
+    for (iter = first; iter; iter = withsiblings ? iter->next : NULL) {
+        idx = lyd_compact_fill(tree, iter, 0);
+        if (prev) {
+            tree->nodes[prev].next = idx;
+        }
+        prev = idx;
+    }
+    assert(tree->count == count);
+
+    return tree;
+}
+
+API struct lyd_compact *
+lyd_dup_compact(const struct lyd_node *node, int options)
+{
+    FUN_IN;
+
+    return lyd_dup_compact_(node, options, 0);
+}
+
+API struct lyd_compact *
+lyd_dup_compact_withsiblings(const struct lyd_node *node, int options)
+{
+    FUN_IN;
+
+    return lyd_dup_compact_(node, options, 1);
+}
+
+API const char *
+lyd_compact_value(const struct lyd_compact *tree, uint32_t idx)
+{
+    FUN_IN;
+
+    const struct lyd_compact_node *cnode;
+
+    if (!tree || !idx || (idx >= tree->count)) {
+        LOGARG;
+        return NULL;
+    }
+
+    cnode = &tree->nodes[idx];
+    if (!(cnode->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST))) {
+        return NULL;
+    }
+    return (cnode->flags & LYD_COMPACT_INLINE) ? cnode->value.inl : cnode->value.str;
+}
+
+static struct lyd_node *
+lyd_compact_expand_r(const struct lyd_compact *tree, uint32_t idx, struct lyd_node *parent)
+{
+    const struct lyd_compact_node *cnode = &tree->nodes[idx];
+    struct lyd_node *ret;
+    uint32_t child;
+    int dflt = (cnode->flags & LYD_COMPACT_DFLT) ? 1 : 0;
+
+    if (cnode->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST)) {
+        if (parent) {
+            return _lyd_new_leaf(parent, cnode->schema, lyd_compact_value(tree, idx), dflt, 0);
+        }
+        return lyd_create_leaf(cnode->schema, lyd_compact_value(tree, idx), dflt, 0);
+    }
+
+    ret = _lyd_new(parent, cnode->schema, dflt);
+    if (!ret) {
+        return NULL;
+    }
+    for (child = cnode->child; child; child = tree->nodes[child].next) {
+        if (!lyd_compact_expand_r(tree, child, ret)) {
+            if (!parent) {
+                lyd_free(ret);
+            }
+            return NULL;
+        }
+    }
+
+    return ret;
+}
+
+API struct lyd_node *
+lyd_compact_expand(const struct lyd_compact *tree, uint32_t idx, int withsiblings)
+{
+    FUN_IN;
+
+    struct lyd_node *first = NULL, *node;
+
+    if (!tree || !idx || (idx >= tree->count)) {
+        LOGARG;
+        return NULL;
+    }
+
+    for (; idx; idx = withsiblings ? tree->nodes[idx].next : 0) {
+        node = lyd_compact_expand_r(tree, idx, NULL);
+        if (!node) {
+            lyd_free_withsiblings(first);
+            return NULL;
+        }
+        if (!first) {
+            first = node;
+        } else if (lyd_insert_after(first->prev, node)) {
+            lyd_free(node);
+            lyd_free_withsiblings(first);
+            return NULL;
+        }
+    }
+
+    return first;
+}
+
+API void
+lyd_compact_free(struct lyd_compact *tree)
+{
+    FUN_IN;
+
+    uint32_t i;
+
+    if (!tree) {
+        return;
+    }
+
+    for (i = 1; i < tree->count; ++i) {
+        if ((tree->nodes[i].schema->nodetype & (LYS_LEAF | LYS_LEAFLIST))
+                && !(tree->nodes[i].flags & LYD_COMPACT_INLINE)) {
+            lydict_remove(tree->ctx, tree->nodes[i].value.str);
+        }
+    }
+    free(tree->nodes);
+    free(tree);
+}
+
 API void
 lyd_free_attr(struct ly_ctx *ctx, struct lyd_node *parent, struct lyd_attr *attr, int recursive)
 {
@@ -7955,8 +9333,8 @@ error:
  * @return EXIT_SUCCESS or EXIT_FAILURE
  */
 static int
-lyd_wd_add(struct lyd_node **root, struct ly_ctx *ctx, const struct lys_module **modules, int mod_count,
-           struct unres_data *unres, int options)
+lyd_wd_add_(struct lyd_node **root, struct ly_ctx *ctx, const struct lys_module **modules, int mod_count,
+            struct unres_data *unres, int options)
 {
     struct lys_node *siter;
     int i;
@@ -8043,6 +9421,45 @@ lyd_wd_add(struct lyd_node **root, struct ly_ctx *ctx, const struct lys_module *
     return EXIT_SUCCESS;
 }
 
+static int
+lyd_wd_add(struct lyd_node **root, struct ly_ctx *ctx, const struct lys_module **modules, int mod_count,
+           struct unres_data *unres, int options)
+{
+    int ret;
+    uint64_t prof;
+
+    LY_PROF_START(prof);
+    ret = lyd_wd_add_(root, ctx, modules, mod_count, unres, options);
+    LY_PROF_STOP(LY_PROF_DEFAULTS, prof);
+
+    return ret;
+}
+
+/**
+ * @brief Free all the implicit default nodes among the siblings and in their subtrees.
+ *
+ * @param[in,out] first First sibling to process, it is moved if freed.
+ */
+static void
+lyd_wd_free_dflt(struct lyd_node **first)
+{
+    struct lyd_node *next, *elem;
+    int is_first;
+
+    LY_TREE_FOR_SAFE(*first, next, elem) {
+        if (elem->dflt) {
+            /* *first may be the parent's child pointer, so update it only after the node is unlinked */
+            is_first = (elem == *first);
+            lyd_free(elem);
+            if (is_first) {
+                *first = next;
+            }
+        } else if (!(elem->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) && elem->child) {
+            lyd_wd_free_dflt(&elem->child);
+        }
+    }
+}
+
 int
 lyd_defaults_add_unres(struct lyd_node **root, int options, struct ly_ctx *ctx, const struct lys_module **modules,
                        int mod_count, const struct lyd_node *data_tree, struct lyd_node *act_notif,
@@ -8218,6 +9635,63 @@ unlink_datatree:
     return ret;
 }
 
+API int
+lyd_wd_materialize(struct lyd_node **node, struct ly_ctx *ctx, int options)
+{
+    FUN_IN;
+
+    struct lyd_node *next, *iter, *act_notif = NULL;
+    struct unres_data *unres;
+    int ret;
+
+    if (!node || (!(*node) && !ctx)) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    if (*node) {
+        ctx = (*node)->schema->module->ctx;
+    }
+    if (lyp_data_check_options(ctx, options, __func__)) {
+        return EXIT_FAILURE;
+    }
+    options &= (LYD_OPT_TYPEMASK | LYD_OPT_NOSIBLINGS);
+
+    if (*node && !(options & LYD_OPT_NOSIBLINGS) && !(*node)->parent) {
+        /* the first sibling */
+        while ((*node)->prev->next) {
+            *node = (*node)->prev;
+        }
+    }
+
+    if ((options & (LYD_OPT_RPC | LYD_OPT_RPCREPLY | LYD_OPT_NOTIF)) && *node
+            && !((*node)->schema->nodetype & (LYS_RPC | LYS_NOTIF))) {
+        /* find the nested action/notification */
+        LY_TREE_DFS_BEGIN(*node, next, iter) {
+            if (iter->schema->nodetype & (LYS_ACTION | LYS_NOTIF)) {
+                act_notif = iter;
+                break;
+            }
+            LY_TREE_DFS_END(*node, next, iter);
+        }
+        if (!act_notif) {
+            LOGERR(ctx, LY_EINVAL, "%s: no action/notification in the data tree.", __func__);
+            return EXIT_FAILURE;
+        }
+    }
+
+    unres = calloc(1, sizeof *unres);
+    LY_CHECK_ERR_RETURN(!unres, LOGMEM(ctx), EXIT_FAILURE);
+
+    /* the tree was already validated, evaluate only the when conditions of the new nodes */
+    ret = lyd_defaults_add_unres(node, options | LYD_OPT_TRUSTED, ctx, NULL, 0, NULL, act_notif, unres, 1);
+
+    free(unres->node);
+    free(unres->type);
+    free(unres);
+    return ret;
+}
+
 API struct lys_module *
 lyd_node_module(const struct lyd_node *node)
 {
@@ -8230,6 +9704,81 @@ lyd_node_module(const struct lyd_node *node)
     return node->schema->module->type ? ((struct lys_submodule *)node->schema->module)->belongsto : node->schema->module;
 }
 
+API int
+lyd_tree_stats(const struct lyd_node *node, int withsiblings, struct lyd_tree_stats *stats)
+{
+    FUN_IN;
+
+    const struct lyd_node *root, *next, *elem;
+    const struct lyd_attr *attr;
+
+    if (!node || !stats) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    memset(stats, 0, sizeof *stats);
+
+    if (withsiblings) {
+        node = lyd_first_sibling((struct lyd_node *)node);
+    }
+    LY_TREE_FOR(node, root) {
+        LY_TREE_DFS_BEGIN(root, next, elem) {
+            ++stats->nodes;
+            switch (elem->schema->nodetype) {
+            case LYS_CONTAINER:
+                ++stats->containers;
+                stats->bytes += sizeof *elem;
+                break;
+            case LYS_LIST:
+                ++stats->lists;
+                stats->bytes += sizeof *elem;
+                break;
+            case LYS_LEAF:
+                ++stats->leaves;
+                stats->bytes += sizeof(struct lyd_node_leaf_list);
+                break;
+            case LYS_LEAFLIST:
+                ++stats->leaflists;
+                stats->bytes += sizeof(struct lyd_node_leaf_list);
+                break;
+            case LYS_ANYXML:
+            case LYS_ANYDATA:
+                ++stats->anydata;
+                stats->bytes += sizeof(struct lyd_node_anydata);
+                break;
+            default:
+                ++stats->operations;
+                stats->bytes += sizeof *elem;
+                break;
+            }
+            if (elem->dflt) {
+                ++stats->dflt;
+            }
+
+            LY_TREE_FOR(elem->attr, attr) {
+                ++stats->attrs;
+                stats->bytes += sizeof *attr;
+            }
+
+#ifdef LY_ENABLED_CACHE
+            if (elem->schema->nodetype & (LYS_CONTAINER | LYS_LIST | LYS_RPC | LYS_ACTION | LYS_NOTIF)) {
+                lyht_stats(elem->ht, &stats->child_ht);
+            }
+#endif
+
+            LY_TREE_DFS_END(root, next, elem);
+        }
+
+        if (!withsiblings) {
+            break;
+        }
+    }
+    stats->bytes += stats->child_ht.bytes;
+
+    return EXIT_SUCCESS;
+}
+
 API double
 lyd_dec64_to_double(const struct lyd_node *node)
 {
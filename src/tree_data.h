@@ -537,6 +537,11 @@ char *lyd_path(const struct lyd_node *node);
 #define LYD_OPT_VAL_DIFF 0x40000 /**< Flag only for validation, store all the data node changes performed by the validation
                                       in a diff structure. */
 #define LYD_OPT_LYB_MOD_UPDATE 0x80000 /**< Allow to parse data using an updated revision of a module, relevant only for LYB format. */
+#define LYD_OPT_WD_LAZY  0x100000 /**< Do not keep the implicit default nodes in the resulting data tree. They are still
+                                      created for the validation (when, must and leafref evaluation), but freed once
+                                      it is finished, so the tree holds only the explicit data. The default nodes can
+                                      be created on demand by lyd_wd_materialize(). Cannot be combined with
+                                      #LYD_OPT_VAL_DIFF. */
 #define LYD_OPT_DATA_TEMPLATE 0x1000000 /**< Data represents YANG data template. */
 #define LYD_OPT_MULTI_ERRORS  0x2000000 /**< Report all validation errors instead of the first one.
                                              Applicable only in combination with #LYD_OPT_DATA and #LYD_OPT_CONFIG flags.
@@ -662,6 +667,55 @@ struct lyd_node *lyd_parse_fd(struct ly_ctx *ctx, int fd, LYD_FORMAT format, int
  */
 struct lyd_node *lyd_parse_path(struct ly_ctx *ctx, const char *path, LYD_FORMAT format, int options, ...);
 
+/**
+ * @brief Incremental data parser, opaque structure created by lyd_parser_new().
+ */
+struct lyd_parser;
+
+/**
+ * @brief Start parsing data that are available in chunks (for example as they arrive from network).
+ *
+ * The data are parsed as soon as they are fed, sibling subtrees in chunks of about 64 kB and larger containers
+ * and list instances in parts, so only an incomplete part of the data is kept buffered, even inside a single
+ * top-level subtree. The whole data tree is validated once it is finished by lyd_parser_finish().
+ * LYB data are buffered and parsed all at once.
+ *
+ * @param[in] ctx Context to connect with the data tree being built here.
+ * @param[in] format Format of the input data to be parsed.
+ * @param[in] options Parser options, see @ref parseroptions. Only data trees (#LYD_OPT_DATA, #LYD_OPT_CONFIG,
+ * #LYD_OPT_GET, #LYD_OPT_GETCONFIG, and #LYD_OPT_EDIT) can be parsed, #LYD_OPT_NOSIBLINGS and #LYD_OPT_VAL_DIFF
+ * are not supported.
+ * @return New parser, NULL on error.
+ */
+struct lyd_parser *lyd_parser_new(struct ly_ctx *ctx, LYD_FORMAT format, int options);
+
+/**
+ * @brief Feed the next chunk of data into a parser.
+ *
+ * @param[in] parser Parser to use.
+ * @param[in] data Next chunk of the data, does not have to be NULL-terminated and can end anywhere.
+ * @param[in] len Length of \p data.
+ * @return 0 on success, nonzero in case of an error. After an error, the parser can only be freed.
+ */
+int lyd_parser_feed(struct lyd_parser *parser, const char *data, size_t len);
+
+/**
+ * @brief Finish parsing, validate the data tree, and free the parser.
+ *
+ * @param[in] parser Parser to finish.
+ * @return Pointer to the built data tree or NULL in case of empty data. To free the returned structure,
+ *         use lyd_free(). In these cases, the function sets #ly_errno to LY_SUCCESS. In case of error,
+ *         #ly_errno contains appropriate error code (see #LY_ERR).
+ */
+struct lyd_node *lyd_parser_finish(struct lyd_parser *parser);
+
+/**
+ * @brief Free a parser without finishing it, for example after an error.
+ *
+ * @param[in] parser Parser to free.
+ */
+void lyd_parser_free(struct lyd_parser *parser);
+
 /**
  * @brief Parse (and validate) XML tree.
  *
@@ -745,7 +799,8 @@ struct lyd_node *lyd_new_leaf(struct lyd_node *parent, const struct lys_module *
  * __PARTIAL CHANGE__ - validate after the final change on the data tree (see @ref howtodatamanipulators).
  *
  * Despite the prototype allows to provide a leaflist node as \p leaf parameter, only leafs are accepted.
- * Also, the leaf will never be default after calling this function successfully.
+ * Also, the leaf will never be default after calling this function successfully. If \p val_str is exactly
+ * the current canonical value (e.g. an unchanged counter), it is neither parsed nor stored again.
  *
  * @param[in] leaf A leaf node to change.
  * @param[in] val_str String form of the new value to be set to the \p leaf. In case the type is #LY_TYPE_INST
@@ -898,6 +953,122 @@ struct lyd_node *lyd_new_yangdata(const struct lys_module *module, const char *n
 struct lyd_node *lyd_new_path(struct lyd_node *data_tree, const struct ly_ctx *ctx, const char *path, void *value,
                               LYD_ANYDATA_VALUETYPE value_type, int options);
 
+/**
+ * @brief Compiled data path, opaque structure created by ly_path_compile().
+ */
+struct ly_path;
+
+/**
+ * @brief Resolve a data path template against the schema once so that it can be used repeatedly
+ * by lyd_find_path_compiled() and lyd_new_path_compiled() without any further string processing.
+ *
+ * The \p path is an absolute simple data path (see @ref howtoxpath) without any predicates, for example
+ * "/ietf-interfaces:interfaces/interface/enabled". Every key of every list on the path and the value of a leaf-list
+ * (only as the last node) become value slots that are bound when executing the compiled path. The slots are
+ * ordered as they appear on the path and keys of a single list are in the schema key order. Key-less lists
+ * and state (config false) leaf-lists cannot be part of a compiled path since they do not identify a single instance.
+ *
+ * @param[in] ctx Context with the schema.
+ * @param[in] path Data path template.
+ * @param[in] options Only #LYD_PATH_OPT_OUTPUT is supported, to resolve RPC/action output nodes instead of input ones.
+ * @return Compiled path to be freed by ly_path_free(), NULL on error.
+ */
+struct ly_path *ly_path_compile(const struct ly_ctx *ctx, const char *path, int options);
+
+/**
+ * @brief Get the number of value slots of a compiled path.
+ *
+ * @param[in] cpath Compiled path.
+ * @return Number of values expected by lyd_find_path_compiled() and lyd_new_path_compiled().
+ */
+unsigned int ly_path_slot_count(const struct ly_path *cpath);
+
+/**
+ * @brief Free a compiled path.
+ *
+ * @param[in] cpath Compiled path to free.
+ */
+void ly_path_free(struct ly_path *cpath);
+
+/**
+ * @brief Find the single data node identified by a compiled path with the slot values bound.
+ *
+ * If cache is enabled, every non-top-level step is found in a constant time.
+ *
+ * @param[in] data_tree Any top-level node of the data tree to search.
+ * @param[in] cpath Compiled path.
+ * @param[in] values Array of ly_path_slot_count() values, one for each slot in the slot order. Can be NULL
+ * if there are no slots.
+ * @return Found data node, NULL if not found or on error (ly_errno is set).
+ */
+struct lyd_node *lyd_find_path_compiled(const struct lyd_node *data_tree, const struct ly_path *cpath, const char **values);
+
+/**
+ * @brief Create a new data node based on a compiled path with the slot values bound. Behaves exactly
+ * as lyd_new_path() with the equivalent path with all the predicates filled.
+ *
+ * __PARTIAL CHANGE__ - validate after the final change on the data tree (see @ref howtodatamanipulators).
+ *
+ * @param[in] data_tree Existing data tree to add to/modify (including siblings). Can be NULL.
+ * @param[in] ctx Context to use. Mandatory if \p data_tree is NULL.
+ * @param[in] cpath Compiled path.
+ * @param[in] values Array of ly_path_slot_count() values, one for each slot in the slot order. Can be NULL
+ * if there are no slots. A leaf-list value slot has preference over \p value.
+ * @param[in] value Value of the new leaf/leaf-list, see lyd_new_path().
+ * @param[in] value_type Type of the provided \p value parameter in case of creating anydata or anyxml node.
+ * @param[in] options Bitmask of options flags, see @ref pathoptions. #LYD_PATH_OPT_OUTPUT is ignored, the value
+ * used for compiling \p cpath applies.
+ * @return First created (or updated with #LYD_PATH_OPT_UPDATE) node,
+ * NULL if #LYD_PATH_OPT_UPDATE was used and the full path exists or the leaf original value matches \p value,
+ * NULL and ly_errno is set on error.
+ */
+struct lyd_node *lyd_new_path_compiled(struct lyd_node *data_tree, const struct ly_ctx *ctx, const struct ly_path *cpath,
+                                       const char **values, void *value, LYD_ANYDATA_VALUETYPE value_type, int options);
+
+/**
+ * @brief Batch of lyd_new_path() operations, opaque structure created by lyd_batch_new().
+ */
+struct lyd_batch;
+
+/**
+ * @brief Start a batch of data node creations from a stream of (path, value) pairs.
+ *
+ * The batch remembers the nodes created for the previous path so that every following path is created
+ * relative to the deepest node it shares with the previous path instead of being resolved from the data tree root.
+ * The best performance is therefore achieved if the paths are sorted, meaning all the descendants of a node
+ * are added one after another. Other paths are still handled correctly, only slower.
+ *
+ * The data tree must not be modified in any other way until the batch is finished by lyd_batch_finish().
+ *
+ * __PARTIAL CHANGE__ - validate after the final change on the data tree (see @ref howtodatamanipulators).
+ *
+ * @param[in] data_tree Existing data tree to add to/modify (including siblings). Can be NULL.
+ * @param[in] ctx Context to use. Mandatory if \p data_tree is NULL.
+ * @param[in] options Bitmask of options flags used for all the paths, see @ref pathoptions.
+ * #LYD_PATH_OPT_NOPARENTRET is ignored.
+ * @return New batch, NULL on error.
+ */
+struct lyd_batch *lyd_batch_new(struct lyd_node *data_tree, const struct ly_ctx *ctx, int options);
+
+/**
+ * @brief Create a new data node in a batch, the same as lyd_new_path() would.
+ *
+ * @param[in] batch Batch to use.
+ * @param[in] path Absolute simple data path (see @ref howtoxpath).
+ * @param[in] value Value of the new leaf/leaf-list, string value for anydata/anyxml. Can be NULL.
+ * @return 0 on success (including no change with #LYD_PATH_OPT_UPDATE), -1 on error. The batch can be
+ * used further even after an error.
+ */
+int lyd_batch_add(struct lyd_batch *batch, const char *path, const char *value);
+
+/**
+ * @brief Finish a batch and free it.
+ *
+ * @param[in] batch Batch to finish.
+ * @return First top-level sibling of the created or modified data tree, NULL if empty.
+ */
+struct lyd_node *lyd_batch_finish(struct lyd_batch *batch);
+
 /**
  * @brief Learn the relative instance position of a list or leaf-list within other instances of the
  * same schema node.
@@ -971,6 +1142,97 @@ struct lyd_node *lyd_dup_withsiblings(const struct lyd_node *node, int options);
  */
 struct lyd_node *lyd_dup_to_ctx(const struct lyd_node *node, int options, struct ly_ctx *ctx);
 
+/**
+ * @brief Node of a compact data tree, see lyd_dup_compact().
+ *
+ * The nodes reference each other by 32-bit indices into the array of all the nodes, they have no hash
+ * nor a hash table of their children, and short values are stored inline.
+ */
+struct lyd_compact_node {
+    struct lys_node *schema;    /**< schema node */
+    uint32_t parent;            /**< index of the parent node, 0 for a top-level node */
+    uint32_t child;             /**< index of the first child, 0 if there is none */
+    uint32_t next;              /**< index of the next sibling, 0 for the last sibling */
+    uint32_t flags;             /**< flags, see @ref compactflags */
+    union {
+        const char *str;        /**< canonical value stored in the dictionary */
+        char inl[8];            /**< short canonical value stored inline (#LYD_COMPACT_INLINE) */
+    } value;                    /**< value of a leaf or a leaf-list, use lyd_compact_value() to get it */
+};
+
+/**
+ * @defgroup compactflags Compact data node flags
+ * @ingroup datatree
+ * @{
+ */
+#define LYD_COMPACT_DFLT   0x01 /**< default node */
+#define LYD_COMPACT_INLINE 0x02 /**< the value is stored in value.inl */
+/** @} compactflags */
+
+/**
+ * @brief Compact read-only copy of a data tree created by lyd_dup_compact().
+ *
+ * The nodes are stored in a single array in the document order. Index 0 is not used so that it means
+ * no node, the first top-level node has index 1.
+ */
+struct lyd_compact {
+    struct ly_ctx *ctx;              /**< context of the schema nodes and of the values in the dictionary */
+    struct lyd_compact_node *nodes;  /**< array of the nodes */
+    uint32_t count;                  /**< number of the items in nodes, including the unused one */
+};
+
+/**
+ * @brief Create a compact read-only copy of the specified data tree \p node with all its descendants.
+ *
+ * A compact node needs about a third of the memory of a regular leaf, which suits large data trees that are
+ * only read, such as operational state data. The data cannot be changed, searched by XPath, validated,
+ * or printed, use lyd_compact_expand() to get a regular data tree for that. Attributes are not kept and
+ * anydata and anyxml nodes are not supported.
+ *
+ * @param[in] node Data tree node to be copied.
+ * @param[in] options Bitmask of options flags, see @ref dupoptions. Only #LYD_DUP_OPT_NO_ATTR is supported,
+ * without it the data tree must not contain any attributes.
+ * @return Compact copy of \p node, NULL on error.
+ */
+struct lyd_compact *lyd_dup_compact(const struct lyd_node *node, int options);
+
+/**
+ * @brief Create a compact read-only copy of the specified data tree and all its siblings (preceding as well
+ * as following). See lyd_dup_compact() for the details.
+ *
+ * @param[in] node Data tree sibling node to be copied.
+ * @param[in] options Bitmask of options flags, see @ref dupoptions. Only #LYD_DUP_OPT_NO_ATTR is supported.
+ * @return Compact copy of \p node and all of its siblings, NULL on error.
+ */
+struct lyd_compact *lyd_dup_compact_withsiblings(const struct lyd_node *node, int options);
+
+/**
+ * @brief Get the canonical value of a compact leaf or leaf-list.
+ *
+ * @param[in] tree Compact data tree.
+ * @param[in] idx Index of the node.
+ * @return Value of the node, NULL if it is not a leaf or a leaf-list.
+ */
+const char *lyd_compact_value(const struct lyd_compact *tree, uint32_t idx);
+
+/**
+ * @brief Create a regular data tree from a compact one. The values are parsed again and the created nodes
+ * are not validated.
+ *
+ * @param[in] tree Compact data tree.
+ * @param[in] idx Index of the node to create with all its descendants.
+ * @param[in] withsiblings Whether to create also all the following siblings of the node.
+ * @return Created data tree, NULL on error.
+ */
+struct lyd_node *lyd_compact_expand(const struct lyd_compact *tree, uint32_t idx, int withsiblings);
+
+/**
+ * @brief Free a compact data tree.
+ *
+ * @param[in] tree Compact data tree to free.
+ */
+void lyd_compact_free(struct lyd_compact *tree);
+
 /**
  * @brief Merge a (sub)tree into a data tree.
  *
@@ -1331,6 +1593,24 @@ int lyd_value_type(struct lys_node *node, const char *value, struct lys_type **t
  */
 int lyd_wd_default(struct lyd_node_leaf_list *node);
 
+/**
+ * @brief Add the implicit default nodes into a data tree that was parsed or validated with #LYD_OPT_WD_LAZY.
+ *
+ * The default nodes are created the same way as by the validation (including the evaluation of their when
+ * conditions), but no other validation checks are performed. The nodes already present in the tree are not
+ * affected, so the function can be called repeatedly. To keep the source tree lazy (e.g. to print it with
+ * #LYP_WD_ALL), materialize the default nodes in its duplicate.
+ *
+ * @param[in,out] node Data tree to add the default nodes into. If it is an inner node, only its subtree is
+ *                     processed. It can be changed in case a new top-level default node is added before it.
+ * @param[in] ctx Context of the data tree, used only if \p node points to an empty tree.
+ * @param[in] options Data type of the tree (one of the @ref parseroptions data type flags, e.g. #LYD_OPT_CONFIG) and
+ *                    optionally #LYD_OPT_NOSIBLINGS. In case of #LYD_OPT_RPC, #LYD_OPT_RPCREPLY or #LYD_OPT_NOTIF,
+ *                    the tree must contain the operation/notification.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lyd_wd_materialize(struct lyd_node **node, struct ly_ctx *ctx, int options);
+
 /**
  * @brief Learn if a node is supposed to be printed based on the options.
  *
@@ -1438,7 +1718,7 @@ const struct lys_type *lyd_leaf_type(const struct lyd_node_leaf_list *leaf);
 * @param[in] root Root node of the data tree to print. It can be actually any (not only real root)
 * node of the data tree to print the specific subtree.
 * @param[in] format Data output format.
-* @param[in] options [printer flags](@ref printerflags). \p format LYD_LYB accepts only #LYP_WITHSIBLINGS option.
+* @param[in] options [printer flags](@ref printerflags). \p format LYD_LYB accepts only #LYP_WITHSIBLINGS and #LYP_PARALLEL options.
 * @return 0 on success, 1 on failure (#ly_errno is set).
 */
 int lyd_print_mem(char **strp, const struct lyd_node *root, LYD_FORMAT format, int options);
@@ -1450,7 +1730,7 @@ int lyd_print_mem(char **strp, const struct lyd_node *root, LYD_FORMAT format, i
  * @param[in] root Root node of the data tree to print. It can be actually any (not only real root)
  * node of the data tree to print the specific subtree.
  * @param[in] format Data output format.
- * @param[in] options [printer flags](@ref printerflags). \p format LYD_LYB accepts only #LYP_WITHSIBLINGS option.
+ * @param[in] options [printer flags](@ref printerflags). \p format LYD_LYB accepts only #LYP_WITHSIBLINGS and #LYP_PARALLEL options.
  * @return 0 on success, 1 on failure (#ly_errno is set).
  */
 int lyd_print_fd(int fd, const struct lyd_node *root, LYD_FORMAT format, int options);
@@ -1462,7 +1742,7 @@ int lyd_print_fd(int fd, const struct lyd_node *root, LYD_FORMAT format, int opt
  * @param[in] root Root node of the data tree to print. It can be actually any (not only real root)
  * node of the data tree to print the specific subtree.
  * @param[in] format Data output format.
- * @param[in] options [printer flags](@ref printerflags). \p format LYD_LYB accepts only #LYP_WITHSIBLINGS option.
+ * @param[in] options [printer flags](@ref printerflags). \p format LYD_LYB accepts only #LYP_WITHSIBLINGS and #LYP_PARALLEL options.
  * @return 0 on success, 1 on failure (#ly_errno is set).
  */
 int lyd_print_file(FILE *f, const struct lyd_node *root, LYD_FORMAT format, int options);
@@ -1474,7 +1754,7 @@ int lyd_print_file(FILE *f, const struct lyd_node *root, LYD_FORMAT format, int
  * @param[in] root Root node of the data tree to print. It can be actually any (not only real root)
  * node of the data tree to print the specific subtree.
  * @param[in] format Data output format.
- * @param[in] options [printer flags](@ref printerflags). \p format LYD_LYB accepts only #LYP_WITHSIBLINGS option.
+ * @param[in] options [printer flags](@ref printerflags). \p format LYD_LYB accepts only #LYP_WITHSIBLINGS and #LYP_PARALLEL options.
  * @return 0 on success, 1 on failure (#ly_errno is set).
  */
 int lyd_print_path(const char *path, const struct lyd_node *root, LYD_FORMAT format, int options);
@@ -1487,12 +1767,124 @@ int lyd_print_path(const char *path, const struct lyd_node *root, LYD_FORMAT for
  * node of the data tree to print the specific subtree.
  * @param[in] arg Optional caller-specific argument to be passed to the \p writeclb callback.
  * @param[in] format Data output format.
- * @param[in] options [printer flags](@ref printerflags). \p format LYD_LYB accepts only #LYP_WITHSIBLINGS option.
+ * @param[in] options [printer flags](@ref printerflags). \p format LYD_LYB accepts only #LYP_WITHSIBLINGS and #LYP_PARALLEL options.
  * @return 0 on success, 1 on failure (#ly_errno is set).
  */
 int lyd_print_clb(ssize_t (*writeclb)(void *arg, const void *buf, size_t count), void *arg,
                   const struct lyd_node *root, LYD_FORMAT format, int options);
 
+/**
+ * @brief Convert data from one format into another without building the whole data tree.
+ *
+ * XML and JSON data are parsed and printed in chunks of sibling subtrees of about 64 kB, larger
+ * containers and list instances are printed in parts, even inside a single top-level subtree. So only
+ * the currently printed chunk and its ancestors are held in memory rather than the whole data.
+ * The values are still checked, but the data cannot be validated as a whole (as if #LYD_OPT_TRUSTED
+ * was used) and implicit default nodes are not printed. All the instances of a list or leaf-list
+ * must be adjacent to be printed as JSON. #LYD_LYB data (input or output), #LYD_OPT_NOSIBLINGS,
+ * and #LYD_OPT_DATA_ADD_YANGLIB need the whole data tree, so they are not supported.
+ * To transcode input arriving in pieces, use lyd_transcoder_new().
+ *
+ * @param[in] ctx Context to connect with the data.
+ * @param[in] data Serialized data in the \p in_format.
+ * @param[in] in_format Format of the input \p data.
+ * @param[in] parse_options Parser options (@ref parseroptions), only data trees (#LYD_OPT_DATA, #LYD_OPT_CONFIG,
+ * #LYD_OPT_GET, #LYD_OPT_GETCONFIG, and #LYD_OPT_EDIT) are supported.
+ * @param[out] strp Pointer to store the resulting dump.
+ * @param[in] out_format Data output format.
+ * @param[in] print_options [printer flags](@ref printerflags), #LYP_WITHSIBLINGS is always used.
+ * @return 0 on success, 1 on failure (#ly_errno is set).
+ */
+int lyd_transcode_mem(struct ly_ctx *ctx, const char *data, LYD_FORMAT in_format, int parse_options, char **strp,
+                      LYD_FORMAT out_format, int print_options);
+
+/**
+ * @brief Convert data from one format into another without building the whole data tree.
+ *
+ * See lyd_transcode_mem() for the details.
+ *
+ * @param[in] ctx Context to connect with the data.
+ * @param[in] data Serialized data in the \p in_format.
+ * @param[in] in_format Format of the input \p data.
+ * @param[in] parse_options Parser options (@ref parseroptions).
+ * @param[in] fd File descriptor where to print the data.
+ * @param[in] out_format Data output format.
+ * @param[in] print_options [printer flags](@ref printerflags).
+ * @return 0 on success, 1 on failure (#ly_errno is set).
+ */
+int lyd_transcode_fd(struct ly_ctx *ctx, const char *data, LYD_FORMAT in_format, int parse_options, int fd,
+                     LYD_FORMAT out_format, int print_options);
+
+/**
+ * @brief Convert data from one format into another without building the whole data tree.
+ *
+ * See lyd_transcode_mem() for the details.
+ *
+ * @param[in] ctx Context to connect with the data.
+ * @param[in] data Serialized data in the \p in_format.
+ * @param[in] in_format Format of the input \p data.
+ * @param[in] parse_options Parser options (@ref parseroptions).
+ * @param[in] writeclb Callback function to write the data (see write(1)).
+ * @param[in] arg Optional caller-specific argument to be passed to the \p writeclb callback.
+ * @param[in] out_format Data output format.
+ * @param[in] print_options [printer flags](@ref printerflags).
+ * @return 0 on success, 1 on failure (#ly_errno is set).
+ */
+int lyd_transcode_clb(struct ly_ctx *ctx, const char *data, LYD_FORMAT in_format, int parse_options,
+                      ssize_t (*writeclb)(void *arg, const void *buf, size_t count), void *arg,
+                      LYD_FORMAT out_format, int print_options);
+
+/**
+ * @brief Incremental transcoder, opaque structure created by lyd_transcoder_new().
+ */
+struct lyd_transcoder;
+
+/**
+ * @brief Create a transcoder of data arriving in pieces.
+ *
+ * The data are passed by lyd_transcoder_feed() and converted as in lyd_transcode_mem(), the transcoded
+ * data are written by \p writeclb as soon as they are read. Only the data not read yet (usually just
+ * the end of the last piece) are kept, so neither the input nor the output is held in memory as a whole.
+ *
+ * @param[in] ctx Context to connect with the data.
+ * @param[in] in_format Format of the input data, #LYD_XML or #LYD_JSON.
+ * @param[in] parse_options Parser options (@ref parseroptions), only data trees are supported.
+ * @param[in] writeclb Callback function to write the data (see write(1)).
+ * @param[in] arg Optional caller-specific argument to be passed to the \p writeclb callback.
+ * @param[in] out_format Data output format, #LYD_XML or #LYD_JSON.
+ * @param[in] print_options [printer flags](@ref printerflags), #LYP_WITHSIBLINGS is always used.
+ * @return Transcoder to be finished by lyd_transcoder_finish() or freed by lyd_transcoder_free(),
+ * NULL on error.
+ */
+struct lyd_transcoder *lyd_transcoder_new(struct ly_ctx *ctx, LYD_FORMAT in_format, int parse_options,
+                                          ssize_t (*writeclb)(void *arg, const void *buf, size_t count), void *arg,
+                                          LYD_FORMAT out_format, int print_options);
+
+/**
+ * @brief Pass the next piece of the input data to a transcoder.
+ *
+ * @param[in] tc Transcoder.
+ * @param[in] data Next piece of the data, it does not need to be terminated by a zero byte.
+ * @param[in] len Length of \p data.
+ * @return 0 on success, 1 on failure (#ly_errno is set), the transcoder can then only be freed.
+ */
+int lyd_transcoder_feed(struct lyd_transcoder *tc, const char *data, size_t len);
+
+/**
+ * @brief Transcode the rest of the input data and free the transcoder.
+ *
+ * @param[in] tc Transcoder, it is always freed.
+ * @return 0 on success, 1 on failure (#ly_errno is set).
+ */
+int lyd_transcoder_finish(struct lyd_transcoder *tc);
+
+/**
+ * @brief Free a transcoder without finishing it.
+ *
+ * @param[in] tc Transcoder to free.
+ */
+void lyd_transcoder_free(struct lyd_transcoder *tc);
+
 /**
  * @brief Get the double value of a decimal64 leaf/leaf-list.
  *
@@ -1512,6 +1904,47 @@ double lyd_dec64_to_double(const struct lyd_node *node);
  */
 int lyd_lyb_data_length(const char *data);
 
+/**
+ * @brief Statistics of hash tables, see lyd_tree_stats() and ly_ctx_stats().
+ */
+struct ly_ht_stats {
+    uint32_t count;                  /**< number of hash tables */
+    uint32_t size;                   /**< number of allocated records */
+    uint32_t used;                   /**< number of used records */
+    uint32_t probe_max;              /**< longest distance of a record from the record given by its hash */
+    uint64_t probe_total;            /**< sum of the distances of all the records from the records given by their hashes,
+                                          probe_total / used is the average collision chain length */
+    size_t bytes;                    /**< allocated memory */
+};
+
+/**
+ * @brief Statistics of a data tree, see lyd_tree_stats().
+ */
+struct lyd_tree_stats {
+    uint32_t nodes;                  /**< number of all the data nodes */
+    uint32_t containers;             /**< number of containers */
+    uint32_t lists;                  /**< number of list instances */
+    uint32_t leaves;                 /**< number of leaves */
+    uint32_t leaflists;              /**< number of leaf-list instances */
+    uint32_t anydata;                /**< number of anydata and anyxml nodes */
+    uint32_t operations;             /**< number of RPC, action, and notification nodes */
+    uint32_t dflt;                   /**< number of default nodes */
+    uint32_t attrs;                  /**< number of attributes */
+    size_t bytes;                    /**< memory of the node and attribute structures and the children hash tables,
+                                          the values stored in the context dictionary are not included */
+    struct ly_ht_stats child_ht;     /**< hash tables of the children (available only with the cache enabled) */
+};
+
+/**
+ * @brief Get the memory usage and other statistics of a data tree.
+ *
+ * @param[in] node Data tree to examine.
+ * @param[in] withsiblings Whether to include also all the siblings of \p node.
+ * @param[out] stats Statistics to fill.
+ * @return 0 on success, nonzero in case of an error.
+ */
+int lyd_tree_stats(const struct lyd_node *node, int withsiblings, struct lyd_tree_stats *stats);
+
 #ifdef LY_ENABLED_LYD_PRIV
 
 /**
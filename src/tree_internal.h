@@ -64,6 +64,117 @@ struct lyd_node_pos {
     uint32_t pos;
 };
 
+/**
+ * @brief Internal structure of a compiled data path, see ly_path_compile().
+ */
+struct ly_path {
+    struct ly_ctx *ctx;
+    struct ly_path_step {
+        const struct lys_node *schema;  /**< data schema node of the step */
+        uint32_t hash;                  /**< precomputed data node hash, unused for lists and leaf-lists */
+        uint16_t slot;                  /**< index of the first value slot of a list or leaf-list */
+    } *steps;
+    uint16_t count;                     /**< number of steps */
+    uint16_t slot_count;                /**< number of value slots */
+};
+
+/**
+ * @brief Internal structure of a batch of data node creations, see lyd_batch_new().
+ */
+struct lyd_batch {
+    struct ly_ctx *ctx;
+    struct lyd_node *tree;              /**< any top-level node of the data tree */
+    int options;                        /**< path options */
+    char *path;                         /**< previous path */
+    size_t path_size;                   /**< allocated size of path */
+    struct lyd_batch_level {
+        size_t end;                     /**< end offset of the path segment in path */
+        struct lyd_node *node;          /**< data node of the path segment */
+    } *levels;                          /**< cursor, nodes of all the segments of path */
+    uint16_t depth;                     /**< number of valid levels */
+    uint16_t size;                      /**< allocated levels */
+};
+
+/**
+ * @brief Text length of sibling subtrees read at once by a chunk reader, also the length of a container
+ * or list instance from which it is not read whole, but its node is opened and its children read in chunks.
+ */
+#define LYD_CHUNK_SIZE 65536
+
+/**
+ * @brief Events of a chunk reader, see ::lyd_chunk_clb.
+ */
+#define LYD_CHUNK_OPEN  1               /**< node was created, its children follow in the next events */
+#define LYD_CHUNK_NODES 2               /**< node and all its following siblings are complete subtrees */
+#define LYD_CHUNK_CLOSE 3               /**< all the children of the opened node were read */
+
+/**
+ * @brief Callback for the data read in chunks.
+ *
+ * The callback takes over the top-level nodes of #LYD_CHUNK_OPEN and #LYD_CHUNK_NODES events, even if it fails.
+ * Other nodes are linked into the opened parent, the callback may free them once passed, but an opened node
+ * only after its #LYD_CHUNK_CLOSE event.
+ *
+ * @param[in] event Chunk event.
+ * @param[in] node Node of the event.
+ * @param[in] arg Arbitrary user argument.
+ * @return 0 on success, non-zero to stop reading.
+ */
+typedef int (*lyd_chunk_clb)(int event, struct lyd_node *node, void *arg);
+
+/**
+ * @brief Resumable scanner of the next subtree in the data read by a chunk reader.
+ */
+struct lyd_chunk_scan {
+    size_t scanned;                     /**< offset in the subtree up to which it was scanned */
+    size_t stag_len;                    /**< XML length of the start tag, 0 if not scanned yet */
+    uint32_t depth;                     /**< element/object nesting depth */
+    uint8_t state;                      /**< scanner state */
+    uint8_t whole;                      /**< subtree cannot be opened, scan it whole */
+    char quote;                         /**< XML attribute value quote */
+};
+
+/**
+ * @brief Internal structure of a chunk reader of XML and JSON data trees, see lyp_chunk_reader_init().
+ */
+struct lyd_chunk_reader {
+    struct ly_ctx *ctx;
+    LYD_FORMAT format;
+    int options;                        /**< parser options */
+    lyd_chunk_clb clb;
+    void *arg;
+    struct unres_data *unres;           /**< unresolved items of the chunk */
+
+    struct lyd_node *parent;            /**< innermost opened node, NULL on the top level */
+    struct lyd_node *chunk;             /**< first node of the chunk being read */
+    size_t chunk_len;                   /**< text length of the chunk */
+    struct lyd_chunk_scan scan;         /**< scanner of the next subtree */
+
+    struct lyxml_elem *xml_parent;      /**< XML start tag of the innermost opened element */
+
+    struct lyd_chunk_json_frame *frames; /**< JSON objects and arrays being read, the first is the top-level object */
+    uint32_t frame_count;
+    uint32_t frame_size;
+    uint8_t done;                       /**< JSON top-level object was read */
+};
+
+/**
+ * @brief Internal structure of an incremental data parser, see lyd_parser_new().
+ */
+struct lyd_parser {
+    struct ly_ctx *ctx;
+    LYD_FORMAT format;
+    int options;                        /**< parser options */
+    int error;                          /**< parsing failed */
+    struct lyd_node *tree;              /**< first top-level sibling of the data parsed so far */
+
+    char *buf;                          /**< data not read yet */
+    size_t len;                         /**< length of the data in buf */
+    size_t size;                        /**< allocated size of buf */
+
+    struct lyd_chunk_reader reader;     /**< reader of XML and JSON data */
+};
+
 /**
  * @brief Internal structure for LYB parser/printer.
  */
@@ -164,6 +275,8 @@ int lyb_has_schema_model(struct lys_node *sibling, const struct lys_module **mod
 
     void lyd_insert_hash(struct lyd_node *node);
 
+    int lyd_insert_hash_bulk(struct lyd_node *node);
+
     void lyd_unlink_hash(struct lyd_node *node, struct lyd_node *orig_parent);
 #endif
 
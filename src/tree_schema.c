@@ -1109,7 +1109,14 @@ lys_parse_mem(struct ly_ctx *ctx, const char *data, LYS_INFORMAT format)
 {
     FUN_IN;
 
-    return lys_parse_mem_(ctx, data, format, NULL, 0, 1);
+    const struct lys_module *mod;
+    uint64_t prof;
+
+    LY_PROF_START(prof);
+    mod = lys_parse_mem_(ctx, data, format, NULL, 0, 1);
+    LY_PROF_STOP(LY_PROF_SCHEMA_PARSE, prof);
+
+    return mod;
 }
 
 struct lys_submodule *
@@ -1222,7 +1229,15 @@ lys_parse_fd(struct ly_ctx *ctx, int fd, LYS_INFORMAT format)
 {
     FUN_IN;
 
-    return lys_parse_fd_(ctx, fd, format, NULL, 1);
+    const struct lys_module *mod;
+    uint64_t prof;
+
+    /* including mapping the file */
+    LY_PROF_START(prof);
+    mod = lys_parse_fd_(ctx, fd, format, NULL, 1);
+    LY_PROF_STOP(LY_PROF_SCHEMA_PARSE, prof);
+
+    return mod;
 }
 
 static void
@@ -1663,6 +1678,109 @@ lys_restr_dup(struct lys_module *mod, struct lys_restr *old, int size, int shall
     return result;
 }
 
+static int
+lys_type_share_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    return ((struct ly_type_share *)val1_p)->info == ((struct ly_type_share *)val2_p)->info;
+}
+
+static uint32_t
+lys_type_share_hash(const void *info)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&info, sizeof info);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Use a type restriction array in another type instead of duplicating it.
+ *
+ * @param[in] ctx Context with the shared arrays.
+ * @param[in] info Array to share.
+ * @return \p info, NULL on error.
+ */
+static void *
+lys_type_info_share(struct ly_ctx *ctx, void *info)
+{
+    struct ly_type_share rec, *match;
+    uint32_t hash;
+
+    if (!ctx->type_shares) {
+        ctx->type_shares = lyht_new(8, sizeof rec, lys_type_share_equal, NULL, 1);
+        LY_CHECK_ERR_RETURN(!ctx->type_shares, LOGMEM(ctx), NULL);
+    }
+
+    rec.info = info;
+    hash = lys_type_share_hash(info);
+    if (!lyht_find(ctx->type_shares, &rec, hash, (void **)&match)) {
+        ++match->refcount;
+    } else {
+        /* the original type and the new one */
+        rec.refcount = 2;
+        if (lyht_insert(ctx->type_shares, &rec, hash, NULL)) {
+            LOGINT(ctx);
+            return NULL;
+        }
+    }
+
+    return info;
+}
+
+/**
+ * @brief Stop using a type restriction array.
+ *
+ * @param[in] ctx Context with the shared arrays.
+ * @param[in] info Array that is no longer used by a type.
+ * @return 1 if the array is still used by another type, 0 if it should be freed.
+ */
+static int
+lys_type_info_unshare(struct ly_ctx *ctx, const void *info)
+{
+    struct ly_type_share rec, *match;
+    uint32_t hash;
+
+    if (!ctx->type_shares || !info) {
+        return 0;
+    }
+
+    rec.info = info;
+    hash = lys_type_share_hash(info);
+    if (lyht_find(ctx->type_shares, &rec, hash, (void **)&match)) {
+        return 0;
+    }
+
+    if (--match->refcount == 1) {
+        /* the last user owns the array again */
+        lyht_remove(ctx->type_shares, &rec, hash);
+    }
+    return 1;
+}
+
+/* type restrictions with extension instances are always duplicated, these belong to the module of the type */
+static int
+lys_restr_shareable(const struct lys_restr *restr, int size)
+{
+    int i;
+
+    for (i = 0; i < size; i++) {
+        if (restr[i].ext_size) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static struct lys_restr *
+lys_type_restr_dup(struct lys_module *mod, struct lys_restr *old, int size, int share, int shallow,
+                   struct unres_schema *unres)
+{
+    if (share && lys_restr_shareable(old, size)) {
+        return lys_type_info_share(mod->ctx, old);
+    }
+    return lys_restr_dup(mod, old, size, shallow, unres);
+}
+
 void
 lys_restr_free(struct ly_ctx *ctx, struct lys_restr *restr,
                void (*private_destructor)(const struct lys_node *node, void *priv))
@@ -1698,9 +1816,13 @@ lys_iffeature_free(struct ly_ctx *ctx, struct lys_iffeature *iffeature, uint8_t
     free(iffeature);
 }
 
+/*
+ * share - whether the restrictions of a resolved type can be shared instead of duplicated,
+ *         they are never modified once the type is resolved
+ */
 static int
 type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *new, struct lys_type *old,
-         LY_DATA_TYPE base, int in_grp, int shallow, struct unres_schema *unres)
+         LY_DATA_TYPE base, int in_grp, int share, int shallow, struct unres_schema *unres)
 {
     int i;
     unsigned int u;
@@ -1708,12 +1830,24 @@ type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *new,
     switch (base) {
     case LY_TYPE_BINARY:
         if (old->info.binary.length) {
-            new->info.binary.length = lys_restr_dup(mod, old->info.binary.length, 1, shallow, unres);
+            new->info.binary.length = lys_type_restr_dup(mod, old->info.binary.length, 1, share, shallow, unres);
         }
         break;
 
     case LY_TYPE_BITS:
         new->info.bits.count = old->info.bits.count;
+        if (new->info.bits.count && share) {
+            for (u = 0; u < old->info.bits.count; u++) {
+                if (old->info.bits.bit[u].ext_size || old->info.bits.bit[u].iffeature_size) {
+                    break;
+                }
+            }
+            if (u == old->info.bits.count) {
+                new->info.bits.bit = lys_type_info_share(mod->ctx, old->info.bits.bit);
+                LY_CHECK_RETURN(!new->info.bits.bit, -1);
+                break;
+            }
+        }
         if (new->info.bits.count) {
             new->info.bits.bit = calloc(new->info.bits.count, sizeof *new->info.bits.bit);
             LY_CHECK_ERR_RETURN(!new->info.bits.bit, LOGMEM(mod->ctx), -1);
@@ -1738,12 +1872,24 @@ type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *new,
         new->info.dec64.dig = old->info.dec64.dig;
         new->info.dec64.div = old->info.dec64.div;
         if (old->info.dec64.range) {
-            new->info.dec64.range = lys_restr_dup(mod, old->info.dec64.range, 1, shallow, unres);
+            new->info.dec64.range = lys_type_restr_dup(mod, old->info.dec64.range, 1, share, shallow, unres);
         }
         break;
 
     case LY_TYPE_ENUM:
         new->info.enums.count = old->info.enums.count;
+        if (new->info.enums.count && share) {
+            for (u = 0; u < old->info.enums.count; u++) {
+                if (old->info.enums.enm[u].ext_size || old->info.enums.enm[u].iffeature_size) {
+                    break;
+                }
+            }
+            if (u == old->info.enums.count) {
+                new->info.enums.enm = lys_type_info_share(mod->ctx, old->info.enums.enm);
+                LY_CHECK_RETURN(!new->info.enums.enm, -1);
+                break;
+            }
+        }
         if (new->info.enums.count) {
             new->info.enums.enm = calloc(new->info.enums.count, sizeof *new->info.enums.enm);
             LY_CHECK_ERR_RETURN(!new->info.enums.enm, LOGMEM(mod->ctx), -1);
@@ -1798,7 +1944,7 @@ type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *new,
     case LY_TYPE_UINT32:
     case LY_TYPE_UINT64:
         if (old->info.num.range) {
-            new->info.num.range = lys_restr_dup(mod, old->info.num.range, 1, shallow, unres);
+            new->info.num.range = lys_type_restr_dup(mod, old->info.num.range, 1, share, shallow, unres);
         }
         break;
 
@@ -1814,10 +1960,11 @@ type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *new,
 
     case LY_TYPE_STRING:
         if (old->info.str.length) {
-            new->info.str.length = lys_restr_dup(mod, old->info.str.length, 1, shallow, unres);
+            new->info.str.length = lys_type_restr_dup(mod, old->info.str.length, 1, share, shallow, unres);
         }
         if (old->info.str.pat_count) {
-            new->info.str.patterns = lys_restr_dup(mod, old->info.str.patterns, old->info.str.pat_count, shallow, unres);
+            new->info.str.patterns = lys_type_restr_dup(mod, old->info.str.patterns, old->info.str.pat_count, share,
+                                                        shallow, unres);
             new->info.str.pat_count = old->info.str.pat_count;
 #ifdef LY_ENABLED_CACHE
             if (!in_grp) {
@@ -1877,7 +2024,7 @@ lys_yang_type_dup(struct lys_module *module, struct lys_node *parent, struct yan
         LOGMEM(module->ctx);
         goto error;
     }
-    if (type_dup(module, parent, type, old->type, new->base, in_grp, shallow, unres)) {
+    if (type_dup(module, parent, type, old->type, new->base, in_grp, 0, shallow, unres)) {
         new->type->base = new->base;
         lys_type_free(module->ctx, new->type, NULL);
         memset(&new->type->info, 0, sizeof new->type->info);
@@ -2291,7 +2438,7 @@ lys_type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *n
         return EXIT_SUCCESS;
     }
 
-    return type_dup(mod, parent, new, old, new->base, in_grp, shallow, unres);
+    return type_dup(mod, parent, new, old, new->base, in_grp, !shallow, shallow, unres);
 }
 
 void
@@ -2299,6 +2446,7 @@ lys_type_free(struct ly_ctx *ctx, struct lys_type *type,
               void (*private_destructor)(const struct lys_node *node, void *priv))
 {
     unsigned int i;
+    int shared;
 
     assert(ctx);
     if (!type) {
@@ -2309,10 +2457,16 @@ lys_type_free(struct ly_ctx *ctx, struct lys_type *type,
 
     switch (type->base) {
     case LY_TYPE_BINARY:
+        if (lys_type_info_unshare(ctx, type->info.binary.length)) {
+            break;
+        }
         lys_restr_free(ctx, type->info.binary.length, private_destructor);
         free(type->info.binary.length);
         break;
     case LY_TYPE_BITS:
+        if (lys_type_info_unshare(ctx, type->info.bits.bit)) {
+            break;
+        }
         for (i = 0; i < type->info.bits.count; i++) {
             lydict_remove(ctx, type->info.bits.bit[i].name);
             lydict_remove(ctx, type->info.bits.bit[i].dsc);
@@ -2326,11 +2480,17 @@ lys_type_free(struct ly_ctx *ctx, struct lys_type *type,
         break;
 
     case LY_TYPE_DEC64:
+        if (lys_type_info_unshare(ctx, type->info.dec64.range)) {
+            break;
+        }
         lys_restr_free(ctx, type->info.dec64.range, private_destructor);
         free(type->info.dec64.range);
         break;
 
     case LY_TYPE_ENUM:
+        if (lys_type_info_unshare(ctx, type->info.enums.enm)) {
+            break;
+        }
         for (i = 0; i < type->info.enums.count; i++) {
             lydict_remove(ctx, type->info.enums.enm[i].name);
             lydict_remove(ctx, type->info.enums.enm[i].dsc);
@@ -2351,6 +2511,9 @@ lys_type_free(struct ly_ctx *ctx, struct lys_type *type,
     case LY_TYPE_UINT16:
     case LY_TYPE_UINT32:
     case LY_TYPE_UINT64:
+        if (lys_type_info_unshare(ctx, type->info.num.range)) {
+            break;
+        }
         lys_restr_free(ctx, type->info.num.range, private_destructor);
         free(type->info.num.range);
         break;
@@ -2360,18 +2523,26 @@ lys_type_free(struct ly_ctx *ctx, struct lys_type *type,
         break;
 
     case LY_TYPE_STRING:
-        lys_restr_free(ctx, type->info.str.length, private_destructor);
-        free(type->info.str.length);
+        if (!lys_type_info_unshare(ctx, type->info.str.length)) {
+            lys_restr_free(ctx, type->info.str.length, private_destructor);
+            free(type->info.str.length);
+        }
+        shared = lys_type_info_unshare(ctx, type->info.str.patterns);
         for (i = 0; i < type->info.str.pat_count; i++) {
-            lys_restr_free(ctx, &type->info.str.patterns[i], private_destructor);
+            if (!shared) {
+                lys_restr_free(ctx, &type->info.str.patterns[i], private_destructor);
+            }
 #ifdef LY_ENABLED_CACHE
+            /* compiled patterns are never shared */
             if (type->info.str.patterns_pcre) {
                 pcre_free((pcre*)type->info.str.patterns_pcre[2 * i]);
                 pcre_free_study((pcre_extra*)type->info.str.patterns_pcre[2 * i + 1]);
             }
 #endif
         }
-        free(type->info.str.patterns);
+        if (!shared) {
+            free(type->info.str.patterns);
+        }
 #ifdef LY_ENABLED_CACHE
         free(type->info.str.patterns_pcre);
 #endif
@@ -3835,6 +4006,8 @@ lys_free(struct lys_module *module, void (*private_destructor)(const struct lys_
                     memmove(&ctx->models.list[i], ctx->models.list[i + 1], (ctx->models.used - i) * sizeof *ctx->models.list);
                 }
                 ctx->models.list[ctx->models.used] = NULL;
+                ctx->models.module_set_id++;
+                ctx->models.module_set_gen++;
                 /* we are done */
                 break;
             }
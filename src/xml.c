@@ -1025,8 +1025,12 @@ process:
         /* process element content */
         c++;
         lws = NULL;
+        if (options & LYXML_PARSE_STAG) {
+            /* only the start tag */
+            closed_flag = 1;
+        }
 
-        while (*c) {
+        while (*c && !closed_flag) {
             if (!strncmp(c, "</", 2)) {
                 if (lws && !elem->child) {
                     /* leading white spaces were actually content */
@@ -1237,31 +1241,19 @@ error:
 }
 
 /* logs directly */
-API struct lyxml_elem *
-lyxml_parse_mem(struct ly_ctx *ctx, const char *data, int options)
+struct lyxml_elem *
+lyxml_parse_next(struct ly_ctx *ctx, const char **data, int options)
 {
-    FUN_IN;
-
-    const char *c = data;
+    const char *c = *data;
     unsigned int len;
-    struct lyxml_elem *root, *first = NULL, *next;
-
-    if (!ctx) {
-        LOGARG;
-        return NULL;
-    }
-
-    if (!data) {
-        /* nothing to parse */
-        return NULL;
-    }
+    struct lyxml_elem *elem;
 
-repeat:
     /* process document */
     while (1) {
         if (!*c) {
             /* eof */
-            return first;
+            *data = c;
+            return NULL;
         } else if (is_xmlws(*c)) {
             /* skip whitespaces */
             ign_xmlws(c);
@@ -1269,21 +1261,21 @@ repeat:
             /* XMLDecl or PI - ignore it */
             c += 2;
             if (parse_ignore(ctx, c, "?>", &len)) {
-                goto error;
+                return NULL;
             }
             c += len;
         } else if (!strncmp(c, "<!--", 4)) {
             /* Comment - ignore it */
             c += 2;
             if (parse_ignore(ctx, c, "-->", &len)) {
-                goto error;
+                return NULL;
             }
             c += len;
         } else if (!strncmp(c, "<!", 2)) {
             /* DOCTYPE */
             /* TODO - standalone ignore counting < and > */
             LOGERR(ctx, LY_EINVAL, "DOCTYPE not supported in XML documents.");
-            goto error;
+            return NULL;
         } else if (*c == '<') {
             /* element - process it in next loop to strictly follow XML
              * format
@@ -1291,31 +1283,63 @@ repeat:
             break;
         } else {
             LOGVAL(ctx, LYE_XML_INCHAR, LY_VLOG_NONE, NULL, c);
-            goto error;
+            return NULL;
         }
     }
 
-    root = lyxml_parse_elem(ctx, c, &len, NULL, options);
-    if (!root) {
-        goto error;
-    } else if (!first) {
-        first = root;
-    } else {
-        first->prev->next = root;
-        root->prev = first->prev;
-        first->prev = root;
+    elem = lyxml_parse_elem(ctx, c, &len, NULL, options);
+    if (!elem) {
+        return NULL;
     }
     c += len;
 
-    /* ignore the rest of document where can be comments, PIs and whitespaces,
-     * note that we are not detecting syntax errors in these parts
-     */
+    /* ignore the whitespaces after the element, note that we are not
+     * detecting syntax errors in the rest of the document here */
     ign_xmlws(c);
-    if (*c) {
-        if (options & LYXML_PARSE_MULTIROOT) {
-            goto repeat;
+
+    *data = c;
+    return elem;
+}
+
+/* logs directly */
+API struct lyxml_elem *
+lyxml_parse_mem(struct ly_ctx *ctx, const char *data, int options)
+{
+    FUN_IN;
+
+    const char *c = data;
+    struct lyxml_elem *root, *first = NULL, *next;
+
+    if (!ctx) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (!data) {
+        /* nothing to parse */
+        return NULL;
+    }
+
+    while (*c) {
+        root = lyxml_parse_next(ctx, &c, options);
+        if (!root) {
+            if (*c) {
+                goto error;
+            }
+            /* eof */
+            break;
+        } else if (!first) {
+            first = root;
         } else {
+            first->prev->next = root;
+            root->prev = first->prev;
+            first->prev = root;
+        }
+
+        /* there can be comments, PIs and whitespaces in the rest of the document */
+        if (*c && !(options & LYXML_PARSE_MULTIROOT)) {
             LOGWRN(ctx, "There are some not parsed data:\n%s", c);
+            break;
         }
     }
 
@@ -1373,7 +1397,7 @@ error:
 int
 lyxml_dump_text(struct lyout *out, const char *text, LYXML_DATA_TYPE type)
 {
-    unsigned int i, n;
+    unsigned int i, n, run;
 
     if (!text) {
         return 0;
@@ -1398,8 +1422,11 @@ lyxml_dump_text(struct lyout *out, const char *text, LYXML_DATA_TYPE type)
             }
             /* falls through */
         default:
-            ly_write(out, &text[i], 1);
-            n++;
+            /* write all the following characters that need no escaping at once */
+            run = 1 + strcspn(&text[i + 1], (type == LYXML_DATA_ATTR) ? "&<>\"" : "&<>");
+            ly_write(out, &text[i], run);
+            n += run;
+            i += run - 1;
         }
     }
 
@@ -1572,6 +1599,7 @@ lyxml_print_fd(int fd, const struct lyxml_elem *elem, int options)
     FUN_IN;
 
     struct lyout out;
+    int r;
 
     if (fd < 0 || !elem) {
         return 0;
@@ -1583,10 +1611,17 @@ lyxml_print_fd(int fd, const struct lyxml_elem *elem, int options)
     out.method.fd = fd;
 
     if (options & LYXML_PRINT_SIBLINGS) {
-        return dump_siblings(&out, elem, options);
+        r = dump_siblings(&out, elem, options);
     } else {
-        return dump_elem(&out, elem, 0, options, 1);
+        r = dump_elem(&out, elem, 0, options, 1);
+    }
+
+    if (ly_print_flush(&out)) {
+        LOGERR(NULL, LY_ESYS, "Print error (%s).", strerror(errno));
+        r = -1;
     }
+    free(out.fd_buf);
+    return r;
 }
 
 API int
@@ -214,7 +214,7 @@ int lyxml_print_file(FILE * stream, const struct lyxml_elem *elem, int options);
  * @param[in] fd File descriptor to print out the tree.
  * @param[in] elem Root element of the XML tree to print
  * @param[in] options Dump options, see @ref xmldumpoptions.
- * @return number of printed characters.
+ * @return number of printed characters, -1 if writing the data failed.
  */
 int lyxml_print_fd(int fd, const struct lyxml_elem *elem, int options);
 
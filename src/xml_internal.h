@@ -43,6 +43,11 @@
         (c >= 0xf900 && c <= 0xfdcf) || (c >= 0xfdf0 && c <= 0xfffd) || \
         (c >= 0x10000 && c <= 0xeffff))
 
+/**
+ * @brief Internal XML parser option, parse only the start tag of an element, its content is left unparsed.
+ */
+#define LYXML_PARSE_STAG 0x80
+
 /*
  * Functions
  * Tree Manipulation
@@ -60,6 +65,30 @@
  */
 int lyxml_add_child(struct ly_ctx *ctx, struct lyxml_elem *parent, struct lyxml_elem *child);
 
+/**
+ * @brief Parse the next top-level XML element from a document, skipping
+ * any whitespaces, comments, and processing instructions before it.
+ *
+ * @param[in] ctx libyang context to use.
+ * @param[in,out] data Position in the document, moved after the parsed element.
+ * @param[in] options Parser options (@ref xmlreadoptions).
+ * @return Parsed element, NULL on error or at the end of the document (\p data is then set to it).
+ */
+struct lyxml_elem *lyxml_parse_next(struct ly_ctx *ctx, const char **data, int options);
+
+/**
+ * @brief Parse an XML element.
+ *
+ * @param[in] ctx libyang context to use.
+ * @param[in] data Element in a document, starting with '<'.
+ * @param[out] len Length of the parsed element.
+ * @param[in] parent Parent element to add the element to and to resolve its namespaces in, may be NULL.
+ * @param[in] options Parser options (@ref xmlreadoptions or #LYXML_PARSE_STAG).
+ * @return Parsed element, NULL on error.
+ */
+struct lyxml_elem *lyxml_parse_elem(struct ly_ctx *ctx, const char *data, unsigned int *len, struct lyxml_elem *parent,
+                                    int options);
+
 /* copy_ns: 0 - set invalid namespaces to NULL, 1 - copy them into this subtree */
 void lyxml_correct_elem_ns(struct ly_ctx *ctx, struct lyxml_elem *elem, struct lyxml_elem *orig, int copy_ns,
                            int correct_attrs);
@@ -26,7 +26,6 @@
 #include <limits.h>
 #include <errno.h>
 #include <math.h>
-#include <pcre.h>
 
 #include "xpath.h"
 #include "libyang.h"
@@ -538,6 +537,24 @@ cast_string_elem(struct lyd_node *node, struct lys_module *local_mod, int fake_c
     return str;
 }
 
+/**
+ * @brief Check whether a data node is a dummy node, which is not considered part of the data tree.
+ *
+ * Nodes are either created dummy (#LYD_VAL_INUSE flag), or the context node is dummy for the evaluation
+ * with #LYXP_DUMMY_CTX, so that the evaluation itself does not modify the data tree.
+ *
+ * @param[in] node Node to check.
+ * @param[in] cur_node Original context node.
+ * @param[in] options XPath options.
+ *
+ * @return non-zero if dummy, 0 otherwise.
+ */
+static int
+node_is_dummy(const struct lyd_node *node, const struct lyd_node *cur_node, int options)
+{
+    return (node->validity & LYD_VAL_INUSE) || ((options & LYXP_DUMMY_CTX) && (node == cur_node));
+}
+
 /**
  * @brief Cast a LYXP_SET_NODE_SET set into a string.
  *        Context position aware.
@@ -554,7 +571,7 @@ cast_node_set_to_string(struct lyxp_set *set, struct lyd_node *cur_node, struct
     enum lyxp_node_type root_type;
     char *str;
 
-    if ((set->val.nodes[0].type != LYXP_NODE_ATTR) && (set->val.nodes[0].node->validity & LYD_VAL_INUSE)) {
+    if ((set->val.nodes[0].type != LYXP_NODE_ATTR) && node_is_dummy(set->val.nodes[0].node, cur_node, options)) {
         LOGVAL(local_mod->ctx, LYE_XPATH_DUMMY, LY_VLOG_LYD, set->val.nodes[0].node, set->val.nodes[0].node->schema->name);
         return NULL;
     }
@@ -1246,122 +1263,151 @@ retry:
 }
 
 /**
- * @brief Get unique \p node position in the data.
- *
- * @param[in] node Node to find.
- * @param[in] node_type Node type of \p node.
- * @param[in] root Root node.
- * @param[in] root_type Type of the XPath \p root node.
- * @param[in] prev Node that we think is before \p node in DFS from \p root. Can optionally
- * be used to increase efficiency and start the DFS from this node.
- * @param[in] prev_pos Node \p prev position. Optional, but must be set if \p prev is set.
- *
- * @return Node position.
+ * @brief Node (or attribute) with its position in the data, used when assigning positions.
  */
+struct set_pos_node {
+    const void *node;
+    uint32_t pos;
+};
+
+static int
+set_pos_equal_cb(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    return ((struct set_pos_node *)val1_p)->node == ((struct set_pos_node *)val2_p)->node;
+}
+
 static uint32_t
-get_node_pos(const struct lyd_node *node, enum lyxp_node_type node_type, const struct lyd_node *root,
-             enum lyxp_node_type root_type, const struct lyd_node **prev, uint32_t *prev_pos)
+set_pos_hash(const void *node)
 {
-    const struct lyd_node *next, *elem = NULL, *top_sibling;
-    uint32_t pos = 1;
+    uint32_t hash;
 
-    assert(prev && prev_pos && !root->prev->next);
+    hash = dict_hash_multi(0, (const char *)&node, sizeof node);
+    return dict_hash_multi(hash, NULL, 0);
+}
 
-    if ((node_type == LYXP_NODE_ROOT) || (node_type == LYXP_NODE_ROOT_CONFIG)) {
-        return 0;
+/**
+ * @brief Document positions of the data nodes learned during a single lyxp_eval() call.
+ *
+ * The positions are learned by a DFS that is resumed from where it stopped the last time,
+ * so the data tree is walked at most once for all the sorts and merges of an evaluation.
+ */
+struct set_pos_cache {
+    const struct lyd_node *root;    /**< context root the positions are relative to */
+    enum lyxp_node_type root_type;  /**< context root type */
+    struct hash_table *ht;          /**< learned positions of nodes and attributes (struct set_pos_node) */
+    const struct lyd_node *next;    /**< next node to walk, NULL if the whole tree was walked */
+    uint32_t pos;                   /**< position of the last walked node */
+};
+
+/* positions of the evaluation in progress in this thread */
+static THREAD_LOCAL struct set_pos_cache *set_pos_cache;
+
+static void
+set_pos_cache_clean(struct set_pos_cache *cache)
+{
+    lyht_free(cache->ht);
+    memset(cache, 0, sizeof *cache);
+}
+
+/**
+ * @brief Learn the position of a node and of its attributes.
+ *
+ * @param[in] ht Hash table with the learned positions.
+ * @param[in] elem Node to learn.
+ * @param[in] pos Position of \p elem.
+ * @param[in] node Node or attribute being looked for.
+ *
+ * @return 1 if \p node was learned, 0 if not, -1 on error.
+ */
+static int
+set_pos_learn(struct hash_table *ht, const struct lyd_node *elem, uint32_t pos, const void *node)
+{
+    struct set_pos_node pnode;
+    struct lyd_attr *attr;
+    int found = 0;
+
+    pnode.node = elem;
+    pnode.pos = pos;
+    LY_CHECK_RETURN(lyht_insert(ht, &pnode, set_pos_hash(elem), NULL) == -1, -1);
+    if (elem == node) {
+        found = 1;
     }
 
-    if (*prev) {
-        /* start from the previous element instead from the root */
-        elem = next = *prev;
-        pos = *prev_pos;
-        for (top_sibling = elem; top_sibling->parent; top_sibling = top_sibling->parent);
-        goto dfs_search;
+    /* attributes have the position of their parent */
+    for (attr = elem->attr; attr; attr = attr->next) {
+        pnode.node = attr;
+        LY_CHECK_RETURN(lyht_insert(ht, &pnode, set_pos_hash(attr), NULL) == -1, -1);
+        if (attr == node) {
+            found = 1;
+        }
     }
 
-    LY_TREE_FOR(root, top_sibling) {
-        /* TREE DFS */
-        LY_TREE_DFS_BEGIN(top_sibling, next, elem) {
-dfs_search:
-            if ((root_type == LYXP_NODE_ROOT_CONFIG) && (elem->schema->flags & LYS_CONFIG_R)) {
-                goto skip_children;
-            }
+    return found;
+}
 
-            if (elem == node) {
-                break;
-            }
-            ++pos;
+/**
+ * @brief Get the position of a node (attribute), walk the data tree further if it was not learned yet.
+ *
+ * @param[in] cache Learned positions.
+ * @param[in] node Node or attribute.
+ * @param[out] pos Position of \p node.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int
+set_pos_get(struct set_pos_cache *cache, const void *node, uint32_t *pos)
+{
+    const struct lyd_node *elem, *next;
+    struct set_pos_node pnode, *match;
+    int r;
 
-            /* TREE DFS END */
-            /* select element for the next run - children first,
-             * child exception for lyd_node_leaf and lyd_node_leaflist, but not the root */
+    pnode.node = node;
+    if (!lyht_find(cache->ht, &pnode, set_pos_hash(node), (void **)&match)) {
+        *pos = match->pos;
+        return 0;
+    }
+
+    while ((elem = cache->next)) {
+        r = 0;
+        if ((cache->root_type == LYXP_NODE_ROOT_CONFIG) && (elem->schema->flags & LYS_CONFIG_R)) {
+            /* skip the whole subtree */
+            next = NULL;
+        } else {
+            ++cache->pos;
+            r = set_pos_learn(cache->ht, elem, cache->pos, node);
+            LY_CHECK_RETURN(r == -1, -1);
+
+            /* children first, child exception for leaves, leaf-lists and anydata */
             if (elem->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) {
                 next = NULL;
             } else {
                 next = elem->child;
             }
-            if (!next) {
-skip_children:
-                /* no children */
-                if (elem == top_sibling) {
-                    /* we are done, root has no children */
-                    elem = NULL;
-                    break;
-                }
-                /* try siblings */
-                next = elem->next;
-            }
-            while (!next) {
-                /* no siblings, go back through parents */
-                if (elem->parent == top_sibling->parent) {
-                    /* we are done, no next element to process */
-                    elem = NULL;
-                    break;
-                }
-                /* parent is already processed, go to its sibling */
-                elem = elem->parent;
-                next = elem->next;
-            }
         }
 
-        /* node found */
-        if (elem) {
-            break;
+        /* then siblings, then go back through parents (all the context root siblings are walked) */
+        for (; !next && elem; elem = elem->parent) {
+            next = elem->next;
         }
-    }
+        cache->next = next;
 
-    if (!elem) {
-        if (!(*prev)) {
-            /* we went from root and failed to find it, cannot be */
-            LOGINT(node->schema->module->ctx);
+        if (r) {
+            *pos = cache->pos;
             return 0;
-        } else {
-            /* node is before prev, we assumed otherwise :( */
-            //LOGDBG(LY_LDGXPATH, "get_node_pos optimalization fail.");
-
-            *prev = NULL;
-            *prev_pos = 0;
-
-            elem = next = top_sibling = root;
-            pos = 1;
-            goto dfs_search;
         }
     }
 
-    /*if (*prev) {
-        LOGDBG(LY_LDGXPATH, "get_node_pos optimalization success.");
-    }*/
-
-    /* remember the last found node for next time */
-    *prev = node;
-    *prev_pos = pos;
-
-    return pos;
+    /* the node is not in the data tree, cannot be */
+    LOGINT(cache->root->schema->module->ctx);
+    return -1;
 }
 
 /**
  * @brief Assign (fill) missing node positions.
  *
+ * The positions are taken from the positions learned during the current evaluation,
+ * the data tree is walked further only for nodes that were not reached yet.
+ *
  * @param[in] set Set to fill positions in.
  * @param[in] root Context root node.
  * @param[in] root_type Context root type.
@@ -1371,35 +1417,44 @@ skip_children:
 static int
 set_assign_pos(struct lyxp_set *set, const struct lyd_node *root, enum lyxp_node_type root_type)
 {
-    const struct lyd_node *prev = NULL, *tmp_node;
-    uint32_t i, tmp_pos = 0;
+    struct set_pos_cache local_cache, *cache;
+    uint32_t i;
+    int ret = 0;
+
+    assert(!root->prev->next);
+
+    cache = set_pos_cache;
+    if (!cache) {
+        /* not in an evaluation, learn the positions just for this set */
+        memset(&local_cache, 0, sizeof local_cache);
+        cache = &local_cache;
+    }
+
+    if (!cache->ht || (cache->root != root) || (cache->root_type != root_type)) {
+        /* start the walk */
+        set_pos_cache_clean(cache);
+        cache->ht = lyht_new(1, sizeof(struct set_pos_node), set_pos_equal_cb, NULL, 1);
+        LY_CHECK_ERR_RETURN(!cache->ht, LOGMEM(root->schema->module->ctx), -1);
+        cache->root = root;
+        cache->root_type = root_type;
+        cache->next = root;
+    }
 
+    /* all roots have position 0 */
     for (i = 0; i < set->used; ++i) {
-        if (!set->val.nodes[i].pos) {
-            tmp_node = NULL;
-            switch (set->val.nodes[i].type) {
-            case LYXP_NODE_ATTR:
-                tmp_node = lyd_attr_parent(root, set->val.attrs[i].attr);
-                if (!tmp_node) {
-                    LOGINT(root->schema->module->ctx);
-                    return -1;
-                }
-                /* fallthrough */
-            case LYXP_NODE_ELEM:
-            case LYXP_NODE_TEXT:
-                if (!tmp_node) {
-                    tmp_node = set->val.nodes[i].node;
-                }
-                set->val.nodes[i].pos = get_node_pos(tmp_node, set->val.nodes[i].type, root, root_type, &prev, &tmp_pos);
-                break;
-            default:
-                /* all roots have position 0 */
+        if (!set->val.nodes[i].pos && ((set->val.nodes[i].type == LYXP_NODE_ELEM)
+                || (set->val.nodes[i].type == LYXP_NODE_TEXT) || (set->val.nodes[i].type == LYXP_NODE_ATTR))) {
+            if (set_pos_get(cache, set->val.nodes[i].node, &set->val.nodes[i].pos)) {
+                ret = -1;
                 break;
             }
         }
     }
 
-    return 0;
+    if (cache == &local_cache) {
+        set_pos_cache_clean(cache);
+    }
+    return ret;
 }
 
 /**
@@ -1534,23 +1589,26 @@ set_comp_cast(struct lyxp_set *trg, struct lyxp_set *src, enum lyxp_set_type typ
 #ifndef NDEBUG
 
 /**
- * @brief Bubble sort \p set into XPath document order.
+ * @brief Sort \p set into XPath document order.
  *        Context position aware. Unused in the 'Release' build target.
  *
+ * Positions of all the nodes are assigned at once and the set is then
+ * merge-sorted, unless it is already sorted.
+ *
  * @param[in] set Set to sort.
  * @param[in] cur_node Original context node.
  * @param[in] options Whether to apply data node access restrictions defined for 'when' and 'must' evaluation.
  *
- * @return How many times the whole set was traversed - 1 (if set was sorted, returns 0).
+ * @return 0 if the set was already sorted, 1 if it had to be sorted, -1 on error.
  */
 static int
 set_sort(struct lyxp_set *set, const struct lyd_node *cur_node, int options)
 {
-    uint32_t i, j;
-    int ret = 0, cmp, inverted, change;
+    uint32_t i, j, k, start, width, mid, end;
+    int ret = 0;
     const struct lyd_node *root;
     enum lyxp_node_type root_type;
-    struct lyxp_set_node item;
+    struct lyxp_set_node *buf, *src, *dst, *tmp;
 
     if ((set->type != LYXP_SET_NODE_SET) || (set->used == 1)) {
         return 0;
@@ -1567,36 +1625,44 @@ set_sort(struct lyxp_set *set, const struct lyd_node *cur_node, int options)
     LOGDBG(LY_LDGXPATH, "SORT BEGIN");
     print_set_debug(set);
 
-    for (i = 0; i < set->used; ++i) {
-        inverted = 0;
-        change = 0;
+    /* the set is usually sorted, check it first */
+    for (i = 1; i < set->used; ++i) {
+        if (set_sort_compare(&set->val.nodes[i - 1], &set->val.nodes[i], root) > 0) {
+            break;
+        }
+    }
 
-        for (j = 1; j < set->used - i; ++j) {
-            /* compare node positions */
-            if (inverted) {
-                cmp = set_sort_compare(&set->val.nodes[j], &set->val.nodes[j - 1], root);
-            } else {
-                cmp = set_sort_compare(&set->val.nodes[j - 1], &set->val.nodes[j], root);
-            }
+    if (i < set->used) {
+        ret = 1;
 
-            /* swap if needed */
-            if ((inverted && (cmp < 0)) || (!inverted && (cmp > 0))) {
-                change = 1;
+        buf = malloc(set->used * sizeof *buf);
+        LY_CHECK_ERR_RETURN(!buf, LOGMEM(root->schema->module->ctx), -1);
 
-                item = set->val.nodes[j - 1];
-                set->val.nodes[j - 1] = set->val.nodes[j];
-                set->val.nodes[j] = item;
-            } else {
-                /* whether node_pos1 should be smaller than node_pos2 or the other way around */
-                inverted = !inverted;
+        /* bottom-up merge sort, stable */
+        src = set->val.nodes;
+        dst = buf;
+        for (width = 1; width < set->used; width <<= 1) {
+            for (start = 0; start < set->used; start += 2 * width) {
+                mid = (start + width < set->used) ? start + width : set->used;
+                end = (mid + width < set->used) ? mid + width : set->used;
+                for (i = start, j = start, k = mid; i < end; ++i) {
+                    if ((j < mid) && ((k == end) || (set_sort_compare(&src[j], &src[k], root) <= 0))) {
+                        dst[i] = src[j++];
+                    } else {
+                        dst[i] = src[k++];
+                    }
+                }
             }
-        }
 
-        ++ret;
+            tmp = src;
+            src = dst;
+            dst = tmp;
+        }
 
-        if (!change) {
-            break;
+        if (src != set->val.nodes) {
+            memcpy(set->val.nodes, src, set->used * sizeof *src);
         }
+        free(buf);
     }
 
     LOGDBG(LY_LDGXPATH, "SORT END %d", ret);
@@ -1622,7 +1688,7 @@ set_sort(struct lyxp_set *set, const struct lyd_node *cur_node, int options)
     }
 #endif
 
-    return ret - 1;
+    return ret;
 }
 
 /**
@@ -1669,10 +1735,11 @@ set_sorted_dup_node_clean(struct lyxp_set *set)
 static int
 set_sorted_merge(struct lyxp_set *trg, struct lyxp_set *src, struct lyd_node *cur_node, int options)
 {
-    uint32_t i, j, count, dup_count;
+    uint32_t i, j, count;
     int cmp;
     const struct lyd_node *root;
     enum lyxp_node_type root_type;
+    struct lyxp_set_node *nodes;
 
     if (((trg->type != LYXP_SET_NODE_SET) && (trg->type != LYXP_SET_EMPTY))
             || ((src->type != LYXP_SET_NODE_SET) && (src->type != LYXP_SET_EMPTY))) {
@@ -1702,78 +1769,42 @@ set_sorted_merge(struct lyxp_set *trg, struct lyxp_set *src, struct lyd_node *cu
     print_set_debug(src);
 #endif
 
-    /* make memory for the merge (duplicates are not detected yet, so space
-     * will likely be wasted on them, too bad) */
-    if (trg->size - trg->used < src->used) {
-        trg->size = trg->used + src->used;
-
-        trg->val.nodes = ly_realloc(trg->val.nodes, trg->size * sizeof *trg->val.nodes);
-        LY_CHECK_ERR_RETURN(!trg->val.nodes, LOGMEM(cur_node->schema->module->ctx), -1);
-    }
+    /* merge both sets into a new array, duplicates are skipped */
+    nodes = malloc((trg->used + src->used) * sizeof *nodes);
+    LY_CHECK_ERR_RETURN(!nodes, LOGMEM(cur_node->schema->module->ctx), -1);
 
     i = 0;
     j = 0;
     count = 0;
-    dup_count = 0;
-    do {
-        cmp = set_sort_compare(&src->val.nodes[i], &trg->val.nodes[j], root);
+    while ((i < src->used) || (j < trg->used)) {
+        if (i == src->used) {
+            cmp = 1;
+        } else if (j == trg->used) {
+            cmp = -1;
+        } else {
+            cmp = set_sort_compare(&src->val.nodes[i], &trg->val.nodes[j], root);
+        }
+
         if (!cmp) {
-            if (!count) {
-                /* duplicate, just skip it */
-                ++i;
-                ++j;
-            } else {
-                /* we are copying something already, so let's copy the duplicate too,
-                 * we are hoping that afterwards there are some more nodes to
-                 * copy and this way we can copy them all together */
-                ++count;
-                ++dup_count;
-                ++i;
-                ++j;
-            }
-        } else if (cmp < 0) {
-            /* inserting src node into trg, just remember it for now */
-            ++count;
+            /* duplicate, keep the target node */
+            nodes[count++] = trg->val.nodes[j++];
             ++i;
-
+        } else if (cmp < 0) {
 #ifdef LY_ENABLED_CACHE
             /* insert the hash now */
-            set_insert_node_hash(trg, src->val.nodes[i - 1].node, src->val.nodes[i - 1].type);
+            set_insert_node_hash(trg, src->val.nodes[i].node, src->val.nodes[i].type);
 #endif
-        } else if (count) {
-copy_nodes:
-            /* time to actually copy the nodes, we have found the largest block of nodes */
-            memmove(&trg->val.nodes[j + (count - dup_count)],
-                    &trg->val.nodes[j],
-                    (trg->used - j) * sizeof *trg->val.nodes);
-            memcpy(&trg->val.nodes[j - dup_count], &src->val.nodes[i - count], count * sizeof *src->val.nodes);
-
-            trg->used += count - dup_count;
-            /* do not change i, except the copying above, we are basically doing exactly what is in the else branch below */
-            j += count - dup_count;
-
-            count = 0;
-            dup_count = 0;
+            nodes[count++] = src->val.nodes[i++];
         } else {
-            ++j;
-        }
-    } while ((i < src->used) && (j < trg->used));
-
-    if ((i < src->used) || count) {
-#ifdef LY_ENABLED_CACHE
-        uint32_t k;
-
-        /* insert all the hashes first */
-        for (k = i; k < src->used; ++k) {
-            set_insert_node_hash(trg, src->val.nodes[k].node, src->val.nodes[k].type);
+            nodes[count++] = trg->val.nodes[j++];
         }
-#endif
-        /* loop ended, but we need to copy something at trg end */
-        count += src->used - i;
-        i = src->used;
-        goto copy_nodes;
     }
 
+    free(trg->val.nodes);
+    trg->val.nodes = nodes;
+    trg->size = trg->used + src->used;
+    trg->used = count;
+
 #ifdef LY_ENABLED_CACHE
     /* we are inserting hashes before the actual node insert, which causes
      * situations when there were initially not enough items for a hash table,
@@ -3715,6 +3746,90 @@ xpath_derived_from_ident_cmp(struct lys_ident *ident, const char *ident_str)
     return 0;
 }
 
+/**
+ * @brief Find the identities referenced by the second argument of derived-from() in the context identity index.
+ *
+ * @param[in] ctx Context to use.
+ * @param[in] ident_str Identity in the JSON format (with a module name prefix).
+ * @return Set of the matching identities (from all the revisions of the module), NULL if no prefix was used
+ * or on error. The identities are then compared by names.
+ */
+static struct ly_set *
+xpath_derived_from_ident_find(struct ly_ctx *ctx, const char *ident_str)
+{
+    struct ly_set *targets;
+    struct lys_ident *ident;
+    const char *ptr;
+    int i, len;
+
+    ptr = strchr(ident_str, ':');
+    if (!ptr) {
+        return NULL;
+    }
+    len = ptr - ident_str;
+    ++ptr;
+
+    targets = ly_set_new();
+    if (!targets) {
+        return NULL;
+    }
+    for (i = 0; i < ctx->models.used; ++i) {
+        if (strncmp(ctx->models.list[i]->name, ident_str, len) || ctx->models.list[i]->name[len]) {
+            continue;
+        }
+        ident = ly_ctx_ident_find(ctx, ctx->models.list[i], ptr, strlen(ptr));
+        if (ident) {
+            ly_set_add(targets, ident, LY_SET_OPT_USEASLIST);
+        }
+    }
+
+    return targets;
+}
+
+/**
+ * @brief Check whether an identity is (transitively) derived from the second argument of derived-from().
+ *
+ * @param[in] ident Identity to check.
+ * @param[in] ident_str Second argument of derived-from().
+ * @param[in] targets Identities found for \p ident_str, if found.
+ * @param[in] self Whether the identity itself matches as well.
+ * @return 1 if derived, 0 if not.
+ */
+static int
+xpath_derived_from_ident_check(struct lys_ident *ident, const char *ident_str, struct ly_set *targets, int self)
+{
+    unsigned int i;
+    int rc;
+
+    if (self && !xpath_derived_from_ident_cmp(ident, ident_str)) {
+        return 1;
+    }
+
+    if (targets) {
+        for (i = 0; i < targets->number; ++i) {
+            rc = ly_ctx_ident_derived(ident->module->ctx, ident, targets->set.g[i]);
+            if (rc == -1) {
+                /* identity not indexed */
+                break;
+            } else if (rc) {
+                return 1;
+            }
+        }
+        if (i == targets->number) {
+            return 0;
+        }
+    }
+
+    /* walk the bases */
+    for (i = 0; i < ident->base_size; ++i) {
+        if (xpath_derived_from_ident_check(ident->base[i], ident_str, NULL, 1)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 /**
  * @brief Execute the YANG 1.1 derived-from(node-set, string) function. Returns LYXP_SET_BOOLEAN depending
  *        on whether the first argument nodes contain a node of an identity derived from the second
@@ -3732,9 +3847,10 @@ static int
 xpath_derived_from(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyd_node *cur_node, struct lys_module *local_mod,
                    struct lyxp_set *set, int options)
 {
-    uint32_t i, j;
+    uint32_t i;
     struct lyd_node_leaf_list *leaf;
     struct lys_node_leaf *sleaf;
+    struct ly_set *targets;
     lyd_val *val;
     int ret = EXIT_SUCCESS;
 
@@ -3773,6 +3889,7 @@ xpath_derived_from(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct ly
 
     set_fill_boolean(set, 0);
     if (args[0]->type != LYXP_SET_EMPTY) {
+        targets = xpath_derived_from_ident_find(local_mod->ctx, args[1]->val.str);
         for (i = 0; i < args[0]->used; ++i) {
             val = NULL;
             if (args[0]->val.nodes[i].type == LYXP_NODE_ELEM) {
@@ -3786,19 +3903,12 @@ xpath_derived_from(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct ly
                     val = &args[0]->val.attrs[i].attr->value;
                 }
             }
-            if (val) {
-                for (j = 0; j < val->ident->base_size; ++j) {
-                    if (!xpath_derived_from_ident_cmp(val->ident->base[j], args[1]->val.str)) {
-                        set_fill_boolean(set, 1);
-                        break;
-                    }
-                }
-
-                if (j < val->ident->base_size) {
-                    break;
-                }
+            if (val && xpath_derived_from_ident_check(val->ident, args[1]->val.str, targets, 0)) {
+                set_fill_boolean(set, 1);
+                break;
             }
         }
+        ly_set_free(targets);
     }
 
     return EXIT_SUCCESS;
@@ -3821,9 +3931,10 @@ static int
 xpath_derived_from_or_self(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyd_node *cur_node,
                            struct lys_module *local_mod, struct lyxp_set *set, int options)
 {
-    uint32_t i, j;
+    uint32_t i;
     struct lyd_node_leaf_list *leaf;
     struct lys_node_leaf *sleaf;
+    struct ly_set *targets;
     lyd_val *val;
     int ret = EXIT_SUCCESS;
 
@@ -3862,6 +3973,7 @@ xpath_derived_from_or_self(struct lyxp_set **args, uint16_t UNUSED(arg_count), s
 
     set_fill_boolean(set, 0);
     if (args[0]->type != LYXP_SET_EMPTY) {
+        targets = xpath_derived_from_ident_find(local_mod->ctx, args[1]->val.str);
         for (i = 0; i < args[0]->used; ++i) {
             val = NULL;
             if (args[0]->val.nodes[i].type == LYXP_NODE_ELEM) {
@@ -3875,24 +3987,12 @@ xpath_derived_from_or_self(struct lyxp_set **args, uint16_t UNUSED(arg_count), s
                     val = &args[0]->val.attrs[i].attr->value;
                 }
             }
-            if (val) {
-                if (!xpath_derived_from_ident_cmp(val->ident, args[1]->val.str)) {
-                    set_fill_boolean(set, 1);
-                    break;
-                }
-
-                for (j = 0; j < val->ident->base_size; ++j) {
-                    if (!xpath_derived_from_ident_cmp(val->ident->base[j], args[1]->val.str)) {
-                        set_fill_boolean(set, 1);
-                        break;
-                    }
-                }
-
-                if (j < val->ident->base_size) {
-                    break;
-                }
+            if (val && xpath_derived_from_ident_check(val->ident, args[1]->val.str, targets, 1)) {
+                set_fill_boolean(set, 1);
+                break;
             }
         }
+        ly_set_free(targets);
     }
 
     return EXIT_SUCCESS;
@@ -4557,7 +4657,6 @@ static int
 xpath_re_match(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyd_node *cur_node, struct lys_module *local_mod,
                struct lyxp_set *set, int options)
 {
-    pcre *precomp;
     struct lys_node_leaf *sleaf;
     int ret = EXIT_SUCCESS;
 
@@ -4592,15 +4691,16 @@ xpath_re_match(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyd_no
         return -1;
     }
 
-    if (lyp_check_pattern(local_mod->ctx, args[1]->val.str, &precomp)) {
-        return -1;
-    }
-    if (pcre_exec(precomp, NULL, args[0]->val.str, strlen(args[0]->val.str), 0, 0, NULL, 0)) {
-        set_fill_boolean(set, 0);
-    } else {
+    switch (lyp_regex_match(local_mod->ctx, args[1]->val.str, args[0]->val.str)) {
+    case 0:
         set_fill_boolean(set, 1);
+        break;
+    case 1:
+        set_fill_boolean(set, 0);
+        break;
+    default:
+        return -1;
     }
-    free(precomp);
 
     return EXIT_SUCCESS;
 }
@@ -5129,7 +5229,7 @@ xpath_sum(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyd_node *c
  * @return EXIT_SUCCESS on success, -1 on error.
  */
 static int
-xpath_text(struct lyxp_set **UNUSED(args), uint16_t UNUSED(arg_count), struct lyd_node *UNUSED(cur_node),
+xpath_text(struct lyxp_set **UNUSED(args), uint16_t UNUSED(arg_count), struct lyd_node *cur_node,
            struct lys_module *local_mod, struct lyxp_set *set, int options)
 {
     uint32_t i;
@@ -5150,7 +5250,7 @@ xpath_text(struct lyxp_set **UNUSED(args), uint16_t UNUSED(arg_count), struct ly
     for (i = 0; i < set->used;) {
         switch (set->val.nodes[i].type) {
         case LYXP_NODE_ELEM:
-            if (set->val.nodes[i].node->validity & LYD_VAL_INUSE) {
+            if (node_is_dummy(set->val.nodes[i].node, cur_node, options)) {
                 LOGVAL(local_mod->ctx, LYE_XPATH_DUMMY, LY_VLOG_LYD, set->val.nodes[i].node, set->val.nodes[i].node->schema->name);
                 return -1;
             }
@@ -5665,7 +5765,7 @@ moveto_node(struct lyxp_set *set, struct lyd_node *cur_node, struct lys_module *
             }
 
         /* skip nodes without children - leaves, leaflists, anyxmls, and dummy nodes (ouput root will eval to true) */
-        } else if (!(set->val.nodes[i].node->validity & LYD_VAL_INUSE)
+        } else if (!node_is_dummy(set->val.nodes[i].node, cur_node, options)
                 && !(set->val.nodes[i].node->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA))) {
 
             LY_TREE_FOR(set->val.nodes[i].node->child, sub) {
@@ -5902,7 +6002,7 @@ moveto_node_alldesc(struct lyxp_set *set, struct lyd_node *cur_node, struct lys_
             }
 
             /* dummy and context check */
-            if ((elem->validity & LYD_VAL_INUSE) || ((root_type == LYXP_NODE_ROOT_CONFIG) && (elem->schema->flags & LYS_CONFIG_R))) {
+            if (node_is_dummy(elem, cur_node, options) || ((root_type == LYXP_NODE_ROOT_CONFIG) && (elem->schema->flags & LYS_CONFIG_R))) {
                 goto skip_children;
             }
 
@@ -6128,7 +6228,7 @@ skip_children:
  * @return EXIT_SUCCESS on success, -1 on error.
  */
 static int
-moveto_attr(struct lyxp_set *set, struct lyd_node *cur_node, const char *qname, uint16_t qname_len, int UNUSED(options))
+moveto_attr(struct lyxp_set *set, struct lyd_node *cur_node, const char *qname, uint16_t qname_len, int options)
 {
     uint32_t i;
     int replaced, all = 0, pref_len;
@@ -6167,7 +6267,7 @@ moveto_attr(struct lyxp_set *set, struct lyd_node *cur_node, const char *qname,
 
         /* only attributes of an elem (not dummy) can be in the result, skip all the rest;
          * our attributes are always qualified */
-        if ((set->val.nodes[i].type == LYXP_NODE_ELEM) && !(set->val.nodes[i].node->validity & LYD_VAL_INUSE)) {
+        if ((set->val.nodes[i].type == LYXP_NODE_ELEM) && !node_is_dummy(set->val.nodes[i].node, cur_node, options)) {
             LY_TREE_FOR(set->val.nodes[i].node->attr, sub) {
 
                 /* check "namespace" */
@@ -6354,8 +6454,8 @@ moveto_attr_alldesc(struct lyxp_set *set, struct lyd_node *cur_node, struct lys_
 
 static int
 moveto_self_add_children_r(const struct lyd_node *parent, uint32_t parent_pos, enum lyxp_node_type parent_type,
-                           struct lyxp_set *to_set, const struct lyxp_set *dup_check_set, enum lyxp_node_type root_type,
-                           int options)
+                           struct lyxp_set *to_set, const struct lyxp_set *dup_check_set, const struct lyd_node *cur_node,
+                           enum lyxp_node_type root_type, int options)
 {
     const struct lyd_node *sub;
     int ret;
@@ -6373,9 +6473,10 @@ moveto_self_add_children_r(const struct lyd_node *parent, uint32_t parent_pos, e
                 set_insert_node(to_set, sub, 0, LYXP_NODE_ELEM, to_set->used);
 
                 /* skip anydata/anyxml and dummy nodes */
-                if (!(sub->schema->nodetype & LYS_ANYDATA) && !(sub->validity & LYD_VAL_INUSE)) {
+                if (!(sub->schema->nodetype & LYS_ANYDATA) && !node_is_dummy(sub, cur_node, options)) {
                     /* also add all the children of this node, recursively */
-                    ret = moveto_self_add_children_r(sub, 0, LYXP_NODE_ELEM, to_set, dup_check_set, root_type, options);
+                    ret = moveto_self_add_children_r(sub, 0, LYXP_NODE_ELEM, to_set, dup_check_set, cur_node, root_type,
+                                                     options);
                     if (ret) {
                         return ret;
                     }
@@ -6401,12 +6502,13 @@ moveto_self_add_children_r(const struct lyd_node *parent, uint32_t parent_pos, e
                     set_insert_node(to_set, sub, 0, LYXP_NODE_ELEM, to_set->used);
 
                     /* skip anydata/anyxml and dummy nodes */
-                    if ((sub->schema->nodetype & LYS_ANYDATA) || (sub->validity & LYD_VAL_INUSE)) {
+                    if ((sub->schema->nodetype & LYS_ANYDATA) || node_is_dummy(sub, cur_node, options)) {
                         continue;
                     }
 
                     /* also add all the children of this node, recursively */
-                    ret = moveto_self_add_children_r(sub, 0, LYXP_NODE_ELEM, to_set, dup_check_set, root_type, options);
+                    ret = moveto_self_add_children_r(sub, 0, LYXP_NODE_ELEM, to_set, dup_check_set, cur_node, root_type,
+                                                     options);
                     if (ret) {
                         return ret;
                     }
@@ -6478,13 +6580,14 @@ moveto_self(struct lyxp_set *set, struct lyd_node *cur_node, int all_desc, int o
         }
 
         /* skip anydata/anyxml and dummy nodes */
-        if ((set->val.nodes[i].node->schema->nodetype & LYS_ANYDATA) || (set->val.nodes[i].node->validity & LYD_VAL_INUSE)) {
+        if ((set->val.nodes[i].node->schema->nodetype & LYS_ANYDATA)
+                || node_is_dummy(set->val.nodes[i].node, cur_node, options)) {
             continue;
         }
 
         /* add all the children */
         ret = moveto_self_add_children_r(set->val.nodes[i].node, set->val.nodes[i].pos, set->val.nodes[i].type, &ret_set,
-                                         set, root_type, options);
+                                         set, cur_node, root_type, options);
         if (ret) {
             set_free_content(&ret_set);
             return ret;
@@ -8634,6 +8737,7 @@ lyxp_eval(const char *expr, const struct lyd_node *cur_node, enum lyxp_node_type
 {
     struct ly_ctx *ctx;
     struct lyxp_expr *exp;
+    struct set_pos_cache pos_cache, *prev_pos_cache;
     uint16_t exp_idx = 0;
     int rc = -1;
 
@@ -8643,6 +8747,7 @@ lyxp_eval(const char *expr, const struct lyd_node *cur_node, enum lyxp_node_type
     }
 
     ctx = local_mod->ctx;
+    LY_PROF_COUNT(LY_PROF_XPATH_EVAL);
 
     exp = lyxp_parse_expr(ctx, expr);
     if (!exp) {
@@ -8670,7 +8775,15 @@ lyxp_eval(const char *expr, const struct lyd_node *cur_node, enum lyxp_node_type
         set_insert_node(set, (struct lyd_node *)cur_node, 0, cur_node_type, 0);
     }
 
+    /* document positions are learned once for the whole evaluation */
+    memset(&pos_cache, 0, sizeof pos_cache);
+    prev_pos_cache = set_pos_cache;
+    set_pos_cache = &pos_cache;
+
     rc = eval_expr_select(exp, &exp_idx, 0, (struct lyd_node *)cur_node, (struct lys_module *)local_mod, set, options);
+
+    set_pos_cache = prev_pos_cache;
+    set_pos_cache_clean(&pos_cache);
     if (rc == 2) {
         rc = EXIT_SUCCESS;
     }
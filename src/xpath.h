@@ -247,8 +247,8 @@ struct lyxp_set {
  * be confusing without thorough understanding of XPath evaluation rules defined in RFC 6020.
  *
  * @param[in] expr XPath expression to evaluate. Must be in JSON format (prefixes are model names).
- * @param[in] cur_node Current (context) data node. If the node has #LYD_VAL_INUSE flag, it is considered dummy (intended
- * for but not restricted to evaluation with the LYXP_WHEN flag).
+ * @param[in] cur_node Current (context) data node. If the node has #LYD_VAL_INUSE flag or #LYXP_DUMMY_CTX is used,
+ * it is considered dummy (intended for but not restricted to evaluation with the LYXP_WHEN flag).
  * @param[in] cur_node_type Current (context) data node type. For every standard case use #LYXP_NODE_ELEM. But there are
  * cases when the context node \p cur_node is actually supposed to be the XML root, there is no such data node. So, in
  * this case just pass the first top-level node into \p cur_node and use an enum value for this kind of root
@@ -262,6 +262,11 @@ struct lyxp_set {
  * @param[in] options Whether to apply some evaluation restrictions.
  * LYXP_MUST - apply must data tree access restrictions.
  * LYXP_WHEN - apply when data tree access restrictions and consider LYD_WHEN flags in data nodes.
+ * LYXP_DUMMY_CTX - consider \p cur_node dummy without modifying it.
+ *
+ * Unless the data tree is being modified by another thread, the evaluation can run concurrently with other
+ * evaluations and reading of the same data tree, it does not modify the tree in any way and keeps all its
+ * state in \p set.
  *
  * @return EXIT_SUCCESS on success, EXIT_FAILURE on unresolved when dependency, -1 on error.
  */
@@ -298,6 +303,7 @@ int lyxp_atomize(const char *expr, const struct lys_node *cur_snode, enum lyxp_n
 #define LYXP_SNODE_MUST 0x08
 #define LYXP_SNODE_WHEN 0x10
 #define LYXP_SNODE_OUTPUT 0x20
+#define LYXP_DUMMY_CTX 0x40
 
 #define LYXP_SNODE_ALL 0x3C
 
@@ -246,6 +246,64 @@ test_similar_strings(void **state) {
     lydict_remove(ctx, "bbba");
 }
 
+static void
+test_lydict_pinned(void **state)
+{
+    (void) state; /* unused */
+    char yang[8192];
+    const char *xml = "<pin-cont xmlns=\"urn:pin\"><pin-leaf>pin-cont</pin-leaf></pin-cont>";
+    struct ly_ctx *pctx;
+    struct ly_ctx_stats *stats;
+    const struct lys_module *mod;
+    struct lyd_node *data;
+    const char *name, *str;
+    int i, len;
+
+    /* nothing is pinned by default */
+    stats = ly_ctx_stats(ctx);
+    assert_ptr_not_equal(stats, NULL);
+    assert_int_equal(stats->dict_pinned, 0);
+    free(stats);
+
+    /* enough names to enlarge the pinned strings table */
+    len = sprintf(yang, "module pin {namespace \"urn:pin\"; prefix p; container pin-cont { leaf pin-leaf { type string; }");
+    for (i = 0; i < 200; ++i) {
+        len += sprintf(yang + len, "leaf l%d { type int32; }", i);
+    }
+    strcpy(yang + len, "}}");
+
+    pctx = ly_ctx_new(NULL, LY_CTX_PIN_SCHEMA_STRINGS);
+    assert_ptr_not_equal(pctx, NULL);
+    mod = lys_parse_mem(pctx, yang, LYS_IN_YANG);
+    assert_ptr_not_equal(mod, NULL);
+    name = mod->data->child->name;
+
+    stats = ly_ctx_stats(pctx);
+    assert_ptr_not_equal(stats, NULL);
+    assert_true(stats->dict_pinned > 200);
+    free(stats);
+
+    /* pinned strings are not refcounted */
+    str = lydict_insert(pctx, "pin-leaf-other", 8);
+    assert_ptr_equal(str, name);
+    for (i = 0; i < 4; ++i) {
+        lydict_remove(pctx, name);
+    }
+    assert_string_equal(name, "pin-leaf");
+    assert_ptr_equal(lydict_insert_zc(pctx, strdup("pin-leaf")), name);
+
+    data = lyd_parse_mem(pctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(data, NULL);
+    assert_ptr_equal(((struct lyd_node_leaf_list *)data->child)->value_str, mod->data->name);
+    lyd_free_withsiblings(data);
+
+    /* and they are kept until the context is destroyed */
+    assert_int_equal(ly_ctx_remove_module(mod, NULL), 0);
+    assert_ptr_equal(lydict_insert(pctx, "pin-leaf", 0), name);
+
+    ly_ctx_destroy(pctx, NULL);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -253,6 +311,7 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_lydict_insert_zc, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lydict_remove, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_similar_strings, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lydict_pinned, setup_f, teardown_f),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -1484,6 +1484,150 @@ test_ly_path_xml2json(void **state)
     free(mem);
 }
 
+void
+test_ly_ctx_stats(void **state)
+{
+    (void) state; /* unused */
+    struct ly_ctx_stats *stats;
+    uint32_t i, refs = 0, nodes = 0;
+    int found = 0;
+
+    stats = ly_ctx_stats(ctx);
+    assert_ptr_not_equal(stats, NULL);
+
+    /* dictionary */
+    assert_int_not_equal(stats->dict_strings, 0);
+    assert_int_equal(stats->dict_ht.count, 1);
+    assert_int_equal(stats->dict_ht.used, stats->dict_strings);
+    assert_true(stats->dict_refs >= stats->dict_strings);
+    assert_true(stats->dict_bytes > stats->dict_strings);
+    for (i = 0; i < LY_STATS_REFCOUNT_BUCKETS; ++i) {
+        refs += stats->dict_refcounts[i];
+    }
+    assert_int_equal(refs, stats->dict_strings);
+
+    /* schemas */
+    for (i = 0; i < stats->module_count; ++i) {
+        nodes += stats->modules[i].nodes;
+        if (stats->modules[i].module == module) {
+            assert_int_not_equal(stats->modules[i].nodes, 0);
+            assert_true(stats->modules[i].bytes >= stats->modules[i].nodes * sizeof(struct lys_node));
+            found = 1;
+        }
+    }
+    assert_int_equal(found, 1);
+    assert_int_equal(nodes, stats->nodes);
+
+    free(stats);
+
+    assert_ptr_equal(ly_ctx_stats(NULL), NULL);
+}
+
+static void
+prof_clb(LY_PROF_PHASE phase, uint64_t nsec, void *arg)
+{
+    (void) nsec; /* unused */
+    uint64_t *ends = arg;
+
+    assert_true(phase < LY_PROF_PHASE_COUNT);
+    ++ends[phase];
+}
+
+static void
+test_ly_prof(void **state)
+{
+    (void) state; /* unused */
+    const char *yang = "module prof {namespace urn:prof; prefix p;"
+                       "container c {must \"count(l) < 10\"; list l {key k; unique v; leaf k {type string;}"
+                       "leaf v {type int8;} leaf r {type leafref {path \"../../l/k\";}}}"
+                       "leaf w {when \"../l\"; type string; default \"x\";}}}";
+    const char *data = "<c xmlns=\"urn:prof\"><l><k>a</k><v>1</v></l><l><k>b</k><v>2</v><r>a</r></l></c>";
+    struct lyd_node *tree;
+    struct lyxml_elem *xml;
+    struct ly_prof prof;
+    uint64_t ends[LY_PROF_PHASE_COUNT] = {0};
+    char *str;
+    FILE *f;
+    int i;
+
+    assert_ptr_not_equal(lys_parse_mem(ctx, yang, LYS_IN_YANG), NULL);
+
+    /* disabled by default */
+    ly_prof_reset();
+    tree = lyd_parse_mem(ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(tree, NULL);
+    lyd_free_withsiblings(tree);
+    ly_prof_get(&prof);
+    for (i = 0; i < LY_PROF_PHASE_COUNT; ++i) {
+        assert_int_equal(prof.calls[i], 0);
+        assert_int_equal(prof.nsec[i], 0);
+    }
+    for (i = 0; i < LY_PROF_COUNTER_COUNT; ++i) {
+        assert_int_equal(prof.counters[i], 0);
+    }
+
+    assert_int_equal(ly_prof_enable(1), 0);
+    ly_prof_set_clb(prof_clb, ends);
+
+    tree = lyd_parse_mem(ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(tree, NULL);
+    assert_int_equal(lyd_validate(&tree, LYD_OPT_CONFIG, NULL), 0);
+    assert_int_equal(lyd_print_mem(&str, tree, LYD_JSON, LYP_WITHSIBLINGS), 0);
+    free(str);
+    lyd_free_withsiblings(tree);
+
+    /* parsing from a file descriptor */
+    f = tmpfile();
+    assert_ptr_not_equal(f, NULL);
+    assert_int_equal(fputs(data, f) < 0, 0);
+    assert_int_equal(fflush(f), 0);
+    tree = lyd_parse_fd(ctx, fileno(f), LYD_XML, LYD_OPT_CONFIG);
+    fclose(f);
+    assert_ptr_not_equal(tree, NULL);
+    lyd_free_withsiblings(tree);
+
+    /* parsing an XML tree */
+    xml = lyxml_parse_mem(ctx, data, 0);
+    assert_ptr_not_equal(xml, NULL);
+    tree = lyd_parse_xml(ctx, &xml, LYD_OPT_CONFIG);
+    lyxml_free_withsiblings(ctx, xml);
+    assert_ptr_not_equal(tree, NULL);
+    lyd_free_withsiblings(tree);
+
+    /* schema parsing */
+    assert_ptr_not_equal(lys_parse_mem(ctx, "module prof2 {namespace urn:prof2; prefix p2;}", LYS_IN_YANG), NULL);
+
+    ly_prof_set_clb(NULL, NULL);
+    assert_int_equal(ly_prof_enable(0), 1);
+
+    ly_prof_get(&prof);
+    assert_int_equal(prof.calls[LY_PROF_PARSE], 3);
+    assert_int_equal(prof.calls[LY_PROF_VALIDATE], 1);
+    assert_int_equal(prof.calls[LY_PROF_PRINT], 1);
+    assert_int_equal(prof.calls[LY_PROF_TOKENIZE], 2);
+    assert_int_equal(prof.calls[LY_PROF_SCHEMA_PARSE], 1);
+    assert_true(prof.calls[LY_PROF_SCHEMA_LOOKUP] >= 8);
+    assert_true(prof.calls[LY_PROF_VALUE] >= 5);
+    assert_true(prof.calls[LY_PROF_WHEN] >= 1);
+    assert_true(prof.calls[LY_PROF_MUST] >= 1);
+    assert_true(prof.calls[LY_PROF_LEAFREF] >= 1);
+    assert_true(prof.calls[LY_PROF_UNIQUE] >= 1);
+    assert_true(prof.calls[LY_PROF_DEFAULTS] >= 1);
+    assert_true(prof.calls[LY_PROF_MANDATORY] >= 1);
+    assert_true(prof.nsec[LY_PROF_PARSE] >= prof.nsec[LY_PROF_TOKENIZE]);
+    assert_true(prof.counters[LY_PROF_XPATH_EVAL] >= 2);
+    assert_true(prof.counters[LY_PROF_DICT_HIT] > 0);
+    assert_true(prof.counters[LY_PROF_DICT_MISS] > 0);
+    for (i = 0; i < LY_PROF_PHASE_COUNT; ++i) {
+        assert_int_equal(ends[i], prof.calls[i]);
+    }
+
+    ly_prof_reset();
+    ly_prof_get(&prof);
+    assert_int_equal(prof.calls[LY_PROF_PARSE], 0);
+    assert_int_equal(prof.counters[LY_PROF_DICT_HIT], 0);
+}
+
 void
 test_ly_set_dup(void **state)
 {
@@ -1643,6 +1787,8 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_ly_ctx_find_path, setup_f, teardown_f),
         cmocka_unit_test(test_ly_ctx_destroy),
         cmocka_unit_test_setup_teardown(test_ly_path_xml2json, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_stats, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_ly_prof, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_set_dup, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_vecode, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_errmsg, setup_f, teardown_f),
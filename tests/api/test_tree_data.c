@@ -538,6 +538,65 @@ test_lyd_change_leaf(void **state)
 
 }
 
+static void
+test_lyd_change_leaf_counter(void **state)
+{
+    (void) state; /* unused */
+    const char *yang =
+    "module counters {"
+        "namespace \"urn:counters\";"
+        "prefix c;"
+        "container stats {"
+            "leaf packets { type uint64; default 0; }"
+            "leaf rate { type decimal64 { fraction-digits 2; } }"
+        "}"
+    "}";
+    const struct lys_module *mod;
+    struct lyd_node *data;
+    struct lyd_node_leaf_list *packets, *rate;
+    const char *str;
+
+    mod = lys_parse_mem(ctx, yang, LYS_IN_YANG);
+    assert_non_null(mod);
+
+    data = lyd_new(NULL, mod, "stats");
+    assert_non_null(data);
+    rate = (struct lyd_node_leaf_list *)lyd_new_leaf(data, NULL, "rate", "1.5");
+    assert_non_null(rate);
+    assert_int_equal(lyd_validate(&data, LYD_OPT_CONFIG, NULL), 0);
+    packets = (struct lyd_node_leaf_list *)data->child->prev;
+    assert_string_equal(packets->schema->name, "packets");
+    assert_int_equal(packets->dflt, 1);
+
+    /* the same value only clears the default flag */
+    assert_int_equal(lyd_change_leaf(packets, "0"), 0);
+    assert_int_equal(packets->dflt, 0);
+    assert_int_equal(lyd_change_leaf(packets, "0"), 1);
+
+    /* the unchanged value is kept as is */
+    assert_int_equal(lyd_change_leaf(packets, "42"), 0);
+    str = packets->value_str;
+    assert_int_equal(lyd_change_leaf(packets, "42"), 1);
+    assert_ptr_equal(packets->value_str, str);
+    assert_int_equal(lyd_change_leaf(packets, "+042"), 1);
+    assert_string_equal(packets->value_str, "42");
+    assert_int_equal(packets->value.uint64, 42);
+
+    assert_int_equal(lyd_change_leaf(packets, "43"), 0);
+    assert_int_equal(packets->value.uint64, 43);
+    assert_int_equal(lyd_change_leaf(packets, "-1"), -1);
+    assert_string_equal(packets->value_str, "43");
+
+    /* decimal64 values are compared in the canonical form */
+    assert_string_equal(rate->value_str, "1.5");
+    assert_int_equal(lyd_change_leaf(rate, "1.50"), 1);
+    assert_int_equal(lyd_change_leaf(rate, "1.5"), 1);
+    assert_int_equal(lyd_change_leaf(rate, "2.25"), 0);
+    assert_int_equal(rate->value.dec64, 225);
+
+    lyd_free_withsiblings(data);
+}
+
 static void
 test_lyd_output_new_leaf(void **state)
 {
@@ -731,6 +790,198 @@ test_lyd_new_path(void **state)
     lyd_free_withsiblings(root);
 }
 
+static void
+test_lyd_path_compiled(void **state)
+{
+    (void) state; /* unused */
+    struct ly_path *cpath;
+    struct lyd_node *node;
+    struct lyd_node_leaf_list *leaf;
+    const char *values[2];
+    char key1[12];
+    int i;
+
+    /* predicates and missing nodes are not allowed */
+    assert_null(ly_path_compile(ctx, "/a:l[key1='1'][key2='1']/value", 0));
+    assert_null(ly_path_compile(ctx, "/a:l/non-existing", 0));
+    assert_null(ly_path_compile(ctx, "l/value", 0));
+
+    /* no slots */
+    cpath = ly_path_compile(ctx, "/a:x/bubba", 0);
+    assert_non_null(cpath);
+    assert_int_equal(ly_path_slot_count(cpath), 0);
+    leaf = (struct lyd_node_leaf_list *)lyd_find_path_compiled(root, cpath, NULL);
+    assert_non_null(leaf);
+    assert_string_equal(leaf->value_str, "test");
+    ly_path_free(cpath);
+
+    /* list keys as slots */
+    cpath = ly_path_compile(ctx, "/a:l/value", 0);
+    assert_non_null(cpath);
+    assert_int_equal(ly_path_slot_count(cpath), 2);
+
+    values[1] = "2";
+    for (i = 0; i < 10; ++i) {
+        sprintf(key1, "%d", i);
+        values[0] = key1;
+        node = lyd_new_path_compiled(root, NULL, cpath, values, "val", 0, 0);
+        assert_non_null(node);
+        assert_string_equal(node->schema->name, "l");
+        assert_ptr_equal(node->parent, NULL);
+    }
+
+    /* the target exists */
+    values[0] = "5";
+    assert_null(lyd_new_path_compiled(root, NULL, cpath, values, "val", 0, 0));
+    assert_int_equal(ly_errno, LY_EVALID);
+    ly_errno = 0;
+
+    node = lyd_new_path_compiled(root, NULL, cpath, values, "new-val", 0, LYD_PATH_OPT_UPDATE);
+    assert_non_null(node);
+    assert_string_equal(node->schema->name, "value");
+
+    leaf = (struct lyd_node_leaf_list *)lyd_find_path_compiled(root, cpath, values);
+    assert_ptr_equal(leaf, node);
+    assert_string_equal(leaf->value_str, "new-val");
+
+    values[0] = "9";
+    leaf = (struct lyd_node_leaf_list *)lyd_find_path_compiled(root, cpath, values);
+    assert_non_null(leaf);
+    assert_string_equal(leaf->value_str, "val");
+
+    /* non-canonical key values */
+    values[0] = "+09";
+    assert_ptr_equal(lyd_find_path_compiled(root, cpath, values), leaf);
+
+    /* not found and invalid values */
+    values[0] = "10";
+    assert_null(lyd_find_path_compiled(root, cpath, values));
+    values[0] = "x";
+    assert_null(lyd_find_path_compiled(root, cpath, values));
+    assert_null(lyd_find_path_compiled(root, cpath, NULL));
+
+    ly_path_free(cpath);
+
+    /* creating the key only creates the list instance */
+    cpath = ly_path_compile(ctx, "/a:l/key2", 0);
+    assert_non_null(cpath);
+    values[0] = "20";
+    values[1] = "21";
+    node = lyd_new_path_compiled(root, NULL, cpath, values, NULL, 0, 0);
+    assert_non_null(node);
+    assert_string_equal(node->schema->name, "l");
+    leaf = (struct lyd_node_leaf_list *)lyd_find_path_compiled(root, cpath, values);
+    assert_non_null(leaf);
+    assert_string_equal(leaf->value_str, "21");
+    ly_path_free(cpath);
+}
+
+static void
+test_lyd_path_compiled_leaflist(void **state)
+{
+    (void) state; /* unused */
+    const char *yang =
+    "module m {"
+        "namespace \"urn:m\";"
+        "prefix m;"
+        "container c {"
+            "leaf-list ll { type string; }"
+            "leaf x { type string; }"
+            "list l { key \"k\"; leaf k { type int8; } leaf-list ill { type int8; } }"
+        "}"
+    "}";
+    struct ly_path *cpath;
+    struct lyd_node *data, *node;
+    const char *values[2];
+    char key[12];
+    int i;
+
+    assert_non_null(lys_parse_mem(ctx, yang, LYS_IN_YANG));
+    data = lyd_new_path(NULL, ctx, "/m:c/x", "a", 0, 0);
+    assert_non_null(data);
+
+    /* leaf-list value passed as the node value, not bound */
+    cpath = ly_path_compile(ctx, "/m:c/ll", 0);
+    assert_non_null(cpath);
+    node = lyd_new_path_compiled(data, NULL, cpath, NULL, "v1", 0, 0);
+    assert_non_null(node);
+    assert_string_equal(((struct lyd_node_leaf_list *)node)->value_str, "v1");
+    assert_null(lyd_new_path_compiled(data, NULL, cpath, NULL, "v1", 0, 0));
+    assert_int_equal(ly_errno, LY_EVALID);
+
+    /* missing leaf-list value */
+    assert_null(lyd_new_path_compiled(data, NULL, cpath, NULL, NULL, 0, 0));
+    assert_int_equal(ly_errno, LY_EINVAL);
+    assert_null(lyd_find_path_compiled(data, cpath, NULL));
+    assert_int_equal(ly_errno, LY_EINVAL);
+    values[0] = "v1";
+    assert_ptr_equal(lyd_find_path_compiled(data, cpath, values), node);
+    ly_path_free(cpath);
+
+    /* enough list and leaf-list instances for the children hash tables */
+    cpath = ly_path_compile(ctx, "/m:c/l/ill", 0);
+    assert_non_null(cpath);
+    for (i = 0; i < 16; ++i) {
+        sprintf(key, "%d", i - 8);
+        values[0] = key;
+        values[1] = "1";
+        assert_non_null(lyd_new_path_compiled(data, NULL, cpath, values, NULL, 0, 0));
+        sprintf(key, "%d", i + 10);
+        values[0] = "-5";
+        values[1] = key;
+        assert_non_null(lyd_new_path_compiled(data, NULL, cpath, values, NULL, 0, 0));
+    }
+    values[1] = "13";
+    node = lyd_find_path_compiled(data, cpath, values);
+    assert_non_null(node);
+    assert_string_equal(((struct lyd_node_leaf_list *)node)->value_str, "13");
+    assert_string_equal(((struct lyd_node_leaf_list *)node->parent->child)->value_str, "-5");
+    values[0] = "-05";
+    values[1] = "+13";
+    assert_ptr_equal(lyd_find_path_compiled(data, cpath, values), node);
+    values[1] = "x";
+    assert_null(lyd_find_path_compiled(data, cpath, values));
+    ly_path_free(cpath);
+
+    lyd_free_withsiblings(data);
+}
+
+static void
+test_lyd_batch(void **state)
+{
+    (void) state; /* unused */
+    struct lyd_batch *batch;
+    struct lyd_node *tree;
+    char *str;
+    const char *result =
+    "<x xmlns=\"urn:a\"><bubba>b</bubba><number32>3</number32><number64>6</number64></x>"
+    "<l xmlns=\"urn:a\"><key1>1</key1><key2>1</key2><value>v1</value></l>"
+    "<l xmlns=\"urn:a\"><key1>2</key1><key2>1</key2><value>v3</value></l>";
+
+    batch = lyd_batch_new(root, NULL, LYD_PATH_OPT_UPDATE);
+    assert_non_null(batch);
+
+    assert_int_equal(lyd_batch_add(batch, "/a:x/bubba", "b"), 0);
+    assert_int_equal(lyd_batch_add(batch, "/a:x/number32", "3"), 0);
+    assert_int_equal(lyd_batch_add(batch, "/a:l[key1='1'][key2='1']/value", "v1"), 0);
+    assert_int_equal(lyd_batch_add(batch, "/a:l[key1='2'][key2='1']/value", "v2"), 0);
+    /* no change */
+    assert_int_equal(lyd_batch_add(batch, "/a:l[key1='2'][key2='1']/value", "v2"), 0);
+    /* errors do not break the batch */
+    assert_int_equal(lyd_batch_add(batch, "/a:l[key1='2'][key2='1']/non-existing", "v2"), -1);
+    assert_int_equal(lyd_batch_add(batch, "/a:l[key1='2'][key2='1']/key3", "v2"), -1);
+    /* unsorted */
+    assert_int_equal(lyd_batch_add(batch, "/a:x/number64", "6"), 0);
+    assert_int_equal(lyd_batch_add(batch, "/a:l[key1='2'][key2='1']/value", "v3"), 0);
+
+    tree = lyd_batch_finish(batch);
+    assert_ptr_equal(tree, root);
+
+    lyd_print_mem(&str, tree, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(str, result);
+    free(str);
+}
+
 static void
 test_lyd_dup(void **state)
 {
@@ -1437,6 +1688,50 @@ error:
     fail();
 }
 
+static void
+test_lyd_print_fd_large(void **state)
+{
+    (void) state; /* unused */
+    char *value, *expected, *result;
+    char file_name[20];
+    const LYD_FORMAT formats[] = {LYD_XML, LYD_JSON};
+    struct stat sb;
+    int i, fd;
+
+    /* a value larger than the output buffer with characters to escape */
+    value = malloc(50001);
+    assert_non_null(value);
+    for (i = 0; i < 50000; ++i) {
+        value[i] = (i % 1000 == 999) ? "&<\"\\"[(i / 1000) % 4] : 'a' + i % 26;
+    }
+    value[50000] = '\0';
+    assert_int_equal(lyd_change_leaf((struct lyd_node_leaf_list *)root->child, value), 0);
+    free(value);
+
+    for (i = 0; i < 2; ++i) {
+        memset(file_name, 0, sizeof(file_name));
+        strncpy(file_name, TMP_TEMPLATE, sizeof(file_name));
+        fd = mkstemp(file_name);
+        assert_int_not_equal(fd, -1);
+        unlink(file_name);
+
+        assert_int_equal(lyd_print_fd(fd, root, formats[i], LYP_FORMAT), 0);
+        assert_int_equal(lyd_print_mem(&expected, root, formats[i], LYP_FORMAT), 0);
+
+        assert_int_equal(fstat(fd, &sb), 0);
+        assert_int_equal(sb.st_size, strlen(expected));
+        result = malloc(sb.st_size + 1);
+        assert_non_null(result);
+        assert_int_equal(pread(fd, result, sb.st_size, 0), sb.st_size);
+        result[sb.st_size] = '\0';
+        assert_string_equal(result, expected);
+
+        free(result);
+        free(expected);
+        close(fd);
+    }
+}
+
 static void
 test_lyd_print_file_xml(void **state)
 {
@@ -1914,6 +2209,91 @@ test_lyd_dup_to_ctx(void **state)
     ly_ctx_destroy(new_ctx, NULL);
 }
 
+static void
+test_lyd_dup_compact(void **state)
+{
+    (void) state; /* unused */
+    struct lyd_compact *tree;
+    struct lyd_node *node, *any;
+    char *orig, *expanded;
+    uint32_t idx, list;
+
+    assert_non_null(lyd_new_path(root, NULL, "/a:x/number32", "42", 0, 0));
+    assert_non_null(lyd_new_path(root, NULL, "/a:l[key1='1'][key2='2']/value", "a value longer than inline", 0, 0));
+    assert_non_null(lyd_new_path(root, NULL, "/a:l[key1='3'][key2='4']/value", "short", 0, 0));
+    lyd_print_mem(&orig, root, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL);
+
+    tree = lyd_dup_compact_withsiblings(root, 0);
+    assert_non_null(tree);
+    assert_ptr_equal(tree->ctx, ctx);
+
+    /* the nodes are stored in the document order */
+    idx = 1;
+    assert_string_equal(tree->nodes[idx].schema->name, "x");
+    assert_int_equal(tree->nodes[idx].parent, 0);
+    assert_null(lyd_compact_value(tree, idx));
+    idx = tree->nodes[idx].child;
+    assert_int_equal(idx, 2);
+    for (; idx; idx = tree->nodes[idx].next) {
+        assert_int_equal(tree->nodes[idx].parent, 1);
+        if (!strcmp(tree->nodes[idx].schema->name, "number32")) {
+            assert_string_equal(lyd_compact_value(tree, idx), "42");
+            assert_true(tree->nodes[idx].flags & LYD_COMPACT_INLINE);
+        } else if (!strcmp(tree->nodes[idx].schema->name, "def-leaf")) {
+            assert_true(tree->nodes[idx].flags & LYD_COMPACT_DFLT);
+        }
+    }
+    for (list = tree->nodes[1].next; strcmp(tree->nodes[list].schema->name, "l"); list = tree->nodes[list].next);
+    idx = tree->nodes[tree->nodes[list].child].next;
+    idx = tree->nodes[idx].next;
+    assert_string_equal(tree->nodes[idx].schema->name, "value");
+    assert_string_equal(lyd_compact_value(tree, idx), "a value longer than inline");
+    assert_false(tree->nodes[idx].flags & LYD_COMPACT_INLINE);
+    assert_int_equal(tree->nodes[tree->count - 1].next, 0);
+    assert_string_equal(lyd_compact_value(tree, tree->count - 1), "short");
+
+    /* expanding gives back the same data */
+    node = lyd_compact_expand(tree, 1, 1);
+    assert_non_null(node);
+    lyd_print_mem(&expanded, node, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL);
+    assert_string_equal(expanded, orig);
+    free(expanded);
+    lyd_free_withsiblings(node);
+
+    /* a single list instance */
+    node = lyd_compact_expand(tree, list, 0);
+    assert_non_null(node);
+    assert_null(node->next);
+    assert_string_equal(node->schema->name, "l");
+    assert_string_equal(((struct lyd_node_leaf_list *)node->child)->value_str, "1");
+    lyd_free(node);
+
+    assert_null(lyd_compact_expand(tree, tree->count, 0));
+    lyd_compact_free(tree);
+
+    /* only the node itself */
+    tree = lyd_dup_compact(root, 0);
+    assert_non_null(tree);
+    assert_int_equal(tree->nodes[1].next, 0);
+    lyd_compact_free(tree);
+
+    /* attributes are not kept */
+    assert_non_null(lyd_insert_attr(root, NULL, "test", "test"));
+    assert_null(lyd_dup_compact(root, 0));
+    tree = lyd_dup_compact(root, LYD_DUP_OPT_NO_ATTR);
+    assert_non_null(tree);
+    lyd_compact_free(tree);
+    assert_null(lyd_dup_compact(root, LYD_DUP_OPT_RECURSIVE));
+
+    /* anydata are not supported */
+    any = lyd_new_anydata(NULL, root->schema->module, "any", "<a/>", LYD_ANYDATA_SXML);
+    assert_non_null(any);
+    assert_null(lyd_dup_compact(any, 0));
+    lyd_free(any);
+
+    free(orig);
+}
+
 static void
 test_lyd_new_anydata(void **state)
 {
@@ -2006,6 +2386,40 @@ test_lyd_first_sibling(void **state)
     }
 }
 
+static void
+test_lyd_tree_stats(void **state)
+{
+    (void) state; /* unused */
+    struct lyd_tree_stats stats;
+    struct lyd_node *sibling, *next, *elem;
+    uint32_t count = 0;
+
+    LY_TREE_FOR(root, sibling) {
+        LY_TREE_DFS_BEGIN(sibling, next, elem) {
+            ++count;
+            LY_TREE_DFS_END(sibling, next, elem);
+        }
+    }
+
+    assert_int_equal(lyd_tree_stats(root, 1, &stats), 0);
+    assert_int_equal(stats.nodes, count);
+    assert_int_equal(stats.containers + stats.lists + stats.leaves + stats.leaflists + stats.anydata + stats.operations,
+                     count);
+    assert_int_not_equal(stats.dflt, 0);
+    assert_int_equal(stats.attrs, 0);
+    assert_true(stats.bytes >= count * sizeof(struct lyd_node));
+
+    /* attributes are counted too */
+    assert_ptr_not_equal(lyd_insert_attr(root, NULL, "a:test", "value"), NULL);
+    assert_int_equal(lyd_tree_stats(root->child, 0, &stats), 0);
+    assert_int_equal(stats.nodes, 1);
+    assert_int_equal(stats.attrs, 0);
+    assert_int_equal(lyd_tree_stats(root, 0, &stats), 0);
+    assert_int_equal(stats.attrs, 1);
+
+    assert_int_not_equal(lyd_tree_stats(NULL, 0, &stats), 0);
+}
+
 static void
 test_lyd_print_path(void **state)
 {
@@ -2030,8 +2444,12 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_lyd_new, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_new_leaf, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_change_leaf, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_change_leaf_counter, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_output_new_leaf, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_new_path, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_path_compiled, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_path_compiled_leaflist, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_batch, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_dup, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_insert, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_insert_sibling, setup_f, teardown_f),
@@ -2053,6 +2471,7 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_lyd_print_fd_xml, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_print_fd_xml_format, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_print_fd_json, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_print_fd_large, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_print_file_xml, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_print_file_xml_format, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_print_file_json, setup_f, teardown_f),
@@ -2067,10 +2486,12 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_lyd_new_output, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_dup_withsiblings, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_dup_to_ctx, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_dup_compact, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_new_anydata, setup_f3, teardown_f3),
         cmocka_unit_test_setup_teardown(test_lyd_new_output_anydata, setup_f3, teardown_f3),
         cmocka_unit_test_setup_teardown(test_lyd_first_sibling, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_print_path, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_tree_stats, setup_f, teardown_f),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
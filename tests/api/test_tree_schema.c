@@ -389,6 +389,36 @@ test_lys_parse_mem(void **state)
     ctx = NULL;
 }
 
+static void
+test_lys_parse_mem_strings(void **state)
+{
+    (void) state; /* unused */
+    const struct lys_module *module;
+    const char *yang = "module c {\n"
+"  namespace urn:c; /* block comment with * and / and \"quotes\" **\n"
+"     over ** more / lines */ prefix c;\n"
+"  description \"First line, \\\"quoted\\\", \\\\ and\\ttab.\n"
+"               Second \t line   \n"
+"                 indented\";   // line comment * / \" '\n"
+"  reference 'single \\n \"quoted\" ' + \"con\" + 'catenated';\n"
+"  contact \"\xc5\xbelu\xc5\xa5ou\xc4\x8dk\xc3\xbd k\xc5\xaf\xc5\x88\";\n"
+"}\n"
+"// trailing comment without a new line";
+
+    ctx = ly_ctx_new(NULL, 0);
+    assert_ptr_not_equal(ctx, NULL);
+
+    module = lys_parse_mem(ctx, yang, LYS_IN_YANG);
+    assert_ptr_not_equal(module, NULL);
+    assert_string_equal(module->prefix, "c");
+    assert_string_equal(module->dsc, "First line, \"quoted\", \\ and\ttab.\nSecond \t line\n  indented");
+    assert_string_equal(module->ref, "single \\n \"quoted\" concatenated");
+    assert_string_equal(module->contact, "\xc5\xbelu\xc5\xa5ou\xc4\x8dk\xc3\xbd k\xc5\xaf\xc5\x88");
+
+    ly_ctx_destroy(ctx, NULL);
+    ctx = NULL;
+}
+
 static void
 test_lys_parse_fd(void **state)
 {
@@ -1575,6 +1605,7 @@ int main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_lys_parse_mem),
+        cmocka_unit_test(test_lys_parse_mem_strings),
         cmocka_unit_test(test_lys_parse_fd),
         cmocka_unit_test(test_lys_parse_path),
         cmocka_unit_test_setup_teardown(test_lys_features_list, setup_f, teardown_f),
@@ -257,6 +257,13 @@ test_lyxml_print_fd(void **state)
     result = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
 
     assert_string_equal(res_xml, result);
+    munmap(result, sb.st_size);
+    close(fd);
+
+    /* the data cannot be written */
+    fd = open(file_name, O_RDONLY);
+    assert_int_not_equal(fd, -1);
+    assert_int_equal(lyxml_print_fd(fd, xml, 0), -1);
 
     close(fd);
     unlink(file_name);
@@ -361,6 +361,29 @@ test_functions_operators(void **state)
     st->set = NULL;
 }
 
+static void
+test_doc_order(void **state)
+{
+    struct state *st = (*state);
+    const char *names[] = {"name", "description", "mtu", "mtu", "name", "description", "ip", "ip"};
+    uint32_t i;
+
+    /* union of sets in reverse document order */
+    st->set = lyd_find_path(st->dt, "/ietf-interfaces:interfaces/interface[name='iface2']/ietf-ip:ipv4/ietf-ip:address/ietf-ip:ip"
+                            " | //ietf-interfaces:description | //ietf-ip:mtu | //ietf-interfaces:name");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 8);
+    for (i = 0; i < st->set->number; ++i) {
+        assert_string_equal(st->set->set.d[i]->schema->name, names[i]);
+    }
+    assert_string_equal(((struct lyd_node_leaf_list *)st->set->set.d[0])->value_str, "iface1");
+    assert_string_equal(((struct lyd_node_leaf_list *)st->set->set.d[4])->value_str, "iface2");
+    assert_string_equal(((struct lyd_node_leaf_list *)st->set->set.d[6])->value_str, "10.0.0.5");
+    assert_string_equal(((struct lyd_node_leaf_list *)st->set->set.d[7])->value_str, "172.0.0.5");
+    ly_set_free(st->set);
+    st->set = NULL;
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -368,6 +391,7 @@ int main(void)
                     cmocka_unit_test_setup_teardown(test_simple, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_advanced, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_functions_operators, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_doc_order, setup_f, teardown_f),
                     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -111,6 +111,35 @@ test_func_re_match(void **state)
     assert_int_equal(st->set->number, 2);
 }
 
+static void
+test_func_re_match_many(void **state)
+{
+    struct state *st = (*state);
+    char path[128];
+    int i;
+
+    st->dt = lyd_parse_mem(st->ctx, data1, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    /* more different patterns than the context keeps compiled */
+    for (i = 0; i < 200; ++i) {
+        sprintf(path, "/xpath-1.1:top/*[re-match(., 'a+b+%s|x%d')]", (i % 2) ? "c+" : "", i % 100);
+        st->set = lyd_find_path(st->dt, path);
+        assert_ptr_not_equal(st->set, NULL);
+        assert_int_equal(st->set->number, (i % 2) ? 2 : 1);
+        ly_set_free(st->set);
+    }
+
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[re-match(., 'a+b+c+')]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 2);
+    ly_set_free(st->set);
+
+    /* invalid pattern */
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[re-match(., 'a[')]");
+    assert_ptr_equal(st->set, NULL);
+}
+
 static void
 test_func_deref(void **state)
 {
@@ -179,6 +208,90 @@ test_func_derived_from4(void **state)
     assert_int_equal(st->set->number, 0);
 }
 
+static void
+test_func_derived_from_transitive(void **state)
+{
+    struct state *st = (*state);
+    const char *data =
+    "<top xmlns=\"urn:xpath-1.1\">"
+        "<identref>ident3</identref>"
+    "</top>";
+
+    st->dt = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[derived-from(., 'xpath-1.1:ident1')]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 1);
+    ly_set_free(st->set);
+
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[derived-from(., 'xpath-1.1:ident2')]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 1);
+    ly_set_free(st->set);
+
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[derived-from(., 'xpath-1.1:ident3')]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 0);
+    ly_set_free(st->set);
+
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[derived-from-or-self(., 'xpath-1.1:ident3')]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 1);
+    ly_set_free(st->set);
+
+    /* no module prefix */
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[derived-from(., 'ident1')]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 1);
+}
+
+static void
+test_func_derived_from_module_set_wrap(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod, *other;
+    uint16_t id;
+    const char *data =
+    "<top xmlns=\"urn:xpath-1.1\">"
+        "<identref>ident3</identref>"
+    "</top>";
+
+    other = lys_parse_mem(st->ctx, "module other {namespace urn:other; prefix o;}", LYS_IN_YANG);
+    assert_ptr_not_equal(other, NULL);
+
+    /* identities indexed */
+    st->dt = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[derived-from(., 'xpath-1.1:ident1')]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 1);
+    ly_set_free(st->set);
+    st->set = NULL;
+    lyd_free_withsiblings(st->dt);
+    st->dt = NULL;
+    id = ly_ctx_get_module_set_id(st->ctx);
+
+    /* the module with the indexed identities is freed and loaded again in the module set with the same id */
+    mod = ly_ctx_get_module(st->ctx, "xpath-1.1", NULL, 0);
+    assert_int_equal(ly_ctx_remove_module(mod, NULL), 0);
+    while ((uint16_t)(ly_ctx_get_module_set_id(st->ctx) + 1) != id) {
+        if (other->disabled) {
+            assert_int_equal(lys_set_enabled(other), 0);
+        } else {
+            assert_int_equal(lys_set_disabled(other), 0);
+        }
+    }
+    assert_ptr_not_equal(ly_ctx_load_module(st->ctx, "xpath-1.1", NULL), NULL);
+    assert_int_equal(ly_ctx_get_module_set_id(st->ctx), id);
+
+    st->dt = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+    st->set = lyd_find_path(st->dt, "/xpath-1.1:top/*[derived-from(., 'xpath-1.1:ident1')]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 1);
+}
+
 static void
 test_func_derived_from_or_self1(void **state)
 {
@@ -288,11 +401,14 @@ main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup_teardown(test_func_re_match, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_func_re_match_many, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_deref, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from1, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from2, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from3, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from4, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_func_derived_from_transitive, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_func_derived_from_module_set_wrap, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from_or_self1, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from_or_self2, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_func_derived_from_or_self3, setup_f, teardown_f),
@@ -0,0 +1,948 @@
+/**
+ * @file benchmark.c
+ * @brief Benchmarks of libyang data operations on generated schemas and data
+ *
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#define _GNU_SOURCE
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/resource.h>
+
+#include "libyang.h"
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+# define BENCH_COUNT_ALLOCS
+# include <malloc.h>
+#endif
+
+#define BENCH_MAX_SIZES 16
+#define BENCH_MAX_SCHEMA_DIRS 16
+
+/* generated schema parameters */
+struct bench_params {
+    int depth;           /* nesting depth of the containers in nested entries */
+    int chain;           /* length of the leafref chain in every item */
+    int musts;           /* number of must conditions of every item */
+};
+
+struct bench {
+    struct bench_params params;
+    char *schema;
+    struct ly_ctx *ctx;
+
+    /* existing schemas loaded by the schemas benchmark */
+    const char *schema_dirs[BENCH_MAX_SCHEMA_DIRS];
+    int schema_dir_count;
+    char **modules;      /* names of all the modules found in the directories */
+    int module_count;
+
+    uint64_t size;       /* requested number of data nodes */
+    uint64_t nodes;      /* actual number of data nodes */
+    uint32_t items;      /* number of generated item list instances */
+    char *xml;
+    char *json;
+    char *lyb;
+    struct lyd_node *tree;
+
+    /* per-iteration data prepared outside of the measured code */
+    struct lyd_node *work, *work2;
+    char *str;
+    struct lyd_difflist *diff;
+};
+
+/* measured values of one benchmark */
+struct measure {
+    uint64_t start_ns;
+    uint64_t start_allocs;
+    uint64_t start_alloc_bytes;
+
+    int runs;
+    uint64_t wall_min;
+    uint64_t wall_total;
+    uint64_t allocs;
+    uint64_t alloc_bytes;
+    long peak_rss;
+};
+
+#ifdef BENCH_COUNT_ALLOCS
+
+/*
+ * Allocations are counted by interposing the glibc allocator, which covers all the allocations made
+ * by libyang (but not those made internally by the C library itself).
+ */
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static uint64_t alloc_count;
+static uint64_t alloc_bytes;
+
+void *
+malloc(size_t size)
+{
+    ++alloc_count;
+    alloc_bytes += size;
+    return __libc_malloc(size);
+}
+
+void *
+calloc(size_t nmemb, size_t size)
+{
+    ++alloc_count;
+    alloc_bytes += nmemb * size;
+    return __libc_calloc(nmemb, size);
+}
+
+void *
+realloc(void *ptr, size_t size)
+{
+    size_t old_size;
+
+    /* count only the enlargement */
+    old_size = ptr ? malloc_usable_size(ptr) : 0;
+    ++alloc_count;
+    if (size > old_size) {
+        alloc_bytes += size - old_size;
+    }
+    return __libc_realloc(ptr, size);
+}
+
+#else
+
+static uint64_t alloc_count;
+static uint64_t alloc_bytes;
+
+#endif
+
+/*
+ * helpers
+ */
+
+struct buf {
+    char *data;
+    size_t len;
+    size_t size;
+};
+
+static void
+buf_printf(struct buf *buf, const char *format, ...)
+{
+    va_list ap;
+    int r;
+
+    while (1) {
+        va_start(ap, format);
+        r = vsnprintf(buf->data + buf->len, buf->size - buf->len, format, ap);
+        va_end(ap);
+        if (r < 0) {
+            fprintf(stderr, "Formatting failed.\n");
+            exit(1);
+        }
+        if ((size_t)r < buf->size - buf->len) {
+            buf->len += r;
+            return;
+        }
+
+        buf->size = (buf->size ? buf->size * 2 : 4096) + r;
+        buf->data = realloc(buf->data, buf->size);
+        if (!buf->data) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+}
+
+static uint64_t
+now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* reset the peak resident set size (Linux only, silently ignored elsewhere) */
+static void
+peak_rss_reset(void)
+{
+    FILE *f;
+
+    f = fopen("/proc/self/clear_refs", "w");
+    if (f) {
+        fputs("5", f);
+        fclose(f);
+    }
+}
+
+/* peak resident set size in kB */
+static long
+peak_rss_get(void)
+{
+    FILE *f;
+    char line[128];
+    long rss = -1;
+    struct rusage usage;
+
+    f = fopen("/proc/self/status", "r");
+    if (f) {
+        while (fgets(line, sizeof line, f)) {
+            if (!strncmp(line, "VmHWM:", 6)) {
+                rss = strtol(line + 6, NULL, 10);
+                break;
+            }
+        }
+        fclose(f);
+    }
+
+    if ((rss == -1) && !getrusage(RUSAGE_SELF, &usage)) {
+        rss = usage.ru_maxrss;
+    }
+    return rss;
+}
+
+static void
+measure_start(struct measure *m)
+{
+    if (!m->runs) {
+        peak_rss_reset();
+    }
+    m->start_allocs = alloc_count;
+    m->start_alloc_bytes = alloc_bytes;
+    m->start_ns = now_ns();
+}
+
+static void
+measure_stop(struct measure *m)
+{
+    uint64_t wall;
+
+    wall = now_ns() - m->start_ns;
+    if (!m->runs) {
+        /* allocations are deterministic, remember them from the first run */
+        m->allocs = alloc_count - m->start_allocs;
+        m->alloc_bytes = alloc_bytes - m->start_alloc_bytes;
+        m->peak_rss = peak_rss_get();
+    }
+
+    if (!m->runs || (wall < m->wall_min)) {
+        m->wall_min = wall;
+    }
+    m->wall_total += wall;
+    ++m->runs;
+}
+
+/*
+ * schema and data generators
+ */
+
+static char *
+gen_schema(const struct bench_params *params)
+{
+    struct buf buf = {NULL, 0, 0};
+    int i;
+
+    buf_printf(&buf,
+               "module bench {\n"
+               "  yang-version 1.1;\n"
+               "  namespace \"urn:libyang:bench\";\n"
+               "  prefix b;\n\n"
+               "  typedef value {\n"
+               "    type union {\n"
+               "      type int32 { range \"-1000000000..1000000000\"; }\n"
+               "      type enumeration { enum none; enum all; }\n"
+               "      type string { pattern \"[a-z][a-z0-9]*\"; }\n"
+               "    }\n"
+               "  }\n\n"
+               "  container items {\n"
+               "    list item {\n"
+               "      key \"id\";\n");
+    for (i = 0; i < params->musts; ++i) {
+        buf_printf(&buf, "      must \"number(id) + %d >= %d and string-length(name) > 0\";\n", i, i);
+    }
+    buf_printf(&buf,
+               "      leaf id { type uint32; }\n"
+               "      leaf name { type string { length \"1..64\"; } }\n"
+               "      leaf value { type value; }\n"
+               "      leaf enabled { type boolean; default \"true\"; }\n"
+               "      leaf limit { when \"../enabled = 'true'\"; type uint32; }\n");
+    for (i = 0; i < params->chain; ++i) {
+        if (!i) {
+            buf_printf(&buf, "      leaf ref0 { type leafref { path \"../id\"; } }\n");
+        } else {
+            buf_printf(&buf, "      leaf ref%d { type leafref { path \"../ref%d\"; } }\n", i, i - 1);
+        }
+    }
+    buf_printf(&buf,
+               "      leaf-list tag { type string; }\n"
+               "    }\n"
+               "  }\n\n"
+               "  container nested {\n"
+               "    list entry {\n"
+               "      key \"id\";\n"
+               "      leaf id { type uint32; }\n");
+    for (i = 1; i <= params->depth; ++i) {
+        buf_printf(&buf, "%*scontainer n%d {\n", 4 + 2 * i, "", i);
+    }
+    buf_printf(&buf, "%*sleaf value { type value; }\n", 6 + 2 * params->depth, "");
+    for (i = params->depth; i >= 1; --i) {
+        buf_printf(&buf, "%*s}\n", 4 + 2 * i, "");
+    }
+    buf_printf(&buf,
+               "    }\n"
+               "  }\n"
+               "}\n");
+
+    return buf.data;
+}
+
+static void
+gen_value(struct buf *buf, uint32_t i)
+{
+    switch (i % 3) {
+    case 0:
+        buf_printf(buf, "%" PRIu32, i);
+        break;
+    case 1:
+        buf_printf(buf, "%s", (i % 2) ? "none" : "all");
+        break;
+    default:
+        buf_printf(buf, "v%" PRIu32, i);
+        break;
+    }
+}
+
+/* generate XML data with approximately the requested number of nodes */
+static char *
+gen_data(struct bench *b)
+{
+    struct buf buf = {NULL, 0, 0};
+    uint32_t i, entries;
+    int j;
+    uint64_t item_nodes, entry_nodes;
+
+    /* a quarter of the nodes is in the deep nested entries, the rest in the wide list */
+    entry_nodes = b->params.depth + 3;
+    item_nodes = 8 + b->params.chain;
+    entries = b->size / 4 / entry_nodes;
+    b->items = (b->size - entries * entry_nodes) / item_nodes;
+    if (!b->items) {
+        b->items = 1;
+    }
+
+    buf_printf(&buf, "<items xmlns=\"urn:libyang:bench\">");
+    for (i = 0; i < b->items; ++i) {
+        buf_printf(&buf, "<item><id>%" PRIu32 "</id><name>item%" PRIu32 "</name><value>", i, i);
+        gen_value(&buf, i);
+        buf_printf(&buf, "</value><enabled>%s</enabled>", (i % 2) ? "false" : "true");
+        if (!(i % 2)) {
+            buf_printf(&buf, "<limit>%" PRIu32 "</limit>", i * 10);
+        }
+        for (j = 0; j < b->params.chain; ++j) {
+            buf_printf(&buf, "<ref%d>%" PRIu32 "</ref%d>", j, i, j);
+        }
+        buf_printf(&buf, "<tag>t%" PRIu32 "</tag><tag>u%" PRIu32 "</tag></item>", i % 8, i);
+    }
+    buf_printf(&buf, "</items>");
+
+    if (entries) {
+        buf_printf(&buf, "<nested xmlns=\"urn:libyang:bench\">");
+        for (i = 0; i < entries; ++i) {
+            buf_printf(&buf, "<entry><id>%" PRIu32 "</id>", i);
+            for (j = 1; j <= b->params.depth; ++j) {
+                buf_printf(&buf, "<n%d>", j);
+            }
+            buf_printf(&buf, "<value>");
+            gen_value(&buf, i);
+            buf_printf(&buf, "</value>");
+            for (j = b->params.depth; j >= 1; --j) {
+                buf_printf(&buf, "</n%d>", j);
+            }
+            buf_printf(&buf, "</entry>");
+        }
+        buf_printf(&buf, "</nested>");
+    }
+
+    return buf.data;
+}
+
+/* change names of every 16th item */
+static void
+modify_tree(struct lyd_node *tree)
+{
+    struct lyd_node *item, *child;
+    char name[32];
+    uint32_t i = 0;
+
+    LY_TREE_FOR(tree->child, item) {
+        if (i++ % 16) {
+            continue;
+        }
+        LY_TREE_FOR(item->child, child) {
+            if (!strcmp(child->schema->name, "name")) {
+                sprintf(name, "changed%" PRIu32, i);
+                lyd_change_leaf((struct lyd_node_leaf_list *)child, name);
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * benchmarks, every one returns non-zero on error
+ */
+
+static int
+bench_ctx(struct bench *b, struct measure *m)
+{
+    struct ly_ctx *ctx;
+    int ret = 0;
+
+    measure_start(m);
+    ctx = ly_ctx_new(NULL, 0);
+    if (!ctx || !lys_parse_mem(ctx, b->schema, LYS_IN_YANG)) {
+        ret = 1;
+    }
+    measure_stop(m);
+
+    ly_ctx_destroy(ctx, NULL);
+    return ret;
+}
+
+static int
+bench_schemas(struct bench *b, struct measure *m)
+{
+    struct ly_ctx *ctx;
+    int i, ret = 0;
+
+    if (!b->module_count) {
+        /* no schema directories */
+        return 0;
+    }
+
+    measure_start(m);
+    ctx = ly_ctx_new(NULL, 0);
+    if (!ctx) {
+        ret = 1;
+    }
+    for (i = 0; !ret && (i < b->schema_dir_count); ++i) {
+        if (ly_ctx_set_searchdir(ctx, b->schema_dirs[i])) {
+            ret = 1;
+        }
+    }
+    for (i = 0; !ret && (i < b->module_count); ++i) {
+        if (!ly_ctx_load_module(ctx, b->modules[i], NULL)) {
+            ret = 1;
+        }
+    }
+    measure_stop(m);
+
+    ly_ctx_destroy(ctx, NULL);
+    return ret;
+}
+
+static int
+bench_parse(struct bench *b, struct measure *m, const char *data, LYD_FORMAT format)
+{
+    struct lyd_node *tree;
+
+    measure_start(m);
+    tree = lyd_parse_mem(b->ctx, data, format, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    measure_stop(m);
+
+    lyd_free_withsiblings(tree);
+    return tree ? 0 : 1;
+}
+
+static int
+bench_parse_xml(struct bench *b, struct measure *m)
+{
+    return bench_parse(b, m, b->xml, LYD_XML);
+}
+
+static int
+bench_parse_json(struct bench *b, struct measure *m)
+{
+    return bench_parse(b, m, b->json, LYD_JSON);
+}
+
+static int
+bench_parse_lyb(struct bench *b, struct measure *m)
+{
+    return bench_parse(b, m, b->lyb, LYD_LYB);
+}
+
+static int
+bench_validate(struct bench *b, struct measure *m)
+{
+    int ret;
+
+    /* duplicated nodes are not validated */
+    b->work = lyd_dup_withsiblings(b->tree, LYD_DUP_OPT_RECURSIVE);
+
+    measure_start(m);
+    ret = lyd_validate(&b->work, LYD_OPT_CONFIG, NULL);
+    measure_stop(m);
+
+    lyd_free_withsiblings(b->work);
+    return ret;
+}
+
+static int
+bench_print(struct bench *b, struct measure *m, LYD_FORMAT format)
+{
+    int ret;
+
+    measure_start(m);
+    ret = lyd_print_mem(&b->str, b->tree, format, LYP_WITHSIBLINGS);
+    measure_stop(m);
+
+    free(b->str);
+    return ret;
+}
+
+static int
+bench_print_xml(struct bench *b, struct measure *m)
+{
+    return bench_print(b, m, LYD_XML);
+}
+
+static int
+bench_print_json(struct bench *b, struct measure *m)
+{
+    return bench_print(b, m, LYD_JSON);
+}
+
+static int
+bench_print_lyb(struct bench *b, struct measure *m)
+{
+    return bench_print(b, m, LYD_LYB);
+}
+
+static int
+bench_dup(struct bench *b, struct measure *m)
+{
+    measure_start(m);
+    b->work = lyd_dup_withsiblings(b->tree, LYD_DUP_OPT_RECURSIVE);
+    measure_stop(m);
+
+    lyd_free_withsiblings(b->work);
+    return b->work ? 0 : 1;
+}
+
+static int
+bench_free(struct bench *b, struct measure *m)
+{
+    b->work = lyd_dup_withsiblings(b->tree, LYD_DUP_OPT_RECURSIVE);
+    if (!b->work) {
+        return 1;
+    }
+
+    measure_start(m);
+    lyd_free_withsiblings(b->work);
+    measure_stop(m);
+
+    return 0;
+}
+
+static int
+bench_diff(struct bench *b, struct measure *m)
+{
+    b->work = lyd_dup_withsiblings(b->tree, LYD_DUP_OPT_RECURSIVE);
+    modify_tree(b->work);
+
+    measure_start(m);
+    b->diff = lyd_diff(b->tree, b->work, 0);
+    measure_stop(m);
+
+    lyd_free_diff(b->diff);
+    lyd_free_withsiblings(b->work);
+    return b->diff ? 0 : 1;
+}
+
+static int
+bench_merge(struct bench *b, struct measure *m)
+{
+    int ret;
+
+    b->work = lyd_dup_withsiblings(b->tree, LYD_DUP_OPT_RECURSIVE);
+    b->work2 = lyd_dup_withsiblings(b->tree, LYD_DUP_OPT_RECURSIVE);
+    modify_tree(b->work2);
+
+    measure_start(m);
+    ret = lyd_merge(b->work, b->work2, 0);
+    measure_stop(m);
+
+    lyd_free_withsiblings(b->work);
+    lyd_free_withsiblings(b->work2);
+    return ret;
+}
+
+static int
+bench_xpath(struct bench *b, struct measure *m)
+{
+    struct ly_set *set;
+    char path[128];
+    uint32_t i;
+    int ret = 0;
+
+    measure_start(m);
+
+    /* key lookups */
+    for (i = 0; i < 10; ++i) {
+        sprintf(path, "/bench:items/item[id='%" PRIu32 "']/name", (uint32_t)(((uint64_t)b->items * i) / 10));
+        set = lyd_find_path(b->tree, path);
+        if (!set || (set->number != 1)) {
+            ret = 1;
+        }
+        ly_set_free(set);
+    }
+
+    /* filter over all the instances */
+    set = lyd_find_path(b->tree, "/bench:items/item[enabled='true' and limit > 100]/tag");
+    if (!set) {
+        ret = 1;
+    }
+    ly_set_free(set);
+
+    /* descendants */
+    set = lyd_find_path(b->tree, "/bench:nested//value");
+    if (!set) {
+        ret = 1;
+    }
+    ly_set_free(set);
+
+    measure_stop(m);
+    return ret;
+}
+
+static const struct {
+    const char *name;
+    int (*run)(struct bench *b, struct measure *m);
+} benchmarks[] = {
+    {"context", bench_ctx},
+    {"schemas", bench_schemas},
+    {"parse_xml", bench_parse_xml},
+    {"parse_json", bench_parse_json},
+    {"parse_lyb", bench_parse_lyb},
+    {"validate", bench_validate},
+    {"print_xml", bench_print_xml},
+    {"print_json", bench_print_json},
+    {"print_lyb", bench_print_lyb},
+    {"dup", bench_dup},
+    {"free", bench_free},
+    {"diff", bench_diff},
+    {"merge", bench_merge},
+    {"xpath", bench_xpath},
+    {NULL, NULL}
+};
+
+/*
+ * driver
+ */
+
+/* whether a YANG file contains a submodule, which is loaded with its main module */
+static int
+schema_is_submodule(const char *dir, const char *name)
+{
+    FILE *f;
+    char path[4096], line[256];
+    size_t i;
+    int ret = 0;
+
+    snprintf(path, sizeof path, "%s/%s", dir, name);
+    f = fopen(path, "r");
+    if (!f) {
+        return 0;
+    }
+    while (fgets(line, sizeof line, f)) {
+        for (i = 0; (line[i] == ' ') || (line[i] == '\t'); ++i);
+        if (!strncmp(line + i, "submodule", 9)) {
+            ret = 1;
+            break;
+        } else if (!strncmp(line + i, "module", 6)) {
+            break;
+        }
+    }
+    fclose(f);
+    return ret;
+}
+
+/* collect the names of all the YANG modules in the schema directories */
+static int
+schemas_collect(struct bench *b)
+{
+    DIR *dir;
+    struct dirent *file;
+    size_t len;
+    char **modules;
+    int i;
+
+    for (i = 0; i < b->schema_dir_count; ++i) {
+        dir = opendir(b->schema_dirs[i]);
+        if (!dir) {
+            fprintf(stderr, "Failed to open \"%s\".\n", b->schema_dirs[i]);
+            return 1;
+        }
+        while ((file = readdir(dir))) {
+            len = strlen(file->d_name);
+            if ((len < 6) || strcmp(file->d_name + len - 5, ".yang")
+                    || schema_is_submodule(b->schema_dirs[i], file->d_name)) {
+                continue;
+            }
+
+            /* module name without the revision and the suffix */
+            len = strcspn(file->d_name, "@.");
+            modules = realloc(b->modules, (b->module_count + 1) * sizeof *b->modules);
+            if (!modules || !(modules[b->module_count] = strndup(file->d_name, len))) {
+                fprintf(stderr, "Memory allocation failed.\n");
+                exit(1);
+            }
+            b->modules = modules;
+            ++b->module_count;
+        }
+        closedir(dir);
+    }
+
+    return 0;
+}
+
+static int
+bench_prepare(struct bench *b)
+{
+    struct lyd_tree_stats stats;
+
+    b->xml = gen_data(b);
+    b->tree = lyd_parse_mem(b->ctx, b->xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    if (!b->tree) {
+        fprintf(stderr, "Failed to parse the generated data (%s).\n", ly_errmsg(b->ctx));
+        return 1;
+    }
+
+    if (lyd_print_mem(&b->json, b->tree, LYD_JSON, LYP_WITHSIBLINGS)
+            || lyd_print_mem(&b->lyb, b->tree, LYD_LYB, LYP_WITHSIBLINGS)) {
+        fprintf(stderr, "Failed to print the generated data (%s).\n", ly_errmsg(b->ctx));
+        return 1;
+    }
+
+    lyd_tree_stats(b->tree, 1, &stats);
+    b->nodes = stats.nodes;
+    return 0;
+}
+
+static void
+bench_cleanup(struct bench *b)
+{
+    lyd_free_withsiblings(b->tree);
+    b->tree = NULL;
+    free(b->xml);
+    b->xml = NULL;
+    free(b->json);
+    b->json = NULL;
+    free(b->lyb);
+    b->lyb = NULL;
+}
+
+static int
+bench_selected(const char *name, char **selected, int selected_count)
+{
+    int i;
+
+    if (!selected_count) {
+        return 1;
+    }
+    for (i = 0; i < selected_count; ++i) {
+        if (!strcmp(name, selected[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void
+help(const char *prog)
+{
+    int i;
+
+    printf("Usage: %s [options]\n\n", prog);
+    printf("Options:\n"
+           "  -h          Show this help.\n"
+           "  -n NODES    Approximate number of data nodes, can be repeated (default 1000, 10000, 100000).\n"
+           "  -r REPEAT   Number of runs of every benchmark, the fastest and average times are reported (default 3).\n"
+           "  -d DEPTH    Nesting depth of the generated containers (default 16).\n"
+           "  -l LENGTH   Length of the generated leafref chains (default 4).\n"
+           "  -m MUSTS    Number of the generated must conditions on every list instance (default 2).\n"
+           "  -s DIR      Directory with YANG modules all loaded by the schemas benchmark, can be repeated.\n"
+           "  -b NAME     Run only the named benchmark, can be repeated.\n"
+           "  -o FILE     Write the JSON results into FILE instead of stdout.\n\n");
+    printf("Benchmarks:\n");
+    for (i = 0; benchmarks[i].name; ++i) {
+        printf("  %s\n", benchmarks[i].name);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    struct bench b;
+    struct measure m;
+    uint64_t sizes[BENCH_MAX_SIZES];
+    char *selected[32];
+    int size_count = 0, selected_count = 0, repeat = 3, first = 1, opt, i, j, s, ret = 1;
+    const char *out_path = NULL;
+    FILE *out = stdout;
+
+    memset(&b, 0, sizeof b);
+    b.params.depth = 16;
+    b.params.chain = 4;
+    b.params.musts = 2;
+
+    while ((opt = getopt(argc, argv, "hn:r:d:l:m:s:b:o:")) != -1) {
+        switch (opt) {
+        case 'h':
+            help(argv[0]);
+            return 0;
+        case 'n':
+            if (size_count == BENCH_MAX_SIZES) {
+                fprintf(stderr, "Too many sizes.\n");
+                return 1;
+            }
+            sizes[size_count++] = strtoull(optarg, NULL, 10);
+            break;
+        case 'r':
+            repeat = atoi(optarg);
+            break;
+        case 'd':
+            b.params.depth = atoi(optarg);
+            break;
+        case 'l':
+            b.params.chain = atoi(optarg);
+            break;
+        case 'm':
+            b.params.musts = atoi(optarg);
+            break;
+        case 's':
+            if (b.schema_dir_count == BENCH_MAX_SCHEMA_DIRS) {
+                fprintf(stderr, "Too many schema directories.\n");
+                return 1;
+            }
+            b.schema_dirs[b.schema_dir_count++] = optarg;
+            break;
+        case 'b':
+            if (selected_count == (signed)(sizeof selected / sizeof *selected)) {
+                fprintf(stderr, "Too many benchmarks selected.\n");
+                return 1;
+            }
+            selected[selected_count++] = optarg;
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        default:
+            help(argv[0]);
+            return 1;
+        }
+    }
+    if ((repeat < 1) || (b.params.depth < 0) || (b.params.chain < 0) || (b.params.musts < 0)) {
+        fprintf(stderr, "Invalid parameters.\n");
+        return 1;
+    }
+    if (!size_count) {
+        sizes[size_count++] = 1000;
+        sizes[size_count++] = 10000;
+        sizes[size_count++] = 100000;
+    }
+
+    if (schemas_collect(&b)) {
+        goto cleanup;
+    }
+
+    b.schema = gen_schema(&b.params);
+    b.ctx = ly_ctx_new(NULL, 0);
+    if (!b.ctx || !lys_parse_mem(b.ctx, b.schema, LYS_IN_YANG)) {
+        fprintf(stderr, "Failed to create the context with the generated schema.\n");
+        goto cleanup;
+    }
+
+    if (out_path) {
+        out = fopen(out_path, "w");
+        if (!out) {
+            fprintf(stderr, "Failed to open \"%s\".\n", out_path);
+            goto cleanup;
+        }
+    }
+
+    fprintf(out, "{\n  \"libyang\": \"%s\",\n", LY_VERSION);
+    fprintf(out, "  \"parameters\": {\"depth\": %d, \"chain\": %d, \"musts\": %d, \"repeat\": %d, \"allocs\": %s},\n",
+            b.params.depth, b.params.chain, b.params.musts, repeat,
+#ifdef BENCH_COUNT_ALLOCS
+            "true"
+#else
+            "false"
+#endif
+            );
+    fprintf(out, "  \"results\": [");
+
+    for (s = 0; s < size_count; ++s) {
+        b.size = sizes[s];
+        if (bench_prepare(&b)) {
+            goto cleanup;
+        }
+        fprintf(stderr, "%" PRIu64 " nodes (%" PRIu64 " requested)\n", b.nodes, b.size);
+
+        for (i = 0; benchmarks[i].name; ++i) {
+            if (!bench_selected(benchmarks[i].name, selected, selected_count)) {
+                continue;
+            }
+
+            memset(&m, 0, sizeof m);
+            for (j = 0; j < repeat; ++j) {
+                if (benchmarks[i].run(&b, &m)) {
+                    fprintf(stderr, "Benchmark \"%s\" failed (%s).\n", benchmarks[i].name, ly_errmsg(b.ctx));
+                    goto cleanup;
+                }
+            }
+            fprintf(stderr, "  %-12s %12.3f ms\n", benchmarks[i].name, m.wall_min / 1000000.0);
+
+            fprintf(out, "%s\n    {\"benchmark\": \"%s\", \"size\": %" PRIu64 ", \"nodes\": %" PRIu64
+                    ", \"runs\": %d, \"wall_ns_min\": %" PRIu64 ", \"wall_ns_avg\": %" PRIu64 ", \"allocs\": %" PRIu64
+                    ", \"alloc_bytes\": %" PRIu64 ", \"peak_rss_kb\": %ld}", first ? "" : ",", benchmarks[i].name,
+                    b.size, b.nodes, m.runs, m.wall_min, m.wall_total / m.runs, m.allocs, m.alloc_bytes, m.peak_rss);
+            first = 0;
+        }
+
+        bench_cleanup(&b);
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    ret = 0;
+
+cleanup:
+    if (out && (out != stdout)) {
+        fclose(out);
+    }
+    bench_cleanup(&b);
+    ly_ctx_destroy(b.ctx, NULL);
+    free(b.schema);
+    for (i = 0; i < b.module_count; ++i) {
+        free(b.modules[i]);
+    }
+    free(b.modules);
+    return ret;
+}
@@ -540,6 +540,74 @@ test_val_diff(void **state)
     lyd_free_val_diff(diff);
 }
 
+static void
+test_wd_lazy(void **state)
+{
+    struct state *st = (*state);
+    struct ly_set *set;
+    const char *xml_in = "<df xmlns=\"urn:libyang:tests:defaults\"><a1>1</a1></df>";
+    const char *xml_all = "<df xmlns=\"urn:libyang:tests:defaults\">"
+                        "<a1>1</a1>"
+                        "<foo>42</foo>"
+                        "<llist>42</llist><dllist>1</dllist><dllist>2</dllist><dllist>3</dllist>"
+                        "<b1_1>42</b1_1>"
+                      "</df><hidden xmlns=\"urn:libyang:tests:defaults\">"
+                        "<foo>42</foo><baz>42</baz></hidden>";
+    const char *xml_rpc = "<rpc1 xmlns=\"urn:libyang:tests:defaults\" xmlns:ncwd=\"urn:ietf:params:xml:ns:yang:ietf-netconf-with-defaults\">"
+                         "<inleaf2 ncwd:default=\"true\">def1</inleaf2>"
+                       "</rpc1>";
+
+    /* no default nodes are kept in the tree */
+    st->dt = lyd_parse_mem(st->ctx, xml_in, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_WD_LAZY);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_ptr_equal(st->dt->next, NULL);
+
+    assert_int_equal(lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL), 0);
+    assert_string_equal(st->xml, xml_in);
+    free(st->xml);
+    st->xml = NULL;
+
+    set = lyd_find_path(st->dt, "/defaults:df/foo");
+    assert_ptr_not_equal(set, NULL);
+    assert_int_equal(set->number, 0);
+    ly_set_free(set);
+
+    /* revalidation does not add them either */
+    assert_int_equal(lyd_validate(&(st->dt), LYD_OPT_CONFIG | LYD_OPT_WD_LAZY, NULL), 0);
+    assert_ptr_equal(st->dt->next, NULL);
+
+    /* create them on demand */
+    assert_int_equal(lyd_wd_materialize(&(st->dt), NULL, LYD_OPT_CONFIG), 0);
+    assert_int_equal(lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL), 0);
+    assert_string_equal(st->xml, xml_all);
+    free(st->xml);
+    st->xml = NULL;
+
+    set = lyd_find_path(st->dt, "/defaults:df/foo");
+    assert_ptr_not_equal(set, NULL);
+    assert_int_equal(set->number, 1);
+    assert_int_equal(set->set.d[0]->dflt, 1);
+    ly_set_free(set);
+
+    /* nothing new the second time */
+    assert_int_equal(lyd_wd_materialize(&(st->dt), NULL, LYD_OPT_CONFIG), 0);
+    assert_int_equal(lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL), 0);
+    assert_string_equal(st->xml, xml_all);
+    free(st->xml);
+    st->xml = NULL;
+    lyd_free_withsiblings(st->dt);
+
+    /* RPC */
+    st->dt = lyd_new_path(NULL, st->ctx, "/defaults:rpc1", NULL, 0, 0);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_int_equal(lyd_validate(&(st->dt), LYD_OPT_RPC | LYD_OPT_WD_LAZY, NULL), 0);
+    assert_ptr_equal(st->dt->child, NULL);
+
+    assert_int_equal(lyd_wd_materialize(&(st->dt), NULL, LYD_OPT_RPC), 0);
+    assert_int_equal(lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL_TAG), 0);
+    assert_string_equal(st->xml, xml_rpc);
+}
+
 static void
 test_feature(void **state)
 {
@@ -690,6 +758,7 @@ int main(void)
                     cmocka_unit_test_setup_teardown(test_rpc_augment, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_notif_default, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_val_diff, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_wd_lazy, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_feature, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_leaflist_in10, setup_clean_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_leaflist_yang, setup_clean_f, teardown_f),
@@ -84,6 +84,10 @@ test_leafref_free(void **state)
     lyd_free(st->data->child->child->prev);
     r = lyd_validate(&(st->data), LYD_OPT_CONFIG, NULL);
     assert_int_not_equal(r, 0);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_NOLEAFREF);
+    assert_ptr_not_equal(ly_err_first(st->ctx), NULL);
+    assert_string_equal(ly_err_first(st->ctx)->prev->path, "/leafrefs:lrtests/link");
+    assert_string_equal(ly_errpath(st->ctx), "/leafrefs:lrtests/link");
 
     lyd_new_leaf(st->data->child, NULL, "name", "jedna");
     r = lyd_validate(&(st->data), LYD_OPT_CONFIG, NULL);
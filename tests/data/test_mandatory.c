@@ -81,6 +81,10 @@ test_mandatory(void **state)
                                  "<llist1>1</llist1><llist1>2</llist1><llist1>3</llist1>"
                                  "<llist1>4</llist1><llist1>5</llist1><llist1>6</llist1>"
                                "</top>";
+    const char many_llist1_mixed[] = "<top xmlns=\"urn:libyang:tests:mandatory\">"
+                                 "<llist1>1</llist1><llist1>2</llist1><leaf1>a</leaf1><llist1>3</llist1>"
+                                 "<llist1>4</llist1><leaf3>c</leaf3><llist1>5</llist1><llist1>7</llist1>"
+                               "</top>";
     const char miss_leaf2[] = "<top xmlns=\"urn:libyang:tests:mandatory\">"
                                 "<leaf1>a</leaf1><llist1>1</llist1><llist1>2</llist1>"
                               "</top>";
@@ -127,6 +131,12 @@ test_mandatory(void **state)
     assert_int_equal(ly_vecode(st->ctx), LYVE_NOMAX);
     assert_string_equal(ly_errpath(st->ctx), "/mandatory:top/llist1[.='6']");
 
+    st->dt = lyd_parse_mem(st->ctx, many_llist1_mixed, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_equal(st->dt, NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_NOMAX);
+    assert_string_equal(ly_errpath(st->ctx), "/mandatory:top/llist1[.='7']");
+
     st->dt = lyd_parse_mem(st->ctx, miss_leaf2, LYD_XML, LYD_OPT_CONFIG);
     assert_ptr_equal(st->dt, NULL);
     assert_int_equal(ly_errno, LY_EVALID);
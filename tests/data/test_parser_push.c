@@ -0,0 +1,370 @@
+/**
+ * @file test_parser_push.c
+ * @brief Cmocka tests for parsing data incrementally in chunks.
+ *
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <cmocka.h>
+
+#include "tests/config.h"
+#include "libyang.h"
+
+struct state {
+    struct ly_ctx *ctx;
+    struct lyd_node *dt;
+    struct lyd_parser *parser;
+};
+
+static const char *schema =
+"module t {"
+"  namespace urn:t;"
+"  prefix t;"
+"  import ietf-yang-metadata { prefix md; }"
+"  md:annotation note { type string; }"
+"  container c {"
+"    leaf a { type uint8; }"
+"    leaf b { type string; default \"x\"; }"
+"  }"
+"  list l { key k; leaf k { type string; } leaf v { type int32; } }"
+"  leaf-list ll { type string; }"
+"  leaf top { type string; }"
+"  leaf d { type string; default \"dflt\"; }"
+"  leaf ref { type leafref { path \"/t:top\"; } }"
+"  leaf w { when \"/t:top = 'val'\"; type string; }"
+"  container big {"
+"    list item { key id; leaf id { type uint32; } leaf name { type string; } leaf-list tag { type string; }"
+"      container sub { leaf x { type int8; } } }"
+"    leaf last { type string; }"
+"  }"
+"}";
+
+static const char *data_xml =
+"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+"<!-- <c> is not here -->\n"
+"<c xmlns=\"urn:t\"><a>5</a></c>\n"
+"<l xmlns=\"urn:t\"><k>one</k><v>1</v></l>"
+"<l xmlns=\"urn:t\"><k>two</k></l>"
+"<ref xmlns=\"urn:t\">val</ref>"
+"<ll xmlns=\"urn:t\"><![CDATA[</ll>]]></ll>"
+"<ll xmlns=\"urn:t\">y</ll>"
+"<top xmlns=\"urn:t\" xmlns:t=\"urn:t\" t:note='a>b'>val</top>"
+"<w xmlns=\"urn:t\">x</w>\n";
+
+static const char *data_json =
+" {"
+  "\"t:c\": {\"a\": 5},"
+  "\"t:l\": [{\"k\": \"one\", \"v\": 1}, {\"k\": \"two\"}],"
+  "\"t:ref\": \"val\","
+  "\"@t:ll\": [null, {\"t:note\": \"hi\"}],"
+  "\"t:ll\": [\"x\", \"y\"],"
+  "\"t:top\": \"val\","
+  "\"@t:top\": {\"t:note\": \"hi, \\\"}\"},"
+  "\"t:w\": \"x\""
+"} \n";
+
+static int
+setup_f(void **state)
+{
+    struct state *st;
+
+    (*state) = st = calloc(1, sizeof *st);
+    if (!st) {
+        fprintf(stderr, "Memory allocation error");
+        return -1;
+    }
+
+    /* libyang context */
+    st->ctx = ly_ctx_new(TESTS_DIR"/schema/yang/ietf/", 0);
+    if (!st->ctx) {
+        fprintf(stderr, "Failed to create context.\n");
+        goto error;
+    }
+
+    if (!lys_parse_mem(st->ctx, schema, LYS_IN_YANG)) {
+        fprintf(stderr, "Failed to load schema.\n");
+        goto error;
+    }
+
+    return 0;
+
+error:
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return -1;
+}
+
+static int
+teardown_f(void **state)
+{
+    struct state *st = (*state);
+
+    lyd_parser_free(st->parser);
+    lyd_free_withsiblings(st->dt);
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return 0;
+}
+
+/* feed the data in chunks of the given size */
+static struct lyd_node *
+parse_chunks(struct state *st, const char *data, size_t len, LYD_FORMAT format, size_t chunk_size)
+{
+    size_t i;
+
+    /* a parser left after a failed feed */
+    lyd_parser_free(st->parser);
+    st->parser = lyd_parser_new(st->ctx, format, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->parser, NULL);
+    for (i = 0; i < len; i += chunk_size) {
+        if (lyd_parser_feed(st->parser, &data[i], (len - i < chunk_size) ? len - i : chunk_size)) {
+            return NULL;
+        }
+    }
+
+    ly_errno = LY_SUCCESS;
+    st->dt = lyd_parser_finish(st->parser);
+    st->parser = NULL;
+    return st->dt;
+}
+
+/* data parsed in chunks must be the same as data parsed at once */
+static void
+parse_check(struct state *st, const char *data, size_t len, LYD_FORMAT format)
+{
+    struct lyd_node *tree;
+    char *expected, *printed;
+    size_t chunk_size;
+
+    tree = lyd_parse_mem(st->ctx, data, format, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(tree, NULL);
+    assert_int_equal(lyd_print_mem(&expected, tree, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL_TAG), 0);
+    lyd_free_withsiblings(tree);
+
+    for (chunk_size = 1; chunk_size < 8; ++chunk_size) {
+        assert_ptr_not_equal(parse_chunks(st, data, len, format, chunk_size), NULL);
+        assert_int_equal(lyd_print_mem(&printed, st->dt, LYD_XML, LYP_WITHSIBLINGS | LYP_WD_ALL_TAG), 0);
+        assert_string_equal(printed, expected);
+        free(printed);
+        lyd_free_withsiblings(st->dt);
+        st->dt = NULL;
+    }
+    assert_ptr_not_equal(parse_chunks(st, data, len, format, len), NULL);
+
+    free(expected);
+}
+
+static void
+test_xml(void **state)
+{
+    struct state *st = (*state);
+
+    parse_check(st, data_xml, strlen(data_xml), LYD_XML);
+}
+
+static void
+test_json(void **state)
+{
+    struct state *st = (*state);
+
+    parse_check(st, data_json, strlen(data_json), LYD_JSON);
+}
+
+/* single top-level container with a large list and a large list instance */
+static char *
+big_data(uint32_t count, uint32_t tags)
+{
+    char *data;
+    size_t size, len;
+    uint32_t i;
+
+    size = 64 + count * 96 + tags * 32;
+    data = malloc(size);
+    assert_ptr_not_equal(data, NULL);
+
+    len = sprintf(data, "<big xmlns=\"urn:t\">");
+    for (i = 0; i < count; ++i) {
+        len += sprintf(data + len, "<item><id>%u</id><name>item %u</name><tag>a</tag><sub><x>%d</x></sub></item>",
+                       i, i, (int)(i % 100));
+    }
+    len += sprintf(data + len, "<item><id>%u</id>", count);
+    for (i = 0; i < tags; ++i) {
+        len += sprintf(data + len, "<tag>tag %u</tag>", i);
+    }
+    len += sprintf(data + len, "</item><last>end</last></big>");
+    assert_true(len < size);
+
+    return data;
+}
+
+static void
+test_big(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *tree;
+    char *data, *json, *expected, *printed;
+    size_t chunk_sizes[] = {65536, 4093}, i;
+
+    data = big_data(5000, 10000);
+    tree = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(tree, NULL);
+    assert_int_equal(lyd_print_mem(&expected, tree, LYD_XML, LYP_WITHSIBLINGS), 0);
+    assert_int_equal(lyd_print_mem(&json, tree, LYD_JSON, LYP_WITHSIBLINGS), 0);
+    lyd_free_withsiblings(tree);
+
+    for (i = 0; i < sizeof chunk_sizes / sizeof *chunk_sizes; ++i) {
+        assert_ptr_not_equal(parse_chunks(st, data, strlen(data), LYD_XML, chunk_sizes[i]), NULL);
+        assert_int_equal(lyd_print_mem(&printed, st->dt, LYD_XML, LYP_WITHSIBLINGS), 0);
+        assert_string_equal(printed, expected);
+        free(printed);
+        lyd_free_withsiblings(st->dt);
+        st->dt = NULL;
+
+        assert_ptr_not_equal(parse_chunks(st, json, strlen(json), LYD_JSON, chunk_sizes[i]), NULL);
+        assert_int_equal(lyd_print_mem(&printed, st->dt, LYD_XML, LYP_WITHSIBLINGS), 0);
+        assert_string_equal(printed, expected);
+        free(printed);
+        lyd_free_withsiblings(st->dt);
+        st->dt = NULL;
+    }
+
+    /* malformed element deep in the large list instance */
+    data[strlen(data) - 40] = '<';
+    assert_ptr_equal(parse_chunks(st, data, strlen(data), LYD_XML, 65536), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+
+    free(json);
+    free(expected);
+    free(data);
+}
+
+static void
+test_lyb(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *tree;
+    char *data_lyb;
+
+    tree = lyd_parse_mem(st->ctx, data_xml, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(tree, NULL);
+    assert_int_equal(lyd_print_mem(&data_lyb, tree, LYD_LYB, LYP_WITHSIBLINGS), 0);
+    lyd_free_withsiblings(tree);
+
+    parse_check(st, data_lyb, lyd_lyb_data_length(data_lyb), LYD_LYB);
+    free(data_lyb);
+}
+
+static void
+test_empty(void **state)
+{
+    struct state *st = (*state);
+
+    /* only default nodes are created */
+    assert_ptr_not_equal(parse_chunks(st, "<!-- empty --> ", 15, LYD_XML, 2), NULL);
+    assert_string_equal(st->dt->schema->name, "c");
+    assert_int_equal(st->dt->dflt, 1);
+    lyd_free_withsiblings(st->dt);
+    st->dt = NULL;
+
+    assert_ptr_not_equal(parse_chunks(st, " { } ", 5, LYD_JSON, 1), NULL);
+    assert_int_equal(st->dt->dflt, 1);
+}
+
+static void
+test_validation(void **state)
+{
+    struct state *st = (*state);
+    const char *data;
+
+    /* duplicate list instances in different chunks */
+    data = "<l xmlns=\"urn:t\"><k>one</k></l><top xmlns=\"urn:t\">val</top><l xmlns=\"urn:t\"><k>one</k></l>";
+    assert_ptr_equal(parse_chunks(st, data, strlen(data), LYD_XML, 4), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_DUPLIST);
+
+    /* leafref target in a later chunk */
+    data = "{\"t:ref\":\"val\",\"t:top\":\"val\"}";
+    assert_ptr_not_equal(parse_chunks(st, data, strlen(data), LYD_JSON, 3), NULL);
+    lyd_free_withsiblings(st->dt);
+    st->dt = NULL;
+
+    data = "{\"t:ref\":\"val\",\"t:top\":\"other\"}";
+    assert_ptr_equal(parse_chunks(st, data, strlen(data), LYD_JSON, 3), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_NOLEAFREF);
+
+    /* when condition depending on another chunk */
+    data = "<w xmlns=\"urn:t\">x</w><top xmlns=\"urn:t\">other</top>";
+    assert_ptr_equal(parse_chunks(st, data, strlen(data), LYD_XML, 5), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_NOWHEN);
+}
+
+static void
+test_invalid(void **state)
+{
+    struct state *st = (*state);
+    const char *data;
+
+    /* incomplete data */
+    data = "<top xmlns=\"urn:t\">val</top><c xmlns=\"urn:t\">";
+    assert_ptr_equal(parse_chunks(st, data, strlen(data), LYD_XML, 6), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+    data = "{\"t:top\":\"val\",";
+    assert_ptr_equal(parse_chunks(st, data, strlen(data), LYD_JSON, 6), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_ptr_equal(parse_chunks(st, "", 0, LYD_JSON, 1), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+
+    /* malformed data */
+    data = "<top xmlns=\"urn:t\">val</top>garbage";
+    assert_ptr_equal(parse_chunks(st, data, strlen(data), LYD_XML, 100), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+    data = "{\"t:top\":\"val\",}";
+    assert_ptr_equal(parse_chunks(st, data, strlen(data), LYD_JSON, 1), NULL);
+    data = "{\"t:top\":\"val\"} x";
+    assert_ptr_equal(parse_chunks(st, data, strlen(data), LYD_JSON, 1), NULL);
+
+    /* invalid value, the parser cannot be used further */
+    data = "<c xmlns=\"urn:t\"><a>300</a></c>";
+    assert_ptr_equal(parse_chunks(st, data, strlen(data), LYD_XML, 10), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_int_not_equal(lyd_parser_feed(st->parser, "<top xmlns=\"urn:t\">val</top>", 28), 0);
+    assert_ptr_equal(lyd_parser_finish(st->parser), NULL);
+    st->parser = NULL;
+
+    /* only data trees */
+    assert_ptr_equal(lyd_parser_new(st->ctx, LYD_XML, LYD_OPT_RPC), NULL);
+    assert_int_equal(ly_errno, LY_EINVAL);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+                    cmocka_unit_test_setup_teardown(test_xml, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_json, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_lyb, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_big, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_empty, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_validation, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_invalid, setup_f, teardown_f),
+                    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,356 @@
+/**
+ * @file test_read_threads.c
+ * @brief Cmocka tests for concurrent read-only access to a single data tree.
+ *
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <cmocka.h>
+
+#include "tests/config.h"
+#include "libyang.h"
+
+#define THREAD_COUNT 8
+#define ITERATIONS 20
+#define ITEM_COUNT 64
+
+struct state {
+    struct ly_ctx *ctx;
+    struct lyd_node *tree;
+    struct ly_path *cpath;
+    char *expected_print;
+    unsigned int expected_count[8];
+    struct lyd_node *expected_first[8];
+};
+
+static const char *schema =
+"module t {"
+"  namespace urn:t;"
+"  prefix t;"
+"  container c {"
+"    list l {"
+"      key k;"
+"      leaf k { type string; }"
+"      leaf v { type int32; }"
+"      leaf ref { type leafref { path \"../../l/k\"; } }"
+"      leaf flag { type boolean; }"
+"      leaf w { when \"../flag = 'true'\"; type string; }"
+"      leaf-list ll { type string; }"
+"    }"
+"    leaf total { type uint32; }"
+"  }"
+"}";
+
+/* read-only expressions evaluated concurrently */
+static const char *paths[] = {
+    "/t:c/l",
+    "/t:c/l[k='item10']/v",
+    "/t:c/l[v > 30 and flag = 'true']",
+    "/t:c/l[position() = last()]/k",
+    "//ll[. = 'x']",
+    "/t:c/l[deref(ref)/../v = 5]",
+    "/t:c/l[re-match(k, 'item[0-9]')]",
+    "/t:c/l[count(ll) = 2]/w",
+};
+
+static int
+setup_f(void **state)
+{
+    struct state *st;
+    char *data, *ptr;
+    int i;
+    struct ly_set *set;
+
+    (*state) = st = calloc(1, sizeof *st);
+    if (!st) {
+        fprintf(stderr, "Memory allocation error");
+        return -1;
+    }
+
+    /* libyang context */
+    st->ctx = ly_ctx_new(NULL, 0);
+    if (!st->ctx) {
+        fprintf(stderr, "Failed to create context.\n");
+        goto error;
+    }
+
+    if (!lys_parse_mem(st->ctx, schema, LYS_IN_YANG)) {
+        fprintf(stderr, "Failed to load schema.\n");
+        goto error;
+    }
+
+    /* data */
+    data = malloc(ITEM_COUNT * 256 + 64);
+    if (!data) {
+        goto error;
+    }
+    ptr = data + sprintf(data, "<c xmlns=\"urn:t\">");
+    for (i = 0; i < ITEM_COUNT; ++i) {
+        ptr += sprintf(ptr, "<l><k>item%d</k><v>%d</v><ref>item%d</ref><flag>%s</flag>%s<ll>x</ll>%s</l>", i, i,
+                       (i * 7) % ITEM_COUNT, (i % 3) ? "true" : "false", (i % 3) ? "<w>when</w>" : "",
+                       (i % 2) ? "<ll>y</ll>" : "");
+    }
+    sprintf(ptr, "<total>%d</total></c>", ITEM_COUNT);
+    st->tree = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    free(data);
+    if (!st->tree) {
+        fprintf(stderr, "Failed to parse data.\n");
+        goto error;
+    }
+
+    st->cpath = ly_path_compile(st->ctx, "/t:c/l/v", 0);
+    if (!st->cpath) {
+        fprintf(stderr, "Failed to compile path.\n");
+        goto error;
+    }
+
+    /* expected results from a single thread */
+    for (i = 0; i < (signed)(sizeof paths / sizeof *paths); ++i) {
+        set = lyd_find_path(st->tree, paths[i]);
+        if (!set || !set->number) {
+            fprintf(stderr, "Unexpected result of \"%s\".\n", paths[i]);
+            ly_set_free(set);
+            goto error;
+        }
+        st->expected_count[i] = set->number;
+        st->expected_first[i] = set->set.d[0];
+        ly_set_free(set);
+    }
+    if (lyd_print_mem(&st->expected_print, st->tree, LYD_JSON, LYP_WITHSIBLINGS)) {
+        goto error;
+    }
+
+    return 0;
+
+error:
+    lyd_free_withsiblings(st->tree);
+    ly_path_free(st->cpath);
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return -1;
+}
+
+static int
+teardown_f(void **state)
+{
+    struct state *st = (*state);
+
+    free(st->expected_print);
+    ly_path_free(st->cpath);
+    lyd_free_withsiblings(st->tree);
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return 0;
+}
+
+/* returns the number of failed checks */
+static void *
+reader(void *arg)
+{
+    struct state *st = arg;
+    struct ly_set *set;
+    struct lyd_node *node, *match;
+    char *str, key[16];
+    const char *values[1];
+    unsigned int i, j;
+    long failed = 0;
+
+    for (j = 0; j < ITERATIONS; ++j) {
+        for (i = 0; i < sizeof paths / sizeof *paths; ++i) {
+            set = lyd_find_path(st->tree, paths[i]);
+            if (!set || (set->number != st->expected_count[i]) || (set->set.d[0] != st->expected_first[i])) {
+                ++failed;
+            }
+            ly_set_free(set);
+        }
+
+        /* compiled path and sibling lookup */
+        sprintf(key, "item%u", j % ITEM_COUNT);
+        values[0] = key;
+        node = lyd_find_path_compiled(st->tree, st->cpath, values);
+        if (!node || (atoi(((struct lyd_node_leaf_list *)node)->value_str) != (signed)(j % ITEM_COUNT))) {
+            ++failed;
+        } else if (lyd_find_sibling(st->tree->child, node->parent, &match) || (match != node->parent)) {
+            ++failed;
+        }
+
+        /* printing */
+        if (lyd_print_mem(&str, st->tree, LYD_JSON, LYP_WITHSIBLINGS) || strcmp(str, st->expected_print)) {
+            ++failed;
+        }
+        free(str);
+    }
+
+    return (void *)failed;
+}
+
+static void
+test_concurrent_read(void **state)
+{
+    struct state *st = (*state);
+    pthread_t threads[THREAD_COUNT];
+    void *failed;
+    int i;
+
+    for (i = 0; i < THREAD_COUNT; ++i) {
+        assert_int_equal(pthread_create(&threads[i], NULL, reader, st), 0);
+    }
+    for (i = 0; i < THREAD_COUNT; ++i) {
+        assert_int_equal(pthread_join(threads[i], &failed), 0);
+        assert_int_equal((long)failed, 0);
+    }
+}
+
+static void
+test_concurrent_read_validated(void **state)
+{
+    struct state *st = (*state);
+    pthread_t threads[THREAD_COUNT];
+    void *failed;
+    int i;
+
+    /* validation (when evaluation) does not leave any trace in the tree */
+    assert_int_equal(lyd_validate(&st->tree, LYD_OPT_CONFIG, NULL), 0);
+
+    for (i = 0; i < THREAD_COUNT; ++i) {
+        assert_int_equal(pthread_create(&threads[i], NULL, reader, st), 0);
+    }
+    for (i = 0; i < THREAD_COUNT; ++i) {
+        assert_int_equal(pthread_join(threads[i], &failed), 0);
+        assert_int_equal((long)failed, 0);
+    }
+}
+
+static const char *schema_p =
+"module p {"
+"  namespace urn:p;"
+"  prefix p;"
+"  list top {"
+"    key k;"
+"    leaf k { type string; }"
+"    container in { leaf v { type int32; } }"
+"    leaf-list ll { type string; }"
+"    anydata any;"
+"  }"
+"  container c2 {"
+"    list e {"
+"      key k;"
+"      leaf k { type uint32; }"
+"      leaf s { type string; }"
+"    }"
+"  }"
+"}";
+
+static const char *schema_q =
+"module q {"
+"  namespace urn:q;"
+"  prefix q;"
+"  import p { prefix p; }"
+"  augment /p:c2/p:e { leaf extra { type string; } }"
+"}";
+
+static void
+test_print_parallel(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *tree;
+    struct lyd_node_leaf_list *leaf;
+    struct ly_set *set;
+    LY_DATA_TYPE value_type;
+    char *data, *ptr, *serial, *parallel;
+    const LYD_FORMAT formats[] = {LYD_XML, LYD_JSON, LYD_LYB};
+    const int options[] = {LYP_WITHSIBLINGS, LYP_WITHSIBLINGS | LYP_FORMAT, 0};
+    unsigned int i, j;
+
+    assert_non_null(lys_parse_mem(st->ctx, schema_p, LYS_IN_YANG));
+    assert_non_null(lys_parse_mem(st->ctx, schema_q, LYS_IN_YANG));
+
+    /* top-level list entries, a container with a large list with augmented nodes and the original tree */
+    data = malloc(ITEM_COUNT * 1024);
+    assert_non_null(data);
+    ptr = data;
+    for (i = 0; i < ITEM_COUNT; ++i) {
+        ptr += sprintf(ptr, "<top xmlns=\"urn:p\"><k>t%u</k><in><v>%u</v></in><ll>a&lt;b</ll><ll>%u</ll>"
+                       "<any><c xmlns=\"urn:t\"><total>%u</total></c></any></top>", i, i, i, i);
+    }
+    ptr += sprintf(ptr, "<c2 xmlns=\"urn:p\">");
+    for (i = 0; i < ITEM_COUNT * 4; ++i) {
+        ptr += sprintf(ptr, "<e><k>%u</k><s>\"%u\"</s>%s</e>", i, i, (i % 3) ? "" : "<extra xmlns=\"urn:q\">x</extra>");
+    }
+    sprintf(ptr, "</c2>");
+    tree = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    free(data);
+    assert_non_null(tree);
+    assert_int_equal(lyd_merge(tree, st->tree, LYD_OPT_EXPLICIT), 0);
+
+    for (i = 0; i < sizeof formats / sizeof *formats; ++i) {
+        for (j = 0; j < sizeof options / sizeof *options; ++j) {
+            if ((formats[i] == LYD_LYB) && (options[j] & LYP_FORMAT)) {
+                continue;
+            }
+            assert_int_equal(lyd_print_mem(&serial, tree, formats[i], options[j]), 0);
+            assert_int_equal(lyd_print_mem(&parallel, tree, formats[i], options[j] | LYP_PARALLEL), 0);
+            if (formats[i] == LYD_LYB) {
+                assert_int_equal(lyd_lyb_data_length(parallel), lyd_lyb_data_length(serial));
+                assert_int_equal(memcmp(parallel, serial, lyd_lyb_data_length(serial)), 0);
+            } else {
+                assert_string_equal(parallel, serial);
+            }
+            free(serial);
+            free(parallel);
+        }
+    }
+
+    /* a subtree of the list */
+    assert_int_equal(lyd_print_mem(&serial, tree->prev->child, LYD_JSON, LYP_WITHSIBLINGS | LYP_FORMAT), 0);
+    assert_int_equal(lyd_print_mem(&parallel, tree->prev->child, LYD_JSON, LYP_WITHSIBLINGS | LYP_FORMAT | LYP_PARALLEL), 0);
+    assert_string_equal(parallel, serial);
+    free(serial);
+    free(parallel);
+
+    /* an error in a subtree printed by another thread is reported in this thread */
+    set = lyd_find_path(tree, "/p:c2/e[k='200']/s");
+    assert_non_null(set);
+    assert_int_equal(set->number, 1);
+    leaf = (struct lyd_node_leaf_list *)set->set.d[0];
+    value_type = leaf->value_type;
+    leaf->value_type = LY_TYPE_DER;
+    ly_err_clean(st->ctx, NULL);
+    parallel = NULL;
+    assert_int_not_equal(lyd_print_mem(&parallel, tree, LYD_XML, LYP_WITHSIBLINGS | LYP_PARALLEL), 0);
+    free(parallel);
+    assert_int_equal(ly_errno, LY_EINT);
+    assert_non_null(ly_err_first(st->ctx));
+    assert_int_equal(ly_err_first(st->ctx)->prev->no, LY_EINT);
+    leaf->value_type = value_type;
+    ly_set_free(set);
+
+    lyd_free_withsiblings(tree);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+                    cmocka_unit_test_setup_teardown(test_concurrent_read, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_concurrent_read_validated, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_print_parallel, setup_f, teardown_f),
+                    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,493 @@
+/**
+ * @file test_transcode.c
+ * @brief Cmocka tests for transcoding data without building the whole data tree.
+ *
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <sys/resource.h>
+#include <stdarg.h>
+#include <cmocka.h>
+
+#include "tests/config.h"
+#include "libyang.h"
+
+struct state {
+    struct ly_ctx *ctx;
+    char *str;
+};
+
+static const char *schema =
+"module t {"
+"  namespace urn:t;"
+"  prefix t;"
+"  import ietf-yang-metadata { prefix md; }"
+"  md:annotation note { type string; }"
+"  container c {"
+"    leaf a { type uint8; }"
+"    leaf b { type string; default \"x\"; }"
+"  }"
+"  list l { key k; leaf k { type string; } leaf v { type int32; } }"
+"  leaf-list ll { type string; }"
+"  leaf top { type string; }"
+"  leaf d { type string; default \"dflt\"; }"
+"  leaf ref { type leafref { path \"/t:top\"; } }"
+"  container big {"
+"    list item {"
+"      key id;"
+"      leaf id { type uint32; }"
+"      leaf name { type string; }"
+"      leaf-list tag { type string; }"
+"      container sub { leaf x { type int8; } }"
+"    }"
+"    leaf last { type string; }"
+"  }"
+"}";
+
+static const char *data_xml =
+"<c xmlns=\"urn:t\"><a>5</a></c>"
+"<l xmlns=\"urn:t\"><k>one</k><v>1</v></l>"
+"<l xmlns=\"urn:t\"><k>two</k></l>"
+"<ll xmlns=\"urn:t\">x</ll>"
+"<ll xmlns=\"urn:t\">y</ll>"
+"<top xmlns=\"urn:t\" xmlns:t=\"urn:t\" t:note=\"hi\">val</top>"
+"<ref xmlns=\"urn:t\">val</ref>";
+
+static const char *data_json =
+"{"
+  "\"t:c\": {\"a\": 5},"
+  "\"t:l\": [{\"k\": \"one\", \"v\": 1}, {\"k\": \"two\"}],"
+  "\"t:ll\": [\"x\", \"y\"],"
+  "\"t:top\": \"val\","
+  "\"@t:top\": {\"t:note\": \"hi, \\\"}\"},"
+  "\"t:ref\": \"val\""
+"}";
+
+static int
+setup_f(void **state)
+{
+    struct state *st;
+
+    (*state) = st = calloc(1, sizeof *st);
+    if (!st) {
+        fprintf(stderr, "Memory allocation error");
+        return -1;
+    }
+
+    /* libyang context */
+    st->ctx = ly_ctx_new(TESTS_DIR"/schema/yang/ietf/", 0);
+    if (!st->ctx) {
+        fprintf(stderr, "Failed to create context.\n");
+        goto error;
+    }
+
+    if (!lys_parse_mem(st->ctx, schema, LYS_IN_YANG)) {
+        fprintf(stderr, "Failed to load schema.\n");
+        goto error;
+    }
+
+    return 0;
+
+error:
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return -1;
+}
+
+static int
+teardown_f(void **state)
+{
+    struct state *st = (*state);
+
+    free(st->str);
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return 0;
+}
+
+/* transcoded data must be the same as parsed and printed data */
+static void
+transcode_check(struct state *st, const char *data, LYD_FORMAT in_format, LYD_FORMAT out_format, int print_options)
+{
+    struct lyd_node *tree;
+    char *printed;
+
+    tree = lyd_parse_mem(st->ctx, data, in_format, LYD_OPT_CONFIG);
+    assert_int_equal(ly_errno, LY_SUCCESS);
+    assert_int_equal(lyd_print_mem(&printed, tree, out_format, print_options | LYP_WITHSIBLINGS), 0);
+    lyd_free_withsiblings(tree);
+
+    assert_int_equal(lyd_transcode_mem(st->ctx, data, in_format, LYD_OPT_CONFIG, &st->str, out_format, print_options), 0);
+    assert_string_equal(st->str, printed);
+    free(printed);
+    free(st->str);
+    st->str = NULL;
+}
+
+/* single top-level container with many list instances, one of them larger than a chunk */
+static char *
+big_data(uint32_t count, uint32_t large, uint32_t large_tags)
+{
+    char *data, *ptr;
+    uint32_t i, j;
+
+    data = malloc(count * 128 + large_tags * 64 + 128);
+    if (!data) {
+        return NULL;
+    }
+
+    ptr = data + sprintf(data, "<big xmlns=\"urn:t\" xmlns:t=\"urn:t\">");
+    for (i = 0; i < count; ++i) {
+        ptr += sprintf(ptr, "<item><id>%u</id><name>name-%u</name><tag>a</tag><tag>b%u</tag><sub><x>%u</x></sub></item>",
+                       i, i, i % 7, i % 100);
+        if (i == large) {
+            ptr += sprintf(ptr, "<item><id>%u</id><name>large</name>", count);
+            for (j = 0; j < large_tags; ++j) {
+                ptr += sprintf(ptr, (j % 1000) ? "<tag>tag-%u</tag>" : "<tag t:note=\"n%u\">tag-%u</tag>", j, j);
+            }
+            ptr += sprintf(ptr, "</item>");
+        }
+    }
+    sprintf(ptr, "<last>end</last></big>");
+
+    return data;
+}
+
+/* the JSON parser does not accept annotations printed without their module, so they are removed for JSON input */
+static void
+strip_notes(char *data)
+{
+    char *ptr;
+
+    while ((ptr = strstr(data, " t:note=\""))) {
+        memset(ptr, ' ', strchr(ptr + 9, '"') - ptr + 1);
+    }
+}
+
+static ssize_t
+discard_clb(void *arg, const void *buf, size_t count)
+{
+    (void)arg;
+    (void)buf;
+
+    return count;
+}
+
+struct buffer {
+    char *data;
+    size_t len;
+    size_t size;
+};
+
+/* memory printer reallocates on every write, too slow for large data with sanitizers */
+static ssize_t
+buffer_clb(void *arg, const void *buf, size_t count)
+{
+    struct buffer *b = arg;
+    char *mem;
+
+    if (b->len + count + 1 > b->size) {
+        b->size = (b->len + count + 1) * 2;
+        mem = realloc(b->data, b->size);
+        if (!mem) {
+            return -1;
+        }
+        b->data = mem;
+    }
+    memcpy(b->data + b->len, buf, count);
+    b->len += count;
+    b->data[b->len] = '\0';
+
+    return count;
+}
+
+static long
+maxrss_kb(void)
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static void
+test_memory(void **state)
+{
+    struct state *st = (*state);
+    struct buffer json = {NULL, 0, 0};
+    char *data;
+    long rss, limit;
+
+    /* about 8 MB in a single subtree, parsed into a data tree it needs many times more */
+    data = big_data(80000, 40000, 20000);
+    assert_non_null(data);
+    /* only the opened nodes and a chunk are held, not the whole tree (nor the data size) */
+    limit = strlen(data) / 1024 / 4;
+
+    rss = maxrss_kb();
+    assert_int_equal(lyd_transcode_clb(st->ctx, data, LYD_XML, LYD_OPT_CONFIG, discard_clb, NULL, LYD_JSON, 0), 0);
+    rss = maxrss_kb() - rss;
+#ifndef __SANITIZE_ADDRESS__
+    assert_true(rss < limit);
+#else
+    /* freed memory is kept in the sanitizer quarantine */
+    (void)limit;
+#endif
+
+    strip_notes(data);
+    assert_int_equal(lyd_transcode_clb(st->ctx, data, LYD_XML, LYD_OPT_CONFIG, buffer_clb, &json, LYD_JSON, 0), 0);
+    free(data);
+
+    rss = maxrss_kb();
+    assert_int_equal(lyd_transcode_clb(st->ctx, json.data, LYD_JSON, LYD_OPT_CONFIG, discard_clb, NULL, LYD_XML, 0), 0);
+    rss = maxrss_kb() - rss;
+#ifndef __SANITIZE_ADDRESS__
+    assert_true(rss < limit);
+#endif
+
+    free(json.data);
+}
+
+/* the input data are generated and fed piece by piece, they are never held as a whole */
+static void
+test_memory_feed(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_transcoder *tc;
+    char piece[256];
+    uint32_t i, len;
+    long rss;
+    size_t total = 0;
+
+    rss = maxrss_kb();
+    tc = lyd_transcoder_new(st->ctx, LYD_XML, LYD_OPT_CONFIG, discard_clb, NULL, LYD_JSON, 0);
+    assert_non_null(tc);
+    len = sprintf(piece, "<big xmlns=\"urn:t\">");
+    for (i = 0; i < 80000; ++i) {
+        assert_int_equal(lyd_transcoder_feed(tc, piece, len), 0);
+        total += len;
+        len = sprintf(piece, "<item><id>%u</id><name>name-%u</name><tag>a</tag><tag>b%u</tag><sub><x>%u</x></sub></item>",
+                      i, i, i % 7, i % 100);
+    }
+    assert_int_equal(lyd_transcoder_feed(tc, piece, len), 0);
+    assert_int_equal(lyd_transcoder_feed(tc, "<last>end</last></big>", 22), 0);
+    total += len + 22;
+    assert_int_equal(lyd_transcoder_finish(tc), 0);
+    rss = maxrss_kb() - rss;
+#ifndef __SANITIZE_ADDRESS__
+    /* about 8 MB of data, neither the data nor the data tree are held */
+    assert_true(rss < (long)(total / 1024 / 4));
+#else
+    (void)rss;
+    (void)total;
+#endif
+}
+
+/* transcoded data fed in pieces must be the same as transcoded at once */
+static void
+transcode_feed_check(struct state *st, const char *data, LYD_FORMAT in_format, LYD_FORMAT out_format, size_t piece)
+{
+    struct lyd_transcoder *tc;
+    struct buffer out = {NULL, 0, 0};
+    size_t len, i;
+
+    assert_int_equal(lyd_transcode_mem(st->ctx, data, in_format, LYD_OPT_CONFIG, &st->str, out_format, 0), 0);
+
+    tc = lyd_transcoder_new(st->ctx, in_format, LYD_OPT_CONFIG, buffer_clb, &out, out_format, 0);
+    assert_non_null(tc);
+    len = strlen(data);
+    for (i = 0; i < len; i += piece) {
+        assert_int_equal(lyd_transcoder_feed(tc, data + i, (len - i < piece) ? len - i : piece), 0);
+    }
+    assert_int_equal(lyd_transcoder_finish(tc), 0);
+
+    assert_string_equal(out.data ? out.data : "", st->str);
+    free(out.data);
+    free(st->str);
+    st->str = NULL;
+}
+
+static void
+test_feed(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_transcoder *tc;
+    char *data;
+
+    transcode_feed_check(st, data_xml, LYD_XML, LYD_JSON, 1);
+    transcode_feed_check(st, data_xml, LYD_XML, LYD_XML, 7);
+    transcode_feed_check(st, data_json, LYD_JSON, LYD_XML, 1);
+    transcode_feed_check(st, data_json, LYD_JSON, LYD_JSON, 5);
+
+    data = big_data(3000, 1500, 10000);
+    assert_non_null(data);
+    transcode_feed_check(st, data, LYD_XML, LYD_JSON, 4093);
+    transcode_feed_check(st, data, LYD_XML, LYD_JSON, 65536);
+    free(data);
+
+    /* nothing fed */
+    transcode_feed_check(st, "", LYD_XML, LYD_JSON, 1);
+
+    /* invalid value, the transcoder can then only be freed */
+    tc = lyd_transcoder_new(st->ctx, LYD_XML, LYD_OPT_CONFIG, discard_clb, NULL, LYD_JSON, 0);
+    assert_non_null(tc);
+    assert_int_equal(lyd_transcoder_feed(tc, "<c xmlns=\"urn:t\"><a>300</a></c><top xmlns=\"urn:t\">", 50), 1);
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_int_equal(lyd_transcoder_feed(tc, "val</top>", 9), 1);
+    lyd_transcoder_free(tc);
+
+    /* incomplete data */
+    tc = lyd_transcoder_new(st->ctx, LYD_JSON, LYD_OPT_CONFIG, discard_clb, NULL, LYD_XML, 0);
+    assert_non_null(tc);
+    assert_int_equal(lyd_transcoder_feed(tc, "{\"t:top\":\"val\"", 15), 0);
+    assert_int_equal(lyd_transcoder_finish(tc), 1);
+}
+
+static void
+test_big(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *tree;
+    char *data, *json;
+
+    data = big_data(3000, 1500, 10000);
+    assert_non_null(data);
+
+    /* leaf-list metadata are printed after all the instances */
+    transcode_check(st, data, LYD_XML, LYD_JSON, 0);
+    transcode_check(st, data, LYD_XML, LYD_JSON, LYP_FORMAT);
+
+    /* annotation namespaces of nested chunks are declared on them, so the rest is compared without annotations */
+    strip_notes(data);
+    transcode_check(st, data, LYD_XML, LYD_XML, 0);
+    transcode_check(st, data, LYD_XML, LYD_XML, LYP_FORMAT);
+
+    tree = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    assert_non_null(tree);
+    assert_int_equal(lyd_print_mem(&json, tree, LYD_JSON, LYP_WITHSIBLINGS | LYP_FORMAT), 0);
+    lyd_free_withsiblings(tree);
+    free(data);
+
+    transcode_check(st, json, LYD_JSON, LYD_JSON, 0);
+    transcode_check(st, json, LYD_JSON, LYD_XML, LYP_FORMAT);
+    free(json);
+}
+
+static void
+test_xml(void **state)
+{
+    struct state *st = (*state);
+
+    transcode_check(st, data_xml, LYD_XML, LYD_XML, 0);
+    transcode_check(st, data_xml, LYD_XML, LYD_XML, LYP_FORMAT);
+    transcode_check(st, data_xml, LYD_XML, LYD_JSON, 0);
+    transcode_check(st, data_xml, LYD_XML, LYD_JSON, LYP_FORMAT);
+
+    /* empty data */
+    assert_int_equal(lyd_transcode_mem(st->ctx, "", LYD_XML, LYD_OPT_CONFIG, &st->str, LYD_XML, 0), 0);
+    assert_string_equal(st->str, "");
+    free(st->str);
+    assert_int_equal(lyd_transcode_mem(st->ctx, "<!-- nothing -->", LYD_XML, LYD_OPT_CONFIG, &st->str, LYD_JSON,
+                                       LYP_FORMAT), 0);
+    assert_string_equal(st->str, "{\n}\n");
+}
+
+static void
+test_json(void **state)
+{
+    struct state *st = (*state);
+
+    transcode_check(st, data_json, LYD_JSON, LYD_XML, 0);
+    transcode_check(st, data_json, LYD_JSON, LYD_XML, LYP_FORMAT);
+    transcode_check(st, data_json, LYD_JSON, LYD_JSON, 0);
+    transcode_check(st, data_json, LYD_JSON, LYD_JSON, LYP_FORMAT);
+
+    /* metadata member before the node */
+    transcode_check(st, "{\"@t:top\":{\"t:note\":\"hi\"},\"t:top\":\"val\",\"t:ll\":[\"x\"]}", LYD_JSON, LYD_XML, 0);
+
+    /* empty data */
+    assert_int_equal(lyd_transcode_mem(st->ctx, " { } ", LYD_JSON, LYD_OPT_CONFIG, &st->str, LYD_JSON, 0), 0);
+    assert_string_equal(st->str, "{}");
+}
+
+static void
+test_unsupported(void **state)
+{
+    struct state *st = (*state);
+
+    /* LYB and the options need the whole data tree, they are refused rather than parsing it */
+    assert_int_not_equal(lyd_transcode_mem(st->ctx, data_xml, LYD_XML, LYD_OPT_CONFIG, &st->str, LYD_LYB, 0), 0);
+    assert_int_equal(ly_errno, LY_EINVAL);
+    assert_ptr_equal(st->str, NULL);
+    assert_int_not_equal(lyd_transcode_mem(st->ctx, data_xml, LYD_LYB, LYD_OPT_CONFIG, &st->str, LYD_XML, 0), 0);
+    assert_int_equal(ly_errno, LY_EINVAL);
+    assert_int_not_equal(lyd_transcode_mem(st->ctx, data_xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_NOSIBLINGS,
+                                           &st->str, LYD_JSON, 0), 0);
+    assert_int_equal(ly_errno, LY_EINVAL);
+    assert_int_not_equal(lyd_transcode_mem(st->ctx, data_xml, LYD_XML, LYD_OPT_DATA_ADD_YANGLIB,
+                                           &st->str, LYD_JSON, 0), 0);
+    assert_int_equal(ly_errno, LY_EINVAL);
+    assert_ptr_equal(lyd_transcoder_new(st->ctx, LYD_LYB, LYD_OPT_CONFIG, discard_clb, NULL, LYD_XML, 0), NULL);
+    assert_int_equal(ly_errno, LY_EINVAL);
+}
+
+static void
+test_invalid(void **state)
+{
+    struct state *st = (*state);
+    const char *not_adjacent = "<l xmlns=\"urn:t\"><k>one</k></l><top xmlns=\"urn:t\">val</top><l xmlns=\"urn:t\"><k>two</k></l>";
+
+    /* list instances are printed in a single JSON array */
+    assert_int_not_equal(lyd_transcode_mem(st->ctx, not_adjacent, LYD_XML, LYD_OPT_CONFIG, &st->str, LYD_JSON, 0), 0);
+    assert_ptr_equal(st->str, NULL);
+    transcode_check(st, not_adjacent, LYD_XML, LYD_XML, 0);
+
+    /* values are still checked */
+    assert_int_not_equal(lyd_transcode_mem(st->ctx, "<c xmlns=\"urn:t\"><a>300</a></c>", LYD_XML, LYD_OPT_CONFIG,
+                                           &st->str, LYD_JSON, 0), 0);
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_int_not_equal(lyd_transcode_mem(st->ctx, "{\"t:c\":{\"a\":300}}", LYD_JSON, LYD_OPT_CONFIG,
+                                           &st->str, LYD_XML, 0), 0);
+    assert_int_equal(ly_errno, LY_EVALID);
+
+    /* malformed data */
+    assert_int_not_equal(lyd_transcode_mem(st->ctx, "{\"t:top\":\"val\"", LYD_JSON, LYD_OPT_CONFIG,
+                                           &st->str, LYD_XML, 0), 0);
+    assert_int_not_equal(lyd_transcode_mem(st->ctx, "<top xmlns=\"urn:t\">val</top><", LYD_XML, LYD_OPT_CONFIG,
+                                           &st->str, LYD_JSON, 0), 0);
+
+    /* only data trees */
+    assert_int_not_equal(lyd_transcode_mem(st->ctx, data_xml, LYD_XML, LYD_OPT_RPC, &st->str, LYD_JSON, 0), 0);
+    assert_int_equal(ly_errno, LY_EINVAL);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+                    /* first, before any test builds a large data tree */
+                    cmocka_unit_test_setup_teardown(test_memory_feed, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_memory, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_feed, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_big, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_xml, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_json, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_unsupported, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_invalid, setup_f, teardown_f),
+                    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
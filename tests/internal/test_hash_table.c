@@ -139,17 +139,15 @@ test_resize(void **state)
     assert_int_equal(ht->size, 16);
 
     for (i = 0; i < 2; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, 0);
+        assert_false(LYHT_REC_FILLED(ht, i));
     }
     for (; i < 8; ++i) {
+        assert_true(LYHT_REC_FILLED(ht, i));
         rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, 1);
         assert_int_equal(rec->hash, i);
     }
     for (; i < 16; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, 0);
+        assert_false(LYHT_REC_FILLED(ht, i));
     }
 
     for (i = 0; i < 2; ++i) {
@@ -188,52 +186,42 @@ test_collisions(void **state)
 
     /* check all records */
     for (i = 0; i < 2; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, 0);
+        assert_false(LYHT_REC_FILLED(ht, i));
     }
-    rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-    assert_int_equal(rec->hits, 4);
-    assert_int_equal(GET_REC_VAL(rec), i);
-    ++i;
     for (; i < 6; ++i) {
+        assert_true(LYHT_REC_FILLED(ht, i));
         rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, 1);
         assert_int_equal(GET_REC_VAL(rec), i);
     }
     for (; i < 8; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, 0);
+        assert_false(LYHT_REC_FILLED(ht, i));
     }
 
+    /* the last collision is moved into the removed record */
     i = 4;
     assert_int_equal(lyht_remove(ht, &i, 2), 0);
 
     rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-    assert_int_equal(rec->hits, -1);
+    assert_int_equal(GET_REC_VAL(rec), 5);
+    assert_false(LYHT_REC_FILLED(ht, 5));
 
     i = 2;
     assert_int_equal(lyht_remove(ht, &i, 2), 0);
 
     /* check all records */
     for (i = 0; i < 2; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, 0);
+        assert_false(LYHT_REC_FILLED(ht, i));
     }
+    assert_true(LYHT_REC_FILLED(ht, i));
     rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-    assert_int_equal(rec->hits, 2);
-    assert_int_equal(GET_REC_VAL(rec), 5);
+    assert_int_equal(GET_REC_VAL(rec), 3);
     ++i;
+    assert_true(LYHT_REC_FILLED(ht, i));
     rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-    assert_int_equal(rec->hits, 1);
-    assert_int_equal(GET_REC_VAL(rec), 3);
+    assert_int_equal(GET_REC_VAL(rec), 5);
     ++i;
-    for (; i < 6; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, -1);
-    }
     for (; i < 8; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, 0);
+        assert_false(LYHT_REC_FILLED(ht, i));
     }
 
     for (i = 0; i < 3; ++i) {
@@ -255,17 +243,8 @@ test_collisions(void **state)
     assert_int_equal(lyht_remove(ht, &i, 2), 0);
 
     /* check all records */
-    for (i = 0; i < 2; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, 0);
-    }
-    for (; i < 6; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, -1);
-    }
-    for (; i < 8; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, 0);
+    for (i = 0; i < 8; ++i) {
+        assert_false(LYHT_REC_FILLED(ht, i));
     }
 }
 
@@ -293,21 +272,65 @@ test_invalid_move(void **state)
     assert_int_equal(lyht_insert(ht, &a[6], 6, NULL), 0);
     assert_int_equal(lyht_insert(ht, &a[7], 7, NULL), 0);
 
-    /* these are the invalid values */
-    for (i = 1; i < 4; ++i) {
-        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
-        assert_int_equal(rec->hits, -1);
+    /* the collision was moved right after its hash, there are no deleted records */
+    rec = lyht_get_rec(ht->recs, ht->rec_size, 1);
+    assert_int_equal(GET_REC_VAL(rec), 4);
+    for (i = 2; i < 5; ++i) {
+        assert_false(LYHT_REC_FILLED(ht, i));
     }
 
     /* if all the values were being moved correctly, this succeeds */
     assert_int_equal(lyht_insert(ht, &a[8], 0, NULL), 0);
 
+    for (i = 0; i < 3; ++i) {
+        assert_true(LYHT_REC_FILLED(ht, i));
+        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
+        assert_int_equal(rec->hash, 0);
+    }
+    assert_int_equal(lyht_find(ht, &a[4], 0, NULL), 0);
+    assert_int_equal(lyht_find(ht, &a[8], 0, NULL), 0);
+}
+
+static void
+test_wrap(void **state)
+{
+    int i, a[] = { 6, 7, 14, 15, 22 };
+    int *match;
+    struct ht_rec *rec;
+
+    (void)state;
+
+    /* collisions continuing from the end of the table to its beginning */
+    assert_int_equal(lyht_insert(ht, &a[0], 6, NULL), 0);
+    assert_int_equal(lyht_insert(ht, &a[1], 7, NULL), 0);
+    assert_int_equal(lyht_insert(ht, &a[2], 6, NULL), 0);
+    assert_int_equal(lyht_insert(ht, &a[3], 7, NULL), 0);
+    assert_int_equal(lyht_insert(ht, &a[4], 6, NULL), 0);
+
+    rec = lyht_get_rec(ht->recs, ht->rec_size, 2);
+    assert_int_equal(GET_REC_VAL(rec), 22);
+
+    /* equal hashes are returned in the order of insertion */
+    assert_int_equal(lyht_find(ht, &a[0], 6, (void **)&match), 0);
+    assert_int_equal(lyht_find_next(ht, match, 6, (void **)&match), 0);
+    assert_int_equal(*match, 14);
+    assert_int_equal(lyht_find_next(ht, match, 6, (void **)&match), 0);
+    assert_int_equal(*match, 22);
+    assert_int_equal(lyht_find_next(ht, match, 6, (void **)&match), 1);
+
+    /* all the following records are moved back across the end of the table */
+    assert_int_equal(lyht_remove(ht, &a[1], 7), 0);
+    rec = lyht_get_rec(ht->recs, ht->rec_size, 7);
+    assert_int_equal(GET_REC_VAL(rec), 14);
     rec = lyht_get_rec(ht->recs, ht->rec_size, 0);
-    assert_int_equal(rec->hits, 3);
+    assert_int_equal(GET_REC_VAL(rec), 15);
     rec = lyht_get_rec(ht->recs, ht->rec_size, 1);
-    assert_int_equal(rec->hits, 1);
-    rec = lyht_get_rec(ht->recs, ht->rec_size, 2);
-    assert_int_equal(rec->hits, 1);
+    assert_int_equal(GET_REC_VAL(rec), 22);
+    assert_false(LYHT_REC_FILLED(ht, 2));
+
+    for (i = 0; i < 5; ++i) {
+        assert_int_equal(lyht_find(ht, &a[i], a[i] % 8, NULL), i == 1 ? 1 : 0);
+    }
 }
 
 static void
@@ -362,6 +385,7 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_collisions, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_invalid_move, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_invalid_move2, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_wrap, setup_f, teardown_f),
     };
 
     //ly_verb(LY_LLDBG);
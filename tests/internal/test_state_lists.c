@@ -108,6 +108,51 @@ test_hash(void **state)
     lyd_hash_check(st->root1);
 }
 
+static void
+test_hash_parse(void **state)
+{
+    struct lyd_node *root, *root2;
+    struct state *st = (*state);
+    char *str;
+    int i, len;
+
+    /* many instances, the hash tables are built only after all the children are parsed, in every format */
+    str = malloc(1000 * 48 + 64);
+    assert_non_null(str);
+    len = sprintf(str, "<cont xmlns=\"urn:state-lists\">");
+    for (i = 0; i < 1000; ++i) {
+        len += sprintf(str + len, "<ll>val%d</ll><l><leaf1>val%d</leaf1></l>", i, i);
+    }
+    sprintf(str + len, "</cont>");
+    root = lyd_parse_mem(st->ctx, str, LYD_XML, LYD_OPT_GET);
+    free(str);
+    assert_non_null(root);
+    assert_non_null(root->ht);
+    assert_int_equal(root->ht->used, 2000);
+    assert_int_equal(root->ht->size, 4096);
+    lyd_hash_check(root);
+
+    lyd_print_mem(&str, root, LYD_JSON, 0);
+    root2 = lyd_parse_mem(st->ctx, str, LYD_JSON, LYD_OPT_GET);
+    free(str);
+    assert_non_null(root2);
+    assert_int_equal(root2->ht->used, 2000);
+    assert_int_equal(root2->ht->size, 4096);
+    lyd_hash_check(root2);
+    lyd_free(root2);
+
+    lyd_print_mem(&str, root, LYD_LYB, 0);
+    root2 = lyd_parse_mem(st->ctx, str, LYD_LYB, LYD_OPT_GET);
+    free(str);
+    assert_non_null(root2);
+    assert_int_equal(root2->ht->used, 2000);
+    assert_int_equal(root2->ht->size, 4096);
+    lyd_hash_check(root2);
+    lyd_free(root2);
+
+    lyd_free(root);
+}
+
 #endif
 
 static int
@@ -475,6 +520,7 @@ int main(void)
     const struct CMUnitTest tests[] = {
 #ifdef LY_ENABLED_CACHE
                     cmocka_unit_test_setup_teardown(test_hash, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_hash_parse, setup_f, teardown_f),
 #endif
                     cmocka_unit_test_setup_teardown(test_merge_same, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_merge_equal_leaflist, setup_f, teardown_f),
@@ -58,6 +58,7 @@ int main(int argc, char *argv[])
     fprintf(stdout, "%8lu struct lyd_attr\n", x = sizeof(struct lyd_attr)); suma += x;
     fprintf(stdout, "%8lu struct lyd_node\n", x = sizeof(struct lyd_node)); suma += x;
     fprintf(stdout, "%8lu struct lyd_node_leaf_list\n", x = sizeof(struct lyd_node_leaf_list)); suma += x;
+    fprintf(stdout, "%8lu struct lyd_compact_node\n", x = sizeof(struct lyd_compact_node)); suma += x;
     fprintf(stdout, "%8lu struct lyd_node_anyxml\n", x = sizeof(struct lyd_node_anydata)); suma += x;
     fprintf(stdout, "%8lu struct lyd_difflist\n", x = sizeof(struct lyd_difflist)); suma += x;
     fprintf(stdout, "DATA TREE SUM %8lu\n\n", suma);
@@ -1239,6 +1239,56 @@ test_typedef_patterns_optimizations_yin(void **state)
     test_typedef_patterns_optimizations_schema(st, mod);
 }
 
+static void
+test_typedef_grouping_shared(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod;
+    struct lys_node_leaf *e1, *e2, *s1, *s2, *f1, *f2;
+    struct lyd_node *root;
+    const char *yang = "module x {"
+"  yang-version 1.1;"
+"  namespace \"urn:x\";"
+"  prefix x;"
+"  feature f;"
+"  grouping g {"
+"    leaf e { type enumeration { enum one; enum two; } }"
+"    leaf s { type string { length 1..5; pattern \"[a-z]*\"; } }"
+"    leaf f { type enumeration { enum one { if-feature f; } enum two; } } }"
+"  container c1 { uses g; }"
+"  container c2 { uses g; } }";
+    const char *data1 = "<c1 xmlns=\"urn:x\"><e>two</e><s>abc</s><f>two</f></c1>"
+"<c2 xmlns=\"urn:x\"><e>one</e><s>xyz</s></c2>";
+    const char *data2 = "<c2 xmlns=\"urn:x\"><s>abcdef</s></c2>";
+
+    mod = lys_parse_mem(st->ctx, yang, LYS_IN_YANG);
+    assert_ptr_not_equal(mod, NULL);
+
+    /* grouping g is the first node, the leaves are children of the uses nodes */
+    e1 = (struct lys_node_leaf *)mod->data->next->child->child;
+    s1 = (struct lys_node_leaf *)e1->next;
+    f1 = (struct lys_node_leaf *)s1->next;
+    e2 = (struct lys_node_leaf *)mod->data->next->next->child->child;
+    s2 = (struct lys_node_leaf *)e2->next;
+    f2 = (struct lys_node_leaf *)s2->next;
+
+    /* restrictions of the grouping instances are shared */
+    assert_ptr_equal(e1->type.info.enums.enm, e2->type.info.enums.enm);
+    assert_ptr_equal(s1->type.info.str.length, s2->type.info.str.length);
+    assert_ptr_equal(s1->type.info.str.patterns, s2->type.info.str.patterns);
+    /* enums with if-feature are not */
+    assert_ptr_not_equal(f1->type.info.enums.enm, f2->type.info.enums.enm);
+
+    root = lyd_parse_mem(st->ctx, data1, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(root, NULL);
+    lyd_free_withsiblings(root);
+
+    root = lyd_parse_mem(st->ctx, data2, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_equal(root, NULL);
+
+    assert_int_equal(ly_ctx_remove_module(mod, NULL), 0);
+}
+
 int
 main(void)
 {
@@ -1266,6 +1316,7 @@ main(void)
         cmocka_unit_test_setup_teardown(test_typedef_11_union_empty_yang, setup_ctx, teardown_ctx),
         cmocka_unit_test_setup_teardown(test_typedef_patterns_optimizations_yin, setup_ctx, teardown_ctx),
         cmocka_unit_test_setup_teardown(test_typedef_patterns_optimizations_yang, setup_ctx, teardown_ctx),
+        cmocka_unit_test_setup_teardown(test_typedef_grouping_shared, setup_ctx, teardown_ctx),
     };
 
     return cmocka_run_group_tests(cmut, NULL, NULL);
@@ -22,6 +22,7 @@
 #include <unistd.h>
 #include <getopt.h>
 #include <libgen.h>
+#include <inttypes.h>
 
 #include "compat.h"
 #include "commands.h"
@@ -138,6 +139,14 @@ cmd_list_help(void)
     printf("\tBasic list output (no -f): i - imported module, I - implemented module\n");
 }
 
+void
+cmd_stats_help(void)
+{
+    printf("stats [-m] [-t (data | config | get | getconfig | edit)] [<data-file-name>]\n\n");
+    printf("\tPrint memory usage of the context (dictionary and schemas) and optionally of a data tree.\n");
+    printf("\t-m         - print the statistics of every module\n");
+}
+
 void
 cmd_feature_help(void)
 {
@@ -1163,6 +1172,149 @@ error:
     return print_list(stdout, ctx, outformat);
 }
 
+static void
+print_ht_stats(FILE *out, const char *name, const struct ly_ht_stats *ht)
+{
+    fprintf(out, "\t%s: %u table(s), %u/%u records used, %lu B, average probe %.2f, longest probe %u\n", name,
+            ht->count, ht->used, ht->size, (unsigned long)ht->bytes, ht->used ? (double)ht->probe_total / ht->used : 0.0,
+            ht->probe_max);
+}
+
+static int
+print_stats(FILE *out, struct ly_ctx *ctx, struct lyd_node *data, int modules)
+{
+    struct ly_ctx_stats *stats;
+    struct lyd_tree_stats dstats;
+    const struct lys_module *mod;
+    uint32_t i;
+
+    stats = ly_ctx_stats(ctx);
+    if (!stats) {
+        return 1;
+    }
+
+    fprintf(out, "Dictionary: %u strings (%u pinned), %" PRIu64 " references, %lu B\n", stats->dict_strings,
+            stats->dict_pinned, stats->dict_refs, (unsigned long)stats->dict_bytes);
+    fprintf(out, "\treferenced 1: %u, 2: %u, 3-4: %u, 5-8: %u, 9-16: %u, 17-32: %u, 33-64: %u, 65+: %u times\n",
+            stats->dict_refcounts[0], stats->dict_refcounts[1], stats->dict_refcounts[2], stats->dict_refcounts[3],
+            stats->dict_refcounts[4], stats->dict_refcounts[5], stats->dict_refcounts[6], stats->dict_refcounts[7]);
+    print_ht_stats(out, "hash table", &stats->dict_ht);
+
+    fprintf(out, "Schemas: %u modules, %u nodes, %lu B, %u compiled patterns, %lu B\n", stats->module_count, stats->nodes,
+            (unsigned long)stats->bytes, stats->patterns, (unsigned long)stats->pattern_bytes);
+    if (modules) {
+        for (i = 0; i < stats->module_count; ++i) {
+            mod = stats->modules[i].module;
+            fprintf(out, "\t%s%s%s: %u nodes, %lu B, %u compiled patterns, %lu B\n", mod->name, mod->rev_size ? "@" : "",
+                    mod->rev_size ? mod->rev[0].date : "", stats->modules[i].nodes, (unsigned long)stats->modules[i].bytes,
+                    stats->modules[i].patterns, (unsigned long)stats->modules[i].pattern_bytes);
+        }
+    }
+    free(stats);
+
+    if (data) {
+        if (lyd_tree_stats(data, 1, &dstats)) {
+            return 1;
+        }
+
+        fprintf(out, "Data: %u nodes, %u attributes, %lu B\n", dstats.nodes, dstats.attrs, (unsigned long)dstats.bytes);
+        fprintf(out, "\tcontainers: %u, lists: %u, leaves: %u, leaf-lists: %u, anydata: %u, operations: %u, default: %u\n",
+                dstats.containers, dstats.lists, dstats.leaves, dstats.leaflists, dstats.anydata, dstats.operations,
+                dstats.dflt);
+        print_ht_stats(out, "children hash tables", &dstats.child_ht);
+    }
+
+    return 0;
+}
+
+int
+cmd_stats(const char *arg)
+{
+    char **argv = NULL, *ptr;
+    int c, argc, option_index, modules = 0, options = LYD_OPT_DATA_NO_YANGLIB, ret = 1;
+    struct lyd_node *data = NULL;
+    static struct option long_options[] = {
+        {"help", no_argument, 0, 'h'},
+        {"modules", no_argument, 0, 'm'},
+        {"option", required_argument, 0, 't'},
+        {NULL, 0, 0, 0}
+    };
+    void *rlcd;
+
+    argc = 1;
+    argv = malloc(2*sizeof *argv);
+    *argv = strdup(arg);
+    ptr = strtok(*argv, " ");
+    while ((ptr = strtok(NULL, " "))) {
+        rlcd = realloc(argv, (argc+2)*sizeof *argv);
+        if (!rlcd) {
+            fprintf(stderr, "Memory allocation failed (%s:%d, %s)", __FILE__, __LINE__, strerror(errno));
+            goto cleanup;
+        }
+        argv = rlcd;
+        argv[argc++] = ptr;
+    }
+    argv[argc] = NULL;
+
+    optind = 0;
+    while (1) {
+        option_index = 0;
+        c = getopt_long(argc, argv, "hmt:", long_options, &option_index);
+        if (c == -1) {
+            break;
+        }
+
+        switch (c) {
+        case 'h':
+            cmd_stats_help();
+            ret = 0;
+            goto cleanup;
+        case 'm':
+            modules = 1;
+            break;
+        case 't':
+            if (!strcmp(optarg, "data")) {
+                options = LYD_OPT_DATA_NO_YANGLIB;
+            } else if (!strcmp(optarg, "config")) {
+                options = LYD_OPT_CONFIG;
+            } else if (!strcmp(optarg, "get")) {
+                options = LYD_OPT_GET;
+            } else if (!strcmp(optarg, "getconfig")) {
+                options = LYD_OPT_GETCONFIG;
+            } else if (!strcmp(optarg, "edit")) {
+                options = LYD_OPT_EDIT;
+            } else {
+                fprintf(stderr, "Invalid parser option \"%s\".\n", optarg);
+                cmd_stats_help();
+                goto cleanup;
+            }
+            break;
+        case '?':
+            /* getopt_long() prints message */
+            goto cleanup;
+        }
+    }
+
+    if (optind < argc) {
+        if (optind + 1 < argc) {
+            fprintf(stderr, "Unknown parameter \"%s\"\n", argv[optind + 1]);
+            goto cleanup;
+        }
+        if (parse_data(argv[optind], LYD_UNKNOWN, &options, NULL, NULL, &data)) {
+            goto cleanup;
+        }
+    }
+
+    ret = print_stats(stdout, ctx, data, modules);
+
+cleanup:
+    free(*argv);
+    free(argv);
+    lyd_free_withsiblings(data);
+
+    return ret;
+}
+
 int
 cmd_feature(const char *arg)
 {
@@ -1526,6 +1678,7 @@ COMMAND commands[] = {
         {"data", cmd_data, cmd_data_help, "Load, validate and optionally print instance data"},
         {"xpath", cmd_xpath, cmd_xpath_help, "Get data nodes satisfying an XPath expression"},
         {"list", cmd_list, cmd_list_help, "List all the loaded models"},
+        {"stats", cmd_stats, cmd_stats_help, "Print memory usage statistics of the context and data"},
         {"feature", cmd_feature, cmd_feature_help, "Print/enable/disable all/specific features of models"},
         {"searchpath", cmd_searchpath, cmd_searchpath_help, "Print/set the search path(s) for models"},
         {"clear", cmd_clear, cmd_clear_help, "Clear the context - remove all the loaded models"},